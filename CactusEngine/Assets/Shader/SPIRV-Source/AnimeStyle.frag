@@ -144,8 +144,7 @@ void main(void)
 	vec2 yTexOffset = vec2(0, texOffset.y);
 
 	// Screen space sample coordinates
-	vec2 screenCoord = (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).xy / (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).w * 0.5f + 0.5f;
-	screenCoord.y = -screenCoord.y;
+	vec2 screenCoord = gl_FragCoord.xy / textureSize(GNormalTexture, 0); // Stays valid when only a sub-rect of the render target is rendered
 
 	// Depth gradient based on normal
 	vec3 rightNormal = texture(GNormalTexture, screenCoord + xTexOffset).xyz;
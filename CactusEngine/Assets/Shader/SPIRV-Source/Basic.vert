@@ -13,6 +13,8 @@ layout(std140, binding = 14) uniform TransformMatrices
 {
 	mat4 ModelMatrix;
 	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
 };
 
 layout(std140, binding = 22) uniform CameraMatrices
@@ -28,9 +30,11 @@ layout(std140, binding = 15) uniform LightSpaceTransformMatrix
 
 void main(void)
 {
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
 	v2fTexCoord = inTexCoord;
 	v2fNormal = normalize(mat3(NormalMatrix) * inNormal);
-	v2fPosition = (ModelMatrix * vec4(inPosition, 1.0)).xyz;
+	v2fPosition = (ModelMatrix * vec4(position, 1.0)).xyz;
 
-	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(inPosition, 1.0);
+	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec2 v2fTexCoord;
+layout(location = 1) in vec3 v2fNormal;
+layout(location = 2) in vec3 v2fPosition;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 3) uniform sampler2D GPositionTexture;
+layout(binding = 5) uniform sampler2D GNormalTexture;
+layout(binding = 0) uniform sampler2D ShadowMapDepthTexture;
+
+layout(set = 1, binding = 0) uniform sampler2D BindlessTextures[];
+
+struct MaterialRecord
+{
+	vec4  AlbedoColor;
+	float Anisotropy;
+	float Roughness;
+	uint  AlbedoTextureIndex;
+	uint  ToneTextureIndex;
+};
+
+layout(std430, set = 1, binding = 1) readonly buffer BindlessMaterials
+{
+	MaterialRecord Materials[];
+};
+
+layout(push_constant) uniform BindlessDrawParams
+{
+	uint MaterialIndex;
+};
+
+const uint InvalidIndex = 0xFFFFFFFFu;
+
+vec4 SampleBindlessTexture(uint index, vec2 texCoord)
+{
+	if (index == InvalidIndex)
+	{
+		return vec4(1);
+	}
+	return texture(BindlessTextures[nonuniformEXT(index)], texCoord);
+}
+
+layout(std140, binding = 17) uniform CameraProperties
+{
+	vec3  CameraPosition;
+	float Aperture;
+	float FocalDistance;
+	float ImageDistance;
+};
+
+// TODO: replace Lambertian model with PBR
+const vec3  LightDirection = vec3(0.0f, 0.8660254f, -0.5f);
+const vec4  LightColor = vec4(1, 1, 1, 1);
+const float LightIntensity = 1.5f;
+const float AmbientIntensity = 0.05f;
+
+
+void main(void)
+{
+	MaterialRecord material = Materials[MaterialIndex];
+	vec4  AlbedoColor = material.AlbedoColor;
+
+	vec4 colorFromAlbedoTexture = SampleBindlessTexture(material.AlbedoTextureIndex, v2fTexCoord);
+	if (colorFromAlbedoTexture.a <= 0)
+	{
+		discard;
+	}
+
+	outColor = AlbedoColor * colorFromAlbedoTexture * LightColor * (clamp(dot(v2fNormal, LightDirection), 0.0f, 1e10) + AmbientIntensity) * LightIntensity;
+}
\ No newline at end of file
@@ -55,8 +55,7 @@ void main(void)
 	vec4 foregroundColor = AlbedoColor * colorFromAlbedoTexture * LightColor * (clamp(dot(v2fNormal, LightDirection), 0.0f, 1e10) + AmbientIntensity) * LightIntensity; // 0.1f is ambient intensity
 	foregroundColor.r *= 1.5f; // Alert: this should be removed after the demo reel
 
-	vec2 screenCoord = (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).xy / (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).w * 0.5f + 0.5f;
-	screenCoord.y = -screenCoord.y;
+	vec2 screenCoord = gl_FragCoord.xy / textureSize(ColorTexture_1, 0); // Stays valid when only a sub-rect of the render target is rendered
 	
 	vec4 backgroundColor = texture(ColorTexture_1, screenCoord);
 	backgroundColor.a = 1.0f;
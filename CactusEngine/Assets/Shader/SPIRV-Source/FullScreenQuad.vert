@@ -2,6 +2,12 @@
 
 layout(location = 0) out vec2 v2fTexCoord;
 
+// Portion of input textures covered by current render area, inputs may be larger than what is rendered into them
+layout(push_constant) uniform FullScreenQuadParameters
+{
+	vec2 TexCoordScale;
+};
+
 // Full-screen quad
 const vec4 quad_pos[4] = vec4[](vec4(-1.0, 1.0, 0.0, 1.0), vec4(-1.0, -1.0, 0.0, 1.0), vec4(1.0, 1.0, 0.0, 1.0), vec4(1.0, -1.0, 0.0, 1.0));
 const vec2 quad_tex[4] = vec2[](vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 1.0), vec2(1.0, 0.0));
@@ -12,4 +18,5 @@ void main(void)
 	gl_Position = quad_pos[gl_VertexIndex];
 	v2fTexCoord = quad_tex[gl_VertexIndex];
 	v2fTexCoord.y = 1.0 - v2fTexCoord.y;
+	v2fTexCoord *= TexCoordScale;
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ layout(std140, binding = 14) uniform TransformMatrices
 {
 	mat4 ModelMatrix;
 	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
 };
 
 layout(std140, binding = 22) uniform CameraMatrices
@@ -23,8 +25,10 @@ layout(std140, binding = 22) uniform CameraMatrices
 
 void main(void)
 {
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
 	v2fNormal = normalize(mat3(NormalMatrix) * inNormal);
-	v2fPosition = (ModelMatrix * vec4(inPosition, 1.0)).xyz;
+	v2fPosition = (ModelMatrix * vec4(position, 1.0)).xyz;
 
-	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(inPosition, 1.0);
+	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -9,6 +9,8 @@ layout(std140, binding = 14) uniform TransformMatrices
 {
 	mat4 ModelMatrix;
 	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
 };
 
 layout(std140, binding = 22) uniform CameraMatrices
@@ -20,5 +22,7 @@ layout(std140, binding = 22) uniform CameraMatrices
 
 void main(void)
 {
-	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(inPosition, 1.0);
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
+	gl_Position = (ProjectionMatrix * ViewMatrix * ModelMatrix) * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -11,6 +11,8 @@ layout(std140, binding = 14) uniform TransformMatrices
 {
 	mat4 ModelMatrix;
 	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
 };
 
 layout(std140, binding = 15) uniform LightSpaceTransformMatrix
@@ -21,6 +23,8 @@ layout(std140, binding = 15) uniform LightSpaceTransformMatrix
 
 void main(void)
 {
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
 	v2fTexCoord = inTexCoord;
-	gl_Position = LightSpaceMatrix * ModelMatrix * vec4(inPosition, 1.0);
+	gl_Position = LightSpaceMatrix * ModelMatrix * vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 430
+
+// Depth is written by fixed function, which keeps early depth test enabled
+
+
+void main(void)
+{
+
+}
\ No newline at end of file
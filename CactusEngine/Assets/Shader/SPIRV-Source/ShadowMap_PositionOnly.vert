@@ -0,0 +1,26 @@
+#version 430
+
+// Reads position stream only, for shadow casters that need no alpha cutout
+
+layout(location = 0) in vec3 inPosition;
+
+layout(std140, binding = 14) uniform TransformMatrices
+{
+	mat4 ModelMatrix;
+	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
+};
+
+layout(std140, binding = 15) uniform LightSpaceTransformMatrix
+{
+	mat4 LightSpaceMatrix;
+};
+
+
+void main(void)
+{
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
+	gl_Position = LightSpaceMatrix * ModelMatrix * vec4(position, 1.0);
+}
\ No newline at end of file
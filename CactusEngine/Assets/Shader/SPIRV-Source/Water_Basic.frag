@@ -65,8 +65,7 @@ const float DistortionDensity = 10.0f;
 void main(void)
 {
 	// Screen space sample coordinates
-	vec2 screenCoord = (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).xy / (ProjectionMatrix * ViewMatrix * vec4(v2fPosition, 1)).w * 0.5f + 0.5f;
-	screenCoord.y = -screenCoord.y;
+	vec2 screenCoord = gl_FragCoord.xy / textureSize(ColorTexture_1, 0); // Stays valid when only a sub-rect of the render target is rendered
 	// Simulate refraction
 	vec2 distortedCoord = screenCoord + DistortionAmount * vec2(sin(DistortionFreq * Time + DistortionDensity * v2fPosition.x), cos(DistortionFreq * Time + DistortionDensity * v2fPosition.z));
 
@@ -13,6 +13,8 @@ layout(std140, binding = 14) uniform TransformMatrices
 {
 	mat4 ModelMatrix;
 	mat4 NormalMatrix;
+	vec4 PositionScale; // Decodes quantized vertex positions, identity for float vertices
+	vec4 PositionOffset;
 };
 
 layout(std140, binding = 22) uniform CameraMatrices
@@ -41,6 +43,8 @@ const vec2  Direction = vec2(-0.7071068f, -0.7071068f);
 
 void main(void)
 {
+	vec3 position = inPosition * PositionScale.xyz + PositionOffset.xyz;
+
 	v2fTexCoord = inTexCoord + vec2(fract(-0.05f * Time));
 
 	vec2 noiseTexCoord = inTexCoord + vec2(fract(NoiseFrequency * Time)) * NoiseDirection;
@@ -52,11 +56,11 @@ void main(void)
 	float frequency = 2.0f / WaveLength;
 	float phi = Speed * frequency;
 	
-	float xWave = Steepness * Amplitude * Direction.x * cos(frequency * dot(Direction, inPosition.xy) + phi * noisedTime);
-	float yWave = Steepness * Amplitude * Direction.y * cos(frequency * dot(Direction, inPosition.xy) + phi * noisedTime);
-	float zWave = Amplitude * sin(frequency * dot(Direction, inPosition.xy) + phi * noisedTime);
+	float xWave = Steepness * Amplitude * Direction.x * cos(frequency * dot(Direction, position.xy) + phi * noisedTime);
+	float yWave = Steepness * Amplitude * Direction.y * cos(frequency * dot(Direction, position.xy) + phi * noisedTime);
+	float zWave = Amplitude * sin(frequency * dot(Direction, position.xy) + phi * noisedTime);
 
-	vec3 vPosition = vec3(xWave + inPosition.x, yWave + inPosition.y, zWave + inPosition.z);
+	vec3 vPosition = vec3(xWave + position.x, yWave + position.y, zWave + position.z);
 
 	// Normal
 	float xNormal = -(Direction.x * frequency * Amplitude * cos(frequency * dot(Direction, vPosition.xy) + phi * noisedTime));
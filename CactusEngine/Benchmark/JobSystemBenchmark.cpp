@@ -0,0 +1,275 @@
+// Standalone microbenchmark comparing JobSystem with the SafeQueue + condition variable pool it replaced in render graph
+// Not part of engine build, compile it on its own together with job system sources, e.g.
+//   g++ -std=c++17 -O2 -pthread -include cstddef -IUtilities -ICommon Benchmark/JobSystemBenchmark.cpp Utilities/JobSystem.cpp Utilities/LogUtility.cpp Common/MemoryAllocator.cpp -o JobSystemBenchmark
+//   cl /std:c++17 /O2 /EHsc /IUtilities /ICommon Benchmark\JobSystemBenchmark.cpp Utilities\JobSystem.cpp Utilities\LogUtility.cpp Common\MemoryAllocator.cpp
+#include "JobSystem.h"
+#include "SafeQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace Engine
+{
+	// Same scheme render graph used before job system: shared locked queue, workers woken by condition variable
+	class LegacyThreadPool
+	{
+	public:
+		LegacyThreadPool(uint32_t threadCount)
+			: m_isRunning(true)
+		{
+			for (uint32_t i = 0; i < threadCount; i++)
+			{
+				m_threads.emplace_back(&LegacyThreadPool::ThreadFunction, this);
+			}
+		}
+
+		~LegacyThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> guard(m_mutex);
+				m_isRunning = false;
+			}
+			m_cv.notify_all();
+
+			for (auto& thread : m_threads)
+			{
+				thread.join();
+			}
+		}
+
+		void Schedule(const JobFunction& function, std::atomic<uint32_t>* pCounter)
+		{
+			pCounter->fetch_add(1);
+			{
+				std::lock_guard<std::mutex> guard(m_mutex);
+				m_jobQueue.Push([function, pCounter]()
+					{
+						function();
+						pCounter->fetch_sub(1);
+					});
+			}
+			m_cv.notify_all();
+		}
+
+		// Waiting thread does not help, it yields until all jobs are done
+		void Wait(const std::atomic<uint32_t>* pCounter)
+		{
+			while (pCounter->load() > 0)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+	private:
+		void ThreadFunction()
+		{
+			JobFunction job;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_cv.wait(lock, [this]() { return !m_jobQueue.Empty() || !m_isRunning; });
+					if (!m_isRunning)
+					{
+						return;
+					}
+				}
+
+				while (m_jobQueue.TryPop(job))
+				{
+					job();
+					std::this_thread::yield();
+				}
+			}
+		}
+
+	private:
+		bool m_isRunning;
+		std::vector<std::thread> m_threads;
+		SafeQueue<JobFunction> m_jobQueue;
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+	};
+}
+
+using namespace Engine;
+
+static volatile float gSink = 0.0f;
+
+static void SimulateWork(uint32_t iterations)
+{
+	float value = 0.0f;
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		value += std::sqrt((float)i);
+	}
+	gSink = value;
+}
+
+template<typename Function>
+static double MeasureMedianMs(uint32_t repeatCount, Function function)
+{
+	std::vector<double> results;
+	for (uint32_t i = 0; i < repeatCount; i++)
+	{
+		auto begin = std::chrono::high_resolution_clock::now();
+		function();
+		auto end = std::chrono::high_resolution_clock::now();
+		results.emplace_back(std::chrono::duration<double, std::milli>(end - begin).count());
+	}
+	std::sort(results.begin(), results.end());
+	return results[results.size() / 2];
+}
+
+static void PrintResult(const char* name, double legacyMs, double jobSystemMs)
+{
+	if (legacyMs < 0)
+	{
+		printf("%-36s %14s %14.3f\n", name, "n/a", jobSystemMs);
+		return;
+	}
+	printf("%-36s %14.3f %14.3f %9.2fx\n", name, legacyMs, jobSystemMs, legacyMs / jobSystemMs);
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t workerCount = argc > 1 ? (uint32_t)std::atoi(argv[1]) : 0;
+	if (workerCount == 0)
+	{
+		workerCount = std::thread::hardware_concurrency() > 2 ? std::thread::hardware_concurrency() - 2 : 1;
+	}
+
+	const uint32_t REPEAT_COUNT = 7;
+
+	// Jobs are scheduled in rounds smaller than queue capacity, as jobs that do not fit into the queue are executed inline
+	const uint32_t ROUND_COUNT = 64;
+	const uint32_t JOBS_PER_ROUND = 2048;
+
+	const uint32_t PARALLEL_FOR_COUNT = 1 << 20;
+	const uint32_t PARALLEL_FOR_BATCH = 1024;
+
+	const uint32_t FRAME_COUNT = 1000;
+	const uint32_t JOBS_PER_FRAME = 8; // Roughly the number of render nodes
+	const uint32_t FRAME_JOB_WORK = 2000;
+
+	const uint32_t NESTED_PARENT_COUNT = 64;
+	const uint32_t NESTED_CHILD_COUNT = 64;
+
+	std::vector<float> data(PARALLEL_FOR_COUNT);
+	for (uint32_t i = 0; i < PARALLEL_FOR_COUNT; i++)
+	{
+		data[i] = (float)i;
+	}
+
+	printf("Hardware concurrency: %u, worker threads: %u, median of %u runs\n\n", std::thread::hardware_concurrency(), workerCount, REPEAT_COUNT);
+	printf("%-36s %14s %14s %10s\n", "Scenario", "Legacy (ms)", "JobSystem (ms)", "Speedup");
+
+	double legacyEmpty, legacyParallelFor, legacyFrames;
+	{
+		LegacyThreadPool pool(workerCount);
+		std::atomic<uint32_t> counter(0);
+
+		legacyEmpty = MeasureMedianMs(REPEAT_COUNT, [&]()
+			{
+				for (uint32_t round = 0; round < ROUND_COUNT; round++)
+				{
+					for (uint32_t i = 0; i < JOBS_PER_ROUND; i++)
+					{
+						pool.Schedule([]() {}, &counter);
+					}
+					pool.Wait(&counter);
+				}
+			});
+
+		legacyParallelFor = MeasureMedianMs(REPEAT_COUNT, [&]()
+			{
+				for (uint32_t begin = 0; begin < PARALLEL_FOR_COUNT; begin += PARALLEL_FOR_BATCH)
+				{
+					pool.Schedule([&data, begin, PARALLEL_FOR_BATCH]()
+						{
+							for (uint32_t i = begin; i < begin + PARALLEL_FOR_BATCH; i++)
+							{
+								data[i] = std::sqrt(data[i] * data[i] + 1.0f);
+							}
+						}, &counter);
+				}
+				pool.Wait(&counter);
+			});
+
+		legacyFrames = MeasureMedianMs(REPEAT_COUNT, [&]()
+			{
+				for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+				{
+					for (uint32_t i = 0; i < JOBS_PER_FRAME; i++)
+					{
+						pool.Schedule([FRAME_JOB_WORK]() { SimulateWork(FRAME_JOB_WORK); }, &counter);
+					}
+					pool.Wait(&counter);
+				}
+			});
+	}
+
+	JobSystem::Initialize(workerCount);
+
+	double jobSystemEmpty = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			JobCounter counter;
+			for (uint32_t round = 0; round < ROUND_COUNT; round++)
+			{
+				for (uint32_t i = 0; i < JOBS_PER_ROUND; i++)
+				{
+					JobSystem::Schedule([]() {}, &counter);
+				}
+				JobSystem::WaitForCounter(&counter);
+			}
+		});
+
+	double jobSystemParallelFor = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			JobSystem::ParallelFor(PARALLEL_FOR_COUNT, PARALLEL_FOR_BATCH, [&data](uint32_t i)
+				{
+					data[i] = std::sqrt(data[i] * data[i] + 1.0f);
+				});
+		});
+
+	double jobSystemFrames = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			for (uint32_t frame = 0; frame < FRAME_COUNT; frame++)
+			{
+				JobCounter counter;
+				for (uint32_t i = 0; i < JOBS_PER_FRAME; i++)
+				{
+					JobSystem::Schedule([FRAME_JOB_WORK]() { SimulateWork(FRAME_JOB_WORK); }, &counter);
+				}
+				JobSystem::WaitForCounter(&counter);
+			}
+		});
+
+	// Waiting inside a job would deadlock legacy pool once all its threads wait, so only job system is measured
+	double jobSystemNested = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			JobSystem::ParallelFor(NESTED_PARENT_COUNT, 1, [&](uint32_t)
+				{
+					JobSystem::ParallelFor(NESTED_CHILD_COUNT, 1, [](uint32_t) { SimulateWork(100); });
+				});
+		});
+
+	JobSystem::ShutDown();
+
+	char name[64];
+	snprintf(name, sizeof(name), "%u empty jobs", ROUND_COUNT * JOBS_PER_ROUND);
+	PrintResult(name, legacyEmpty, jobSystemEmpty);
+	snprintf(name, sizeof(name), "ParallelFor %u, batch %u", PARALLEL_FOR_COUNT, PARALLEL_FOR_BATCH);
+	PrintResult(name, legacyParallelFor, jobSystemParallelFor);
+	snprintf(name, sizeof(name), "%u frames of %u jobs", FRAME_COUNT, JOBS_PER_FRAME);
+	PrintResult(name, legacyFrames, jobSystemFrames);
+	snprintf(name, sizeof(name), "Nested ParallelFor %ux%u", NESTED_PARENT_COUNT, NESTED_CHILD_COUNT);
+	PrintResult(name, -1.0, jobSystemNested);
+
+	printf("\n(%f)\n", (float)gSink);
+	return 0;
+}
\ No newline at end of file
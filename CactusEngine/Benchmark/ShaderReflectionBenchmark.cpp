@@ -0,0 +1,227 @@
+// Standalone microbenchmark comparing shader reflection with SPIRV-Cross (cold start) against ShaderReflectionCache_VK (warm start)
+// Not part of engine build, compile it on its own together with reflection cache sources and link SPIRV-Cross core library, e.g.
+//   g++ -std=c++17 -O2 -include cstddef -IUtilities -ICommon -IGraphics/Device/Vulkan -IThird-party -IThird-party/Vulkan/include -IThird-party/SPIRV_Cross/include Benchmark/ShaderReflectionBenchmark.cpp Graphics/Device/Vulkan/ShaderReflectionCache_VK.cpp Utilities/FileUtility.cpp Utilities/LogUtility.cpp Common/MemoryAllocator.cpp -lspirv-cross-core -o ShaderReflectionBenchmark
+//   cl /std:c++17 /O2 /EHsc /IUtilities /ICommon /IGraphics\Device\Vulkan /IThird-party /IThird-party\Vulkan\include /IThird-party\SPIRV_Cross\include Benchmark\ShaderReflectionBenchmark.cpp Graphics\Device\Vulkan\ShaderReflectionCache_VK.cpp Utilities\FileUtility.cpp Utilities\LogUtility.cpp Common\MemoryAllocator.cpp Third-party\SPIRV_Cross\lib\Release\spirv-cross-core.lib
+// Run it from CactusEngine directory, or pass SPIR-V directory as first argument
+#include "ShaderReflectionCache_VK.h"
+#include "spirv_cross.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace Engine;
+
+struct ShaderBinary
+{
+	std::string name;
+	VkShaderStageFlagBits stage;
+	std::vector<char> rawCode;
+};
+
+static bool LoadShaderBinaries(const char* directoryPath, std::vector<ShaderBinary>& outShaders)
+{
+	std::error_code errorCode;
+	for (auto& entry : std::filesystem::directory_iterator(directoryPath, errorCode))
+	{
+		std::string fileName = entry.path().filename().string();
+		if (entry.path().extension() != ".spv")
+		{
+			continue;
+		}
+
+		ShaderBinary shader{};
+		shader.name = fileName;
+		if (fileName.find("_vert.spv") != std::string::npos)
+		{
+			shader.stage = VK_SHADER_STAGE_VERTEX_BIT;
+		}
+		else if (fileName.find("_frag.spv") != std::string::npos)
+		{
+			shader.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		}
+		else if (fileName.find("_comp.spv") != std::string::npos)
+		{
+			shader.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		else
+		{
+			continue;
+		}
+
+		std::ifstream file(entry.path(), std::ios::ate | std::ios::binary);
+		if (!file.is_open())
+		{
+			continue;
+		}
+		shader.rawCode.resize((size_t)file.tellg());
+		file.seekg(0);
+		file.read(shader.rawCode.data(), shader.rawCode.size());
+
+		outShaders.emplace_back(std::move(shader));
+	}
+
+	std::sort(outShaders.begin(), outShaders.end(), [](const ShaderBinary& lhs, const ShaderBinary& rhs) { return lhs.name < rhs.name; });
+	return !errorCode && !outShaders.empty();
+}
+
+static void RecordResources(const spirv_cross::Compiler& spvCompiler, const spirv_cross::SmallVector<spirv_cross::Resource>& resources, EShaderResourceType_VK type, bool useBlockName, ShaderReflection_VK& outReflection)
+{
+	for (auto& resource : resources)
+	{
+		ShaderReflectedResource_VK reflectedResource{};
+		reflectedResource.type = type;
+		reflectedResource.set = spvCompiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+		reflectedResource.binding = spvCompiler.get_decoration(resource.id, spv::DecorationBinding);
+		reflectedResource.descriptorCount = 1;
+		reflectedResource.name = useBlockName ? resource.name : spvCompiler.get_name(resource.id);
+
+		if (type == EShaderResourceType_VK::StorageImage)
+		{
+			auto& spvType = spvCompiler.get_type(resource.type_id);
+			reflectedResource.descriptorCount = spvType.array.empty() ? 1 : spvType.array[0];
+		}
+
+		outReflection.resources.emplace_back(reflectedResource);
+	}
+}
+
+// Same SPIRV-Cross queries as ShaderProgram_VK::ReflectWithCompiler
+static void ReflectWithCompiler(const ShaderBinary& shader, ShaderReflection_VK& outReflection)
+{
+	std::vector<uint32_t> rawCode(shader.rawCode.size() / sizeof(uint32_t));
+	memcpy(rawCode.data(), shader.rawCode.data(), rawCode.size() * sizeof(uint32_t));
+
+	spirv_cross::Compiler spvCompiler(std::move(rawCode));
+	spirv_cross::ShaderResources shaderRes = spvCompiler.get_shader_resources();
+
+	auto activeVars = spvCompiler.get_active_interface_variables();
+	spvCompiler.set_enabled_interface_variables(std::move(activeVars));
+
+	outReflection.stage = shader.stage;
+	outReflection.pushConstantSize = 0;
+	outReflection.resources.clear();
+
+	RecordResources(spvCompiler, shaderRes.uniform_buffers, EShaderResourceType_VK::Uniform, true, outReflection);
+	RecordResources(spvCompiler, shaderRes.separate_samplers, EShaderResourceType_VK::SeparateSampler, false, outReflection);
+	RecordResources(spvCompiler, shaderRes.separate_images, EShaderResourceType_VK::SeparateImage, false, outReflection);
+	RecordResources(spvCompiler, shaderRes.sampled_images, EShaderResourceType_VK::SampledImage, false, outReflection);
+	RecordResources(spvCompiler, shaderRes.storage_buffers, EShaderResourceType_VK::StorageBuffer, true, outReflection);
+	RecordResources(spvCompiler, shaderRes.storage_images, EShaderResourceType_VK::StorageImage, false, outReflection);
+
+	for (auto& pushConstant : shaderRes.push_constant_buffers)
+	{
+		auto& type = spvCompiler.get_type(pushConstant.base_type_id);
+		outReflection.pushConstantSize = std::max<uint32_t>(outReflection.pushConstantSize, (uint32_t)spvCompiler.get_declared_struct_size(type));
+	}
+}
+
+template<typename Function>
+static double MeasureMedianMs(uint32_t repeatCount, Function function)
+{
+	std::vector<double> results;
+	for (uint32_t i = 0; i < repeatCount; i++)
+	{
+		auto begin = std::chrono::high_resolution_clock::now();
+		function();
+		auto end = std::chrono::high_resolution_clock::now();
+		results.emplace_back(std::chrono::duration<double, std::milli>(end - begin).count());
+	}
+	std::sort(results.begin(), results.end());
+	return results[results.size() / 2];
+}
+
+static void PrintResult(const char* name, double timeMs, double baselineMs, size_t shaderCount)
+{
+	printf("%-40s %12.3f %14.2f %9.2fx\n", name, timeMs, timeMs * 1000.0 / shaderCount, baselineMs / timeMs);
+}
+
+int main(int argc, char** argv)
+{
+	const char* shaderDirectory = argc > 1 ? argv[1] : "Assets/Shader/SPIRV";
+	const char* cacheDirectory = "ShaderReflectionBenchmarkCache";
+	const uint32_t REPEAT_COUNT = 15;
+
+	std::vector<ShaderBinary> shaders;
+	if (!LoadShaderBinaries(shaderDirectory, shaders))
+	{
+		printf("No SPIR-V binaries found in %s\n", shaderDirectory);
+		return 1;
+	}
+
+	std::error_code errorCode;
+	std::filesystem::remove_all(cacheDirectory, errorCode);
+
+	// Populate cache the same way first run of the engine does, and keep compiler results to validate cached ones
+	std::vector<ShaderReflection_VK> reference(shaders.size());
+	{
+		ShaderReflectionCache_VK cache(cacheDirectory);
+		for (size_t i = 0; i < shaders.size(); i++)
+		{
+			ReflectWithCompiler(shaders[i], reference[i]);
+			cache.Store(ShaderReflectionCache_VK::HashCode(shaders[i].rawCode), shaders[i].rawCode.size(), reference[i]);
+		}
+	}
+
+	uint32_t mismatchCount = 0;
+
+	// Hashing is included in every scenario, as engine hashes code before looking it up
+	double coldMs = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			for (auto& shader : shaders)
+			{
+				ShaderReflection_VK reflection{};
+				volatile uint64_t hash = ShaderReflectionCache_VK::HashCode(shader.rawCode);
+				(void)hash;
+				ReflectWithCompiler(shader, reflection);
+			}
+		});
+
+	// New cache object per run, so every shader is read from disk like on application start up
+	double warmDiskMs = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			ShaderReflectionCache_VK cache(cacheDirectory);
+			for (size_t i = 0; i < shaders.size(); i++)
+			{
+				ShaderReflection_VK reflection{};
+				if (!cache.Load(ShaderReflectionCache_VK::HashCode(shaders[i].rawCode), shaders[i].rawCode.size(), shaders[i].stage, reflection)
+					|| reflection.pushConstantSize != reference[i].pushConstantSize || reflection.resources.size() != reference[i].resources.size())
+				{
+					mismatchCount++;
+				}
+			}
+		});
+
+	// Shaders shared by multiple programs are served from loaded entries
+	ShaderReflectionCache_VK sharedCache(cacheDirectory);
+	double warmMemoryMs = MeasureMedianMs(REPEAT_COUNT, [&]()
+		{
+			for (auto& shader : shaders)
+			{
+				ShaderReflection_VK reflection{};
+				if (!sharedCache.Load(ShaderReflectionCache_VK::HashCode(shader.rawCode), shader.rawCode.size(), shader.stage, reflection))
+				{
+					mismatchCount++;
+				}
+			}
+		});
+
+	std::filesystem::remove_all(cacheDirectory, errorCode);
+
+	printf("%zu shaders from %s, median of %u runs\n\n", shaders.size(), shaderDirectory, REPEAT_COUNT);
+	printf("%-40s %12s %14s %10s\n", "Scenario", "Total (ms)", "Per shader (us)", "Speedup");
+	PrintResult("Cold: SPIRV-Cross reflection", coldMs, coldMs, shaders.size());
+	PrintResult("Warm: cache read from disk", warmDiskMs, coldMs, shaders.size());
+	PrintResult("Warm: cache entries already loaded", warmMemoryMs, coldMs, shaders.size());
+
+	if (mismatchCount > 0)
+	{
+		printf("\n%u cached reflections did not match SPIRV-Cross results\n", mismatchCount);
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "GraphicsApplication.h"
 #include "ECSWorld.h"
 #include "Timer.h"
+#include "JobSystem.h"
 #include "MemoryAllocator.h"
 #if defined(GLFW_IMPLEMENTATION_CE)
 #include "GLFWWindow.h"
@@ -24,6 +25,8 @@ namespace Engine
 
 	void GraphicsApplication::Initialize()
 	{
+		JobSystem::Initialize();
+
 		CE_NEW(m_pECSWorld, ECSWorld);
 
 		InitSystems();
@@ -58,6 +61,8 @@ namespace Engine
 	{
 		m_pECSWorld->ShutDown();
 		m_pWindow->ShutDown();
+
+		JobSystem::ShutDown();
 	}
 
 	bool GraphicsApplication::ShouldQuit() const
@@ -85,7 +85,19 @@ namespace Engine
 			m_prebuildShadersAndPipelines(true),
 			m_samplerAnisotropyLevel(ESamplerAnisotropyLevel::None),
 			m_activeRenderer(ERendererType::Standard),
-			m_renderScale(1.0f)
+			m_renderScale(1.0f),
+			m_enableDynamicResolution(false),
+			m_targetFrameTime(16.6f),
+			m_minDynamicResolutionScale(0.5f),
+			m_enableBindlessTextures(false),
+			m_enableTransientResourceAliasing(true),
+			m_enableAsyncCompute(true),
+			m_enableVertexQuantization(false),
+			m_enableMeshletCulling(true),
+			m_enablePositionStream(false),
+			m_enableMemoryDefragmentation(true),
+			m_memoryBudgetWarningRatio(0.9f),
+			m_enableGPUProfiling(false)
 		{
 
 		}
@@ -191,6 +203,126 @@ namespace Engine
 			return m_renderScale;
 		}
 
+		void SetDynamicResolution(bool val)
+		{
+			m_enableDynamicResolution = val;
+		}
+
+		bool GetDynamicResolution() const
+		{
+			return m_enableDynamicResolution;
+		}
+
+		void SetTargetFrameTime(float milliseconds)
+		{
+			m_targetFrameTime = std::max<float>(milliseconds, 1.0f);
+		}
+
+		float GetTargetFrameTime() const
+		{
+			return m_targetFrameTime;
+		}
+
+		void SetMinDynamicResolutionScale(float scale)
+		{
+			m_minDynamicResolutionScale = std::clamp<float>(scale, 0.25f, 1.0f);
+		}
+
+		float GetMinDynamicResolutionScale() const
+		{
+			return m_minDynamicResolutionScale;
+		}
+
+		void SetBindlessTextures(bool val)
+		{
+			m_enableBindlessTextures = val;
+		}
+
+		bool GetBindlessTextures() const
+		{
+			return m_enableBindlessTextures;
+		}
+
+		void SetTransientResourceAliasing(bool val)
+		{
+			m_enableTransientResourceAliasing = val;
+		}
+
+		bool GetTransientResourceAliasing() const
+		{
+			return m_enableTransientResourceAliasing;
+		}
+
+		void SetAsyncCompute(bool val)
+		{
+			m_enableAsyncCompute = val;
+		}
+
+		bool GetAsyncCompute() const
+		{
+			return m_enableAsyncCompute;
+		}
+
+		void SetVertexQuantization(bool val)
+		{
+			m_enableVertexQuantization = val;
+		}
+
+		bool GetVertexQuantization() const
+		{
+			return m_enableVertexQuantization;
+		}
+
+		void SetMeshletCulling(bool val)
+		{
+			m_enableMeshletCulling = val;
+		}
+
+		bool GetMeshletCulling() const
+		{
+			return m_enableMeshletCulling;
+		}
+
+		void SetPositionStream(bool val)
+		{
+			m_enablePositionStream = val;
+		}
+
+		bool GetPositionStream() const
+		{
+			return m_enablePositionStream;
+		}
+
+		void SetMemoryDefragmentation(bool val)
+		{
+			m_enableMemoryDefragmentation = val;
+		}
+
+		bool GetMemoryDefragmentation() const
+		{
+			return m_enableMemoryDefragmentation;
+		}
+
+		void SetMemoryBudgetWarningRatio(float val)
+		{
+			m_memoryBudgetWarningRatio = val;
+		}
+
+		float GetMemoryBudgetWarningRatio() const
+		{
+			return m_memoryBudgetWarningRatio;
+		}
+
+		void SetGPUProfiling(bool val)
+		{
+			m_enableGPUProfiling = val;
+		}
+
+		bool GetGPUProfiling() const
+		{
+			return m_enableGPUProfiling;
+		}
+
 	private:
 		// Graphics API to use
 		EGraphicsAPIType m_graphicsAPIType;
@@ -224,5 +356,56 @@ namespace Engine
 		// Internal render resolution multiplier
 		// Allowed range: 0.5 - 2.0
 		float m_renderScale;
+
+		// If true, only a portion of render targets is rendered each frame, its size is adjusted to keep frame time within target
+		// Render targets are still allocated with full render scale, final image is upscaled when written to swapchain
+		bool m_enableDynamicResolution;
+
+		// Frame time budget in milliseconds that dynamic resolution tries to meet
+		float m_targetFrameTime;
+
+		// Lower bound of dynamic resolution, relative to render scale on each axis
+		// Allowed range: 0.25 - 1.0
+		float m_minDynamicResolutionScale;
+
+		// If true, material textures are registered once into a global descriptor array and referenced by index (Vulkan only)
+		// Falls back to per draw texture bindings if descriptor indexing is not supported by device
+		// Right now this can only be set before render system initializes
+		bool m_enableBindlessTextures;
+
+		// If true, render graph intermediate textures whose lifetimes do not overlap within a frame share device memory
+		// Disabling it gives every intermediate texture its own memory, which can help when debugging render graph issues
+		// Right now this can only be set before render system initializes
+		bool m_enableTransientResourceAliasing;
+
+		// If true, render graph compute nodes are submitted to a dedicated compute queue and overlap with graphics work (Vulkan only)
+		// Falls back to graphics queue if device does not expose a compute-only queue family
+		// Right now this can only be set before render system initializes
+		bool m_enableAsyncCompute;
+
+		// If true, mesh vertices are stored in a compact 20 byte layout instead of 44 bytes of 32-bit floats
+		// Positions are quantized relative to mesh bounds and decoded in vertex shaders, falls back to full precision if device lacks vertex format support
+		// Right now this can only be set before render system initializes
+		bool m_enableVertexQuantization;
+
+		// If true, meshes clustered at cook time only draw meshlets that are inside view frustum and not entirely back facing
+		bool m_enableMeshletCulling;
+
+		// If true, meshes also carry a position-only vertex stream, which shadow passes read instead of full interleaved vertices
+		// Costs an extra 8 or 12 bytes of device memory per vertex
+		// Right now this can only be set before render system initializes
+		bool m_enablePositionStream;
+
+		// If true, mesh buffers are periodically moved in small batches to compact device memory left fragmented by freed resources
+		// Right now this can only be set before render system initializes
+		bool m_enableMemoryDefragmentation;
+
+		// A warning is logged when usage of a memory heap exceeds this fraction of its budget
+		// Allowed range: 0.5 - 1.0
+		float m_memoryBudgetWarningRatio;
+
+		// If true, GPU execution time of each render node is measured with timestamp queries, see GPUProfiler
+		// Right now this can only be set before render system initializes
+		bool m_enableGPUProfiling;
 	};
 }
\ No newline at end of file
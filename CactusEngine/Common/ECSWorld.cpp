@@ -70,7 +70,12 @@ namespace Engine
 
 	void ECSWorld::RemoveEntity(uint32_t entityID)
 	{
-		m_entityList.erase(entityID);
+		auto itr = m_entityList.find(entityID);
+		if (itr != m_entityList.end())
+		{
+			CE_DELETE(itr->second);
+			m_entityList.erase(itr);
+		}
 	}
 
 	void ECSWorld::RemoveSystem(ESystemType type)
@@ -126,6 +131,11 @@ namespace Engine
 
 	void ECSWorld::ClearEntities()
 	{
+		// Alert: this assumes no system is processing entities, e.g. called after systems have finished current frame
+		for (auto& entity : m_entityList)
+		{
+			CE_DELETE(entity.second);
+		}
 		m_entityList.clear();
 	}
 
@@ -102,6 +102,11 @@ void ConfigSetup()
 	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetActiveRenderer(ERendererType::Advanced);
 	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetTextureAnisotropyLevel(ESamplerAnisotropyLevel::AFx4);
 	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetRenderScale(1.0f);
+	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetDynamicResolution(false);
+	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetTargetFrameTime(16.6f);
+	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetMinDynamicResolutionScale(0.5f);
+	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetBindlessTextures(false);
+	gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->SetAsyncCompute(true);
 }
 
 void TestAddLights(ECSWorld* pWorld)
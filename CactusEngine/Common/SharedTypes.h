@@ -117,11 +117,23 @@ namespace Engine
 		D16,
 		D24,
 		D32,
+
+		// Block compressed, 4x4 texels per block, only for sampled textures
+		BC1_RGB_UNORM,
+		BC1_RGB_SRGB,
+		BC4_UNORM,
+		BC5_UNORM,
+		BC7_UNORM,
+		BC7_SRGB,
+
 		UNDEFINED,
 
 		// For attribute input
 		RGB32F,
 		RG32F,
+		RGBA16_UNORM,
+		RGB10A2_SNORM,
+		RG16F,
 
 		COUNT
 	};
@@ -131,6 +143,11 @@ namespace Engine
 		return format == ETextureFormat::D16 || format == ETextureFormat::D24 || format == ETextureFormat::D32;
 	}
 
+	inline bool IsBlockCompressedFormat(ETextureFormat format)
+	{
+		return format >= ETextureFormat::BC1_RGB_UNORM && format <= ETextureFormat::BC7_SRGB;
+	}
+
 	enum class EDataType
 	{
 		Float32 = 0,
@@ -203,6 +220,49 @@ namespace Engine
 		COUNT
 	};
 
+	enum class ETextureAccessType
+	{
+		// How a texture is accessed by a render pass, used to derive layout transitions and barriers
+		Undefined = 0, // Not accessed, content can be discarded
+		FragmentShaderRead,
+		TransferRead,
+		TransferWrite,
+		ColorAttachmentWrite,
+		DepthStencilAttachmentWrite,
+		ComputeShaderRead,
+		ComputeShaderWrite, // Storage image access, both reads and writes are covered
+		COUNT
+	};
+
+	inline EImageLayout GetTextureAccessLayout(ETextureAccessType access)
+	{
+		switch (access)
+		{
+		case ETextureAccessType::FragmentShaderRead:
+			return EImageLayout::ShaderReadOnly;
+		case ETextureAccessType::TransferRead:
+			return EImageLayout::TransferSrc;
+		case ETextureAccessType::TransferWrite:
+			return EImageLayout::TransferDst;
+		case ETextureAccessType::ColorAttachmentWrite:
+			return EImageLayout::ColorAttachment;
+		case ETextureAccessType::DepthStencilAttachmentWrite:
+			return EImageLayout::DepthStencilAttachment;
+		case ETextureAccessType::ComputeShaderRead:
+			return EImageLayout::ShaderReadOnly;
+		case ETextureAccessType::ComputeShaderWrite:
+			return EImageLayout::General;
+		default:
+			return EImageLayout::Undefined;
+		}
+	}
+
+	inline bool IsTextureWriteAccess(ETextureAccessType access)
+	{
+		return access == ETextureAccessType::TransferWrite || access == ETextureAccessType::ColorAttachmentWrite || access == ETextureAccessType::DepthStencilAttachmentWrite
+			|| access == ETextureAccessType::ComputeShaderWrite;
+	}
+
 	enum class EAttachmentType
 	{
 		Undefined = 0,
@@ -316,7 +376,8 @@ namespace Engine
 	{
 		TransferSrc = 0x1,
 		TransferDst = 0x2,
-		COUNT = 2
+		Storage = 0x4, // Can be bound as storage buffer in shaders
+		COUNT = 3
 	};
 
 	enum class EMemoryType
@@ -328,12 +389,25 @@ namespace Engine
 		COUNT
 	};
 
+	enum class EMemoryCategory
+	{
+		Mesh = 0,
+		Texture,
+		RenderTarget,
+		Uniform,
+		Staging,
+		Other,
+		COUNT
+	};
+
 	enum class ESemaphoreWaitStage
 	{
 		TopOfPipeline = 0,
 		ColorAttachmentOutput,
 		Transfer,
+		ComputeShader,
 		BottomOfPipeline,
+		AllCommands,
 		COUNT
 	};
 }
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include "MaterialComponent.h"
+#include "GraphicsApplication.h"
+#include "GraphicsDevice.h"
+#include "MemoryAllocator.h"
 
 namespace Engine
 {
@@ -7,10 +10,26 @@ namespace Engine
 		m_transparentPass(false),
 		m_albedoColor(Color4(1, 1, 1, 1)),
 		m_anisotropy(0.0f),
-		m_roughness(0.75f)
+		m_roughness(0.75f),
+		m_bindlessIndex(BINDLESS_INVALID_INDEX),
+		m_bindlessRecordDirty(true)
 	{
 	}
 
+	Material::~Material()
+	{
+		if (m_bindlessIndex == BINDLESS_INVALID_INDEX)
+		{
+			return;
+		}
+
+		auto pDevice = ((GraphicsApplication*)gpGlobal->GetCurrentApplication())->GetGraphicsDevice();
+		if (pDevice && pDevice->IsBindlessTexturingEnabled())
+		{
+			pDevice->UnregisterBindlessMaterial(m_bindlessIndex);
+		}
+	}
+
 	EBuiltInShaderProgramType Material::GetShaderProgramType() const
 	{
 		return m_useShaderType;
@@ -24,6 +43,7 @@ namespace Engine
 	void Material::SetTexture(EMaterialTextureType type, Texture2D* pTexture)
 	{
 		m_Textures[type] = pTexture;
+		m_bindlessRecordDirty = true;
 	}
 
 	Texture2D* Material::GetTexture(EMaterialTextureType type) const
@@ -43,6 +63,7 @@ namespace Engine
 	void Material::SetAlbedoColor(Color4 albedo)
 	{
 		m_albedoColor = albedo;
+		m_bindlessRecordDirty = true;
 	}
 
 	Color4 Material::GetAlbedoColor() const
@@ -53,6 +74,7 @@ namespace Engine
 	void Material::SetAnisotropy(float val)
 	{
 		m_anisotropy = val;
+		m_bindlessRecordDirty = true;
 	}
 
 	float Material::GetAnisotropy() const
@@ -63,6 +85,7 @@ namespace Engine
 	void Material::SetRoughness(float val)
 	{
 		m_roughness = val;
+		m_bindlessRecordDirty = true;
 	}
 
 	float Material::GetRoughness() const
@@ -80,6 +103,26 @@ namespace Engine
 		return m_transparentPass;
 	}
 
+	void Material::SetBindlessIndex(uint32_t index)
+	{
+		m_bindlessIndex = index;
+	}
+
+	uint32_t Material::GetBindlessIndex() const
+	{
+		return m_bindlessIndex;
+	}
+
+	bool Material::IsBindlessRecordDirty() const
+	{
+		return m_bindlessRecordDirty;
+	}
+
+	void Material::ClearBindlessRecordDirty()
+	{
+		m_bindlessRecordDirty = false;
+	}
+
 	MaterialComponent::MaterialComponent()
 		: BaseComponent(EComponentType::Material),
 		m_hasTransparency(false),
@@ -87,6 +130,15 @@ namespace Engine
 	{
 	}
 
+	MaterialComponent::~MaterialComponent()
+	{
+		for (auto& pMaterial : m_materialList)
+		{
+			CE_SAFE_DELETE(pMaterial);
+		}
+		m_materialList.clear();
+	}
+
 	void MaterialComponent::AddMaterial(uint32_t submeshIndex, Material* pMaterialComp)
 	{
 		if (submeshIndex >= m_materialList.size())
@@ -11,7 +11,7 @@ namespace Engine
 	{
 	public:
 		Material();
-		~Material() = default;
+		~Material(); // Releases its slot in device bindless material table
 
 		EBuiltInShaderProgramType GetShaderProgramType() const;
 		void SetShaderProgram(EBuiltInShaderProgramType shaderProgramType);
@@ -31,6 +31,12 @@ namespace Engine
 		void SetTransparent(bool val);
 		bool IsTransparent() const;
 
+		// Index into device bindless material table, only valid when bindless texturing is enabled
+		void SetBindlessIndex(uint32_t index);
+		uint32_t GetBindlessIndex() const;
+		bool IsBindlessRecordDirty() const;
+		void ClearBindlessRecordDirty();
+
 	private:
 		EBuiltInShaderProgramType m_useShaderType;
 		bool m_transparentPass;
@@ -41,13 +47,16 @@ namespace Engine
 
 		float m_anisotropy;
 		float m_roughness;
+
+		uint32_t m_bindlessIndex;
+		bool m_bindlessRecordDirty; // Set whenever a property mirrored in bindless material record changes
 	};
 
 	class MaterialComponent : public BaseComponent
 	{
 	public:
 		MaterialComponent();
-		~MaterialComponent() = default;
+		~MaterialComponent(); // Materials added to the component are owned by it
 
 		void AddMaterial(uint32_t submeshIndex, Material* pMaterialComp);
 		const std::vector<Material*>& GetMaterialList() const;
@@ -1,5 +1,6 @@
 #include "BaseEntity.h"
 #include "BaseComponent.h"
+#include "MemoryAllocator.h"
 
 namespace Engine
 {
@@ -10,6 +11,15 @@ namespace Engine
 	{
 	}
 
+	BaseEntity::~BaseEntity()
+	{
+		for (auto& component : m_componentList)
+		{
+			CE_DELETE(component.second);
+		}
+		m_componentList.clear();
+	}
+
 	uint32_t BaseEntity::GetEntityID() const
 	{
 		return m_entityID;
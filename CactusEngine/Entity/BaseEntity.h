@@ -14,7 +14,7 @@ namespace Engine
 	{
 	public:
 		BaseEntity();
-		virtual ~BaseEntity() = default;
+		virtual ~BaseEntity(); // Attached components are owned by the entity
 
 		void SetEntityID(uint32_t id);
 		uint32_t GetEntityID() const;
@@ -3,6 +3,7 @@
 namespace Engine
 {
 	GraphicsDevice::GraphicsDevice()
+		: m_pPlaceholderTexture(nullptr)
 	{
 
 	}
@@ -23,6 +24,8 @@ namespace Engine
 		{
 			CE_DELETE(pSampler.second);
 		}
+
+		CE_SAFE_DELETE(m_pPlaceholderTexture);
 	}
 
 	TextureSampler* GraphicsDevice::GetTextureSampler(ESamplerAnisotropyLevel level)
@@ -54,6 +57,29 @@ namespace Engine
 		return pSampler;
 	}
 
+	Texture2D* GraphicsDevice::GetPlaceholderTexture() const
+	{
+		DEBUG_ASSERT_CE(m_pPlaceholderTexture != nullptr);
+		return m_pPlaceholderTexture;
+	}
+
+	void GraphicsDevice::CreatePlaceholderTexture()
+	{
+		uint8_t whitePixel[4] = { 255, 255, 255, 255 };
+
+		Texture2DCreateInfo createInfo{};
+		createInfo.textureWidth = 1;
+		createInfo.textureHeight = 1;
+		createInfo.pTextureData = whitePixel;
+		createInfo.format = ETextureFormat::RGBA8_SRGB;
+		createInfo.textureType = ETextureType::SampledImage;
+		createInfo.generateMipmap = false;
+		createInfo.initialLayout = EImageLayout::ShaderReadOnly;
+		createInfo.pSampler = m_DefaultSamplers.at(ESamplerAnisotropyLevel::None);
+
+		CreateTexture2D(createInfo, m_pPlaceholderTexture);
+	}
+
 	void GraphicsDevice::CreateDefaultSamplers()
 	{
 		TextureSamplerCreateInfo createInfo{};
@@ -4,6 +4,7 @@
 #include "NoCopy.h"
 #include "GraphicsResources.h"
 #include "CommandResources.h"
+#include "BuiltInShaderType.h"
 #include "BaseWindow.h"
 
 namespace Engine
@@ -23,6 +24,7 @@ namespace Engine
 		// Generic graphics resource management
 
 		virtual ShaderProgram* CreateShaderProgramFromFile(const char* vertexShaderFilePath, const char* fragmentShaderFilePath) = 0;
+		virtual ShaderProgram* CreateComputeShaderProgramFromFile(const char* computeShaderFilePath) = 0;
 
 		virtual bool CreateVertexBuffer(const VertexBufferCreateInfo& createInfo, VertexBuffer*& pOutput) = 0;
 		virtual bool CreateTexture2D(const Texture2DCreateInfo& createInfo, Texture2D*& pOutput) = 0;
@@ -42,6 +44,7 @@ namespace Engine
 		virtual bool CreatePipelineMultisampleState(const PipelineMultisampleStateCreateInfo& createInfo, PipelineMultisampleState*& pOutput) = 0;
 		virtual bool CreatePipelineViewportState(const PipelineViewportStateCreateInfo& createInfo, PipelineViewportState*& pOutput) = 0;
 		virtual bool CreateGraphicsPipelineObject(const GraphicsPipelineCreateInfo& createInfo, GraphicsPipelineObject*& pOutput) = 0;
+		virtual bool CreateComputePipelineObject(const ComputePipelineCreateInfo& createInfo, ComputePipelineObject*& pOutput) = 0;
 
 		virtual void TransitionImageLayout(Texture2D* pImage, EImageLayout newLayout, uint32_t appliedStages) = 0;
 		virtual void TransitionImageLayout(GraphicsCommandBuffer* pCommandBuffer, Texture2D* pImage, EImageLayout newLayout, uint32_t appliedStages) = 0;
@@ -56,6 +59,7 @@ namespace Engine
 		virtual GraphicsSemaphore* RequestGraphicsSemaphore(ESemaphoreWaitStage waitStage) = 0;
 
 		virtual void BindGraphicsPipeline(const GraphicsPipelineObject* pPipeline, GraphicsCommandBuffer* pCommandBuffer) = 0;
+		virtual void BindComputePipeline(const ComputePipelineObject* pPipeline, GraphicsCommandBuffer* pCommandBuffer) = 0;
 		virtual void BeginRenderPass(const RenderPassObject* pRenderPass, const FrameBuffer* pFrameBuffer, GraphicsCommandBuffer* pCommandBuffer) = 0;
 		virtual void EndRenderPass(GraphicsCommandBuffer* pCommandBuffer) = 0;
 		virtual void EndCommandBuffer(GraphicsCommandBuffer* pCommandBuffer) = 0;
@@ -66,14 +70,62 @@ namespace Engine
 		virtual void SetVertexBuffer(const VertexBuffer* pVertexBuffer, GraphicsCommandBuffer* pCommandBuffer = nullptr) = 0;
 
 		virtual void DrawPrimitive(uint32_t indicesCount, uint32_t baseIndex, uint32_t baseVertex, GraphicsCommandBuffer* pCommandBuffer = nullptr) = 0;
-		virtual void DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer = nullptr) = 0;
+		virtual void DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer = nullptr, const Vector2& texCoordScale = Vector2(1.0f)) = 0; // Texture coordinates span [0, texCoordScale]
+		virtual void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ, GraphicsCommandBuffer* pCommandBuffer) = 0;
 
 		virtual void FlushCommands(bool waitExecution, bool flushImplicitCommands) = 0;
 		virtual void FlushTransferCommands(bool waitExecution) = 0;
+		virtual void FlushComputeCommands(bool waitExecution) = 0; // Same as flushing explicit graphics commands if async compute is not available
 		virtual void WaitSemaphore(GraphicsSemaphore* pSemaphore) = 0;
 		virtual void WaitIdle() = 0;
 
+		virtual void TextureBarriers(const std::vector<TextureBarrierDescription>& barriers, GraphicsCommandBuffer* pCommandBuffer) = 0; // Tracked texture layouts are not modified
+
 		virtual TextureSampler* GetTextureSampler(ESamplerAnisotropyLevel level);
+		Texture2D* GetPlaceholderTexture() const; // 1x1 white texture, sampled in place of textures that are still being loaded
+
+		// Async compute
+
+		virtual bool IsAsyncComputeEnabled() const = 0; // Compute queue type commands are executed on a dedicated queue
+
+		// Texture compression
+
+		virtual bool IsBlockCompressionSupported() const = 0; // BC formats can be used for sampled textures
+
+		// Vertex quantization
+
+		virtual bool IsVertexQuantizationEnabled() const = 0; // Meshes are created with quantized vertex layout, see VertexBufferCreateInfo
+
+		// Asynchronous upload
+
+		virtual bool IsAsyncUploadEnabled() const = 0; // Vertex buffers and textures with data can be created from worker threads
+		virtual bool IsUploadComplete(uint64_t uploadValue) const = 0; // Upload value is obtained from RawResource::GetUploadValue
+
+		// Transient resource aliasing
+
+		virtual void GetTexture2DMemoryRequirements(const Texture2DCreateInfo& createInfo, DeviceMemoryRequirements& outRequirements) = 0;
+		virtual bool CreateTransientMemoryBlock(const DeviceMemoryRequirements& requirements, TransientMemoryBlock*& pOutput) = 0;
+
+		// Device memory statistics
+
+		virtual void GetMemoryStatistics(DeviceMemoryStatistics& outStatistics) const = 0; // Per heap usage and budget, and totals per resource category
+
+		// GPU timestamp queries
+
+		virtual bool IsTimestampQuerySupported() const = 0; // False if any queue render nodes use lacks timestamp support
+		virtual bool CreateTimestampQueryPool(uint32_t queryCount, TimestampQueryPool*& pOutput) = 0;
+		virtual void ResetTimestampQueries(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, GraphicsCommandBuffer* pCommandBuffer) = 0; // Must be recorded outside of render pass, before queries are written
+		virtual void WriteTimestamp(TimestampQueryPool* pQueryPool, uint32_t queryIndex, bool afterPreviousCommands, GraphicsCommandBuffer* pCommandBuffer) = 0; // Otherwise written as soon as the command is reached
+		virtual void GetTimestampResults(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& outTimestamps) = 0; // In nanoseconds, does not wait for results
+
+		// Bindless resource management
+
+		virtual bool IsBindlessTexturingEnabled() const = 0;
+		virtual uint32_t RegisterBindlessTexture(Texture2D* pTexture, const TextureSampler* pSampler = nullptr) = 0; // Uses texture's own sampler if none is specified
+		virtual uint32_t RegisterBindlessMaterial(const BindlessMaterialRecord& record) = 0; // Returns a shared default material if the table is full
+		virtual void UnregisterBindlessMaterial(uint32_t materialIndex) = 0;
+		virtual void UpdateBindlessMaterial(uint32_t materialIndex, const BindlessMaterialRecord& record) = 0;
+		virtual void SetBindlessMaterialIndex(uint32_t materialIndex, GraphicsCommandBuffer* pCommandBuffer) = 0;
 
 		// Swapchain management
 
@@ -93,6 +145,8 @@ namespace Engine
 	protected:
 		GraphicsDevice();
 
+		void CreatePlaceholderTexture(); // Should be called by implementation once it is able to create textures
+
 	private:
 		void CreateDefaultSamplers();
 
@@ -103,8 +157,16 @@ namespace Engine
 		static const uint32_t ATTRIB_TEXCOORD_LOCATION = 2;
 		static const uint32_t ATTRIB_TANGENT_LOCATION = 3;
 
+		// Vertex buffer bindings, position stream is bound alongside interleaved vertices when the mesh has one
+		static const uint32_t VERTEX_BINDING = 0;
+		static const uint32_t POSITION_STREAM_BINDING = 1;
+
+		// Reported for timestamp queries whose results are not yet available
+		static const uint64_t TIMESTAMP_UNAVAILABLE = UINT64_MAX;
+
 	protected:
 		std::unordered_map<ESamplerAnisotropyLevel, TextureSampler*> m_DefaultSamplers;
+		Texture2D* m_pPlaceholderTexture;
 	};
 
 	template<EGraphicsAPIType>
@@ -0,0 +1,359 @@
+#include "BindlessResourceTable_VK.h"
+#include "GraphicsHardwareInterface_VK.h"
+#include "Buffers_VK.h"
+#include "LogUtility.h"
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+
+namespace Engine
+{
+	BindlessResourceTable_VK::BindlessResourceTable_VK(LogicalDevice_VK* pDevice, uint32_t maxTextureCount, uint32_t maxMaterialCount, uint32_t maxFramesInFlight)
+		: m_pDevice(pDevice),
+		m_maxFramesInFlight(maxFramesInFlight),
+		MAX_TEXTURE_COUNT(maxTextureCount),
+		MAX_MATERIAL_COUNT(maxMaterialCount),
+		m_descriptorSetLayout(VK_NULL_HANDLE),
+		m_descriptorPool(VK_NULL_HANDLE),
+		m_frameIndex(0),
+		m_pMaterialBuffer(nullptr),
+		m_pMappedMaterialData(nullptr),
+		m_materialCopySize(0),
+		m_textureCount(0),
+		m_materialCount(0),
+		m_fallbackTextureIndex(BINDLESS_INVALID_INDEX),
+		m_frameCount(0)
+	{
+		m_materialRecords.resize(MAX_MATERIAL_COUNT);
+		m_pendingMaterialUpdates.resize(m_maxFramesInFlight);
+
+		CreateDescriptorSetLayout();
+		CreateDescriptorSet();
+		CreateMaterialBuffer();
+
+		// Same values as a newly created material, without textures
+		BindlessMaterialRecord defaultRecord{};
+		defaultRecord.albedoColor = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+		defaultRecord.anisotropy = 0.0f;
+		defaultRecord.roughness = 0.75f;
+		defaultRecord.albedoTextureIndex = BINDLESS_INVALID_INDEX;
+		defaultRecord.toneTextureIndex = BINDLESS_INVALID_INDEX;
+
+		uint32_t defaultIndex = RegisterMaterial(defaultRecord);
+		DEBUG_ASSERT_CE(defaultIndex == DEFAULT_MATERIAL_INDEX);
+	}
+
+	BindlessResourceTable_VK::~BindlessResourceTable_VK()
+	{
+		if (m_pMappedMaterialData)
+		{
+			m_pDevice->pUploadAllocator->UnmapMemory(m_pMaterialBuffer->m_allocation);
+		}
+		CE_SAFE_DELETE(m_pMaterialBuffer);
+
+		// Sets allocated from the pool are freed along with it
+		vkDestroyDescriptorPool(m_pDevice->logicalDevice, m_descriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(m_pDevice->logicalDevice, m_descriptorSetLayout, nullptr);
+	}
+
+	uint32_t BindlessResourceTable_VK::RegisterTexture(uint64_t textureID, VkImageView imageView, VkImageLayout imageLayout, VkSampler sampler)
+	{
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		auto key = std::make_pair(textureID, sampler);
+		if (m_registeredTextures.find(key) != m_registeredTextures.end())
+		{
+			return m_registeredTextures.at(key);
+		}
+
+		uint32_t index = AllocateSlot(m_freeTextureSlots, m_textureCount, MAX_TEXTURE_COUNT);
+		if (index == BINDLESS_INVALID_INDEX)
+		{
+			LOG_WARNING("Vulkan: Bindless texture table is full, fallback texture is used instead.");
+			return m_fallbackTextureIndex;
+		}
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageView = imageView;
+		imageInfo.imageLayout = imageLayout;
+		imageInfo.sampler = sampler;
+
+		// Written once; the slot stays untouched for the rest of the texture's lifetime, and released slots are only reused
+		// after frames in flight have retired, so in-flight frames are not affected
+		std::vector<VkWriteDescriptorSet> writes(m_descriptorSets.size());
+		for (uint32_t i = 0; i < (uint32_t)writes.size(); i++)
+		{
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = m_descriptorSets[i];
+			writes[i].dstBinding = TEXTURE_ARRAY_BINDING;
+			writes[i].dstArrayElement = index;
+			writes[i].descriptorCount = 1;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+			writes[i].pImageInfo = &imageInfo;
+		}
+
+		vkUpdateDescriptorSets(m_pDevice->logicalDevice, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+
+		m_registeredTextures.emplace(key, index);
+		return index;
+	}
+
+	uint32_t BindlessResourceTable_VK::RegisterMaterial(const BindlessMaterialRecord& record)
+	{
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		uint32_t index = AllocateSlot(m_freeMaterialSlots, m_materialCount, MAX_MATERIAL_COUNT);
+		if (index == BINDLESS_INVALID_INDEX)
+		{
+			LOG_WARNING("Vulkan: Bindless material table is full, default material is used instead.");
+			return DEFAULT_MATERIAL_INDEX;
+		}
+
+		// New slot is not accessed by any frame in flight, all copies can be written right away
+		m_materialRecords[index] = record;
+		for (uint32_t i = 0; i < m_maxFramesInFlight; i++)
+		{
+			GetMappedMaterialData(i)[index] = record;
+		}
+
+		return index;
+	}
+
+	void BindlessResourceTable_VK::UnregisterTexture(uint64_t textureID)
+	{
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		auto itr = m_registeredTextures.lower_bound(std::make_pair(textureID, (VkSampler)VK_NULL_HANDLE));
+		while (itr != m_registeredTextures.end() && itr->first.first == textureID)
+		{
+			// Descriptor is left as is, the slot is not accessed again until it is reassigned
+			m_freeTextureSlots.emplace_back(itr->second, m_frameCount + m_maxFramesInFlight);
+			itr = m_registeredTextures.erase(itr);
+		}
+	}
+
+	void BindlessResourceTable_VK::SetFallbackTexture(uint32_t textureIndex)
+	{
+		m_fallbackTextureIndex = textureIndex;
+	}
+
+	void BindlessResourceTable_VK::UnregisterMaterial(uint32_t materialIndex)
+	{
+		if (materialIndex == DEFAULT_MATERIAL_INDEX || materialIndex == BINDLESS_INVALID_INDEX)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		DEBUG_ASSERT_CE(materialIndex < m_materialCount);
+		m_freeMaterialSlots.emplace_back(materialIndex, m_frameCount + m_maxFramesInFlight);
+	}
+
+	void BindlessResourceTable_VK::UpdateMaterial(uint32_t materialIndex, const BindlessMaterialRecord& record)
+	{
+		DEBUG_ASSERT_CE(materialIndex < m_materialCount);
+
+		// Default material is shared by all materials that fell back to it
+		if (materialIndex == DEFAULT_MATERIAL_INDEX)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		m_materialRecords[materialIndex] = record;
+
+		// Current frame has not been submitted yet, copies of other frames may still be read by GPU
+		uint32_t frameIndex = m_frameIndex.load();
+		GetMappedMaterialData(frameIndex)[materialIndex] = record;
+		for (uint32_t i = 0; i < m_maxFramesInFlight; i++)
+		{
+			if (i != frameIndex)
+			{
+				m_pendingMaterialUpdates[i].emplace_back(materialIndex);
+			}
+		}
+	}
+
+	void BindlessResourceTable_VK::BeginFrame(uint32_t frameIndex)
+	{
+		DEBUG_ASSERT_CE(frameIndex < m_maxFramesInFlight);
+
+		std::lock_guard<std::mutex> guard(m_registrationMutex);
+
+		m_frameCount++;
+
+		auto pMaterialData = GetMappedMaterialData(frameIndex);
+		for (auto materialIndex : m_pendingMaterialUpdates[frameIndex])
+		{
+			pMaterialData[materialIndex] = m_materialRecords[materialIndex];
+		}
+		m_pendingMaterialUpdates[frameIndex].clear();
+
+		m_frameIndex = frameIndex;
+	}
+
+	VkDescriptorSetLayout BindlessResourceTable_VK::GetDescriptorSetLayout() const
+	{
+		return m_descriptorSetLayout;
+	}
+
+	VkDescriptorSet BindlessResourceTable_VK::GetDescriptorSet() const
+	{
+		return m_descriptorSets[m_frameIndex.load()];
+	}
+
+	uint32_t BindlessResourceTable_VK::GetRegisteredTextureCount() const
+	{
+		return m_textureCount - (uint32_t)m_freeTextureSlots.size();
+	}
+
+	uint32_t BindlessResourceTable_VK::GetRegisteredMaterialCount() const
+	{
+		return m_materialCount - (uint32_t)m_freeMaterialSlots.size();
+	}
+
+	uint32_t BindlessResourceTable_VK::AllocateSlot(std::deque<std::pair<uint32_t, uint64_t>>& freeSlots, uint32_t& slotCount, uint32_t maxSlotCount)
+	{
+		// Slots are released in frame order, so only the front one needs to be checked
+		if (!freeSlots.empty() && freeSlots.front().second <= m_frameCount)
+		{
+			uint32_t slot = freeSlots.front().first;
+			freeSlots.pop_front();
+			return slot;
+		}
+
+		if (slotCount >= maxSlotCount)
+		{
+			return BINDLESS_INVALID_INDEX;
+		}
+		return slotCount++;
+	}
+
+	void BindlessResourceTable_VK::CreateDescriptorSetLayout()
+	{
+		std::vector<VkDescriptorSetLayoutBinding> bindings(2);
+
+		bindings[0].binding = TEXTURE_ARRAY_BINDING;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindings[0].descriptorCount = MAX_TEXTURE_COUNT;
+		bindings[0].stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+		bindings[0].pImmutableSamplers = nullptr;
+
+		bindings[1].binding = MATERIAL_BUFFER_BINDING;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].descriptorCount = 1;
+		bindings[1].stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+		bindings[1].pImmutableSamplers = nullptr;
+
+		// Unregistered slots are never accessed, and new slots can be written while the set is bound
+		std::vector<VkDescriptorBindingFlags> bindingFlags =
+		{
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+			0
+		};
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo{};
+		bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+		bindingFlagsCreateInfo.bindingCount = (uint32_t)bindingFlags.size();
+		bindingFlagsCreateInfo.pBindingFlags = bindingFlags.data();
+
+		VkDescriptorSetLayoutCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		createInfo.pNext = &bindingFlagsCreateInfo;
+		createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+		createInfo.bindingCount = (uint32_t)bindings.size();
+		createInfo.pBindings = bindings.data();
+
+		if (vkCreateDescriptorSetLayout(m_pDevice->logicalDevice, &createInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to create bindless descriptor set layout.");
+			return;
+		}
+	}
+
+	void BindlessResourceTable_VK::CreateDescriptorSet()
+	{
+		std::vector<VkDescriptorPoolSize> poolSizes =
+		{
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, MAX_TEXTURE_COUNT * m_maxFramesInFlight },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, m_maxFramesInFlight }
+		};
+
+		VkDescriptorPoolCreateInfo poolCreateInfo{};
+		poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+		poolCreateInfo.maxSets = m_maxFramesInFlight;
+		poolCreateInfo.poolSizeCount = (uint32_t)poolSizes.size();
+		poolCreateInfo.pPoolSizes = poolSizes.data();
+
+		if (vkCreateDescriptorPool(m_pDevice->logicalDevice, &poolCreateInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to create bindless descriptor pool.");
+			return;
+		}
+
+		std::vector<VkDescriptorSetLayout> layouts(m_maxFramesInFlight, m_descriptorSetLayout);
+		m_descriptorSets.resize(m_maxFramesInFlight, VK_NULL_HANDLE);
+
+		VkDescriptorSetAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocateInfo.descriptorPool = m_descriptorPool;
+		allocateInfo.descriptorSetCount = m_maxFramesInFlight;
+		allocateInfo.pSetLayouts = layouts.data();
+
+		if (vkAllocateDescriptorSets(m_pDevice->logicalDevice, &allocateInfo, m_descriptorSets.data()) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to allocate bindless descriptor sets.");
+			return;
+		}
+	}
+
+	void BindlessResourceTable_VK::CreateMaterialBuffer()
+	{
+		// Each copy starts at an offset storage buffer descriptors can point to
+		VkDeviceSize alignment = std::max<VkDeviceSize>(m_pDevice->deviceProperties.limits.minStorageBufferOffsetAlignment, 1);
+		m_materialCopySize = (sizeof(BindlessMaterialRecord) * MAX_MATERIAL_COUNT + alignment - 1) / alignment * alignment;
+
+		RawBufferCreateInfo_VK bufferCreateInfo{};
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		bufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+		bufferCreateInfo.size = m_materialCopySize * m_maxFramesInFlight;
+		bufferCreateInfo.stride = sizeof(BindlessMaterialRecord);
+
+		CE_NEW(m_pMaterialBuffer, RawBuffer_VK, m_pDevice->pUploadAllocator, bufferCreateInfo);
+
+		void* pMappedData = nullptr;
+		if (!m_pDevice->pUploadAllocator->MapMemory(m_pMaterialBuffer->m_allocation, &pMappedData))
+		{
+			throw std::runtime_error("Vulkan: failed to map bindless material buffer.");
+			return;
+		}
+		m_pMappedMaterialData = (uint8_t*)pMappedData;
+
+		std::vector<VkDescriptorBufferInfo> bufferInfos(m_maxFramesInFlight);
+		std::vector<VkWriteDescriptorSet> writes(m_maxFramesInFlight);
+		for (uint32_t i = 0; i < m_maxFramesInFlight; i++)
+		{
+			bufferInfos[i].buffer = m_pMaterialBuffer->m_buffer;
+			bufferInfos[i].offset = m_materialCopySize * i;
+			bufferInfos[i].range = m_materialCopySize;
+
+			writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[i].dstSet = m_descriptorSets[i];
+			writes[i].dstBinding = MATERIAL_BUFFER_BINDING;
+			writes[i].dstArrayElement = 0;
+			writes[i].descriptorCount = 1;
+			writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[i].pBufferInfo = &bufferInfos[i];
+		}
+
+		vkUpdateDescriptorSets(m_pDevice->logicalDevice, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+	}
+
+	BindlessMaterialRecord* BindlessResourceTable_VK::GetMappedMaterialData(uint32_t frameIndex) const
+	{
+		return (BindlessMaterialRecord*)(m_pMappedMaterialData + m_materialCopySize * frameIndex);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+#include "BuiltInShaderType.h"
+#include "VulkanIncludes.h"
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+namespace Engine
+{
+	struct LogicalDevice_VK;
+	class  RawBuffer_VK;
+
+	// Global descriptor set holding all registered material textures and the material record buffer
+	// Textures and materials are referenced by stable indices, so binding it once per pipeline is sufficient
+	// Each frame in flight has its own set and copy of material records, so that updates do not reach frames being executed
+	class BindlessResourceTable_VK
+	{
+	public:
+		BindlessResourceTable_VK(LogicalDevice_VK* pDevice, uint32_t maxTextureCount, uint32_t maxMaterialCount, uint32_t maxFramesInFlight);
+		~BindlessResourceTable_VK();
+
+		// Registering the same texture and sampler pair again returns the previously assigned index
+		// Returns fallback texture index once the table is full
+		uint32_t RegisterTexture(uint64_t textureID, VkImageView imageView, VkImageLayout imageLayout, VkSampler sampler);
+		void UnregisterTexture(uint64_t textureID); // Releases slots of all samplers paired with the texture
+		void SetFallbackTexture(uint32_t textureIndex);
+
+		// Returns default material index once the table is full
+		uint32_t RegisterMaterial(const BindlessMaterialRecord& record);
+		void UnregisterMaterial(uint32_t materialIndex);
+		void UpdateMaterial(uint32_t materialIndex, const BindlessMaterialRecord& record); // Takes effect from current frame, other copies are updated when their frames begin
+
+		// Must only be called when GPU has finished the frame previously recorded in this slot, and no thread is recording
+		// Released slots are only reused after the frames that may still access them have retired
+		void BeginFrame(uint32_t frameIndex);
+
+		VkDescriptorSetLayout GetDescriptorSetLayout() const;
+		VkDescriptorSet GetDescriptorSet() const; // Of current frame
+
+		uint32_t GetRegisteredTextureCount() const;
+		uint32_t GetRegisteredMaterialCount() const;
+
+	private:
+		void CreateDescriptorSetLayout();
+		void CreateDescriptorSet();
+		void CreateMaterialBuffer();
+
+		BindlessMaterialRecord* GetMappedMaterialData(uint32_t frameIndex) const;
+
+		uint32_t AllocateSlot(std::deque<std::pair<uint32_t, uint64_t>>& freeSlots, uint32_t& slotCount, uint32_t maxSlotCount);
+
+	public:
+		// Descriptor set index bindless shaders must declare the table at
+		static const uint32_t DESCRIPTOR_SET_INDEX = 1;
+		static const uint32_t TEXTURE_ARRAY_BINDING = 0;
+		static const uint32_t MATERIAL_BUFFER_BINDING = 1;
+
+		// Reserved on creation, stands in for materials that do not fit into the table
+		static const uint32_t DEFAULT_MATERIAL_INDEX = 0;
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		const uint32_t m_maxFramesInFlight;
+
+		const uint32_t MAX_TEXTURE_COUNT;
+		const uint32_t MAX_MATERIAL_COUNT;
+
+		VkDescriptorSetLayout m_descriptorSetLayout;
+		VkDescriptorPool m_descriptorPool;
+		std::vector<VkDescriptorSet> m_descriptorSets; // Per frame in flight
+		std::atomic<uint32_t> m_frameIndex;
+
+		RawBuffer_VK* m_pMaterialBuffer; // Holds one copy of material records per frame in flight
+		uint8_t* m_pMappedMaterialData;
+		VkDeviceSize m_materialCopySize;
+		std::vector<BindlessMaterialRecord> m_materialRecords; // Latest records, copied into each frame's data when that frame begins
+		std::vector<std::vector<uint32_t>> m_pendingMaterialUpdates; // Per frame in flight, indices of records that are outdated in its copy
+
+		std::mutex m_registrationMutex;
+		std::map<std::pair<uint64_t, VkSampler>, uint32_t> m_registeredTextures; // (Texture ID, sampler) - array index
+		uint32_t m_textureCount; // Including released slots, only grows when free list has no retired slot
+		uint32_t m_materialCount;
+		uint32_t m_fallbackTextureIndex;
+
+		uint64_t m_frameCount;
+		std::deque<std::pair<uint32_t, uint64_t>> m_freeTextureSlots; // (Slot, frame count at which it has retired), in release order
+		std::deque<std::pair<uint32_t, uint64_t>> m_freeMaterialSlots;
+	};
+}
\ No newline at end of file
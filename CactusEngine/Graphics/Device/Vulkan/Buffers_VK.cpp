@@ -4,6 +4,8 @@
 #include "LogUtility.h"
 #include "MemoryAllocator.h"
 
+#include <algorithm>
+
 namespace Engine
 {
 	RawBuffer_VK::RawBuffer_VK(UploadAllocator_VK* pAllocator, const RawBufferCreateInfo_VK& createInfo)
@@ -47,14 +49,22 @@ namespace Engine
 		}
 	}
 
-	VertexBuffer_VK::VertexBuffer_VK(UploadAllocator_VK* pAllocator, const RawBufferCreateInfo_VK& vertexBufferCreateInfo, const RawBufferCreateInfo_VK& indexBufferCreateInfo)
-		: m_pAllocator(pAllocator)
+	VertexBuffer_VK::VertexBuffer_VK(UploadAllocator_VK* pAllocator, const RawBufferCreateInfo_VK& vertexBufferCreateInfo, const RawBufferCreateInfo_VK& indexBufferCreateInfo, const RawBufferCreateInfo_VK* pPositionBufferCreateInfo)
+		: m_pAllocator(pAllocator),
+		m_pPositionBufferImpl(nullptr)
 	{
 		CE_NEW(m_pVertexBufferImpl, RawBuffer_VK, pAllocator, vertexBufferCreateInfo);
 		CE_NEW(m_pIndexBufferImpl, RawBuffer_VK, pAllocator, indexBufferCreateInfo);
 
 		m_indexType = indexBufferCreateInfo.indexFormat;
 		m_sizeInBytes = vertexBufferCreateInfo.size + indexBufferCreateInfo.size;
+
+		m_hasPositionStream = pPositionBufferCreateInfo != nullptr;
+		if (m_hasPositionStream)
+		{
+			CE_NEW(m_pPositionBufferImpl, RawBuffer_VK, pAllocator, *pPositionBufferCreateInfo);
+			m_sizeInBytes += pPositionBufferCreateInfo->size;
+		}
 	}
 
 	RawBuffer_VK* VertexBuffer_VK::GetBufferImpl() const
@@ -67,6 +77,11 @@ namespace Engine
 		return m_pIndexBufferImpl;
 	}
 
+	RawBuffer_VK* VertexBuffer_VK::GetPositionBufferImpl() const
+	{
+		return m_pPositionBufferImpl;
+	}
+
 	VkIndexType VertexBuffer_VK::GetIndexFormat() const
 	{
 		return m_indexType;
@@ -202,30 +217,36 @@ namespace Engine
 		return m_sizeInBytes - m_subAllocatedSize;
 	}
 
-	UniformBufferManager_VK::UniformBufferManager_VK(UploadAllocator_VK* pAllocator)
-		: m_pAllocator(pAllocator)
+	UniformBufferManager_VK::UniformBufferManager_VK(UploadAllocator_VK* pAllocator, uint32_t minOffsetAlignment)
+		: m_pAllocator(pAllocator),
+		m_minOffsetAlignment(std::max(minOffsetAlignment, 1u)),
+		m_peakHighWaterMark(0)
 	{
-		// Create one buffer in each pool by default
-
-		BaseUniformBufferCreateInfo_VK createInfo{};
-		createInfo.size = DEFAULT_BUFFER_SIZE;
-		createInfo.type = EUniformBufferType_VK::Uniform;
-		createInfo.appliedStages = VK_SHADER_STAGE_ALL_GRAPHICS;
+		DEBUG_ASSERT_CE((m_minOffsetAlignment & (m_minOffsetAlignment - 1)) == 0); // Guaranteed to be power of two by spec
 
 		uint32_t maxFramesInFlight = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight();
-		m_baseUniformBuffers.resize(maxFramesInFlight);
+
+		m_ringBuffers.resize(maxFramesInFlight);
+		m_allocatedSizes = std::vector<std::atomic<uint32_t>>(maxFramesInFlight);
+		m_highWaterMarks.resize(maxFramesInFlight, 0);
+		m_overflowBuffers.resize(maxFramesInFlight);
+		m_overflowAllocatedSizes.resize(maxFramesInFlight, 0);
 
 		for (uint32_t i = 0; i < maxFramesInFlight; i++)
 		{
-			BaseUniformBuffer_VK* pBuffer = nullptr;
-			CE_NEW(pBuffer, BaseUniformBuffer_VK, m_pAllocator, createInfo);
-			m_baseUniformBuffers[i].push_back(pBuffer);
+			m_ringBuffers[i] = CreateBaseBuffer(DEFAULT_RING_SIZE);
+			m_allocatedSizes[i].store(0, std::memory_order_relaxed);
 		}
 	}
 
 	UniformBufferManager_VK::~UniformBufferManager_VK()
 	{
-		for (auto& bufferPool : m_baseUniformBuffers)
+		for (auto& pBuffer : m_ringBuffers)
+		{
+			CE_DELETE(pBuffer);
+		}
+
+		for (auto& bufferPool : m_overflowBuffers)
 		{
 			for (auto& pBuffer : bufferPool)
 			{
@@ -236,93 +257,123 @@ namespace Engine
 
 	UniformBuffer UniformBufferManager_VK::GetUniformBuffer(uint32_t size)
 	{
-		UniformBuffer buffer{};
-		auto& bufferPool = m_baseUniformBuffers[m_currentFrameIndex];
+		uint32_t offset = 0;
+		BaseUniformBuffer_VK* pBuffer = AllocateBlock(AlignSize(size), offset);
 
-		std::lock_guard<std::mutex> lock(m_bufferPoolMutex);
-
-		for (auto& pBuffer : bufferPool)
-		{
-			if (pBuffer->GetFreeSpace() >= size)
-			{
-				buffer = pBuffer->AllocateSubBuffer(size);
-				break;
-			}
-		}
-
-		if (!buffer.IsValid())
-		{
-			BaseUniformBufferCreateInfo_VK createInfo{};
-			createInfo.size = DEFAULT_BUFFER_SIZE;
-			createInfo.type = EUniformBufferType_VK::Uniform;
-			createInfo.appliedStages = VK_SHADER_STAGE_ALL_GRAPHICS;
-
-			BaseUniformBuffer_VK* pBuffer = nullptr;
-			CE_NEW(pBuffer, BaseUniformBuffer_VK, m_pAllocator, createInfo);
-			bufferPool.push_back(pBuffer);
-
-			buffer = pBuffer->AllocateSubBuffer(size);
-		}
-
-		return buffer;
+		return pBuffer->AllocateSubBuffer(offset, size);
 	}
 
 	UniformBuffer UniformBufferManager_VK::GetUniformBuffer(UniformBufferReservedRegion& region, uint32_t size)
 	{
-		DEBUG_ASSERT_MESSAGE_CE(size <= region.availableSize, "Reserved buffer region does not have enough space.");
-		auto& bufferPool = m_baseUniformBuffers[m_currentFrameIndex];
+		uint32_t alignedSize = AlignSize(size);
+		DEBUG_ASSERT_MESSAGE_CE(alignedSize <= region.availableSize, "Reserved buffer region does not have enough space.");
 
 		uint32_t internalOffset = region.totalSize - region.availableSize;
-		auto buffer = bufferPool[region.index]->AllocateSubBuffer(region.offset + internalOffset, size);
-		region.availableSize -= size;
+		auto buffer = ((BaseUniformBuffer_VK*)region.pParentBuffer)->AllocateSubBuffer(region.offset + internalOffset, size);
+		region.availableSize -= alignedSize;
 
 		return buffer;
 	}
 
 	UniformBufferReservedRegion UniformBufferManager_VK::ReserveBufferRegion(uint32_t size)
 	{
-		DEBUG_ASSERT_MESSAGE_CE(size <= DEFAULT_BUFFER_SIZE, "Invalid buffer region reservation size.");
-		auto& bufferPool = m_baseUniformBuffers[m_currentFrameIndex];
-
 		UniformBufferReservedRegion region{};
-		region.totalSize = size;
-		region.availableSize = size;
+		region.totalSize = AlignSize(size);
+		region.availableSize = region.totalSize;
+		region.pParentBuffer = AllocateBlock(region.totalSize, region.offset);
 
-		std::lock_guard<std::mutex> lock(m_bufferPoolMutex);
+		return region;
+	}
 
-		for (uint32_t i = 0; i < bufferPool.size(); ++i)
+	void UniformBufferManager_VK::ResetBufferAllocation()
+	{
+		// The frame that used these buffers has finished on device, so they can be safely resized
+		uint32_t usedSize = m_allocatedSizes[m_currentFrameIndex].exchange(0, std::memory_order_relaxed);
+
+		m_highWaterMarks[m_currentFrameIndex] = usedSize;
+		m_peakHighWaterMark = std::max(m_peakHighWaterMark, usedSize);
+
+		if (usedSize > m_ringBuffers[m_currentFrameIndex]->GetSizeInBytes())
 		{
-			if (bufferPool[i]->GetFreeSpace() >= size)
-			{
-				region.index = i;
-				region.offset = bufferPool[i]->ReserveBufferRegion(size);
-				return region;
-			}
+			uint32_t newSize = usedSize + usedSize / 4; // Leave some headroom for fluctuation
+			newSize = (newSize + RING_SIZE_GRANULARITY - 1) / RING_SIZE_GRANULARITY * RING_SIZE_GRANULARITY;
+
+			LOG_MESSAGE("Vulkan: Uniform ring buffer of frame " + std::to_string(m_currentFrameIndex) + " overflowed, high-water mark "
+				+ std::to_string(usedSize) + " bytes, growing from " + std::to_string(m_ringBuffers[m_currentFrameIndex]->GetSizeInBytes()) + " to " + std::to_string(newSize) + " bytes.");
+
+			CE_DELETE(m_ringBuffers[m_currentFrameIndex]);
+			m_ringBuffers[m_currentFrameIndex] = CreateBaseBuffer(newSize);
+		}
+
+		for (auto& pBuffer : m_overflowBuffers[m_currentFrameIndex])
+		{
+			CE_DELETE(pBuffer);
 		}
+		m_overflowBuffers[m_currentFrameIndex].clear();
+		m_overflowAllocatedSizes[m_currentFrameIndex] = 0;
+	}
+
+	uint32_t UniformBufferManager_VK::GetHighWaterMark(uint32_t frameIndex) const
+	{
+		DEBUG_ASSERT_CE(frameIndex < m_highWaterMarks.size());
+		return m_highWaterMarks[frameIndex];
+	}
 
-		// No buffer has enough space, create a new one
+	uint32_t UniformBufferManager_VK::GetPeakHighWaterMark() const
+	{
+		return m_peakHighWaterMark;
+	}
 
+	BaseUniformBuffer_VK* UniformBufferManager_VK::CreateBaseBuffer(uint32_t size) const
+	{
 		BaseUniformBufferCreateInfo_VK createInfo{};
-		createInfo.size = DEFAULT_BUFFER_SIZE;
+		createInfo.size = size;
 		createInfo.type = EUniformBufferType_VK::Uniform;
 		createInfo.appliedStages = VK_SHADER_STAGE_ALL_GRAPHICS;
 
 		BaseUniformBuffer_VK* pBuffer = nullptr;
 		CE_NEW(pBuffer, BaseUniformBuffer_VK, m_pAllocator, createInfo);
-		bufferPool.push_back(pBuffer);
 
-		region.index = bufferPool.size() - 1;
-		region.offset = pBuffer->ReserveBufferRegion(size);
+		return pBuffer;
+	}
 
-		return region;
+	uint32_t UniformBufferManager_VK::AlignSize(uint32_t size) const
+	{
+		return (size + m_minOffsetAlignment - 1) & ~(m_minOffsetAlignment - 1);
 	}
 
-	void UniformBufferManager_VK::ResetBufferAllocation()
+	BaseUniformBuffer_VK* UniformBufferManager_VK::AllocateBlock(uint32_t alignedSize, uint32_t& outOffset)
+	{
+		BaseUniformBuffer_VK* pRingBuffer = m_ringBuffers[m_currentFrameIndex];
+
+		// Fast path: lock-free bump allocation
+		uint32_t offset = m_allocatedSizes[m_currentFrameIndex].fetch_add(alignedSize, std::memory_order_relaxed);
+		if (offset + alignedSize <= pRingBuffer->GetSizeInBytes())
+		{
+			outOffset = offset;
+			return pRingBuffer;
+		}
+
+		// Slow path: ring is exhausted, the overshoot is kept in the counter so that ring can be grown accordingly
+		return AllocateOverflowBlock(alignedSize, outOffset);
+	}
+
+	BaseUniformBuffer_VK* UniformBufferManager_VK::AllocateOverflowBlock(uint32_t alignedSize, uint32_t& outOffset)
 	{
-		auto& bufferPool = m_baseUniformBuffers[m_currentFrameIndex];
-		for (auto& pBuffer : bufferPool)
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+
+		auto& bufferPool = m_overflowBuffers[m_currentFrameIndex];
+		uint32_t& allocatedSize = m_overflowAllocatedSizes[m_currentFrameIndex];
+
+		if (bufferPool.empty() || allocatedSize + alignedSize > bufferPool.back()->GetSizeInBytes())
 		{
-			pBuffer->ResetSubBufferAllocation();
+			bufferPool.push_back(CreateBaseBuffer(std::max(alignedSize, RING_SIZE_GRANULARITY)));
+			allocatedSize = 0;
 		}
+
+		outOffset = allocatedSize;
+		allocatedSize += alignedSize;
+
+		return bufferPool.back();
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "UploadAllocator_VK.h"
 
 #include <mutex>
+#include <atomic>
 
 namespace Engine
 {
@@ -26,6 +27,9 @@ namespace Engine
 		friend class GraphicsHardwareInterface_VK;
 		friend class BaseUniformBuffer_VK;
 		friend class DataTransferBuffer_VK;
+		friend class BindlessResourceTable_VK;
+		friend class MipmapGenerator_VK;
+		friend class UploadManager_VK;
 	};
 
 	class DataTransferBuffer_VK : public DataTransferBuffer
@@ -47,17 +51,19 @@ namespace Engine
 	class VertexBuffer_VK : public VertexBuffer
 	{
 	public:
-		VertexBuffer_VK(UploadAllocator_VK* pAllocator, const RawBufferCreateInfo_VK& vertexBufferCreateInfo, const RawBufferCreateInfo_VK& indexBufferCreateInfo);
+		VertexBuffer_VK(UploadAllocator_VK* pAllocator, const RawBufferCreateInfo_VK& vertexBufferCreateInfo, const RawBufferCreateInfo_VK& indexBufferCreateInfo, const RawBufferCreateInfo_VK* pPositionBufferCreateInfo = nullptr);
 		~VertexBuffer_VK() = default;
 
 		RawBuffer_VK* GetBufferImpl() const;
 		RawBuffer_VK* GetIndexBufferImpl() const;
+		RawBuffer_VK* GetPositionBufferImpl() const; // Null if created without position stream
 		VkIndexType GetIndexFormat() const;
 
 	private:
 		UploadAllocator_VK* m_pAllocator;
 		RawBuffer_VK* m_pVertexBufferImpl;
 		RawBuffer_VK* m_pIndexBufferImpl;
+		RawBuffer_VK* m_pPositionBufferImpl;
 		VkIndexType m_indexType;
 	};
 
@@ -106,10 +112,12 @@ namespace Engine
 		uint32_t m_subAllocatedSize;
 	};
 
+	// Each frame in flight owns one persistently mapped ring buffer, sub-allocated by an atomic bump pointer
+	// Allocations that do not fit fall back to overflow buffers, and the ring is grown to the recorded high-water mark on next reuse
 	class UniformBufferManager_VK : public UniformBufferManager
 	{
 	public:
-		UniformBufferManager_VK(UploadAllocator_VK* pAllocator);
+		UniformBufferManager_VK(UploadAllocator_VK* pAllocator, uint32_t minOffsetAlignment);
 		~UniformBufferManager_VK();
 
 		UniformBuffer GetUniformBuffer(uint32_t size) override;
@@ -118,12 +126,32 @@ namespace Engine
 
 		void ResetBufferAllocation() override;
 
+		uint32_t GetHighWaterMark(uint32_t frameIndex) const override;
+		uint32_t GetPeakHighWaterMark() const override;
+
+	private:
+		BaseUniformBuffer_VK* CreateBaseBuffer(uint32_t size) const;
+		uint32_t AlignSize(uint32_t size) const;
+
+		// Returns the parent buffer and writes the offset of an aligned block of given size
+		BaseUniformBuffer_VK* AllocateBlock(uint32_t alignedSize, uint32_t& outOffset);
+		BaseUniformBuffer_VK* AllocateOverflowBlock(uint32_t alignedSize, uint32_t& outOffset);
+
 	private:
 		UploadAllocator_VK* m_pAllocator;
-		std::vector<std::vector<BaseUniformBuffer_VK*>> m_baseUniformBuffers;
+		const uint32_t m_minOffsetAlignment;
+
+		std::vector<BaseUniformBuffer_VK*> m_ringBuffers;
+		std::vector<std::atomic<uint32_t>> m_allocatedSizes; // Total requested bytes this frame, may exceed ring size
+		std::vector<uint32_t> m_highWaterMarks;
+		uint32_t m_peakHighWaterMark;
 
-		const uint32_t DEFAULT_BUFFER_SIZE = 8 * 1024 * 1024; // 8 MB per base buffer
+		// Slow path, only hit when a ring runs out of space
+		std::vector<std::vector<BaseUniformBuffer_VK*>> m_overflowBuffers;
+		std::vector<uint32_t> m_overflowAllocatedSizes;
+		std::mutex m_overflowMutex;
 
-		std::mutex m_bufferPoolMutex;
+		const uint32_t DEFAULT_RING_SIZE = 8 * 1024 * 1024; // 8 MB per frame
+		const uint32_t RING_SIZE_GRANULARITY = 1024 * 1024;
 	};
 }
\ No newline at end of file
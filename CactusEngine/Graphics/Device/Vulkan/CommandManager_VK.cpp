@@ -19,6 +19,7 @@ namespace Engine
 		m_pAssociatedSubmitSemaphore(nullptr),
 		m_commandBuffer(cmdBuffer),
 		m_pipelineLayout(VK_NULL_HANDLE),
+		m_pushConstantSize(0),
 		m_pSyncObjectManager(nullptr),
 		m_isExternal(false),
 		m_pAllocatedPool(nullptr),
@@ -121,26 +122,35 @@ namespace Engine
 		vkCmdBindPipeline(m_commandBuffer, bindPoint, pipeline);
 	}
 
-	void CommandBuffer_VK::BindPipelineLayout(const VkPipelineLayout pipelineLayout)
+	void CommandBuffer_VK::BindPipelineLayout(const VkPipelineLayout pipelineLayout, uint32_t pushConstantSize)
 	{
 		m_pipelineLayout = pipelineLayout;
+		m_pushConstantSize = pushConstantSize;
 	}
 
-	void CommandBuffer_VK::BindDescriptorSets(const VkPipelineBindPoint bindPoint, const std::vector<DescriptorSet_VK*>& descriptorSets, uint32_t firstSet)
+	void CommandBuffer_VK::BindDescriptorSets(const VkPipelineBindPoint bindPoint, const std::vector<VkDescriptorSet>& descriptorSets, uint32_t firstSet)
 	{
 		DEBUG_ASSERT_CE(m_isRecording);
 
-		std::vector<VkDescriptorSet> setHandles;
-		for (auto& pSet : descriptorSets)
-		{
-			m_boundDescriptorSets.push(pSet);
-			setHandles.emplace_back(pSet->m_descriptorSet);
-		}
-
-		vkCmdBindDescriptorSets(m_commandBuffer, bindPoint, m_pipelineLayout, firstSet, (uint32_t)setHandles.size(), setHandles.data(), 0, nullptr);
+		// Transient descriptor sets are reclaimed per frame by descriptor allocator, no need to track them here
+		vkCmdBindDescriptorSets(m_commandBuffer, bindPoint, m_pipelineLayout, firstSet, (uint32_t)descriptorSets.size(), descriptorSets.data(), 0, nullptr);
 		// Alert: dynamic offset is not handled
 	}
 
+	void CommandBuffer_VK::PushConstants(VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		DEBUG_ASSERT_CE(m_pipelineLayout != VK_NULL_HANDLE);
+		DEBUG_ASSERT_CE(offset + size <= m_pushConstantSize);
+
+		vkCmdPushConstants(m_commandBuffer, m_pipelineLayout, stageFlags, offset, size, pValues);
+	}
+
+	uint32_t CommandBuffer_VK::GetPushConstantSize() const
+	{
+		return m_pushConstantSize;
+	}
+
 	void CommandBuffer_VK::SetViewport(const VkViewport* pViewport, const VkRect2D* pScissor)
 	{
 		DEBUG_ASSERT_CE(m_isRecording);
@@ -169,6 +179,15 @@ namespace Engine
 		}
 	}
 
+	void CommandBuffer_VK::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+	{
+		DEBUG_ASSERT_CE(m_isRecording && !m_inRenderPass);
+		if (groupCountX > 0 && groupCountY > 0 && groupCountZ > 0)
+		{
+			vkCmdDispatch(m_commandBuffer, groupCountX, groupCountY, groupCountZ);
+		}
+	}
+
 	void CommandBuffer_VK::EndRenderPass()
 	{
 		DEBUG_ASSERT_CE(m_inRenderPass);
@@ -263,6 +282,23 @@ namespace Engine
 		pImage->m_appliedStages = appliedStages;
 	}
 
+	void CommandBuffer_VK::ImageMemoryBarriers(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, const std::vector<VkImageMemoryBarrier>& barriers)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		DEBUG_ASSERT_CE(!m_inRenderPass);
+
+		vkCmdPipelineBarrier(m_commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, (uint32_t)barriers.size(), barriers.data());
+	}
+
+	void CommandBuffer_VK::PipelineBarrier(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, const std::vector<VkBufferMemoryBarrier>& bufferBarriers, const std::vector<VkImageMemoryBarrier>& imageBarriers)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		DEBUG_ASSERT_CE(!m_inRenderPass);
+
+		vkCmdPipelineBarrier(m_commandBuffer, srcStage, dstStage, 0, 0, nullptr,
+			(uint32_t)bufferBarriers.size(), bufferBarriers.data(), (uint32_t)imageBarriers.size(), imageBarriers.data());
+	}
+
 	void CommandBuffer_VK::GenerateMipmap(Texture2D_VK* pImage, const VkImageLayout newLayout, uint32_t appliedStages)
 	{
 #if defined(DEBUG_MODE_CE)
@@ -355,6 +391,12 @@ namespace Engine
 		vkCmdCopyBuffer(m_commandBuffer, pSrcBuffer->m_buffer, pDstBuffer->m_buffer, 1, &region); // TODO: offer a batch version
 	}
 
+	void CommandBuffer_VK::CopyBufferToBuffer(const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkBufferCopy& region)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		vkCmdCopyBuffer(m_commandBuffer, srcBuffer, dstBuffer, 1, &region);
+	}
+
 	void CommandBuffer_VK::CopyBufferToTexture2D(const RawBuffer_VK* pSrcBuffer, Texture2D_VK* pDstImage, const std::vector<VkBufferImageCopy>& regions)
 	{
 		DEBUG_ASSERT_CE(m_isRecording);
@@ -373,6 +415,19 @@ namespace Engine
 		vkCmdCopyImage(m_commandBuffer, pSrcImage->m_image, pSrcImage->m_layout, pDstImage->m_image, pDstImage->m_layout, (uint32_t)regions.size(), regions.data());
 	}
 
+	void CommandBuffer_VK::ResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		DEBUG_ASSERT_CE(!m_inRenderPass);
+		vkCmdResetQueryPool(m_commandBuffer, queryPool, firstQuery, queryCount);
+	}
+
+	void CommandBuffer_VK::WriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query)
+	{
+		DEBUG_ASSERT_CE(m_isRecording);
+		vkCmdWriteTimestamp(m_commandBuffer, stage, queryPool, query);
+	}
+
 	void CommandBuffer_VK::WaitPresentationSemaphore(Semaphore_VK* pSemaphore)
 	{
 		m_waitPresentationSemaphores.emplace_back(pSemaphore);
@@ -489,9 +544,15 @@ namespace Engine
 
 	void CommandManager_VK::WaitWorkingQueueIdle()
 	{
+		std::lock_guard<std::mutex> guard(m_workingQueueMutex);
 		vkQueueWaitIdle(m_workingQueue.queue);
 	}
 
+	std::mutex& CommandManager_VK::GetWorkingQueueMutex()
+	{
+		return m_workingQueueMutex;
+	}
+
 	CommandBuffer_VK* CommandManager_VK::RequestPrimaryCommandBuffer()
 	{
 		CommandBuffer_VK* pCommandBuffer = m_pDefaultCommandPool->RequestPrimaryCommandBuffer();
@@ -629,8 +690,11 @@ namespace Engine
 			submitInfo.pWaitDstStageMask = 0;
 			// TODO: handle possible semaphore submission
 
-			vkQueueSubmit(m_workingQueue.queue, 1, &submitInfo, VK_NULL_HANDLE);
-			vkQueueWaitIdle(m_workingQueue.queue);
+			{
+				std::lock_guard<std::mutex> guard(m_workingQueueMutex);
+				vkQueueSubmit(m_workingQueue.queue, 1, &submitInfo, VK_NULL_HANDLE);
+				vkQueueWaitIdle(m_workingQueue.queue);
+			}
 
 			pCmdBuffer->m_inExecution = false;
 			m_pDefaultCommandPool->m_freeCommandBuffers.Push(pCmdBuffer);
@@ -694,7 +758,10 @@ namespace Engine
 
 			while (m_commandSubmissionQueue.TryPop(pCommandSubmitInfo))
 			{
-				vkQueueSubmit(m_workingQueue.queue, 1, &pCommandSubmitInfo->submitInfo, VK_NULL_HANDLE);
+				{
+					std::lock_guard<std::mutex> guard(m_workingQueueMutex);
+					vkQueueSubmit(m_workingQueue.queue, 1, &pCommandSubmitInfo->submitInfo, VK_NULL_HANDLE);
+				}
 
 				if (pCommandSubmitInfo->pNotifySemaphore)
 				{
@@ -774,12 +841,6 @@ namespace Engine
 							pCmdBuffer->m_waitSemaphores.clear();
 							pCmdBuffer->m_signalSemaphores.clear();
 
-							while (!pCmdBuffer->m_boundDescriptorSets.empty())
-							{
-								pCmdBuffer->m_boundDescriptorSets.front()->m_isInUse = false;
-								pCmdBuffer->m_boundDescriptorSets.pop();
-							}
-
 							pCmdBuffer->m_pAssociatedSubmitSemaphore = nullptr;
 							pCmdBuffer->m_inExecution = false;
 
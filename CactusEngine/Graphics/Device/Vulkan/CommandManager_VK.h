@@ -35,7 +35,8 @@ namespace Engine
 	{
 		Explicit = 0x1,
 		Implicit = 0x2,
-		COUNT = 2
+		Upload = 0x4, // Acquires resources uploaded on transfer queue, submitted on its own ahead of other command buffers
+		COUNT = 3
 	};
 
 	struct LogicalDevice_VK;
@@ -60,21 +61,30 @@ namespace Engine
 		void BindIndexBuffer(const VkBuffer indexBuffer, const VkDeviceSize offset, VkIndexType type);
 		void BeginRenderPass(const VkRenderPass renderPass, const VkFramebuffer frameBuffer, const std::vector<VkClearValue>& clearValues, const VkExtent2D& areaExtent, const VkOffset2D& areaOffset = { 0, 0 });
 		void BindPipeline(const VkPipelineBindPoint bindPoint, const VkPipeline pipeline);
-		void BindPipelineLayout(const VkPipelineLayout pipelineLayout); // TODO: integrate this function with BindPipeline
-		void BindDescriptorSets(const VkPipelineBindPoint bindPoint, const std::vector<DescriptorSet_VK*>& descriptorSets, uint32_t firstSet = 0);
+		void BindPipelineLayout(const VkPipelineLayout pipelineLayout, uint32_t pushConstantSize); // TODO: integrate this function with BindPipeline
+		void BindDescriptorSets(const VkPipelineBindPoint bindPoint, const std::vector<VkDescriptorSet>& descriptorSets, uint32_t firstSet = 0);
+		void PushConstants(VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues);
+		uint32_t GetPushConstantSize() const; // Declared by bound pipeline layout, 0 if it has no push constant range
 		void SetViewport(const VkViewport* pViewport, const VkRect2D* pScissor);
 		void DrawPrimitiveIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, uint32_t vertexOffset = 0, uint32_t firstInstance = 0);
 		void DrawPrimitive(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex = 0, uint32_t firstInstance = 0);
+		void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
 		void EndRenderPass();
 		void EndCommandBuffer();
 
 		void TransitionImageLayout(Texture2D_VK* pImage, const VkImageLayout newLayout, uint32_t appliedStages);
+		void ImageMemoryBarriers(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, const std::vector<VkImageMemoryBarrier>& barriers);
+		void PipelineBarrier(VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage, const std::vector<VkBufferMemoryBarrier>& bufferBarriers, const std::vector<VkImageMemoryBarrier>& imageBarriers);
 		void GenerateMipmap(Texture2D_VK* pImage, const VkImageLayout newLayout, uint32_t appliedStages);
 		void CopyBufferToBuffer(const RawBuffer_VK* pSrcBuffer, const RawBuffer_VK* pDstBuffer, const VkBufferCopy& region);
+		void CopyBufferToBuffer(const VkBuffer srcBuffer, const VkBuffer dstBuffer, const VkBufferCopy& region);
 		void CopyBufferToTexture2D(const RawBuffer_VK* pSrcBuffer, Texture2D_VK* pDstImage, const std::vector<VkBufferImageCopy>& regions);
 		void CopyTexture2DToBuffer(Texture2D_VK* pSrcImage, const RawBuffer_VK* pDstBuffer, const std::vector<VkBufferImageCopy>& regions);
 		void CopyTexture2DToTexture2D(Texture2D_VK* pSrcImage, Texture2D_VK* pDstImage, const std::vector<VkImageCopy>& regions);
 
+		void ResetQueryPool(VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount);
+		void WriteTimestamp(VkPipelineStageFlagBits stage, VkQueryPool queryPool, uint32_t query);
+
 		// For presentation only
 		void WaitPresentationSemaphore(Semaphore_VK* pSemaphore);
 		void SignalPresentationSemaphore(Semaphore_VK* pSemaphore);
@@ -89,6 +99,7 @@ namespace Engine
 		uint32_t m_usageFlags; // Bitmap
 
 		VkPipelineLayout m_pipelineLayout;
+		uint32_t m_pushConstantSize;
 
 		TimelineSemaphore_VK* m_pAssociatedSubmitSemaphore;
 		std::vector<Semaphore_VK*> m_waitPresentationSemaphores;
@@ -97,8 +108,6 @@ namespace Engine
 		std::vector<TimelineSemaphore_VK*> m_signalSemaphores;
 		SyncObjectManager_VK* m_pSyncObjectManager;
 
-		std::queue<DescriptorSet_VK*> m_boundDescriptorSets;
-
 		bool m_isRecording;
 		bool m_inRenderPass;
 		bool m_inExecution;
@@ -107,6 +116,7 @@ namespace Engine
 		friend class CommandPool_VK;
 		friend class CommandManager_VK;
 		friend class GraphicsHardwareInterface_VK;
+		friend class UploadManager_VK;
 	};
 
 	class CommandPool_VK : public NoCopy, public GraphicsCommandPool
@@ -132,6 +142,7 @@ namespace Engine
 
 		friend class CommandManager_VK;
 		friend class GraphicsHardwareInterface_VK;
+		friend class UploadManager_VK;
 	};
 
 	struct CommandSubmitInfo_VK
@@ -171,6 +182,7 @@ namespace Engine
 
 		EQueueType GetWorkingQueueType() const;
 		void WaitWorkingQueueIdle();
+		std::mutex& GetWorkingQueueMutex(); // Must be held by anyone else submitting to working queue
 
 		CommandBuffer_VK* RequestPrimaryCommandBuffer();
 		void SubmitCommandBuffers(TimelineSemaphore_VK* pSubmitSemaphore, uint32_t usageMask, ThreadSemaphore* pNotifySemaphore = nullptr);
@@ -204,6 +216,7 @@ namespace Engine
 
 		std::mutex m_externalCommandPoolCreationMutex;
 		std::mutex m_inExecutionQueueRWMutex;
+		std::mutex m_workingQueueMutex; // Vulkan requires queue access to be externally synchronized
 
 		// Async command submission
 		std::thread m_commandBufferSubmissionThread;
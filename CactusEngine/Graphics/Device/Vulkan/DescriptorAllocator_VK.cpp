@@ -1,15 +1,18 @@
 #include "DescriptorAllocator_VK.h"
 #include "GraphicsHardwareInterface_VK.h"
 #include "GHIUtilities_VK.h"
+#include "JobSystem.h"
 #include "LogUtility.h"
 #include "MemoryAllocator.h"
 
+#include <algorithm>
+
 namespace Engine
 {
 	DescriptorSet_VK::DescriptorSet_VK(VkDescriptorSet descSet)
 		: m_descriptorSet(descSet)
 	{
-		m_isInUse = false;
+
 	}
 
 	DescriptorSetLayout_VK::DescriptorSetLayout_VK(LogicalDevice_VK* pDevice, const std::vector<VkDescriptorSetLayoutBinding>& bindings)
@@ -67,8 +70,7 @@ namespace Engine
 
 		if (clearPrev)
 		{
-			vkResetDescriptorPool(m_pDevice->logicalDevice, m_descriptorPool, VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
-			m_allocatedSetsCount = 0;
+			Reset();
 		}
 
 		VkDescriptorSetAllocateInfo allocateInfo{};
@@ -96,7 +98,152 @@ namespace Engine
 		return true;
 	}
 
-	void DescriptorPool_VK::UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos)
+	bool DescriptorPool_VK::AllocateTransientDescriptorSet(VkDescriptorSetLayout layout, VkDescriptorSet& outSet)
+	{
+		DEBUG_ASSERT_CE(m_descriptorPool != VK_NULL_HANDLE);
+
+		if (m_allocatedSetsCount >= MAX_SETS)
+		{
+			return false;
+		}
+
+		VkDescriptorSetAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocateInfo.descriptorPool = m_descriptorPool;
+		allocateInfo.descriptorSetCount = 1;
+		allocateInfo.pSetLayouts = &layout;
+
+		VkResult result = vkAllocateDescriptorSets(m_pDevice->logicalDevice, &allocateInfo, &outSet);
+		if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+		{
+			// Descriptor budget ran out before set count did
+			m_allocatedSetsCount = MAX_SETS;
+			return false;
+		}
+		else if (result != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: Failed to allocate transient descriptor set.");
+			return false;
+		}
+
+		m_allocatedSetsCount++;
+		return true;
+	}
+
+	void DescriptorPool_VK::Reset()
+	{
+		DEBUG_ASSERT_CE(m_descriptorPool != VK_NULL_HANDLE);
+
+		vkResetDescriptorPool(m_pDevice->logicalDevice, m_descriptorPool, 0);
+		m_allocatedSetsCount = 0;
+	}
+
+	DescriptorAllocator_VK::DescriptorAllocator_VK(LogicalDevice_VK* pDevice, uint32_t maxFramesInFlight)
+		: m_pDevice(pDevice),
+		m_maxFramesInFlight(maxFramesInFlight),
+		m_threadSlotCount(JobSystem::GetThreadSlotCount())
+	{
+		DEBUG_ASSERT_MESSAGE_CE(m_threadSlotCount > 0, "Job system should be initialized before descriptor allocator.");
+
+		m_transientFrameIndex = 0;
+		m_activeTransientAllocationCount = 0;
+		m_transientPoolChains.resize(m_maxFramesInFlight * (m_threadSlotCount + 1));
+	}
+
+	DescriptorAllocator_VK::~DescriptorAllocator_VK()
+	{
+		for (auto& pPool : m_descriptorPools)
+		{
+			CE_DELETE(pPool);
+		}
+		m_descriptorPools.clear();
+		m_transientPoolChains.clear();
+	}
+
+	DescriptorPool_VK* DescriptorAllocator_VK::CreateDescriptorPool(uint32_t maxSets, const std::vector<VkDescriptorPoolSize>& poolSizes, VkDescriptorPoolCreateFlags flags)
+	{
+		std::lock_guard<std::mutex> guard(m_poolCreationMutex);
+
+		VkDescriptorPoolCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		createInfo.poolSizeCount = (uint32_t)poolSizes.size();
+		createInfo.pPoolSizes = poolSizes.data();
+		createInfo.maxSets = maxSets;
+		createInfo.flags = flags;
+
+		DescriptorPool_VK* pPool;
+		CE_NEW(pPool, DescriptorPool_VK, m_pDevice, maxSets);
+		m_descriptorPools.emplace_back(pPool);
+
+		if (vkCreateDescriptorPool(m_pDevice->logicalDevice, &createInfo, nullptr, &m_descriptorPools[m_descriptorPools.size() - 1]->m_descriptorPool) == VK_SUCCESS)
+		{
+			return m_descriptorPools[m_descriptorPools.size() - 1];
+		}
+		else
+		{
+			throw std::runtime_error("Vulkan: failed to create new descriptor pool.");
+			return nullptr;
+		}
+	}
+
+	void DescriptorAllocator_VK::DestroyDescriptorPool(DescriptorPool_VK* pPool)
+	{
+		std::lock_guard<std::mutex> guard(m_poolCreationMutex);
+
+		auto it = std::find(m_descriptorPools.begin(), m_descriptorPools.end(), pPool);
+		if (it != m_descriptorPools.end())
+		{
+			m_descriptorPools.erase(it);
+			CE_DELETE(pPool);
+		}
+		else
+		{
+			throw std::runtime_error("Vulkan: failed to destroy descriptor pool.");
+		}
+	}
+
+	VkDescriptorSet DescriptorAllocator_VK::AllocateTransientDescriptorSet(const DescriptorSetLayout_VK* pLayout)
+	{
+		m_activeTransientAllocationCount++;
+
+		uint32_t threadSlot = JobSystem::GetCurrentThreadSlot();
+		uint32_t chainIndex = m_transientFrameIndex * (m_threadSlotCount + 1) + std::min<uint32_t>(threadSlot, m_threadSlotCount);
+
+		VkDescriptorSet newSet = VK_NULL_HANDLE;
+		if (threadSlot < m_threadSlotCount)
+		{
+			newSet = AllocateFromTransientPoolChain(m_transientPoolChains[chainIndex], pLayout);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> guard(m_sharedTransientPoolChainMutex);
+			newSet = AllocateFromTransientPoolChain(m_transientPoolChains[chainIndex], pLayout);
+		}
+
+		m_activeTransientAllocationCount--;
+		return newSet;
+	}
+
+	void DescriptorAllocator_VK::BeginTransientFrame(uint32_t frameIndex)
+	{
+		DEBUG_ASSERT_CE(frameIndex < m_maxFramesInFlight);
+		DEBUG_ASSERT_MESSAGE_CE(m_activeTransientAllocationCount == 0, "Transient descriptor pools are reset while a thread is allocating from them.");
+
+		for (uint32_t i = 0; i <= m_threadSlotCount; i++)
+		{
+			auto& chain = m_transientPoolChains[frameIndex * (m_threadSlotCount + 1) + i];
+
+			for (auto& pPool : chain.pools)
+			{
+				pPool->Reset();
+			}
+			chain.activePoolIndex = 0;
+		}
+
+		m_transientFrameIndex = frameIndex;
+	}
+
+	void DescriptorAllocator_VK::UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos)
 	{
 		std::vector<VkWriteDescriptorSet> descriptorWrites;
 
@@ -146,52 +293,44 @@ namespace Engine
 		}
 	}
 
-	DescriptorAllocator_VK::DescriptorAllocator_VK(LogicalDevice_VK* pDevice)
-		: m_pDevice(pDevice)
+	uint32_t DescriptorAllocator_VK::GetDescriptorPoolCount() const
 	{
-
+		return (uint32_t)m_descriptorPools.size();
 	}
 
-	DescriptorPool_VK* DescriptorAllocator_VK::CreateDescriptorPool(uint32_t maxSets, const std::vector<VkDescriptorPoolSize>& poolSizes)
+	VkDescriptorSet DescriptorAllocator_VK::AllocateFromTransientPoolChain(TransientPoolChain& chain, const DescriptorSetLayout_VK* pLayout)
 	{
-		VkDescriptorPoolCreateInfo createInfo{};
-		createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-		createInfo.poolSizeCount = (uint32_t)poolSizes.size();
-		createInfo.pPoolSizes = poolSizes.data();
-		createInfo.maxSets = maxSets;
-		createInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT; // Descriptor sets can return their individual allocations to the pool
+		VkDescriptorSet newSet = VK_NULL_HANDLE;
+		while (true)
+		{
+			if (chain.activePoolIndex == chain.pools.size())
+			{
+				chain.pools.emplace_back(CreateTransientDescriptorPool());
+			}
 
-		DescriptorPool_VK* pPool;
-		CE_NEW(pPool, DescriptorPool_VK, m_pDevice, maxSets);
-		m_descriptorPools.emplace_back(pPool);
+			if (chain.pools[chain.activePoolIndex]->AllocateTransientDescriptorSet(*pLayout->GetDescriptorSetLayout(), newSet))
+			{
+				return newSet;
+			}
 
-		if (vkCreateDescriptorPool(m_pDevice->logicalDevice, &createInfo, nullptr, &m_descriptorPools[m_descriptorPools.size() - 1]->m_descriptorPool) == VK_SUCCESS)
-		{
-			return m_descriptorPools[m_descriptorPools.size() - 1];
-		}
-		else
-		{
-			throw std::runtime_error("Vulkan: failed to create new descriptor pool.");
-			return nullptr;
+			chain.activePoolIndex++;
 		}
 	}
 
-	void DescriptorAllocator_VK::DestroyDescriptorPool(DescriptorPool_VK* pPool)
+	DescriptorPool_VK* DescriptorAllocator_VK::CreateTransientDescriptorPool()
 	{
-		auto it = std::find(m_descriptorPools.begin(), m_descriptorPools.end(), pPool);
-		if (it != m_descriptorPools.end())
-		{
-			vkDestroyDescriptorPool(m_pDevice->logicalDevice, pPool->m_descriptorPool, nullptr);
-			m_descriptorPools.erase(it);
-		}
-		else
+		// Generic budget shared by all shader programs, sized by the typical descriptor mix of built-in shaders
+		std::vector<VkDescriptorPoolSize> poolSizes =
 		{
-			throw std::runtime_error("Vulkan: failed to destroy descriptor pool.");
-		}
-	}
-
-	uint32_t DescriptorAllocator_VK::GetDescriptorPoolCount() const
-	{
-		return (uint32_t)m_descriptorPools.size();
+			{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 * TRANSIENT_POOL_CAPACITY },
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * TRANSIENT_POOL_CAPACITY },
+			{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2 * TRANSIENT_POOL_CAPACITY },
+			{ VK_DESCRIPTOR_TYPE_SAMPLER, 2 * TRANSIENT_POOL_CAPACITY },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, TRANSIENT_POOL_CAPACITY },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, TRANSIENT_POOL_CAPACITY }
+		};
+
+		// Sets are never freed individually, so we can skip FREE_DESCRIPTOR_SET_BIT and let the driver use a linear allocator
+		return CreateDescriptorPool(TRANSIENT_POOL_CAPACITY, poolSizes, 0);
 	}
 }
\ No newline at end of file
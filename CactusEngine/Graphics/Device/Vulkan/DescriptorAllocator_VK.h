@@ -48,11 +48,9 @@ namespace Engine
 
 	private:
 		VkDescriptorSet m_descriptorSet;
-		std::atomic<bool> m_isInUse;
 		
 		friend class DescriptorPool_VK;
 		friend class DescriptorAllocator_VK;
-		friend class CommandManager_VK;
 		friend class CommandBuffer_VK;
 		friend class ShaderProgram_VK;
 		friend class GraphicsHardwareInterface_VK;
@@ -80,7 +78,8 @@ namespace Engine
 		uint32_t RemainingCapacity() const;
 
 		bool AllocateDescriptorSets(const std::vector<VkDescriptorSetLayout>& layouts, std::vector<DescriptorSet_VK*>& outSets, bool clearPrev = false);
-		void UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos);
+		bool AllocateTransientDescriptorSet(VkDescriptorSetLayout layout, VkDescriptorSet& outSet); // Returns false when the pool is exhausted
+		void Reset();
 		// TODO: add set copy support
 
 	private:
@@ -96,16 +95,45 @@ namespace Engine
 	class DescriptorAllocator_VK
 	{
 	public:
-		DescriptorAllocator_VK(LogicalDevice_VK* pDevice);
-		~DescriptorAllocator_VK() = default;
+		DescriptorAllocator_VK(LogicalDevice_VK* pDevice, uint32_t maxFramesInFlight);
+		~DescriptorAllocator_VK();
 
-		DescriptorPool_VK* CreateDescriptorPool(uint32_t maxSets, const std::vector<VkDescriptorPoolSize>& poolSizes);
+		DescriptorPool_VK* CreateDescriptorPool(uint32_t maxSets, const std::vector<VkDescriptorPoolSize>& poolSizes, VkDescriptorPoolCreateFlags flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT);
 		void DestroyDescriptorPool(DescriptorPool_VK* pPool);
 
+		// Transient sets are allocated from pools owned by the calling thread and are only valid until their frame slot is reused
+		VkDescriptorSet AllocateTransientDescriptorSet(const DescriptorSetLayout_VK* pLayout);
+		// Must only be called when GPU has finished the frame previously recorded in this slot, and all jobs recording commands have finished
+		void BeginTransientFrame(uint32_t frameIndex);
+
+		void UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos);
+
 		uint32_t GetDescriptorPoolCount() const;
 
 	private:
+		DescriptorPool_VK* CreateTransientDescriptorPool();
+
+	public:
+		const uint32_t TRANSIENT_POOL_CAPACITY = 1024; // Maximal number of descriptor sets per transient pool
+
+	private:
+		struct TransientPoolChain
+		{
+			std::vector<DescriptorPool_VK*> pools;
+			uint32_t activePoolIndex = 0;
+		};
+
+		VkDescriptorSet AllocateFromTransientPoolChain(TransientPoolChain& chain, const DescriptorSetLayout_VK* pLayout);
+
 		LogicalDevice_VK* m_pDevice;
 		std::vector<DescriptorPool_VK*> m_descriptorPools;
+		std::mutex m_poolCreationMutex;
+
+		const uint32_t m_maxFramesInFlight;
+		const uint32_t m_threadSlotCount; // Same as job system thread slots
+		std::atomic<uint32_t> m_transientFrameIndex;
+		std::atomic<uint32_t> m_activeTransientAllocationCount; // For checking that no thread allocates while pools are being reset
+		std::vector<TransientPoolChain> m_transientPoolChains; // Indexed by frame * (thread slot count + 1) + thread slot, each chain is only touched by its owning thread
+		std::mutex m_sharedTransientPoolChainMutex; // Last chain of each frame is shared by threads job system has no slot for
 	};
 }
\ No newline at end of file
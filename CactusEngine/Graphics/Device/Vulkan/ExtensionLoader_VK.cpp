@@ -273,7 +273,13 @@ namespace Engine
 				indices.transferFamily = index;
 			}
 
-			if (indices.isComplete())
+			if (queueFamilies[index].queueCount > 0 && (queueFamilies[index].queueFlags & VK_QUEUE_COMPUTE_BIT)
+				&& !(queueFamilies[index].queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.computeFamily.has_value())
+			{
+				indices.computeFamily = index;
+			}
+
+			if (indices.isComplete() && indices.computeFamily.has_value())
 			{
 				break;
 			}
@@ -11,6 +11,7 @@ namespace Engine
 		std::optional<uint32_t> graphicsFamily;
 		std::optional<uint32_t> presentFamily;
 		std::optional<uint32_t> transferFamily;
+		std::optional<uint32_t> computeFamily; // Optional, only families without graphics support are accepted
 
 		bool isComplete()
 		{
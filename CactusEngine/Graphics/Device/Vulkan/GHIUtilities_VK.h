@@ -43,6 +43,20 @@ namespace Engine
 		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 	}
 
+	inline VkFormat GetStorageCompatibleFormat_VK(VkFormat format)
+	{
+		// sRGB formats cannot be used as storage images, the data is accessed through a UNORM view and encoded manually instead
+		switch (format)
+		{
+		case VK_FORMAT_R8G8B8A8_SRGB:
+			return VK_FORMAT_R8G8B8A8_UNORM;
+		case VK_FORMAT_B8G8R8A8_SRGB:
+			return VK_FORMAT_B8G8R8A8_UNORM;
+		default:
+			return format;
+		}
+	}
+
 	inline VkPipelineStageFlagBits DetermineShaderPipelineStage_VK(EShaderType shaderStage)
 	{
 		switch (shaderStage)
@@ -170,6 +184,17 @@ namespace Engine
 			pipelineStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 			return;
 
+		case VK_IMAGE_LAYOUT_GENERAL:
+			// General layout is only used for storage image access in compute shaders so far
+			accessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			return;
+
+		case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+			accessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			return;
+
 		case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
 			accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 			pipelineStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
@@ -183,6 +208,56 @@ namespace Engine
 		}
 	}
 
+	inline void GetAccessAndStageFromTextureAccess_VK(ETextureAccessType access, VkAccessFlags& accessMask, VkPipelineStageFlags& pipelineStage)
+	{
+		switch (access)
+		{
+		case ETextureAccessType::Undefined:
+			accessMask = 0;
+			pipelineStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			return;
+
+		case ETextureAccessType::FragmentShaderRead:
+			accessMask = VK_ACCESS_SHADER_READ_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+			return;
+
+		case ETextureAccessType::TransferRead:
+			accessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			return;
+
+		case ETextureAccessType::TransferWrite:
+			accessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			return;
+
+		case ETextureAccessType::ColorAttachmentWrite:
+			accessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			return;
+
+		case ETextureAccessType::DepthStencilAttachmentWrite:
+			accessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+			return;
+
+		case ETextureAccessType::ComputeShaderRead:
+			accessMask = VK_ACCESS_SHADER_READ_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			return;
+
+		case ETextureAccessType::ComputeShaderWrite:
+			accessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+			pipelineStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+			return;
+
+		default:
+			LOG_ERROR("Vulkan: Unhandled texture access type: " + std::to_string((uint32_t)access));
+			return;
+		}
+	}
+
 	inline uint32_t DetermineMipmapLevels_VK(uint32_t inputSize)
 	{
 		return (uint32_t)std::floor(std::log2(inputSize)) + 1;
@@ -213,12 +288,39 @@ namespace Engine
 		case ETextureFormat::D32:
 			return VK_FORMAT_D32_SFLOAT;
 
+		case ETextureFormat::BC1_RGB_UNORM:
+			return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+
+		case ETextureFormat::BC1_RGB_SRGB:
+			return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+
+		case ETextureFormat::BC4_UNORM:
+			return VK_FORMAT_BC4_UNORM_BLOCK;
+
+		case ETextureFormat::BC5_UNORM:
+			return VK_FORMAT_BC5_UNORM_BLOCK;
+
+		case ETextureFormat::BC7_UNORM:
+			return VK_FORMAT_BC7_UNORM_BLOCK;
+
+		case ETextureFormat::BC7_SRGB:
+			return VK_FORMAT_BC7_SRGB_BLOCK;
+
 		case ETextureFormat::RGB32F:
 			return VK_FORMAT_R32G32B32_SFLOAT;
 
 		case ETextureFormat::RG32F:
 			return VK_FORMAT_R32G32_SFLOAT;
 
+		case ETextureFormat::RGBA16_UNORM:
+			return VK_FORMAT_R16G16B16A16_UNORM;
+
+		case ETextureFormat::RGB10A2_SNORM:
+			return VK_FORMAT_A2B10G10R10_SNORM_PACK32;
+
+		case ETextureFormat::RG16F:
+			return VK_FORMAT_R16G16_SFLOAT;
+
 		default:
 			return VK_FORMAT_UNDEFINED;
 		}
@@ -242,12 +344,32 @@ namespace Engine
 		case ETextureFormat::D32:
 			return 4U;
 
+		// Size of a 4x4 block
+		case ETextureFormat::BC1_RGB_UNORM:
+		case ETextureFormat::BC1_RGB_SRGB:
+		case ETextureFormat::BC4_UNORM:
+			return 8U;
+
+		case ETextureFormat::BC5_UNORM:
+		case ETextureFormat::BC7_UNORM:
+		case ETextureFormat::BC7_SRGB:
+			return 16U;
+
 		default:
 			LOG_ERROR("Vulkan: Unhandled texture format: " + std::to_string((uint32_t)format));
 			return 4U;
 		}
 	}
 
+	inline VkDeviceSize VulkanTextureLevelSize(ETextureFormat format, uint32_t width, uint32_t height)
+	{
+		if (IsBlockCompressedFormat(format))
+		{
+			return (VkDeviceSize)((width + 3) / 4) * ((height + 3) / 4) * VulkanFormatUnitSize(format);
+		}
+		return (VkDeviceSize)width * height * VulkanFormatUnitSize(format);
+	}
+
 	inline VkDeviceSize VulkanFormatUnitSize(VkFormat format)
 	{
 		switch (format)
@@ -682,6 +804,10 @@ namespace Engine
 		{
 			res |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		}
+		if ((usageFlags & (uint32_t)EDataTransferBufferUsage::Storage) != 0)
+		{
+			res |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		}
 
 		DEBUG_ASSERT_CE(res != 0);
 		return res;
@@ -722,9 +848,15 @@ namespace Engine
 		case ESemaphoreWaitStage::Transfer:
 			return VK_PIPELINE_STAGE_TRANSFER_BIT;
 
+		case ESemaphoreWaitStage::ComputeShader:
+			return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
 		case ESemaphoreWaitStage::BottomOfPipeline:
 			return VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 
+		case ESemaphoreWaitStage::AllCommands:
+			return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
 		default:
 			LOG_ERROR("Vulkan: Unhandled semaphore wait stage: " + std::to_string((uint32_t)stage));
 			return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
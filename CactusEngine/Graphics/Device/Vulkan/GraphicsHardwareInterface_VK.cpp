@@ -5,13 +5,17 @@
 #include "Swapchain_VK.h"
 #include "Pipelines_VK.h"
 #include "Shaders_VK.h"
+#include "QueryPool_VK.h"
 #include "GHIUtilities_VK.h"
 #include "ImageTexture.h"
 #include "RenderTexture.h"
+#include "BuiltInResourcesPath.h"
 #include "Timer.h"
 #include "MemoryAllocator.h"
 
 #include <set>
+#include <map>
+#include <algorithm>
 #if defined(GLFW_IMPLEMENTATION_CE)
 #include <GLFW/glfw3.h>
 #endif
@@ -26,6 +30,12 @@ namespace Engine
 		m_isRunning(false),
 		m_appInfo{},
 		m_pMainDevice(nullptr),
+		m_enableBindlessTexturing(false),
+		m_enableBlockCompression(false),
+		m_enableVertexQuantization(false),
+		m_enableMemoryBudget(false),
+		m_enableTimestampQueries(false),
+		m_timestampValidMask(0),
 		m_pSwapchain(nullptr)
 	{
 
@@ -47,9 +57,21 @@ namespace Engine
 		SetupSyncObjectManager();
 		SetupUploadAllocator();
 		SetupDescriptorAllocator();
+		SetupBindlessResourceTable();
+		SetupUploadManager();
+		SetupPipelineCache();
+		SetupShaderReflectionCache();
+		SetupMipmapGenerator();
 
 		SetupSwapchain();
 
+		CreatePlaceholderTexture();
+
+		if (m_pMainDevice->pBindlessResourceTable)
+		{
+			m_pMainDevice->pBindlessResourceTable->SetFallbackTexture(RegisterBindlessTexture(GetPlaceholderTexture()));
+		}
+
 		m_isRunning = true;
 	}
 
@@ -62,6 +84,17 @@ namespace Engine
 			// TODO: correctly organize the sequence of resource release
 			// ...
 
+			CE_SAFE_DELETE(m_pMainDevice->pUploadManager);
+			CE_SAFE_DELETE(m_pMainDevice->pMipmapGenerator);
+			CE_SAFE_DELETE(m_pMainDevice->pBindlessResourceTable);
+
+			// Pipelines created during this run are only persisted on a clean shutdown
+			m_pMainDevice->pPipelineCache->SaveToFile();
+			CE_SAFE_DELETE(m_pMainDevice->pPipelineCache);
+
+			m_pMainDevice->pShaderReflectionCache->LogStatistics();
+			CE_SAFE_DELETE(m_pMainDevice->pShaderReflectionCache);
+
 			vkDestroyDevice(m_pMainDevice->logicalDevice, nullptr);
 
 			if (m_enableValidationLayers)
@@ -103,6 +136,22 @@ namespace Engine
 		return pShaderProgram;
 	}
 
+	ShaderProgram* GraphicsHardwareInterface_VK::CreateComputeShaderProgramFromFile(const char* computeShaderFilePath)
+	{
+		VkShaderModule computeModule = VK_NULL_HANDLE;
+		std::vector<char> computeRawCode;
+
+		CreateShaderModuleFromFile(computeShaderFilePath, m_pMainDevice, computeModule, computeRawCode);
+
+		ComputeShader_VK* pComputeShader;
+		CE_NEW(pComputeShader, ComputeShader_VK, m_pMainDevice, computeModule, computeRawCode);
+
+		ShaderProgram_VK* pShaderProgram;
+		CE_NEW(pShaderProgram, ShaderProgram_VK, this, m_pMainDevice, 1, pComputeShader->GetShaderImpl());
+
+		return pShaderProgram;
+	}
+
 	bool GraphicsHardwareInterface_VK::CreateVertexBuffer(const VertexBufferCreateInfo& createInfo, VertexBuffer*& pOutput)
 	{
 		// We are using directly mapped buffer instead of staging buffer
@@ -111,23 +160,59 @@ namespace Engine
 		RawBufferCreateInfo_VK vertexBufferCreateInfo{};
 		vertexBufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		vertexBufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-		vertexBufferCreateInfo.size = sizeof(float) * createInfo.positionDataCount
-			+ sizeof(float) * createInfo.normalDataCount
-			+ sizeof(float) * createInfo.texcoordDataCount
-			+ sizeof(float) * createInfo.tangentDataCount;
+		vertexBufferCreateInfo.size = (VkDeviceSize)createInfo.GetVertexCount() * createInfo.GetVertexStride();
 		vertexBufferCreateInfo.stride = createInfo.interleavedStride * sizeof(float);
 
 		RawBufferCreateInfo_VK indexBufferCreateInfo{};
 		indexBufferCreateInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 		indexBufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-		indexBufferCreateInfo.size = sizeof(int) * createInfo.indexDataCount;
-		indexBufferCreateInfo.indexFormat = VK_INDEX_TYPE_UINT32;
+		indexBufferCreateInfo.size = (createInfo.useShortIndices ? sizeof(uint16_t) : sizeof(int)) * createInfo.indexDataCount;
+		indexBufferCreateInfo.indexFormat = createInfo.useShortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+		RawBufferCreateInfo_VK positionBufferCreateInfo{};
+		positionBufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+		positionBufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+		positionBufferCreateInfo.size = (VkDeviceSize)createInfo.GetVertexCount() * createInfo.GetPositionStreamStride();
+		positionBufferCreateInfo.stride = createInfo.GetPositionStreamStride();
 
 		// By default vertex data will be created on discrete device, since integrated device will only handle post processing
 		// The alternative is to add a device specifier in VertexBufferCreateInfo
-		CE_NEW(pOutput, VertexBuffer_VK, m_pMainDevice->pUploadAllocator, vertexBufferCreateInfo, indexBufferCreateInfo);
+		CE_NEW(pOutput, VertexBuffer_VK, m_pMainDevice->pUploadAllocator, vertexBufferCreateInfo, indexBufferCreateInfo,
+			createInfo.createPositionStream ? &positionBufferCreateInfo : nullptr);
+
+		// Vertices are interleaved straight into staging memory, without an intermediate copy
+		if (m_pMainDevice->pUploadManager != nullptr)
+		{
+			auto pVertexBuffer = (VertexBuffer_VK*)pOutput;
+
+			// Vertex and index data could end up in different batches if the staging ring wraps in between
+			auto vertexReservation = m_pMainDevice->pUploadManager->ReserveStagingMemory(vertexBufferCreateInfo.size);
+			createInfo.WriteVertexData(vertexReservation.pMappedData);
+			uint64_t vertexUploadValue = m_pMainDevice->pUploadManager->CommitBufferUpload(vertexReservation, pVertexBuffer->GetBufferImpl(),
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+			uint64_t indexUploadValue = m_pMainDevice->pUploadManager->UploadBuffer(createInfo.pIndexData, indexBufferCreateInfo.size, pVertexBuffer->GetIndexBufferImpl(),
+				VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+
+			uint64_t uploadValue = std::max(vertexUploadValue, indexUploadValue);
+
+			// Buffers are not moved by defragmentation until their own data has arrived
+			pVertexBuffer->GetBufferImpl()->MarkUploadValue(vertexUploadValue);
+			pVertexBuffer->GetIndexBufferImpl()->MarkUploadValue(indexUploadValue);
+
+			if (createInfo.createPositionStream)
+			{
+				auto positionReservation = m_pMainDevice->pUploadManager->ReserveStagingMemory(positionBufferCreateInfo.size);
+				createInfo.WritePositionStreamData(positionReservation.pMappedData);
+				uint64_t positionUploadValue = m_pMainDevice->pUploadManager->CommitBufferUpload(positionReservation, pVertexBuffer->GetPositionBufferImpl(),
+					VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+				uploadValue = std::max(uploadValue, positionUploadValue);
+				pVertexBuffer->GetPositionBufferImpl()->MarkUploadValue(positionUploadValue);
+			}
+
+			pOutput->MarkUploadValue(uploadValue);
+			return true;
+		}
 
-		std::vector<float> interleavedVertices = createInfo.ConvertToInterleavedData();
 		void* ppIndexData;
 		void* ppVertexData;
 
@@ -140,7 +225,7 @@ namespace Engine
 		CE_NEW(pVertexStagingBuffer, RawBuffer_VK, m_pMainDevice->pUploadAllocator, vertexStagingBufferCreateInfo);
 
 		m_pMainDevice->pUploadAllocator->MapMemory(pVertexStagingBuffer->m_allocation, &ppVertexData);
-		memcpy(ppVertexData, interleavedVertices.data(), vertexBufferCreateInfo.size);
+		createInfo.WriteVertexData(ppVertexData);
 		m_pMainDevice->pUploadAllocator->UnmapMemory(pVertexStagingBuffer->m_allocation);
 
 		RawBufferCreateInfo_VK indexStagingBufferCreateInfo{};
@@ -171,10 +256,35 @@ namespace Engine
 
 		pCmdBuffer->CopyBufferToBuffer(pIndexStagingBuffer, ((VertexBuffer_VK*)pOutput)->GetIndexBufferImpl(), indexBufferCopyRegion);
 
+		RawBuffer_VK* pPositionStagingBuffer = nullptr;
+		if (createInfo.createPositionStream)
+		{
+			void* ppPositionData;
+
+			RawBufferCreateInfo_VK positionStagingBufferCreateInfo{};
+			positionStagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			positionStagingBufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+			positionStagingBufferCreateInfo.size = positionBufferCreateInfo.size;
+
+			CE_NEW(pPositionStagingBuffer, RawBuffer_VK, m_pMainDevice->pUploadAllocator, positionStagingBufferCreateInfo);
+
+			m_pMainDevice->pUploadAllocator->MapMemory(pPositionStagingBuffer->m_allocation, &ppPositionData);
+			createInfo.WritePositionStreamData(ppPositionData);
+			m_pMainDevice->pUploadAllocator->UnmapMemory(pPositionStagingBuffer->m_allocation);
+
+			VkBufferCopy positionBufferCopyRegion{};
+			positionBufferCopyRegion.srcOffset = 0;
+			positionBufferCopyRegion.dstOffset = 0;
+			positionBufferCopyRegion.size = positionBufferCreateInfo.size;
+
+			pCmdBuffer->CopyBufferToBuffer(pPositionStagingBuffer, ((VertexBuffer_VK*)pOutput)->GetPositionBufferImpl(), positionBufferCopyRegion);
+		}
+
 		m_pMainDevice->pGraphicsCommandManager->SubmitSingleCommandBuffer_Immediate(pCmdBuffer);
 
 		CE_DELETE(pVertexStagingBuffer);
 		CE_DELETE(pIndexStagingBuffer);
+		CE_SAFE_DELETE(pPositionStagingBuffer);
 
 		return true;
 	}
@@ -182,29 +292,47 @@ namespace Engine
 	bool GraphicsHardwareInterface_VK::CreateTexture2D(const Texture2DCreateInfo& createInfo, Texture2D*& pOutput)
 	{
 		Texture2DCreateInfo_VK tex2dCreateInfo{};
-		tex2dCreateInfo.extent = { createInfo.textureWidth, createInfo.textureHeight };
-		tex2dCreateInfo.format = VulkanImageFormat(createInfo.format);
-		tex2dCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL; // Alert: TILING_OPTIMAL could be incompatible with certain formats on certain devices
-		tex2dCreateInfo.usage = DetermineImageUsage_VK(createInfo.textureType);
-		tex2dCreateInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-		tex2dCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		tex2dCreateInfo.aspect = createInfo.textureType == ETextureType::DepthAttachment ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-		tex2dCreateInfo.mipLevels = (createInfo.generateMipmap || createInfo.reserveMipmapMemory) ? DetermineMipmapLevels_VK(std::max<uint32_t>(createInfo.textureWidth, createInfo.textureHeight)) : 1;
+		ConvertTexture2DCreateInfo(createInfo, tex2dCreateInfo);
+
+		if (createInfo.pTransientMemory != nullptr)
+		{
+			tex2dCreateInfo.aliasingAllocation = ((TransientMemoryBlock_VK*)createInfo.pTransientMemory)->m_allocation;
+		}
 	
 		auto pDevice = m_pMainDevice;
 
 		CE_NEW(pOutput, Texture2D_VK, pDevice, tex2dCreateInfo);
 		auto pVkTexture2D = (Texture2D_VK*)pOutput;
 
+		if (createInfo.pTextureData != nullptr && pDevice->pUploadManager != nullptr)
+		{
+			std::vector<VkBufferImageCopy> copyRegions;
+			VkDeviceSize size = GetTexture2DCopyRegions(createInfo, copyRegions);
+
+			// Mipmap generation and layout transition are recorded on graphics queue once the copy is acquired
+			uint64_t uploadValue = pDevice->pUploadManager->UploadTexture2D(createInfo.pTextureData, size, pVkTexture2D, copyRegions,
+				VulkanImageLayout(createInfo.initialLayout), (uint32_t)EShaderType::Fragment, createInfo.generateMipmap);
+			pOutput->MarkUploadValue(uploadValue);
+
+			if (createInfo.pSampler != nullptr)
+			{
+				pOutput->SetSampler(createInfo.pSampler);
+			}
+
+			return true;
+		}
+
 		auto pCmdBuffer = pDevice->pGraphicsCommandManager->RequestPrimaryCommandBuffer();
 		RawBuffer_VK* pStagingBuffer = nullptr;
 
 		if (createInfo.pTextureData != nullptr)
 		{
+			std::vector<VkBufferImageCopy> copyRegions;
+
 			RawBufferCreateInfo_VK bufferCreateInfo{};
 			bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 			bufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
-			bufferCreateInfo.size = (VkDeviceSize)createInfo.textureWidth * createInfo.textureHeight * VulkanFormatUnitSize(createInfo.format);
+			bufferCreateInfo.size = GetTexture2DCopyRegions(createInfo, copyRegions);
 
 			CE_NEW(pStagingBuffer, RawBuffer_VK, pDevice->pUploadAllocator, bufferCreateInfo);
 
@@ -213,20 +341,6 @@ namespace Engine
 			memcpy(ppData, createInfo.pTextureData, bufferCreateInfo.size);
 			pDevice->pUploadAllocator->UnmapMemory(pStagingBuffer->m_allocation);
 
-			std::vector<VkBufferImageCopy> copyRegions;
-			// Only has one level of data
-			VkBufferImageCopy region{};
-			region.bufferOffset = 0;
-			region.bufferRowLength = 0;  // Tightly packed
-			region.bufferImageHeight = 0;// Tightly packed
-			region.imageSubresource.aspectMask = IsDepthFormat(createInfo.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-			region.imageSubresource.mipLevel = 0;
-			region.imageSubresource.baseArrayLayer = 0;
-			region.imageSubresource.layerCount = 1;
-			region.imageOffset = { 0, 0, 0 };
-			region.imageExtent = { createInfo.textureWidth, createInfo.textureHeight, 1 };
-			copyRegions.emplace_back(region);
-
 			pCmdBuffer->TransitionImageLayout(pVkTexture2D, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0);
 
 			pCmdBuffer->CopyBufferToTexture2D(pStagingBuffer, pVkTexture2D, copyRegions);
@@ -256,6 +370,42 @@ namespace Engine
 		return true;
 	}
 
+	VkDeviceSize GraphicsHardwareInterface_VK::GetTexture2DCopyRegions(const Texture2DCreateInfo& createInfo, std::vector<VkBufferImageCopy>& outRegions) const
+	{
+		uint32_t levelCount = createInfo.generateMipmap ? 1 : std::max<uint32_t>(createInfo.mipLevelCount, 1);
+		VkDeviceSize levelOffset = 0;
+		VkDeviceSize dataSize = 0;
+
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			uint32_t levelWidth = std::max<uint32_t>(createInfo.textureWidth >> level, 1);
+			uint32_t levelHeight = std::max<uint32_t>(createInfo.textureHeight >> level, 1);
+
+			if (createInfo.pMipLevelOffsets != nullptr)
+			{
+				levelOffset = createInfo.pMipLevelOffsets[level];
+			}
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = levelOffset;
+			region.bufferRowLength = 0;  // Tightly packed
+			region.bufferImageHeight = 0;// Tightly packed
+			region.imageSubresource.aspectMask = IsDepthFormat(createInfo.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = level;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { levelWidth, levelHeight, 1 }; // Block compressed levels smaller than a block are padded in data but not in extent
+			outRegions.emplace_back(region);
+
+			VkDeviceSize levelSize = VulkanTextureLevelSize(createInfo.format, levelWidth, levelHeight);
+			dataSize = std::max(dataSize, levelOffset + levelSize);
+			levelOffset += levelSize;
+		}
+
+		return dataSize;
+	}
+
 	bool GraphicsHardwareInterface_VK::CreateFrameBuffer(const FrameBufferCreateInfo& createInfo, FrameBuffer*& pOutput)
 	{
 		DEBUG_ASSERT_CE(pOutput == nullptr);
@@ -288,7 +438,7 @@ namespace Engine
 
 	bool GraphicsHardwareInterface_VK::CreateUniformBufferManager(UniformBufferManager*& pOutput)
 	{
-		CE_NEW(pOutput, UniformBufferManager_VK, m_pMainDevice->pUploadAllocator);
+		CE_NEW(pOutput, UniformBufferManager_VK, m_pMainDevice->pUploadAllocator, (uint32_t)m_pMainDevice->deviceProperties.limits.minUniformBufferOffsetAlignment);
 
 		return pOutput != nullptr;
 	}
@@ -303,6 +453,13 @@ namespace Engine
 		VkImageLayout oldLayout = pTextureVK->m_layout;
 		uint32_t oldStages = pTextureVK->m_appliedStages;
 
+		if (m_pMainDevice->pMipmapGenerator && m_pMainDevice->pMipmapGenerator->CanGenerate(pTextureVK))
+		{
+			// Single dispatch instead of one blit and barrier per level
+			m_pMainDevice->pMipmapGenerator->GenerateMipmap(pCmdBufferVK, pTextureVK, oldLayout, oldStages);
+			return;
+		}
+
 		pCmdBufferVK->TransitionImageLayout(pTextureVK, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0);
 		pCmdBufferVK->GenerateMipmap(pTextureVK, oldLayout, oldStages);
 	}
@@ -552,11 +709,27 @@ namespace Engine
 
 		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
 
+		std::vector<VkDescriptorSetLayout> setLayouts = { *pShaderProgram->GetDescriptorSetLayout()->GetDescriptorSetLayout() };
+		if (pShaderProgram->UsesBindlessResourceTable())
+		{
+			if (!m_pMainDevice->pBindlessResourceTable)
+			{
+				throw std::runtime_error("Vulkan: shader program requires bindless resource table, but bindless texturing is not enabled.");
+				return false;
+			}
+			DEBUG_ASSERT_CE(setLayouts.size() == BindlessResourceTable_VK::DESCRIPTOR_SET_INDEX);
+			setLayouts.emplace_back(m_pMainDevice->pBindlessResourceTable->GetDescriptorSetLayout());
+		}
+
+		VkPushConstantRange pushConstantRange{};
+		bool hasPushConstant = pShaderProgram->GetPushConstantRange(pushConstantRange);
+
 		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
 		pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutCreateInfo.setLayoutCount = 1;
-		pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-		pipelineLayoutCreateInfo.pSetLayouts = pShaderProgram->GetDescriptorSetLayout()->GetDescriptorSetLayout();
+		pipelineLayoutCreateInfo.setLayoutCount = (uint32_t)setLayouts.size();
+		pipelineLayoutCreateInfo.pSetLayouts = setLayouts.data();
+		pipelineLayoutCreateInfo.pushConstantRangeCount = hasPushConstant ? 1 : 0;
+		pipelineLayoutCreateInfo.pPushConstantRanges = hasPushConstant ? &pushConstantRange : nullptr;
 
 		if (vkCreatePipelineLayout(m_pMainDevice->logicalDevice, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
 		{
@@ -599,6 +772,52 @@ namespace Engine
 		return pOutput != nullptr;
 	}
 
+	bool GraphicsHardwareInterface_VK::CreateComputePipelineObject(const ComputePipelineCreateInfo& createInfo, ComputePipelineObject*& pOutput)
+	{
+		auto pShaderProgram = (ShaderProgram_VK*)createInfo.pShaderProgram;
+		DEBUG_ASSERT_CE(pShaderProgram->GetStageCount() == 1 && pShaderProgram->GetPipelineBindPoint() == VK_PIPELINE_BIND_POINT_COMPUTE);
+
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+		std::vector<VkDescriptorSetLayout> setLayouts = { *pShaderProgram->GetDescriptorSetLayout()->GetDescriptorSetLayout() };
+		if (pShaderProgram->UsesBindlessResourceTable())
+		{
+			if (!m_pMainDevice->pBindlessResourceTable)
+			{
+				throw std::runtime_error("Vulkan: shader program requires bindless resource table, but bindless texturing is not enabled.");
+				return false;
+			}
+			DEBUG_ASSERT_CE(setLayouts.size() == BindlessResourceTable_VK::DESCRIPTOR_SET_INDEX);
+			setLayouts.emplace_back(m_pMainDevice->pBindlessResourceTable->GetDescriptorSetLayout());
+		}
+
+		VkPushConstantRange pushConstantRange{};
+		bool hasPushConstant = pShaderProgram->GetPushConstantRange(pushConstantRange);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
+		pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutCreateInfo.setLayoutCount = (uint32_t)setLayouts.size();
+		pipelineLayoutCreateInfo.pSetLayouts = setLayouts.data();
+		pipelineLayoutCreateInfo.pushConstantRangeCount = hasPushConstant ? 1 : 0;
+		pipelineLayoutCreateInfo.pPushConstantRanges = hasPushConstant ? &pushConstantRange : nullptr;
+
+		if (vkCreatePipelineLayout(m_pMainDevice->logicalDevice, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to create compute pipeline layout.\n");
+			return false;
+		}
+
+		VkComputePipelineCreateInfo pipelineCreateInfo{};
+		pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineCreateInfo.stage = pShaderProgram->GetShaderStageCreateInfos()[0];
+		pipelineCreateInfo.layout = pipelineLayout;
+		pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+
+		CE_NEW(pOutput, ComputePipeline_VK, m_pMainDevice, pShaderProgram, pipelineCreateInfo);
+
+		return pOutput != nullptr;
+	}
+
 	void GraphicsHardwareInterface_VK::TransitionImageLayout(Texture2D* pImage, EImageLayout newLayout, uint32_t appliedStages)
 	{
 		TransitionImageLayout(m_pMainDevice->pImplicitCmdBuffer, pImage, newLayout, appliedStages);
@@ -680,6 +899,20 @@ namespace Engine
 				return pDevice->pGraphicsCommandManager->RequestExternalCommandPool();
 			}
 		}
+
+		case EQueueType::Compute:
+		{
+			// Graphics queue also supports compute, so no warning is needed when async compute is not available
+			if (pDevice->pComputeCommandManager != nullptr)
+			{
+				return pDevice->pComputeCommandManager->RequestExternalCommandPool();
+			}
+			else
+			{
+				return pDevice->pGraphicsCommandManager->RequestExternalCommandPool();
+			}
+		}
+
 		default:
 		{
 			LOG_ERROR("Vulkan: Unhandled queue type: " + std::to_string((uint32_t)queueType));
@@ -725,9 +958,31 @@ namespace Engine
 		auto pPipelineVK = (GraphicsPipeline_VK*)pPipeline;
 		auto pCommandBufferVK = (CommandBuffer_VK*)pCommandBuffer;
 
-		pCommandBufferVK->BindPipelineLayout(pPipelineVK->GetPipelineLayout());
+		pCommandBufferVK->BindPipelineLayout(pPipelineVK->GetPipelineLayout(), pPipelineVK->GetShaderProgram()->GetPushConstantSize());
 		pCommandBufferVK->BindPipeline(pPipelineVK->GetBindPoint(), pPipelineVK->GetPipeline());
 		pCommandBufferVK->SetViewport(pPipelineVK->GetViewport(), pPipelineVK->GetScissor());
+
+		if (pPipelineVK->GetShaderProgram()->UsesBindlessResourceTable())
+		{
+			// Bindless table of current frame never changes during the frame, binding it once per pipeline is enough
+			std::vector<VkDescriptorSet> bindlessSets = { m_pMainDevice->pBindlessResourceTable->GetDescriptorSet() };
+			pCommandBufferVK->BindDescriptorSets(pPipelineVK->GetBindPoint(), bindlessSets, BindlessResourceTable_VK::DESCRIPTOR_SET_INDEX);
+		}
+	}
+
+	void GraphicsHardwareInterface_VK::BindComputePipeline(const ComputePipelineObject* pPipeline, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		auto pPipelineVK = (ComputePipeline_VK*)pPipeline;
+		auto pCommandBufferVK = (CommandBuffer_VK*)pCommandBuffer;
+
+		pCommandBufferVK->BindPipelineLayout(pPipelineVK->GetPipelineLayout(), pPipelineVK->GetShaderProgram()->GetPushConstantSize());
+		pCommandBufferVK->BindPipeline(pPipelineVK->GetBindPoint(), pPipelineVK->GetPipeline());
+
+		if (pPipelineVK->GetShaderProgram()->UsesBindlessResourceTable())
+		{
+			std::vector<VkDescriptorSet> bindlessSets = { m_pMainDevice->pBindlessResourceTable->GetDescriptorSet() };
+			pCommandBufferVK->BindDescriptorSets(pPipelineVK->GetBindPoint(), bindlessSets, BindlessResourceTable_VK::DESCRIPTOR_SET_INDEX);
+		}
 	}
 
 	void GraphicsHardwareInterface_VK::BeginRenderPass(const RenderPassObject* pRenderPass, const FrameBuffer* pFrameBuffer, GraphicsCommandBuffer* pCommandBuffer)
@@ -774,7 +1029,7 @@ namespace Engine
 		auto pVkShader = (ShaderProgram_VK*)pShaderProgram;
 
 		std::vector<DesciptorUpdateInfo_VK> updateInfos;
-		DescriptorSet_VK* pTargetDescriptorSet = pVkShader->GetDescriptorSet();
+		VkDescriptorSet targetDescriptorSet = pVkShader->GetDescriptorSet();
 
 		for (auto& item : pTable->m_table)
 		{
@@ -783,7 +1038,7 @@ namespace Engine
 			updateInfo.infoType = VulkanDescriptorResourceType(item.type);
 			updateInfo.dstDescriptorType = VulkanDescriptorType(item.type);
 			updateInfo.dstDescriptorBinding = item.binding;
-			updateInfo.dstDescriptorSet = pTargetDescriptorSet->m_descriptorSet;
+			updateInfo.dstDescriptorSet = targetDescriptorSet;
 			updateInfo.dstArrayElement = 0; // Alert: incorrect if it contains array
 
 			switch (updateInfo.infoType)
@@ -821,7 +1076,7 @@ namespace Engine
 
 				VkDescriptorImageInfo imageInfo{};
 				imageInfo.imageView = pImage->m_imageView;
-				imageInfo.imageLayout = pImage->m_layout;
+				imageInfo.imageLayout = item.type == EDescriptorType::StorageImage ? VK_IMAGE_LAYOUT_GENERAL : pImage->m_layout;
 				if (pImage->HasSampler())
 				{
 					imageInfo.sampler = ((Sampler_VK*)pImage->GetSampler())->m_sampler;
@@ -853,8 +1108,8 @@ namespace Engine
 
 		pVkShader->UpdateDescriptorSets(updateInfos);
 
-		std::vector<DescriptorSet_VK*> descSets = { pTargetDescriptorSet };
-		((CommandBuffer_VK*)pCommandBuffer)->BindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, descSets);
+		std::vector<VkDescriptorSet> descSets = { targetDescriptorSet };
+		((CommandBuffer_VK*)pCommandBuffer)->BindDescriptorSets(pVkShader->GetPipelineBindPoint(), descSets);
 	}
 
 	void GraphicsHardwareInterface_VK::SetVertexBuffer(const VertexBuffer* pVertexBuffer, GraphicsCommandBuffer* pCommandBuffer)
@@ -864,7 +1119,12 @@ namespace Engine
 
 		static VkDeviceSize defaultOffset = 0;
 
-		((CommandBuffer_VK*)pCommandBuffer)->BindVertexBuffer(0, 1, &pBuffer->GetBufferImpl()->m_buffer, &defaultOffset);
+		((CommandBuffer_VK*)pCommandBuffer)->BindVertexBuffer(VERTEX_BINDING, 1, &pBuffer->GetBufferImpl()->m_buffer, &defaultOffset);
+		if (pBuffer->HasPositionStream())
+		{
+			// Position-only pipelines read from their own binding, so both kinds of pipelines can be used with the same bindings
+			((CommandBuffer_VK*)pCommandBuffer)->BindVertexBuffer(POSITION_STREAM_BINDING, 1, &pBuffer->GetPositionBufferImpl()->m_buffer, &defaultOffset);
+		}
 		((CommandBuffer_VK*)pCommandBuffer)->BindIndexBuffer(pBuffer->GetIndexBufferImpl()->m_buffer, 0, pBuffer->GetIndexFormat());
 	}
 
@@ -874,11 +1134,27 @@ namespace Engine
 		((CommandBuffer_VK*)pCommandBuffer)->DrawPrimitiveIndexed(indicesCount, 1, baseIndex, baseVertex);
 	}
 
-	void GraphicsHardwareInterface_VK::DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer)
+	void GraphicsHardwareInterface_VK::DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer, const Vector2& texCoordScale)
 	{
 		// Graphics pipelines should be properly setup in renderer, this function is only responsible for issuing draw call
 		DEBUG_ASSERT_CE(pCommandBuffer != nullptr);
-		((CommandBuffer_VK*)pCommandBuffer)->DrawPrimitive(4, 1);
+
+		auto pCommandBufferVK = (CommandBuffer_VK*)pCommandBuffer;
+
+		// Full-screen quad vertex shader declares texture coordinate scale as its only push constant
+		// Programs whose layout has no push constant range cannot receive it, their shaders use unscaled coordinates
+		float pushConstants[2] = { texCoordScale.x, texCoordScale.y };
+		if (pCommandBufferVK->GetPushConstantSize() >= sizeof(pushConstants))
+		{
+			pCommandBufferVK->PushConstants(VK_SHADER_STAGE_ALL_GRAPHICS, 0, sizeof(pushConstants), pushConstants);
+		}
+		pCommandBufferVK->DrawPrimitive(4, 1);
+	}
+
+	void GraphicsHardwareInterface_VK::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		DEBUG_ASSERT_CE(pCommandBuffer != nullptr);
+		((CommandBuffer_VK*)pCommandBuffer)->Dispatch(groupCountX, groupCountY, groupCountZ);
 	}
 
 	void GraphicsHardwareInterface_VK::FlushCommands(bool waitExecution, bool flushImplicitCommands)
@@ -889,6 +1165,11 @@ namespace Engine
 			cmdBufferSubmitMask |= (uint32_t)ECommandBufferUsageFlagBits_VK::Implicit;
 		}
 
+		if (m_pMainDevice->pUploadManager != nullptr)
+		{
+			m_pMainDevice->pUploadManager->AcquirePendingUploads();
+		}
+
 		auto pSemaphore = m_pMainDevice->pSyncObjectManager->RequestTimelineSemaphore();
 		m_pMainDevice->pGraphicsCommandManager->SubmitCommandBuffers(pSemaphore, cmdBufferSubmitMask);
 
@@ -925,6 +1206,27 @@ namespace Engine
 		}
 	}
 
+	void GraphicsHardwareInterface_VK::FlushComputeCommands(bool waitExecution)
+	{
+		if (m_pMainDevice->pComputeCommandManager == nullptr)
+		{
+			// Compute work has been recorded into graphics queue command buffers
+			FlushCommands(waitExecution, false);
+			return;
+		}
+
+		auto pSemaphore = m_pMainDevice->pSyncObjectManager->RequestTimelineSemaphore();
+		m_pMainDevice->pComputeCommandManager->SubmitCommandBuffers(pSemaphore, (uint32_t)ECommandBufferUsageFlagBits_VK::Explicit);
+
+		if (waitExecution)
+		{
+			if (pSemaphore->Wait(FRAME_TIMEOUT) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Vulkan: Flush compute command timeout.");
+			}
+		}
+	}
+
 	void GraphicsHardwareInterface_VK::WaitSemaphore(GraphicsSemaphore* pSemaphore)
 	{
 		auto pVkSemaphore = (TimelineSemaphore_VK*)pSemaphore;
@@ -935,6 +1237,232 @@ namespace Engine
 	void GraphicsHardwareInterface_VK::WaitIdle()
 	{
 		m_pMainDevice->pGraphicsCommandManager->WaitWorkingQueueIdle();
+		if (m_pMainDevice->pComputeCommandManager != nullptr)
+		{
+			m_pMainDevice->pComputeCommandManager->WaitWorkingQueueIdle();
+		}
+	}
+
+	void GraphicsHardwareInterface_VK::TextureBarriers(const std::vector<TextureBarrierDescription>& barriers, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		// Barriers with identical stage masks are recorded by a single command
+		std::map<std::pair<VkPipelineStageFlags, VkPipelineStageFlags>, std::vector<VkImageMemoryBarrier>> barrierBatches;
+
+		for (const auto& desc : barriers)
+		{
+			DEBUG_ASSERT_CE(desc.pTexture->QuerySource() == ETexture2DSource::RawDeviceTexture);
+			auto pImage = (Texture2D_VK*)desc.pTexture;
+
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.oldLayout = desc.discardContent ? VK_IMAGE_LAYOUT_UNDEFINED : VulkanImageLayout(GetTextureAccessLayout(desc.srcAccess));
+			barrier.newLayout = VulkanImageLayout(GetTextureAccessLayout(desc.dstAccess));
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.image = pImage->m_image;
+			barrier.subresourceRange.aspectMask = pImage->m_aspect;
+			if ((pImage->m_aspect & VK_IMAGE_ASPECT_DEPTH_BIT) && HasStencilComponent_VK(pImage->m_format))
+			{
+				barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+			}
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = pImage->m_mipLevels;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+
+			VkPipelineStageFlags srcStage = 0, dstStage = 0;
+			GetAccessAndStageFromTextureAccess_VK(desc.srcAccess, barrier.srcAccessMask, srcStage);
+			GetAccessAndStageFromTextureAccess_VK(desc.dstAccess, barrier.dstAccessMask, dstStage);
+
+			// Only writes need to be made available, a preceding read just requires execution dependency
+			barrier.srcAccessMask &= VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+			if (desc.crossQueue)
+			{
+				// Source access was made visible by semaphore signal on the other queue, only chain the layout transition after the semaphore wait
+				barrier.srcAccessMask = 0;
+				srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+			}
+
+			barrierBatches[std::make_pair(srcStage, dstStage)].emplace_back(barrier);
+		}
+
+		auto pCommandBufferVK = (CommandBuffer_VK*)pCommandBuffer;
+		for (const auto& batch : barrierBatches)
+		{
+			pCommandBufferVK->ImageMemoryBarriers(batch.first.first, batch.first.second, batch.second);
+		}
+	}
+
+	void GraphicsHardwareInterface_VK::GetTexture2DMemoryRequirements(const Texture2DCreateInfo& createInfo, DeviceMemoryRequirements& outRequirements)
+	{
+		Texture2DCreateInfo_VK tex2dCreateInfo{};
+		ConvertTexture2DCreateInfo(createInfo, tex2dCreateInfo);
+
+		VkMemoryRequirements memoryRequirements{};
+		m_pMainDevice->pUploadAllocator->GetTexture2DMemoryRequirements(tex2dCreateInfo, memoryRequirements);
+
+		outRequirements.size = memoryRequirements.size;
+		outRequirements.alignment = memoryRequirements.alignment;
+		outRequirements.memoryTypeBits = memoryRequirements.memoryTypeBits;
+	}
+
+	bool GraphicsHardwareInterface_VK::CreateTransientMemoryBlock(const DeviceMemoryRequirements& requirements, TransientMemoryBlock*& pOutput)
+	{
+		DEBUG_ASSERT_CE(pOutput == nullptr);
+
+		CE_NEW(pOutput, TransientMemoryBlock_VK, m_pMainDevice, requirements);
+		return pOutput != nullptr;
+	}
+
+	void GraphicsHardwareInterface_VK::GetMemoryStatistics(DeviceMemoryStatistics& outStatistics) const
+	{
+		m_pMainDevice->pUploadAllocator->GetMemoryStatistics(outStatistics);
+	}
+
+	bool GraphicsHardwareInterface_VK::IsTimestampQuerySupported() const
+	{
+		return m_enableTimestampQueries;
+	}
+
+	bool GraphicsHardwareInterface_VK::CreateTimestampQueryPool(uint32_t queryCount, TimestampQueryPool*& pOutput)
+	{
+		DEBUG_ASSERT_CE(m_enableTimestampQueries);
+
+		CE_NEW(pOutput, TimestampQueryPool_VK, m_pMainDevice, queryCount);
+		return pOutput != nullptr;
+	}
+
+	void GraphicsHardwareInterface_VK::ResetTimestampQueries(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		((CommandBuffer_VK*)pCommandBuffer)->ResetQueryPool(((TimestampQueryPool_VK*)pQueryPool)->m_queryPool, firstQuery, queryCount);
+	}
+
+	void GraphicsHardwareInterface_VK::WriteTimestamp(TimestampQueryPool* pQueryPool, uint32_t queryIndex, bool afterPreviousCommands, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		VkPipelineStageFlagBits stage = afterPreviousCommands ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		((CommandBuffer_VK*)pCommandBuffer)->WriteTimestamp(stage, ((TimestampQueryPool_VK*)pQueryPool)->m_queryPool, queryIndex);
+	}
+
+	void GraphicsHardwareInterface_VK::GetTimestampResults(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& outTimestamps)
+	{
+		auto pVkQueryPool = (TimestampQueryPool_VK*)pQueryPool;
+		DEBUG_ASSERT_CE(firstQuery + queryCount <= pVkQueryPool->m_queryCount);
+
+		outTimestamps.assign(queryCount, TIMESTAMP_UNAVAILABLE);
+
+		// Each result is followed by its availability, so that queries that are ready can be read without waiting for the rest
+		std::vector<uint64_t> results(queryCount * 2, 0);
+		VkResult result = vkGetQueryPoolResults(m_pMainDevice->logicalDevice, pVkQueryPool->m_queryPool, firstQuery, queryCount, results.size() * sizeof(uint64_t), results.data(),
+			2 * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+		if (result != VK_SUCCESS && result != VK_NOT_READY)
+		{
+			LOG_ERROR("Vulkan: Failed to get timestamp query results.");
+			return;
+		}
+
+		double timestampPeriod = m_pMainDevice->deviceProperties.limits.timestampPeriod; // In nanoseconds per tick
+		for (uint32_t i = 0; i < queryCount; i++)
+		{
+			if (results[i * 2 + 1] != 0)
+			{
+				outTimestamps[i] = (uint64_t)((results[i * 2] & m_timestampValidMask) * timestampPeriod);
+			}
+		}
+	}
+
+	bool GraphicsHardwareInterface_VK::IsAsyncComputeEnabled() const
+	{
+		return m_pMainDevice->pComputeCommandManager != nullptr;
+	}
+
+	bool GraphicsHardwareInterface_VK::IsBlockCompressionSupported() const
+	{
+		return m_enableBlockCompression;
+	}
+
+	bool GraphicsHardwareInterface_VK::IsVertexQuantizationEnabled() const
+	{
+		return m_enableVertexQuantization;
+	}
+
+	bool GraphicsHardwareInterface_VK::IsAsyncUploadEnabled() const
+	{
+		return m_pMainDevice->pUploadManager != nullptr;
+	}
+
+	bool GraphicsHardwareInterface_VK::IsUploadComplete(uint64_t uploadValue) const
+	{
+		if (m_pMainDevice->pUploadManager == nullptr || uploadValue == 0)
+		{
+			return true;
+		}
+		return m_pMainDevice->pUploadManager->IsUploadComplete(uploadValue);
+	}
+
+	bool GraphicsHardwareInterface_VK::IsBindlessTexturingEnabled() const
+	{
+		return m_pMainDevice->pBindlessResourceTable != nullptr;
+	}
+
+	uint32_t GraphicsHardwareInterface_VK::RegisterBindlessTexture(Texture2D* pTexture, const TextureSampler* pSampler)
+	{
+		DEBUG_ASSERT_CE(IsBindlessTexturingEnabled());
+		DEBUG_ASSERT_CE(pTexture != nullptr);
+
+		Texture2D_VK* pImage = nullptr;
+		switch (pTexture->QuerySource())
+		{
+		case ETexture2DSource::ImageTexture:
+			pImage = (Texture2D_VK*)(((ImageTexture*)pTexture)->GetTexture());
+			break;
+
+		case ETexture2DSource::RenderTexture:
+			pImage = (Texture2D_VK*)(((RenderTexture*)pTexture)->GetTexture());
+			break;
+
+		case ETexture2DSource::RawDeviceTexture:
+			pImage = (Texture2D_VK*)pTexture;
+			break;
+
+		default:
+			throw std::runtime_error("Vulkan: Unhandled texture 2D source type.");
+			return BINDLESS_INVALID_INDEX;
+		}
+
+		if (!pSampler)
+		{
+			pSampler = pImage->HasSampler() ? pImage->GetSampler() : GetTextureSampler(ESamplerAnisotropyLevel::None);
+		}
+
+		// Keyed by device texture, as image textures switch from placeholder to the loaded texture
+		return m_pMainDevice->pBindlessResourceTable->RegisterTexture(pImage->GetResourceID(), pImage->m_imageView, pImage->m_layout, ((Sampler_VK*)pSampler)->m_sampler);
+	}
+
+	uint32_t GraphicsHardwareInterface_VK::RegisterBindlessMaterial(const BindlessMaterialRecord& record)
+	{
+		DEBUG_ASSERT_CE(IsBindlessTexturingEnabled());
+		return m_pMainDevice->pBindlessResourceTable->RegisterMaterial(record);
+	}
+
+	void GraphicsHardwareInterface_VK::UnregisterBindlessMaterial(uint32_t materialIndex)
+	{
+		DEBUG_ASSERT_CE(IsBindlessTexturingEnabled());
+		m_pMainDevice->pBindlessResourceTable->UnregisterMaterial(materialIndex);
+	}
+
+	void GraphicsHardwareInterface_VK::UpdateBindlessMaterial(uint32_t materialIndex, const BindlessMaterialRecord& record)
+	{
+		DEBUG_ASSERT_CE(IsBindlessTexturingEnabled());
+		m_pMainDevice->pBindlessResourceTable->UpdateMaterial(materialIndex, record);
+	}
+
+	void GraphicsHardwareInterface_VK::SetBindlessMaterialIndex(uint32_t materialIndex, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		DEBUG_ASSERT_CE(pCommandBuffer != nullptr);
+		DEBUG_ASSERT_CE(materialIndex != BINDLESS_INVALID_INDEX);
+		((CommandBuffer_VK*)pCommandBuffer)->PushConstants(VK_SHADER_STAGE_ALL_GRAPHICS, 0, sizeof(uint32_t), &materialIndex);
 	}
 
 	void GraphicsHardwareInterface_VK::GetSwapchainImages(std::vector<Texture2D*>& outImages) const
@@ -962,6 +1490,11 @@ namespace Engine
 
 		uint32_t cmdBufferSubmitMask = (uint32_t)ECommandBufferUsageFlagBits_VK::Explicit | (uint32_t)ECommandBufferUsageFlagBits_VK::Implicit;
 
+		if (m_pMainDevice->pUploadManager != nullptr)
+		{
+			m_pMainDevice->pUploadManager->AcquirePendingUploads();
+		}
+
 		auto pRenderFinishSemaphore = m_pMainDevice->pSyncObjectManager->RequestSemaphore();
 		m_pMainDevice->pImplicitCmdBuffer->SignalPresentationSemaphore(pRenderFinishSemaphore);
 		m_renderFinishSemaphores.push(pRenderFinishSemaphore);
@@ -983,6 +1516,13 @@ namespace Engine
 			DEBUG_ASSERT_CE(m_frameSemaphores.size() == m_renderFinishSemaphores.size());
 		}
 
+		// The oldest frame in flight has retired (or the next slot was never used), so its transient descriptor sets can be reclaimed
+		m_pMainDevice->pDescriptorAllocator->BeginTransientFrame((frameIndex + 1) % m_pSwapchain->GetMaxFramesInFlight());
+		if (m_pMainDevice->pBindlessResourceTable)
+		{
+			m_pMainDevice->pBindlessResourceTable->BeginFrame((frameIndex + 1) % m_pSwapchain->GetMaxFramesInFlight());
+		}
+
 		// Becasue command buffers are submitted on a separate thread, we need to make sure pRenderFinishSemaphore
 		// is submitted before we present the frame
 		m_commandSubmissionSemaphore.Wait();
@@ -994,6 +1534,9 @@ namespace Engine
 
 		m_pMainDevice->pImplicitCmdBuffer = m_pMainDevice->pGraphicsCommandManager->RequestPrimaryCommandBuffer();
 
+		// Buffers moved by defragmentation are copied with next frame's implicit commands
+		m_pMainDevice->pUploadAllocator->AdvanceFrame();
+
 		if (presentSuccess)
 		{
 			m_pSwapchain->UpdateBackBuffer(frameIndex);
@@ -1344,6 +1887,10 @@ namespace Engine
 		{
 			uniqueQueueFamilies.emplace(queueFamilyIndices.transferFamily.value());
 		}
+		if (queueFamilyIndices.computeFamily.has_value())
+		{
+			uniqueQueueFamilies.emplace(queueFamilyIndices.computeFamily.value());
+		}
 
 		float queuePriority = 1.0f;
 		for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -1369,9 +1916,70 @@ namespace Engine
 		timelineSemaphoreFeatures.pNext = &maintenance4Feature;
 #endif
 
+		// Enabling descriptor indexing for bindless textures
+		VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{};
+		descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetBindlessTextures())
+		{
+			m_enableBindlessTexturing = CheckBindlessTexturingSupport(descriptorIndexingFeatures);
+			if (m_enableBindlessTexturing)
+			{
+#if defined(VK_KHR_maintenance4)
+				maintenance4Feature.pNext = &descriptorIndexingFeatures;
+#else
+				timelineSemaphoreFeatures.pNext = &descriptorIndexingFeatures;
+#endif
+			}
+			else
+			{
+				LOG_WARNING("Vulkan: Descriptor indexing is not supported by device, bindless texturing is disabled.");
+			}
+		}
+
+		VkPhysicalDeviceFeatures supportedFeatures{};
+		vkGetPhysicalDeviceFeatures(m_pMainDevice->physicalDevice, &supportedFeatures);
+
+		m_enableBlockCompression = supportedFeatures.textureCompressionBC == VK_TRUE;
+		if (!m_enableBlockCompression)
+		{
+			LOG_WARNING("Vulkan: BC texture compression is not supported by device, textures are loaded uncompressed.");
+		}
+
+		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetVertexQuantization())
+		{
+			// 10:10:10:2 SNORM is the only one among quantized attribute formats that is not guaranteed to be supported
+			VkFormat quantizedFormats[] = { VK_FORMAT_R16G16B16A16_UNORM, VK_FORMAT_A2B10G10R10_SNORM_PACK32, VK_FORMAT_R16G16_SFLOAT };
+
+			m_enableVertexQuantization = true;
+			for (auto format : quantizedFormats)
+			{
+				VkFormatProperties formatProperties{};
+				vkGetPhysicalDeviceFormatProperties(m_pMainDevice->physicalDevice, format, &formatProperties);
+				m_enableVertexQuantization &= (formatProperties.bufferFeatures & VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT) != 0;
+			}
+
+			if (!m_enableVertexQuantization)
+			{
+				LOG_WARNING("Vulkan: quantized vertex formats are not supported by device, meshes are created with full precision.");
+			}
+		}
+
+		// Without memory budget, heap sizes are reported as budgets and usage only counts engine allocations
+		m_enableMemoryBudget = CheckDeviceExtensionsSupport_VK(m_pMainDevice->physicalDevice, { VK_EXT_MEMORY_BUDGET_EXTENSION_NAME });
+		if (m_enableMemoryBudget)
+		{
+			m_requiredDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+		else
+		{
+			LOG_WARNING("Vulkan: Memory budget is not supported by device, memory usage estimation is less accurate.");
+		}
+
 		// TODO: configure device features by configuration settings
 		VkPhysicalDeviceFeatures deviceFeatures{};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.textureCompressionBC = m_enableBlockCompression ? VK_TRUE : VK_FALSE;
 
 		VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{};
 		physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
@@ -1435,6 +2043,36 @@ namespace Engine
 			m_pMainDevice->transferQueue.isValid = false;
 		}
 
+		if (queueFamilyIndices.computeFamily.has_value())
+		{
+			m_pMainDevice->computeQueue.type = EQueueType::Compute;
+			m_pMainDevice->computeQueue.queueFamilyIndex = queueFamilyIndices.computeFamily.value();
+			vkGetDeviceQueue(m_pMainDevice->logicalDevice, m_pMainDevice->computeQueue.queueFamilyIndex, 0, &m_pMainDevice->computeQueue.queue);
+		}
+		else
+		{
+			m_pMainDevice->computeQueue.isValid = false;
+		}
+
+		// Per Vulkan spec, queue families with zero timestamp valid bits do not support timestamps; profiled nodes may run on graphics or compute queue
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(m_pMainDevice->physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(m_pMainDevice->physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		uint32_t timestampValidBits = queueFamilies[m_pMainDevice->graphicsQueue.queueFamilyIndex].timestampValidBits;
+		if (queueFamilyIndices.computeFamily.has_value())
+		{
+			timestampValidBits = std::min(timestampValidBits, queueFamilies[queueFamilyIndices.computeFamily.value()].timestampValidBits);
+		}
+
+		m_enableTimestampQueries = timestampValidBits > 0 && m_pMainDevice->deviceProperties.limits.timestampPeriod > 0.0f;
+		m_timestampValidMask = timestampValidBits >= 64 ? UINT64_MAX : ((1ull << timestampValidBits) - 1);
+		if (!m_enableTimestampQueries)
+		{
+			LOG_WARNING("Vulkan: Timestamp queries are not supported by device, GPU profiling is disabled.");
+		}
+
 		DEBUG_LOG_MESSAGE((std::string)"Vulkan: Logical device created on " + m_pMainDevice->deviceProperties.deviceName);
 	}
 
@@ -1541,6 +2179,19 @@ namespace Engine
 			m_pMainDevice->pTransferCommandManager = nullptr;
 		}
 
+		if (m_pMainDevice->computeQueue.isValid && gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetAsyncCompute())
+		{
+			CE_NEW(m_pMainDevice->pComputeCommandManager, CommandManager_VK, m_pMainDevice, m_pMainDevice->computeQueue);
+		}
+		else
+		{
+			if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetAsyncCompute())
+			{
+				LOG_WARNING("Vulkan: Dedicated compute queue is not supported, async compute is disabled.");
+			}
+			m_pMainDevice->pComputeCommandManager = nullptr;
+		}
+
 		m_pMainDevice->pImplicitCmdBuffer = m_pMainDevice->pGraphicsCommandManager->RequestPrimaryCommandBuffer();
 	}
 
@@ -1551,12 +2202,133 @@ namespace Engine
 
 	void GraphicsHardwareInterface_VK::SetupUploadAllocator()
 	{
-		CE_NEW(m_pMainDevice->pUploadAllocator, UploadAllocator_VK, m_pMainDevice, m_instance);
+		CE_NEW(m_pMainDevice->pUploadAllocator, UploadAllocator_VK, m_pMainDevice, m_instance, m_enableMemoryBudget,
+			gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight());
 	}
 
 	void GraphicsHardwareInterface_VK::SetupDescriptorAllocator()
 	{
-		CE_NEW(m_pMainDevice->pDescriptorAllocator, DescriptorAllocator_VK, m_pMainDevice);
+		CE_NEW(m_pMainDevice->pDescriptorAllocator, DescriptorAllocator_VK, m_pMainDevice, gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight());
+	}
+
+	void GraphicsHardwareInterface_VK::SetupBindlessResourceTable()
+	{
+		if (!m_enableBindlessTexturing)
+		{
+			m_pMainDevice->pBindlessResourceTable = nullptr;
+			return;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingProperties descriptorIndexingProperties{};
+		descriptorIndexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+
+		VkPhysicalDeviceProperties2 deviceProperties2{};
+		deviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		deviceProperties2.pNext = &descriptorIndexingProperties;
+
+		vkGetPhysicalDeviceProperties2(m_pMainDevice->physicalDevice, &deviceProperties2);
+
+		uint32_t maxTextureCount = std::min(MAX_BINDLESS_TEXTURE_COUNT, descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages);
+		maxTextureCount = std::min(maxTextureCount, descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+
+		CE_NEW(m_pMainDevice->pBindlessResourceTable, BindlessResourceTable_VK, m_pMainDevice, maxTextureCount, MAX_BINDLESS_MATERIAL_COUNT,
+			gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight());
+	}
+
+	void GraphicsHardwareInterface_VK::SetupMipmapGenerator()
+	{
+		CE_NEW(m_pMainDevice->pMipmapGenerator, MipmapGenerator_VK, this, m_pMainDevice);
+
+		if (!m_pMainDevice->pMipmapGenerator->IsValid())
+		{
+			CE_SAFE_DELETE(m_pMainDevice->pMipmapGenerator);
+		}
+	}
+
+	void GraphicsHardwareInterface_VK::SetupUploadManager()
+	{
+		// Without a separate queue family there is no ownership transfer to overlap with, uploads stay on graphics queue
+		if (m_pMainDevice->pTransferCommandManager == nullptr
+			|| m_pMainDevice->transferQueue.queueFamilyIndex == m_pMainDevice->graphicsQueue.queueFamilyIndex)
+		{
+			m_pMainDevice->pUploadManager = nullptr;
+			return;
+		}
+
+		CE_NEW(m_pMainDevice->pUploadManager, UploadManager_VK, m_pMainDevice);
+	}
+
+	void GraphicsHardwareInterface_VK::SetupPipelineCache()
+	{
+		CE_NEW(m_pMainDevice->pPipelineCache, PipelineCache_VK, m_pMainDevice, BuiltInResourcesPath::PIPELINE_CACHE_VK);
+	}
+
+	void GraphicsHardwareInterface_VK::SetupShaderReflectionCache()
+	{
+		CE_NEW(m_pMainDevice->pShaderReflectionCache, ShaderReflectionCache_VK, BuiltInResourcesPath::SHADER_REFLECTION_CACHE_DIRECTORY_VK);
+	}
+
+	bool GraphicsHardwareInterface_VK::CheckBindlessTexturingSupport(VkPhysicalDeviceDescriptorIndexingFeatures& outFeatures)
+	{
+		VkPhysicalDeviceDescriptorIndexingFeatures supportedFeatures{};
+		supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+
+		VkPhysicalDeviceFeatures2 deviceFeatures2{};
+		deviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		deviceFeatures2.pNext = &supportedFeatures;
+
+		vkGetPhysicalDeviceFeatures2(m_pMainDevice->physicalDevice, &deviceFeatures2);
+
+		if (!supportedFeatures.runtimeDescriptorArray
+			|| !supportedFeatures.shaderSampledImageArrayNonUniformIndexing
+			|| !supportedFeatures.descriptorBindingPartiallyBound
+			|| !supportedFeatures.descriptorBindingSampledImageUpdateAfterBind
+			|| !supportedFeatures.descriptorBindingUpdateUnusedWhilePending)
+		{
+			return false;
+		}
+
+		// Only enable what bindless resource table relies on
+		outFeatures.runtimeDescriptorArray = VK_TRUE;
+		outFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		outFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		outFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		outFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+		return true;
+	}
+
+	void GraphicsHardwareInterface_VK::ConvertTexture2DCreateInfo(const Texture2DCreateInfo& createInfo, Texture2DCreateInfo_VK& outCreateInfo) const
+	{
+		outCreateInfo.extent = { createInfo.textureWidth, createInfo.textureHeight };
+		outCreateInfo.format = VulkanImageFormat(createInfo.format);
+		outCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL; // Alert: TILING_OPTIMAL could be incompatible with certain formats on certain devices
+		outCreateInfo.usage = DetermineImageUsage_VK(createInfo.textureType);
+		outCreateInfo.memoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+		outCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		outCreateInfo.aspect = createInfo.textureType == ETextureType::DepthAttachment ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+		outCreateInfo.mipLevels = (createInfo.generateMipmap || createInfo.reserveMipmapMemory) ? DetermineMipmapLevels_VK(std::max<uint32_t>(createInfo.textureWidth, createInfo.textureHeight)) : std::max<uint32_t>(createInfo.mipLevelCount, 1);
+
+		// Render textures with reserved mipmap memory get their mip chain generated by compute at runtime
+		bool computeMipmap = createInfo.reserveMipmapMemory && m_pMainDevice->pMipmapGenerator && m_pMainDevice->pMipmapGenerator->IsFormatSupported(outCreateInfo.format);
+		if (createInfo.enableStorageAccess || computeMipmap)
+		{
+			outCreateInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+
+			if (GetStorageCompatibleFormat_VK(outCreateInfo.format) != outCreateInfo.format)
+			{
+				// Storage views are created with the UNORM equivalent of sRGB formats
+				outCreateInfo.flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+			}
+		}
+
+		if (createInfo.enableAsyncComputeAccess && m_pMainDevice->pComputeCommandManager != nullptr
+			&& m_pMainDevice->computeQueue.queueFamilyIndex != m_pMainDevice->graphicsQueue.queueFamilyIndex)
+		{
+			// Concurrent sharing avoids queue family ownership transfers, at the cost of possibly disabled compression on some hardware
+			outCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+			outCreateInfo.queueFamilyIndices = { m_pMainDevice->graphicsQueue.queueFamilyIndex, m_pMainDevice->computeQueue.queueFamilyIndex };
+		}
 	}
 
 	EDescriptorResourceType_VK GraphicsHardwareInterface_VK::VulkanDescriptorResourceType(EDescriptorType type) const
@@ -1595,6 +2367,14 @@ namespace Engine
 			outInfo.range = pBuffer->GetSizeInBytes();
 			break;
 		}
+		case EDescriptorType::StorageBuffer:
+		{
+			auto pBuffer = (DataTransferBuffer_VK*)pRes;
+			outInfo.buffer = pBuffer->m_pBufferImpl->m_buffer;
+			outInfo.offset = 0;
+			outInfo.range = pBuffer->m_pBufferImpl->m_deviceSize;
+			break;
+		}
 		default:
 			throw std::runtime_error("Vulkan: Unhandled buffer descriptor type or misclassified buffer descriptor type.");
 		}
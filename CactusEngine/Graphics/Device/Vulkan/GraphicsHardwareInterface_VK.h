@@ -4,6 +4,11 @@
 #include "CommandManager_VK.h"
 #include "UploadAllocator_VK.h"
 #include "DescriptorAllocator_VK.h"
+#include "BindlessResourceTable_VK.h"
+#include "MipmapGenerator_VK.h"
+#include "PipelineCache_VK.h"
+#include "ShaderReflectionCache_VK.h"
+#include "UploadManager_VK.h"
 
 namespace Engine
 {
@@ -20,11 +25,18 @@ namespace Engine
 			presentQueue{},
 			graphicsQueue{},
 			transferQueue{},
+			computeQueue{},
 			pGraphicsCommandManager(nullptr),
 			pTransferCommandManager(nullptr),
+			pComputeCommandManager(nullptr),
 			pUploadAllocator(nullptr),
 			pDescriptorAllocator(nullptr),
 			pSyncObjectManager(nullptr),
+			pBindlessResourceTable(nullptr),
+			pMipmapGenerator(nullptr),
+			pPipelineCache(nullptr),
+			pShaderReflectionCache(nullptr),
+			pUploadManager(nullptr),
 			pImplicitCmdBuffer(nullptr)
 		{
 		}
@@ -37,12 +49,19 @@ namespace Engine
 		CommandQueue_VK presentQueue;
 		CommandQueue_VK graphicsQueue;
 		CommandQueue_VK transferQueue;
+		CommandQueue_VK computeQueue;
 
 		CommandManager_VK*		pGraphicsCommandManager;
 		CommandManager_VK*		pTransferCommandManager;
+		CommandManager_VK*		pComputeCommandManager; // Only created if async compute is enabled and a compute-only queue family exists
 		UploadAllocator_VK*		pUploadAllocator;
 		DescriptorAllocator_VK*	pDescriptorAllocator;
 		SyncObjectManager_VK*	pSyncObjectManager;
+		BindlessResourceTable_VK* pBindlessResourceTable; // Only created if bindless texturing is enabled and supported
+		MipmapGenerator_VK*		pMipmapGenerator; // Blit is used for mipmap generation if the generator is not valid
+		PipelineCache_VK*		pPipelineCache;
+		ShaderReflectionCache_VK* pShaderReflectionCache;
+		UploadManager_VK*		pUploadManager; // Only created if a dedicated transfer queue family exists, otherwise data is uploaded immediately on graphics queue
 
 		CommandBuffer_VK*		pImplicitCmdBuffer; // Command buffer used implicitly inside graphics device, for graphics queue
 	};
@@ -59,6 +78,7 @@ namespace Engine
 		EGraphicsAPIType GetGraphicsAPIType() const override;
 
 		ShaderProgram* CreateShaderProgramFromFile(const char* vertexShaderFilePath, const char* fragmentShaderFilePath) override;
+		ShaderProgram* CreateComputeShaderProgramFromFile(const char* computeShaderFilePath) override;
 
 		bool CreateVertexBuffer(const VertexBufferCreateInfo& createInfo, VertexBuffer*& pOutput) override;
 		bool CreateTexture2D(const Texture2DCreateInfo& createInfo, Texture2D*& pOutput) override;
@@ -78,6 +98,7 @@ namespace Engine
 		bool CreatePipelineMultisampleState(const PipelineMultisampleStateCreateInfo& createInfo, PipelineMultisampleState*& pOutput) override;
 		bool CreatePipelineViewportState(const PipelineViewportStateCreateInfo& createInfo, PipelineViewportState*& pOutput) override;
 		bool CreateGraphicsPipelineObject(const GraphicsPipelineCreateInfo& createInfo, GraphicsPipelineObject*& pOutput) override;
+		bool CreateComputePipelineObject(const ComputePipelineCreateInfo& createInfo, ComputePipelineObject*& pOutput) override;
 
 		void TransitionImageLayout(Texture2D* pImage, EImageLayout newLayout, uint32_t appliedStages) override;
 		void TransitionImageLayout(GraphicsCommandBuffer* pCommandBuffer, Texture2D* pImage, EImageLayout newLayout, uint32_t appliedStages) override;
@@ -90,6 +111,7 @@ namespace Engine
 		GraphicsSemaphore* RequestGraphicsSemaphore(ESemaphoreWaitStage waitStage) override;
 
 		void BindGraphicsPipeline(const GraphicsPipelineObject* pPipeline, GraphicsCommandBuffer* pCommandBuffer) override;
+		void BindComputePipeline(const ComputePipelineObject* pPipeline, GraphicsCommandBuffer* pCommandBuffer) override;
 		void BeginRenderPass(const RenderPassObject* pRenderPass, const FrameBuffer* pFrameBuffer, GraphicsCommandBuffer* pCommandBuffer) override;
 		void EndRenderPass(GraphicsCommandBuffer* pCommandBuffer) override;
 		void EndCommandBuffer(GraphicsCommandBuffer* pCommandBuffer) override;
@@ -100,13 +122,43 @@ namespace Engine
 		void SetVertexBuffer(const VertexBuffer* pVertexBuffer, GraphicsCommandBuffer* pCommandBuffer = nullptr) override;
 
 		void DrawPrimitive(uint32_t indicesCount, uint32_t baseIndex, uint32_t baseVertex, GraphicsCommandBuffer* pCommandBuffer = nullptr) override;
-		void DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer) override;
+		void DrawFullScreenQuad(GraphicsCommandBuffer* pCommandBuffer, const Vector2& texCoordScale) override;
+		void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ, GraphicsCommandBuffer* pCommandBuffer) override;
 
 		void FlushCommands(bool waitExecution, bool flushImplicitCommands) override;
 		void FlushTransferCommands(bool waitExecution) override;
+		void FlushComputeCommands(bool waitExecution) override;
 		void WaitSemaphore(GraphicsSemaphore* pSemaphore) override;
 		void WaitIdle() override;
 
+		void TextureBarriers(const std::vector<TextureBarrierDescription>& barriers, GraphicsCommandBuffer* pCommandBuffer) override;
+
+		void GetTexture2DMemoryRequirements(const Texture2DCreateInfo& createInfo, DeviceMemoryRequirements& outRequirements) override;
+		bool CreateTransientMemoryBlock(const DeviceMemoryRequirements& requirements, TransientMemoryBlock*& pOutput) override;
+
+		void GetMemoryStatistics(DeviceMemoryStatistics& outStatistics) const override;
+
+		bool IsTimestampQuerySupported() const override;
+		bool CreateTimestampQueryPool(uint32_t queryCount, TimestampQueryPool*& pOutput) override;
+		void ResetTimestampQueries(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, GraphicsCommandBuffer* pCommandBuffer) override;
+		void WriteTimestamp(TimestampQueryPool* pQueryPool, uint32_t queryIndex, bool afterPreviousCommands, GraphicsCommandBuffer* pCommandBuffer) override;
+		void GetTimestampResults(TimestampQueryPool* pQueryPool, uint32_t firstQuery, uint32_t queryCount, std::vector<uint64_t>& outTimestamps) override;
+
+		bool IsAsyncComputeEnabled() const override;
+
+		bool IsBlockCompressionSupported() const override;
+		bool IsVertexQuantizationEnabled() const override;
+
+		bool IsAsyncUploadEnabled() const override;
+		bool IsUploadComplete(uint64_t uploadValue) const override;
+
+		bool IsBindlessTexturingEnabled() const override;
+		uint32_t RegisterBindlessTexture(Texture2D* pTexture, const TextureSampler* pSampler = nullptr) override;
+		uint32_t RegisterBindlessMaterial(const BindlessMaterialRecord& record) override;
+		void UnregisterBindlessMaterial(uint32_t materialIndex) override;
+		void UpdateBindlessMaterial(uint32_t materialIndex, const BindlessMaterialRecord& record) override;
+		void SetBindlessMaterialIndex(uint32_t materialIndex, GraphicsCommandBuffer* pCommandBuffer) override;
+
 		void GetSwapchainImages(std::vector<Texture2D*>& outImages) const override;
 		uint32_t GetSwapchainPresentImageIndex() const override;
 		void Present(uint32_t frameIndex) override;
@@ -143,13 +195,24 @@ namespace Engine
 		void SetupSyncObjectManager();
 		void SetupUploadAllocator();
 		void SetupDescriptorAllocator();
+		void SetupBindlessResourceTable();
+		void SetupMipmapGenerator();
+		void SetupPipelineCache();
+		void SetupShaderReflectionCache();
+		void SetupUploadManager();
+
+		bool CheckBindlessTexturingSupport(VkPhysicalDeviceDescriptorIndexingFeatures& outFeatures);
 
 		// Converter functions
+		void ConvertTexture2DCreateInfo(const Texture2DCreateInfo& createInfo, Texture2DCreateInfo_VK& outCreateInfo) const;
+		VkDeviceSize GetTexture2DCopyRegions(const Texture2DCreateInfo& createInfo, std::vector<VkBufferImageCopy>& outRegions) const; // Returns size of texture data
 		EDescriptorResourceType_VK VulkanDescriptorResourceType(EDescriptorType type) const;
 		void GetBufferInfoByDescriptorType(EDescriptorType type, const RawResource* pRes, VkDescriptorBufferInfo& outInfo);
 
 	public:
 		const uint64_t FRAME_TIMEOUT = 5e9; // 5 seconds
+		const uint32_t MAX_BINDLESS_TEXTURE_COUNT = 4096;
+		const uint32_t MAX_BINDLESS_MATERIAL_COUNT = 4096;
 
 	private:
 #if defined(DEBUG_MODE_CE)
@@ -171,6 +234,12 @@ namespace Engine
 		std::vector<VkExtensionProperties> m_availableExtensions;
 
 		LogicalDevice_VK* m_pMainDevice;
+		bool m_enableBindlessTexturing;
+		bool m_enableBlockCompression;
+		bool m_enableVertexQuantization;
+		bool m_enableMemoryBudget;
+		bool m_enableTimestampQueries;
+		uint64_t m_timestampValidMask; // Bits beyond those reported valid by queue families are undefined
 
 		Swapchain_VK* m_pSwapchain;
 		std::queue<TimelineSemaphore_VK*> m_frameSemaphores;
@@ -0,0 +1,213 @@
+#include "MipmapGenerator_VK.h"
+#include "GraphicsHardwareInterface_VK.h"
+#include "Buffers_VK.h"
+#include "Textures_VK.h"
+#include "Shaders_VK.h"
+#include "Pipelines_VK.h"
+#include "GHIUtilities_VK.h"
+#include "BuiltInResourcesPath.h"
+#include "BuiltInShaderType.h"
+#include "LogUtility.h"
+#include "MemoryAllocator.h"
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+namespace Engine
+{
+	MipmapGenerator_VK::MipmapGenerator_VK(GraphicsHardwareInterface_VK* pDevice, LogicalDevice_VK* pLogicalDevice)
+		: m_pDevice(pDevice),
+		m_pLogicalDevice(pLogicalDevice),
+		m_isValid(false),
+		m_pShaderProgram(nullptr),
+		m_pPipeline(nullptr),
+		m_pCounterBuffer(nullptr),
+		m_nextCounterIndex(0)
+	{
+		CreatePipeline();
+		if (m_isValid)
+		{
+			CreateCounterBuffer();
+		}
+	}
+
+	MipmapGenerator_VK::~MipmapGenerator_VK()
+	{
+		CE_SAFE_DELETE(m_pCounterBuffer);
+		CE_SAFE_DELETE(m_pPipeline);
+		CE_SAFE_DELETE(m_pShaderProgram);
+	}
+
+	bool MipmapGenerator_VK::IsValid() const
+	{
+		return m_isValid;
+	}
+
+	bool MipmapGenerator_VK::IsFormatSupported(VkFormat format) const
+	{
+		if (!m_isValid)
+		{
+			return false;
+		}
+
+		// Shader declares rgba8 storage images
+		if (GetStorageCompatibleFormat_VK(format) != VK_FORMAT_R8G8B8A8_UNORM)
+		{
+			return false;
+		}
+
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(m_pLogicalDevice->physicalDevice, VK_FORMAT_R8G8B8A8_UNORM, &formatProperties);
+		return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT) != 0;
+	}
+
+	bool MipmapGenerator_VK::CanGenerate(const Texture2D_VK* pTexture) const
+	{
+		if (!m_isValid || pTexture->m_mipStorageViews.empty() || pTexture->m_mipLevels <= 1)
+		{
+			return false;
+		}
+
+		// Work group count is bounded by what a single work group can reduce in the second pass
+		return std::max(pTexture->m_extent.width, pTexture->m_extent.height) <= (TILE_SIZE << 6)
+			&& pTexture->m_mipLevels <= MAX_MIP_LEVEL_COUNT
+			&& IsFormatSupported(pTexture->m_format);
+	}
+
+	void MipmapGenerator_VK::GenerateMipmap(CommandBuffer_VK* pCmdBuffer, Texture2D_VK* pTexture, VkImageLayout newLayout, uint32_t appliedStages)
+	{
+		DEBUG_ASSERT_CE(CanGenerate(pTexture));
+		DEBUG_ASSERT_CE(!pCmdBuffer->InRenderPass());
+		DEBUG_ASSERT_CE(newLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+		RecordLayoutTransition(pCmdBuffer, pTexture, VK_IMAGE_LAYOUT_GENERAL, (uint32_t)EShaderType::Compute);
+
+		pCmdBuffer->BindPipelineLayout(m_pPipeline->GetPipelineLayout(), m_pShaderProgram->GetPushConstantSize());
+		pCmdBuffer->BindPipeline(m_pPipeline->GetBindPoint(), m_pPipeline->GetPipeline());
+
+		VkDescriptorSet descriptorSet = m_pShaderProgram->GetDescriptorSet();
+		std::vector<DesciptorUpdateInfo_VK> updateInfos(2);
+
+		updateInfos[0].hasContent = true;
+		updateInfos[0].infoType = EDescriptorResourceType_VK::Image;
+		updateInfos[0].dstDescriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+		updateInfos[0].dstDescriptorBinding = m_pShaderProgram->GetParamBinding(ShaderParamIDs::MIPMAP_LEVEL_IMAGES);
+		updateInfos[0].dstDescriptorSet = descriptorSet;
+		updateInfos[0].dstArrayElement = 0;
+		for (uint32_t i = 0; i < MAX_MIP_LEVEL_COUNT; i++)
+		{
+			// Every array element must be valid, unused ones point to the last level and are never written
+			VkDescriptorImageInfo imageInfo{};
+			imageInfo.imageView = pTexture->m_mipStorageViews[std::min(i, pTexture->m_mipLevels - 1)];
+			imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+			imageInfo.sampler = VK_NULL_HANDLE;
+			updateInfos[0].imageInfos.emplace_back(imageInfo);
+		}
+
+		VkDescriptorBufferInfo bufferInfo{};
+		bufferInfo.buffer = m_pCounterBuffer->m_buffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = VK_WHOLE_SIZE;
+
+		updateInfos[1].hasContent = true;
+		updateInfos[1].infoType = EDescriptorResourceType_VK::Buffer;
+		updateInfos[1].dstDescriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		updateInfos[1].dstDescriptorBinding = m_pShaderProgram->GetParamBinding(ShaderParamIDs::MIPMAP_GENERATION_COUNTERS);
+		updateInfos[1].dstDescriptorSet = descriptorSet;
+		updateInfos[1].dstArrayElement = 0;
+		updateInfos[1].bufferInfos.emplace_back(bufferInfo);
+
+		m_pShaderProgram->UpdateDescriptorSets(updateInfos);
+
+		std::vector<VkDescriptorSet> descSets = { descriptorSet };
+		pCmdBuffer->BindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, descSets);
+
+		uint32_t groupCountX = (pTexture->m_extent.width + TILE_SIZE - 1) / TILE_SIZE;
+		uint32_t groupCountY = (pTexture->m_extent.height + TILE_SIZE - 1) / TILE_SIZE;
+
+		// Alert: dispatches sharing the same counter must not overlap, this holds as long as fewer than MAX_COUNTER_COUNT generations are in flight
+		PushConstants pushConstants{};
+		pushConstants.baseLevelSize[0] = (int32_t)pTexture->m_extent.width;
+		pushConstants.baseLevelSize[1] = (int32_t)pTexture->m_extent.height;
+		pushConstants.mipLevelCount = pTexture->m_mipLevels;
+		pushConstants.workGroupCount = groupCountX * groupCountY;
+		pushConstants.counterIndex = m_nextCounterIndex.fetch_add(1) % MAX_COUNTER_COUNT;
+		pushConstants.isSRGB = GetStorageCompatibleFormat_VK(pTexture->m_format) != pTexture->m_format ? 1 : 0;
+
+		pCmdBuffer->PushConstants(VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &pushConstants);
+		pCmdBuffer->Dispatch(groupCountX, groupCountY, 1);
+
+		RecordLayoutTransition(pCmdBuffer, pTexture, newLayout, appliedStages);
+	}
+
+	void MipmapGenerator_VK::CreatePipeline()
+	{
+		// Compiled shader may be absent, in which case blit based generation is used
+		std::ifstream shaderFile(BuiltInResourcesPath::SHADER_COMPUTE_MIPMAP_GENERATION_VK, std::ios::binary);
+		if (!shaderFile.is_open())
+		{
+			LOG_WARNING("Vulkan: compute mipmap generation shader is not found, fall back to blit.");
+			m_isValid = false;
+			return;
+		}
+		shaderFile.close();
+
+		m_pShaderProgram = (ShaderProgram_VK*)m_pDevice->CreateComputeShaderProgramFromFile(BuiltInResourcesPath::SHADER_COMPUTE_MIPMAP_GENERATION_VK);
+
+		ComputePipelineCreateInfo pipelineCreateInfo{};
+		pipelineCreateInfo.pShaderProgram = m_pShaderProgram;
+
+		ComputePipelineObject* pPipeline = nullptr;
+		m_isValid = m_pDevice->CreateComputePipelineObject(pipelineCreateInfo, pPipeline);
+		m_pPipeline = (ComputePipeline_VK*)pPipeline;
+	}
+
+	void MipmapGenerator_VK::CreateCounterBuffer()
+	{
+		RawBufferCreateInfo_VK bufferCreateInfo{};
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+		bufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+		bufferCreateInfo.size = sizeof(uint32_t) * MAX_COUNTER_COUNT;
+		bufferCreateInfo.stride = sizeof(uint32_t);
+
+		CE_NEW(m_pCounterBuffer, RawBuffer_VK, m_pLogicalDevice->pUploadAllocator, bufferCreateInfo);
+
+		// Counters only need to be zeroed once, the shader restores them after each dispatch
+		void* pMappedData = nullptr;
+		if (!m_pLogicalDevice->pUploadAllocator->MapMemory(m_pCounterBuffer->m_allocation, &pMappedData))
+		{
+			throw std::runtime_error("Vulkan: failed to map mipmap generation counter buffer.");
+			return;
+		}
+		memset(pMappedData, 0, sizeof(uint32_t) * MAX_COUNTER_COUNT);
+		m_pLogicalDevice->pUploadAllocator->UnmapMemory(m_pCounterBuffer->m_allocation);
+	}
+
+	void MipmapGenerator_VK::RecordLayoutTransition(CommandBuffer_VK* pCmdBuffer, Texture2D_VK* pTexture, VkImageLayout newLayout, uint32_t appliedStages) const
+	{
+		// Transition is always recorded even if the layout stays GENERAL, so that storage writes are made visible
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.oldLayout = pTexture->m_layout;
+		barrier.newLayout = newLayout;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = pTexture->m_image;
+		barrier.subresourceRange.aspectMask = pTexture->m_aspect;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = pTexture->m_mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		VkPipelineStageFlags srcStage = 0, dstStage = 0;
+		GetAccessAndStageFromImageLayout_VK(pTexture->m_layout, barrier.srcAccessMask, srcStage, pTexture->m_appliedStages);
+		GetAccessAndStageFromImageLayout_VK(newLayout, barrier.dstAccessMask, dstStage, appliedStages);
+
+		std::vector<VkImageMemoryBarrier> barriers = { barrier };
+		pCmdBuffer->ImageMemoryBarriers(srcStage, dstStage, barriers);
+
+		pTexture->m_layout = newLayout;
+		pTexture->m_appliedStages = appliedStages;
+	}
+}
\ No newline at end of file
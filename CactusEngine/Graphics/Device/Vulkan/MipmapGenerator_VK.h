@@ -0,0 +1,63 @@
+#pragma once
+#include "VulkanIncludes.h"
+
+#include <atomic>
+
+namespace Engine
+{
+	struct LogicalDevice_VK;
+	class  GraphicsHardwareInterface_VK;
+	class  CommandBuffer_VK;
+	class  Texture2D_VK;
+	class  RawBuffer_VK;
+	class  ShaderProgram_VK;
+	class  ComputePipeline_VK;
+
+	// Generates the whole mip chain of a texture in a single compute dispatch
+	// Each work group downsamples a 64x64 tile to 1x1 through shared memory, the last finished work group then reduces the remaining levels
+	class MipmapGenerator_VK
+	{
+	public:
+		MipmapGenerator_VK(GraphicsHardwareInterface_VK* pDevice, LogicalDevice_VK* pLogicalDevice);
+		~MipmapGenerator_VK();
+
+		bool IsValid() const;
+		bool IsFormatSupported(VkFormat format) const;
+		bool CanGenerate(const Texture2D_VK* pTexture) const;
+
+		// Texture layout is transitioned to given layout after generation, same as the blit version in command buffer
+		void GenerateMipmap(CommandBuffer_VK* pCmdBuffer, Texture2D_VK* pTexture, VkImageLayout newLayout, uint32_t appliedStages);
+
+	private:
+		void CreatePipeline();
+		void CreateCounterBuffer();
+
+		void RecordLayoutTransition(CommandBuffer_VK* pCmdBuffer, Texture2D_VK* pTexture, VkImageLayout newLayout, uint32_t appliedStages) const;
+
+	public:
+		static const uint32_t TILE_SIZE = 64; // Must match the tile size in compute shader
+		static const uint32_t MAX_MIP_LEVEL_COUNT = 13; // Up to 4096x4096
+		static const uint32_t MAX_COUNTER_COUNT = 256;
+
+	private:
+		struct PushConstants
+		{
+			int32_t  baseLevelSize[2];
+			uint32_t mipLevelCount;
+			uint32_t workGroupCount;
+			uint32_t counterIndex;
+			uint32_t isSRGB;
+		};
+
+		GraphicsHardwareInterface_VK* m_pDevice;
+		LogicalDevice_VK* m_pLogicalDevice;
+
+		bool m_isValid;
+
+		ShaderProgram_VK* m_pShaderProgram;
+		ComputePipeline_VK* m_pPipeline;
+
+		RawBuffer_VK* m_pCounterBuffer; // Atomic counters recording finished work groups, each dispatch resets its own counter back to zero
+		std::atomic<uint32_t> m_nextCounterIndex;
+	};
+}
\ No newline at end of file
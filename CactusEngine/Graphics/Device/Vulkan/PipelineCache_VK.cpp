@@ -0,0 +1,150 @@
+#include "PipelineCache_VK.h"
+#include "GraphicsHardwareInterface_VK.h"
+#include "LogUtility.h"
+#include "FileUtility.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace Engine
+{
+	PipelineCache_VK::PipelineCache_VK(LogicalDevice_VK* pDevice, const char* filePath)
+		: m_pDevice(pDevice),
+		m_pipelineCache(VK_NULL_HANDLE),
+		m_pFilePath(filePath),
+		m_isLoadedFromFile(false)
+	{
+		std::vector<char> initialData;
+		if (LoadFromFile(initialData))
+		{
+			if (IsCompatible(initialData))
+			{
+				m_isLoadedFromFile = true;
+			}
+			else
+			{
+				LOG_MESSAGE("Vulkan: pipeline cache was created by a different device or driver, it will be rebuilt.");
+				initialData.clear();
+			}
+		}
+
+		VkPipelineCacheCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		createInfo.initialDataSize = initialData.size();
+		createInfo.pInitialData = initialData.empty() ? nullptr : initialData.data();
+
+		VkResult result = vkCreatePipelineCache(m_pDevice->logicalDevice, &createInfo, nullptr, &m_pipelineCache);
+		if (result != VK_SUCCESS && m_isLoadedFromFile)
+		{
+			// Data passed header validation but driver still refused it, start from an empty cache
+			LOG_WARNING("Vulkan: failed to create pipeline cache from file data, it will be rebuilt.");
+			m_isLoadedFromFile = false;
+
+			createInfo.initialDataSize = 0;
+			createInfo.pInitialData = nullptr;
+			result = vkCreatePipelineCache(m_pDevice->logicalDevice, &createInfo, nullptr, &m_pipelineCache);
+		}
+
+		if (result != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to create pipeline cache.");
+			return;
+		}
+
+		if (m_isLoadedFromFile)
+		{
+			LOG_MESSAGE("Vulkan: loaded pipeline cache of " + std::to_string(initialData.size()) + " bytes from " + m_pFilePath);
+		}
+	}
+
+	PipelineCache_VK::~PipelineCache_VK()
+	{
+		vkDestroyPipelineCache(m_pDevice->logicalDevice, m_pipelineCache, nullptr);
+	}
+
+	VkPipelineCache PipelineCache_VK::GetPipelineCache() const
+	{
+		return m_pipelineCache;
+	}
+
+	bool PipelineCache_VK::IsLoadedFromFile() const
+	{
+		return m_isLoadedFromFile;
+	}
+
+	bool PipelineCache_VK::SaveToFile() const
+	{
+		size_t dataSize = 0;
+		if (vkGetPipelineCacheData(m_pDevice->logicalDevice, m_pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0)
+		{
+			LOG_WARNING("Vulkan: failed to retrieve pipeline cache data.");
+			return false;
+		}
+
+		std::vector<char> data(dataSize);
+		if (vkGetPipelineCacheData(m_pDevice->logicalDevice, m_pipelineCache, &dataSize, data.data()) != VK_SUCCESS)
+		{
+			LOG_WARNING("Vulkan: failed to retrieve pipeline cache data.");
+			return false;
+		}
+
+		if (!FileUtility::WriteFileAtomic(m_pFilePath, [&data](std::ostream& fileWriter) { fileWriter.write(data.data(), data.size()); }))
+		{
+			LOG_ERROR((std::string)"Vulkan: cannot write pipeline cache to " + m_pFilePath);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool PipelineCache_VK::LoadFromFile(std::vector<char>& outData) const
+	{
+		std::ifstream fileReader(m_pFilePath, std::ios::binary | std::ios::ate);
+		if (!fileReader.is_open())
+		{
+			return false;
+		}
+
+		std::streamsize fileSize = fileReader.tellg();
+		if (fileSize <= 0)
+		{
+			return false;
+		}
+
+		outData.resize((size_t)fileSize);
+		fileReader.seekg(0);
+		fileReader.read(outData.data(), fileSize);
+
+		return !fileReader.fail();
+	}
+
+	bool PipelineCache_VK::IsCompatible(const std::vector<char>& data) const
+	{
+		// Header layout is defined by Vulkan spec for VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		struct PipelineCacheHeader
+		{
+			uint32_t headerSize;
+			uint32_t headerVersion;
+			uint32_t vendorID;
+			uint32_t deviceID;
+			uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+		};
+
+		if (data.size() < sizeof(PipelineCacheHeader))
+		{
+			return false;
+		}
+
+		PipelineCacheHeader header{};
+		memcpy(&header, data.data(), sizeof(PipelineCacheHeader));
+
+		const VkPhysicalDeviceProperties& properties = m_pDevice->deviceProperties;
+
+		return header.headerSize >= sizeof(PipelineCacheHeader)
+			&& header.headerSize <= data.size()
+			&& header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+			&& header.vendorID == properties.vendorID
+			&& header.deviceID == properties.deviceID
+			&& memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+#include "VulkanIncludes.h"
+
+#include <vector>
+
+namespace Engine
+{
+	struct LogicalDevice_VK;
+
+	// Device level pipeline cache shared by all pipeline creations, its content is persisted to disk across launches
+	// Cache data written by a different GPU or driver is discarded, as the driver would reject it anyway
+	class PipelineCache_VK
+	{
+	public:
+		PipelineCache_VK(LogicalDevice_VK* pDevice, const char* filePath);
+		~PipelineCache_VK();
+
+		VkPipelineCache GetPipelineCache() const;
+		bool IsLoadedFromFile() const;
+
+		bool SaveToFile() const; // Written to a temporary file first, so that an interrupted save never leaves a corrupted cache behind
+
+	private:
+		bool LoadFromFile(std::vector<char>& outData) const;
+		bool IsCompatible(const std::vector<char>& data) const;
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		VkPipelineCache m_pipelineCache;
+		const char* m_pFilePath;
+		bool m_isLoadedFromFile;
+	};
+}
\ No newline at end of file
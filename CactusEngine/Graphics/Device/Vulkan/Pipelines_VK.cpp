@@ -22,11 +22,10 @@ namespace Engine
 		m_pShaderProgram(pShaderProgram),
 		m_pViewportState(nullptr)
 	{
-		// TODO: support creation from cache to reduce startup time
 		m_pipelineLayout = createInfo.layout;
 		m_pipeline = VK_NULL_HANDLE;
 
-		if (vkCreateGraphicsPipelines(pDevice->logicalDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+		if (vkCreateGraphicsPipelines(pDevice->logicalDevice, pDevice->pPipelineCache->GetPipelineCache(), 1, &createInfo, nullptr, &m_pipeline) != VK_SUCCESS)
 		{
 			LOG_ERROR("Vulkan: failed to create graphics pipeline.");
 		}
@@ -60,6 +59,11 @@ namespace Engine
 		return VK_PIPELINE_BIND_POINT_GRAPHICS;
 	}
 
+	const ShaderProgram_VK* GraphicsPipeline_VK::GetShaderProgram() const
+	{
+		return m_pShaderProgram;
+	}
+
 	const VkViewport* GraphicsPipeline_VK::GetViewport() const
 	{
 		DEBUG_ASSERT_CE(m_pViewportState != nullptr);
@@ -72,6 +76,47 @@ namespace Engine
 		return m_pViewportState->GetScissor();
 	}
 
+	ComputePipeline_VK::ComputePipeline_VK(LogicalDevice_VK* pDevice, ShaderProgram_VK* pShaderProgram, VkComputePipelineCreateInfo& createInfo)
+		: m_pDevice(pDevice),
+		m_pShaderProgram(pShaderProgram)
+	{
+		m_pipelineLayout = createInfo.layout;
+		m_pipeline = VK_NULL_HANDLE;
+
+		if (vkCreateComputePipelines(pDevice->logicalDevice, pDevice->pPipelineCache->GetPipelineCache(), 1, &createInfo, nullptr, &m_pipeline) != VK_SUCCESS)
+		{
+			LOG_ERROR("Vulkan: failed to create compute pipeline.");
+		}
+	}
+
+	ComputePipeline_VK::~ComputePipeline_VK()
+	{
+		DEBUG_ASSERT_CE(m_pipeline != VK_NULL_HANDLE);
+
+		vkDestroyPipelineLayout(m_pDevice->logicalDevice, m_pipelineLayout, nullptr);
+		vkDestroyPipeline(m_pDevice->logicalDevice, m_pipeline, nullptr);
+	}
+
+	VkPipeline ComputePipeline_VK::GetPipeline() const
+	{
+		return m_pipeline;
+	}
+
+	VkPipelineLayout ComputePipeline_VK::GetPipelineLayout() const
+	{
+		return m_pipelineLayout;
+	}
+
+	VkPipelineBindPoint ComputePipeline_VK::GetBindPoint() const
+	{
+		return VK_PIPELINE_BIND_POINT_COMPUTE;
+	}
+
+	const ShaderProgram_VK* ComputePipeline_VK::GetShaderProgram() const
+	{
+		return m_pShaderProgram;
+	}
+
 	PipelineVertexInputState_VK::PipelineVertexInputState_VK(const std::vector<VkVertexInputBindingDescription>& bindingDescs, const std::vector<VkVertexInputAttributeDescription>& attributeDescs)
 		: m_vertexBindingDesc(bindingDescs), m_vertexAttributeDesc(attributeDescs)
 	{
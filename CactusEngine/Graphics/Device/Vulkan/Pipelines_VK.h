@@ -33,6 +33,7 @@ namespace Engine
 		VkPipeline GetPipeline() const;
 		VkPipelineLayout GetPipelineLayout() const;
 		VkPipelineBindPoint GetBindPoint() const;
+		const ShaderProgram_VK* GetShaderProgram() const;
 
 		const VkViewport* GetViewport() const;
 		const VkRect2D* GetScissor() const;
@@ -46,6 +47,25 @@ namespace Engine
 		VkPipelineLayout m_pipelineLayout;
 	};
 
+	class ComputePipeline_VK : public ComputePipelineObject
+	{
+	public:
+		ComputePipeline_VK(LogicalDevice_VK* pDevice, ShaderProgram_VK* pShaderProgram, VkComputePipelineCreateInfo& createInfo);
+		~ComputePipeline_VK();
+
+		VkPipeline GetPipeline() const;
+		VkPipelineLayout GetPipelineLayout() const;
+		VkPipelineBindPoint GetBindPoint() const;
+		const ShaderProgram_VK* GetShaderProgram() const;
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		ShaderProgram_VK* m_pShaderProgram;
+
+		VkPipeline m_pipeline;
+		VkPipelineLayout m_pipelineLayout;
+	};
+
 	class PipelineVertexInputState_VK : public PipelineVertexInputState
 	{
 	public:
@@ -0,0 +1,29 @@
+#include "QueryPool_VK.h"
+#include "GraphicsHardwareInterface_VK.h"
+
+namespace Engine
+{
+	TimestampQueryPool_VK::TimestampQueryPool_VK(LogicalDevice_VK* pDevice, uint32_t queryCount)
+		: m_pDevice(pDevice),
+		m_queryPool(VK_NULL_HANDLE),
+		m_queryCount(queryCount)
+	{
+		DEBUG_ASSERT_CE(pDevice);
+
+		VkQueryPoolCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		createInfo.queryCount = queryCount;
+
+		if (vkCreateQueryPool(m_pDevice->logicalDevice, &createInfo, nullptr, &m_queryPool) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: Failed to create timestamp query pool.");
+			return;
+		}
+	}
+
+	TimestampQueryPool_VK::~TimestampQueryPool_VK()
+	{
+		vkDestroyQueryPool(m_pDevice->logicalDevice, m_queryPool, nullptr);
+	}
+}
\ No newline at end of file
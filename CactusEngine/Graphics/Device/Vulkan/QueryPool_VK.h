@@ -0,0 +1,22 @@
+#pragma once
+#include "GraphicsResources.h"
+#include "VulkanIncludes.h"
+
+namespace Engine
+{
+	struct LogicalDevice_VK;
+
+	class TimestampQueryPool_VK : public TimestampQueryPool
+	{
+	public:
+		TimestampQueryPool_VK(LogicalDevice_VK* pDevice, uint32_t queryCount);
+		~TimestampQueryPool_VK();
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		VkQueryPool m_queryPool;
+		uint32_t m_queryCount;
+
+		friend class GraphicsHardwareInterface_VK;
+	};
+}
\ No newline at end of file
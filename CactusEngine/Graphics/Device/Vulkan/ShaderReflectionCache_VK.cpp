@@ -0,0 +1,225 @@
+#include "ShaderReflectionCache_VK.h"
+#include "LogUtility.h"
+#include "FileUtility.h"
+
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+namespace Engine
+{
+	ShaderReflectionCache_VK::ShaderReflectionCache_VK(const char* directoryPath)
+		: m_directoryPath(directoryPath),
+		m_hitCount(0),
+		m_missCount(0),
+		m_hitTime(0),
+		m_missTime(0)
+	{
+		std::error_code errorCode;
+		std::filesystem::create_directories(m_directoryPath, errorCode);
+	}
+
+	uint64_t ShaderReflectionCache_VK::HashCode(const std::vector<char>& rawCode)
+	{
+		return FileUtility::HashFNV1a64(rawCode.data(), rawCode.size());
+	}
+
+	bool ShaderReflectionCache_VK::Load(uint64_t hash, size_t codeSize, VkShaderStageFlagBits stage, ShaderReflection_VK& outReflection)
+	{
+		CacheEntry entry{};
+		bool isLoaded = false;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			auto itr = m_loadedEntries.find(hash);
+			if (itr != m_loadedEntries.end())
+			{
+				entry = itr->second;
+				isLoaded = true;
+			}
+		}
+
+		// File is read without holding the lock, so that shaders loaded in parallel do not wait for each other
+		// If two programs share a shader both may read it, the first entry is kept
+		if (!isLoaded)
+		{
+			if (!ReadFromFile(hash, codeSize, entry.reflection))
+			{
+				return false;
+			}
+			entry.codeSize = codeSize;
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			entry = m_loadedEntries.emplace(hash, entry).first->second;
+		}
+
+		// Code size is compared as well to make hash collisions even less likely to go unnoticed
+		if (entry.codeSize != codeSize || entry.reflection.stage != stage)
+		{
+			return false;
+		}
+
+		outReflection = entry.reflection;
+		return true;
+	}
+
+	void ShaderReflectionCache_VK::Store(uint64_t hash, size_t codeSize, const ShaderReflection_VK& reflection)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			// Same shader could have been reflected by another program in the meantime
+			if (m_loadedEntries.find(hash) != m_loadedEntries.end())
+			{
+				return;
+			}
+
+			CacheEntry entry{};
+			entry.codeSize = codeSize;
+			entry.reflection = reflection;
+			m_loadedEntries.emplace(hash, entry);
+		}
+
+		// Only the thread that added the entry gets here, so the file has a single writer
+		WriteToFile(hash, codeSize, reflection);
+	}
+
+	void ShaderReflectionCache_VK::RecordReflectionTime(bool isCacheHit, int64_t time)
+	{
+		if (isCacheHit)
+		{
+			m_hitCount++;
+			m_hitTime += time;
+		}
+		else
+		{
+			m_missCount++;
+			m_missTime += time;
+		}
+	}
+
+	void ShaderReflectionCache_VK::LogStatistics() const
+	{
+		uint32_t hitCount = m_hitCount.load();
+		uint32_t missCount = m_missCount.load();
+
+		if (hitCount + missCount == 0)
+		{
+			return;
+		}
+
+		// Average per shader in microseconds, cold and warm launches can be compared directly
+		LOG_MESSAGE("Vulkan: shader reflection cache hits: " + std::to_string(hitCount)
+			+ " (" + std::to_string(hitCount > 0 ? m_hitTime.load() / hitCount / 1000 : 0) + " us per shader), misses: " + std::to_string(missCount)
+			+ " (" + std::to_string(missCount > 0 ? m_missTime.load() / missCount / 1000 : 0) + " us per shader).");
+	}
+
+	std::string ShaderReflectionCache_VK::GetFilePath(uint64_t hash) const
+	{
+		char fileName[32];
+		snprintf(fileName, sizeof(fileName), "%016llx.bin", (unsigned long long)hash);
+		return (std::filesystem::path(m_directoryPath) / fileName).string();
+	}
+
+	bool ShaderReflectionCache_VK::ReadFromFile(uint64_t hash, size_t codeSize, ShaderReflection_VK& outReflection) const
+	{
+		std::ifstream fileReader(GetFilePath(hash), std::ios::binary | std::ios::ate);
+		if (!fileReader.is_open())
+		{
+			return false;
+		}
+
+		// Counts stored in the file are checked against its size, so that a truncated or corrupted file is treated as a miss
+		std::streamoff fileSize = fileReader.tellg();
+		fileReader.seekg(0, std::ios::beg);
+		if (fileSize < 0)
+		{
+			return false;
+		}
+
+		auto remainingBytes = [&fileReader, fileSize]()
+		{
+			std::streamoff position = fileReader.tellg();
+			return position < 0 ? (uint64_t)0 : (uint64_t)(fileSize - position);
+		};
+
+		auto readUInt32 = [&fileReader]()
+		{
+			uint32_t value = 0;
+			fileReader.read((char*)&value, sizeof(uint32_t));
+			return value;
+		};
+
+		uint32_t magic = readUInt32();
+		uint32_t version = readUInt32();
+		uint64_t storedHash = 0;
+		fileReader.read((char*)&storedHash, sizeof(uint64_t));
+		uint64_t storedCodeSize = 0;
+		fileReader.read((char*)&storedCodeSize, sizeof(uint64_t));
+
+		if (fileReader.fail() || magic != FILE_MAGIC || version != FILE_VERSION || storedHash != hash || storedCodeSize != (uint64_t)codeSize)
+		{
+			return false;
+		}
+
+		outReflection.stage = (VkShaderStageFlagBits)readUInt32();
+		outReflection.pushConstantSize = readUInt32();
+
+		uint32_t resourceCount = readUInt32();
+		if (fileReader.fail() || resourceCount > remainingBytes() / RESOURCE_RECORD_MIN_SIZE)
+		{
+			return false;
+		}
+
+		outReflection.resources.resize(resourceCount);
+		for (auto& resource : outReflection.resources)
+		{
+			resource.type = (EShaderResourceType_VK)readUInt32();
+			resource.set = readUInt32();
+			resource.binding = readUInt32();
+			resource.descriptorCount = readUInt32();
+
+			uint32_t nameLength = readUInt32();
+			if (fileReader.fail() || resource.type >= EShaderResourceType_VK::COUNT || nameLength > remainingBytes())
+			{
+				return false;
+			}
+
+			resource.name.resize(nameLength);
+			fileReader.read(resource.name.data(), nameLength);
+		}
+
+		return !fileReader.fail();
+	}
+
+	bool ShaderReflectionCache_VK::WriteToFile(uint64_t hash, size_t codeSize, const ShaderReflection_VK& reflection) const
+	{
+		return FileUtility::WriteFileAtomic(GetFilePath(hash).c_str(), [hash, codeSize, &reflection](std::ostream& fileWriter)
+			{
+				auto writeUInt32 = [&fileWriter](uint32_t value)
+				{
+					fileWriter.write((const char*)&value, sizeof(uint32_t));
+				};
+
+				uint64_t storedCodeSize = codeSize;
+
+				writeUInt32(FILE_MAGIC);
+				writeUInt32(FILE_VERSION);
+				fileWriter.write((const char*)&hash, sizeof(uint64_t));
+				fileWriter.write((const char*)&storedCodeSize, sizeof(uint64_t));
+				writeUInt32((uint32_t)reflection.stage);
+				writeUInt32(reflection.pushConstantSize);
+				writeUInt32((uint32_t)reflection.resources.size());
+
+				for (auto& resource : reflection.resources)
+				{
+					writeUInt32((uint32_t)resource.type);
+					writeUInt32(resource.set);
+					writeUInt32(resource.binding);
+					writeUInt32(resource.descriptorCount);
+					writeUInt32((uint32_t)resource.name.size());
+					fileWriter.write(resource.name.data(), resource.name.size());
+				}
+			});
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+#include "VulkanIncludes.h"
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+namespace Engine
+{
+	enum class EShaderResourceType_VK
+	{
+		Uniform = 0,
+		SeparateSampler,
+		SeparateImage,
+		SampledImage,
+		StorageBuffer,
+		StorageImage,
+		SubpassInput,
+		AccelerationStructure,
+		COUNT
+	};
+
+	struct ShaderReflectedResource_VK
+	{
+		EShaderResourceType_VK type;
+		uint32_t set;
+		uint32_t binding;
+		uint32_t descriptorCount;
+		std::string name;
+	};
+
+	// Everything shader program needs from SPIR-V reflection, so that it can be restored without running SPIRV-Cross
+	struct ShaderReflection_VK
+	{
+		VkShaderStageFlagBits stage;
+		uint32_t pushConstantSize;
+		std::vector<ShaderReflectedResource_VK> resources; // Sorted by resource type
+	};
+
+	// Reflection results are stored in one file per shader, named by the hash of its SPIR-V code
+	// Changed shaders produce a new hash, so stale entries are never read; they are left on disk
+	class ShaderReflectionCache_VK
+	{
+	public:
+		ShaderReflectionCache_VK(const char* directoryPath);
+		~ShaderReflectionCache_VK() = default;
+
+		static uint64_t HashCode(const std::vector<char>& rawCode);
+
+		bool Load(uint64_t hash, size_t codeSize, VkShaderStageFlagBits stage, ShaderReflection_VK& outReflection);
+		void Store(uint64_t hash, size_t codeSize, const ShaderReflection_VK& reflection);
+
+		void RecordReflectionTime(bool isCacheHit, int64_t time); // In nanoseconds
+		void LogStatistics() const;
+
+	private:
+		std::string GetFilePath(uint64_t hash) const;
+		bool ReadFromFile(uint64_t hash, size_t codeSize, ShaderReflection_VK& outReflection) const;
+		bool WriteToFile(uint64_t hash, size_t codeSize, const ShaderReflection_VK& reflection) const;
+
+	public:
+		static const uint32_t FILE_MAGIC = 0x46524543; // "CERF"
+		static const uint32_t FILE_VERSION = 1;
+		static const uint32_t RESOURCE_RECORD_MIN_SIZE = 5 * sizeof(uint32_t); // Type, set, binding, descriptor count and name length
+
+	private:
+		struct CacheEntry
+		{
+			size_t codeSize;
+			ShaderReflection_VK reflection;
+		};
+
+		std::string m_directoryPath;
+
+		// Shaders shared by multiple programs are only read from disk once
+		std::unordered_map<uint64_t, CacheEntry> m_loadedEntries;
+		std::mutex m_mutex;
+
+		std::atomic<uint32_t> m_hitCount;
+		std::atomic<uint32_t> m_missCount;
+		std::atomic<int64_t>  m_hitTime;
+		std::atomic<int64_t>  m_missTime;
+	};
+}
\ No newline at end of file
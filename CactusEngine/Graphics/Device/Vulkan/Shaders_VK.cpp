@@ -1,9 +1,12 @@
 #include "Shaders_VK.h"
 #include "GraphicsHardwareInterface_VK.h"
+#include "BindlessResourceTable_VK.h"
 #include "BuiltInShaderType.h"
 #include "MemoryAllocator.h"
+#include "Timer.h"
 
 #include <cstdarg>
+#include <algorithm>
 
 namespace Engine
 {
@@ -43,20 +46,36 @@ namespace Engine
 		return m_pShaderImpl;
 	}
 
+	ComputeShader_VK::ComputeShader_VK(LogicalDevice_VK* pDevice, VkShaderModule shaderModule, std::vector<char>& rawCode, const char* entry)
+	{
+		CE_NEW(m_pShaderImpl, RawShader_VK, pDevice, shaderModule, VK_SHADER_STAGE_COMPUTE_BIT, entry);
+		m_pShaderImpl->m_rawCode = rawCode;
+	}
+
+	RawShader_VK* ComputeShader_VK::GetShaderImpl() const
+	{
+		return m_pShaderImpl;
+	}
+
 	ShaderProgram_VK::ShaderProgram_VK(GraphicsHardwareInterface_VK* pDevice, LogicalDevice_VK* pLogicalDevice, uint32_t shaderCount, ...)
 		: ShaderProgram(0),
 		m_pLogicalDevice(pLogicalDevice),
 		m_pDescriptorSetLayout(nullptr),
 		m_descriptorPoolCreateInfo{},
-		m_descriptorSetAccessIndex(0)
+		m_usesBindlessResourceTable(false),
+		m_pushConstantSize(0)
 	{
 		m_pDevice = pDevice;
 
+		ResourceDescription emptyDesc{};
+		emptyDesc.id = INVALID_SHADER_PARAM_ID;
+		m_resourceTable.resize(ShaderParamIDs::COUNT, emptyDesc);
+
 		va_list vaShaders;
 		va_start(vaShaders, shaderCount); // shaderCount is the parameter preceding the first variable parameter 
 		RawShader_VK* shaderPtr = nullptr;
 
-		m_descriptorPoolCreateInfo.maxDescSetCount = DESCRIPTOR_POOL_CAPACITY;
+		m_descriptorPoolCreateInfo.maxDescSetCount = 1; // Pool sizes are recorded per set, actual pools are owned by descriptor allocator
 
 		m_shaderStages = 0;
 		while (shaderCount > 0)
@@ -80,9 +99,6 @@ namespace Engine
 		va_end(vaShaders);
 
 		CreateDescriptorSetLayout(m_descriptorPoolCreateInfo);
-		CreateNewDescriptorPool();
-
-		AllocateDescriptorSet(1);
 	}
 
 	ShaderProgram_VK::~ShaderProgram_VK()
@@ -95,19 +111,18 @@ namespace Engine
 			}
 		}
 
-		for (auto& pPool : m_descriptorPools)
-		{
-			m_pLogicalDevice->pDescriptorAllocator->DestroyDescriptorPool(pPool);
-		}
+		CE_DELETE(m_pDescriptorSetLayout);
 	}
 
-	uint32_t ShaderProgram_VK::GetParamBinding(const char* paramName) const
+	uint32_t ShaderProgram_VK::GetParamBinding(ShaderParamID paramID) const
 	{
-		if (m_resourceTable.find(paramName) != m_resourceTable.end())
+		DEBUG_ASSERT_CE(paramID < ShaderParamIDs::COUNT);
+
+		if (m_resourceTable[paramID].id != INVALID_SHADER_PARAM_ID)
 		{
-			return m_resourceTable.at(paramName).binding;
+			return m_resourceTable[paramID].binding;
 		}
-		LOG_ERROR(std::string("Vulkan: Parameter name not found: ") + paramName);
+		LOG_ERROR(std::string("Vulkan: Parameter name not found: ") + SHADER_PARAM_NAME_TABLE[paramID]);
 		return -1;
 	}
 
@@ -121,42 +136,77 @@ namespace Engine
 		return m_pipelineShaderStageCreateInfos.data();
 	}
 
-	DescriptorSet_VK* ShaderProgram_VK::GetDescriptorSet()
+	VkDescriptorSet ShaderProgram_VK::GetDescriptorSet()
 	{
-		std::lock_guard<std::mutex> lock(m_descriptorSetGetMutex);
+		return m_pLogicalDevice->pDescriptorAllocator->AllocateTransientDescriptorSet(m_pDescriptorSetLayout);
+	}
 
-		bool flag = true;
-		for (uint32_t i = m_descriptorSetAccessIndex; ; i = (i + 1) % m_descriptorSets.size())
-		{
-			if (!flag && i == m_descriptorSetAccessIndex)
-			{
-				// No available set found, allocate new one
-				AllocateDescriptorSet(1);
+	const DescriptorSetLayout_VK* ShaderProgram_VK::GetDescriptorSetLayout() const
+	{
+		return m_pDescriptorSetLayout;
+	}
 
-				m_descriptorSetAccessIndex = 0;
-				m_descriptorSets[m_descriptorSets.size() - 1]->m_isInUse = true;
-				return m_descriptorSets[m_descriptorSets.size() - 1];
-			}
-			flag = false;
+	bool ShaderProgram_VK::UsesBindlessResourceTable() const
+	{
+		return m_usesBindlessResourceTable;
+	}
 
-			if (!m_descriptorSets[i]->m_isInUse)
-			{
-				m_descriptorSetAccessIndex = (i + 1) % m_descriptorSets.size();
-				m_descriptorSets[i]->m_isInUse = true;
-				return m_descriptorSets[i];
-			}
+	bool ShaderProgram_VK::GetPushConstantRange(VkPushConstantRange& outRange) const
+	{
+		if (m_pushConstantSize == 0)
+		{
+			return false;
 		}
 
-		throw std::runtime_error("Vulkan: Error getting a usable descriptor set.");
-		return VK_NULL_HANDLE;
+		// A single range visible to all graphics stages keeps push calls independent of the consuming stages
+		outRange.stageFlags = (m_shaderStages & (uint32_t)EShaderType::Compute) ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_ALL_GRAPHICS;
+		outRange.offset = 0;
+		outRange.size = m_pushConstantSize;
+
+		return true;
 	}
 
-	const DescriptorSetLayout_VK* ShaderProgram_VK::GetDescriptorSetLayout() const
+	uint32_t ShaderProgram_VK::GetPushConstantSize() const
 	{
-		return m_pDescriptorSetLayout;
+		return m_pushConstantSize;
+	}
+
+	VkPipelineBindPoint ShaderProgram_VK::GetPipelineBindPoint() const
+	{
+		// Compute shader cannot be linked with other stages
+		return (m_shaderStages & (uint32_t)EShaderType::Compute) ? VK_PIPELINE_BIND_POINT_COMPUTE : VK_PIPELINE_BIND_POINT_GRAPHICS;
 	}
 
 	void ShaderProgram_VK::ReflectResources(const RawShader_VK* pShader, DescriptorPoolCreateInfo& descPoolCreateInfo)
+	{
+		int64_t startTime = Timer::TimeSinceStartUp();
+
+		ShaderReflectionCache_VK* pReflectionCache = m_pLogicalDevice->pShaderReflectionCache;
+		uint64_t hash = ShaderReflectionCache_VK::HashCode(pShader->m_rawCode);
+
+		ShaderReflection_VK reflection{};
+		bool isCacheHit = pReflectionCache != nullptr && pReflectionCache->Load(hash, pShader->m_rawCode.size(), pShader->m_shaderStage, reflection);
+		if (!isCacheHit)
+		{
+			ReflectWithCompiler(pShader, reflection);
+
+			if (pReflectionCache != nullptr)
+			{
+				pReflectionCache->Store(hash, pShader->m_rawCode.size(), reflection);
+			}
+		}
+
+		LoadResourceBinding(reflection);
+		LoadResourceDescriptor(reflection, descPoolCreateInfo);
+		LoadPushConstant(reflection);
+
+		if (pReflectionCache != nullptr)
+		{
+			pReflectionCache->RecordReflectionTime(isCacheHit, Timer::TimeSinceStartUp() - startTime);
+		}
+	}
+
+	void ShaderProgram_VK::ReflectWithCompiler(const RawShader_VK* pShader, ShaderReflection_VK& outReflection)
 	{
 		size_t wordCount = pShader->m_rawCode.size() * sizeof(char) / sizeof(uint32_t);
 		DEBUG_ASSERT_CE(wordCount > 0);
@@ -170,285 +220,167 @@ namespace Engine
 		auto activeVars = spvCompiler.get_active_interface_variables();
 		spvCompiler.set_enabled_interface_variables(std::move(activeVars));
 
-		LoadResourceBinding(spvCompiler, shaderRes);
-		LoadResourceDescriptor(spvCompiler, shaderRes, ShaderStageBitsConvert(pShader->m_shaderStage), descPoolCreateInfo);
-	}
+		outReflection.stage = pShader->m_shaderStage;
+		outReflection.pushConstantSize = 0;
+		outReflection.resources.clear();
 
-	void ShaderProgram_VK::LoadResourceBinding(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes)
-	{
+		// Recorded in the order of resource types
 		for (auto& buffer : shaderRes.uniform_buffers)
 		{
-			ResourceDescription desc{};
-			desc.type = EShaderResourceType_VK::Uniform;
-			desc.binding = spvCompiler.get_decoration(buffer.id, spv::DecorationBinding);
-			desc.name = MatchShaderParamName(buffer.name.c_str());
-
-			m_resourceTable.emplace(desc.name, desc);
+			RecordReflectedResource(spvCompiler, buffer, EShaderResourceType_VK::Uniform, buffer.name, 1, outReflection); // Alert: not sure if descriptor count is correct for uniform blocks
 		}
 
-		if (!shaderRes.push_constant_buffers.empty())
+		for (auto& separateSampler : shaderRes.separate_samplers)
 		{
-			LOG_ERROR("Vulkan: Push constant is not supported but is used in a shader.");
+			RecordReflectedResource(spvCompiler, separateSampler, EShaderResourceType_VK::SeparateSampler, spvCompiler.get_name(separateSampler.id), 1, outReflection);
 		}
 
 		for (auto& separateImage : shaderRes.separate_images)
 		{
-			ResourceDescription desc{};
-			desc.type = EShaderResourceType_VK::SeparateImage;
-			desc.binding = spvCompiler.get_decoration(separateImage.id, spv::DecorationBinding);
-			desc.name = MatchShaderParamName(spvCompiler.get_name(separateImage.id).c_str());
-
-			m_resourceTable.emplace(desc.name, desc);
+			RecordReflectedResource(spvCompiler, separateImage, EShaderResourceType_VK::SeparateImage, spvCompiler.get_name(separateImage.id), 1, outReflection);
 		}
 
-		for (auto& separateSampler : shaderRes.separate_samplers)
+		for (auto& sampledImage : shaderRes.sampled_images)
 		{
-			ResourceDescription desc{};
-			desc.type = EShaderResourceType_VK::SeparateSampler;
-			desc.binding = spvCompiler.get_decoration(separateSampler.id, spv::DecorationBinding);
-			desc.name = MatchShaderParamName(spvCompiler.get_name(separateSampler.id).c_str());
-
-			m_resourceTable.emplace(desc.name, desc);
+			RecordReflectedResource(spvCompiler, sampledImage, EShaderResourceType_VK::SampledImage, spvCompiler.get_name(sampledImage.id), 1, outReflection);
 		}
 
-		for (auto& sampledImage : shaderRes.sampled_images)
+		for (auto& storageBuffer : shaderRes.storage_buffers)
 		{
-			ResourceDescription desc{};
-			desc.type = EShaderResourceType_VK::SampledImage;
-			desc.binding = spvCompiler.get_decoration(sampledImage.id, spv::DecorationBinding);
-			desc.name = MatchShaderParamName(spvCompiler.get_name(sampledImage.id).c_str());
+			RecordReflectedResource(spvCompiler, storageBuffer, EShaderResourceType_VK::StorageBuffer, storageBuffer.name, 1, outReflection);
+		}
 
-			m_resourceTable.emplace(desc.name, desc);
+		for (auto& storageImage : shaderRes.storage_images)
+		{
+			// Image arrays are used to write multiple mip levels in one dispatch
+			auto& type = spvCompiler.get_type(storageImage.type_id);
+			RecordReflectedResource(spvCompiler, storageImage, EShaderResourceType_VK::StorageImage, spvCompiler.get_name(storageImage.id), type.array.empty() ? 1 : type.array[0], outReflection);
 		}
 
-		// TODO: handle storage buffers
-		// TODO: handle storage textures
 		// TODO: handle subpass inputs
+
+		for (auto& pushConstant : shaderRes.push_constant_buffers)
+		{
+			auto& type = spvCompiler.get_type(pushConstant.base_type_id);
+			outReflection.pushConstantSize = std::max<uint32_t>(outReflection.pushConstantSize, (uint32_t)spvCompiler.get_declared_struct_size(type));
+		}
 	}
 
-	void ShaderProgram_VK::LoadResourceDescriptor(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo)
+	void ShaderProgram_VK::RecordReflectedResource(const spirv_cross::Compiler& spvCompiler, const spirv_cross::Resource& resource, EShaderResourceType_VK type, const std::string& name, uint32_t descriptorCount, ShaderReflection_VK& outReflection)
 	{
-		// TODO: eliminate duplicate descriptor set create info
-
-		LoadUniformBuffer(spvCompiler, shaderRes, shaderType, descPoolCreateInfo);
-		LoadSeparateSampler(spvCompiler, shaderRes, shaderType, descPoolCreateInfo);
-		LoadSeparateImage(spvCompiler, shaderRes, shaderType, descPoolCreateInfo);
-		LoadImageSampler(spvCompiler, shaderRes, shaderType, descPoolCreateInfo);
-
-		// TODO: handle storage buffers
-		// TODO: handle storage textures
-		// TODO: handle subpass inputs
+		ShaderReflectedResource_VK reflectedResource{};
+		reflectedResource.type = type;
+		reflectedResource.set = spvCompiler.get_decoration(resource.id, spv::DecorationDescriptorSet);
+		reflectedResource.binding = spvCompiler.get_decoration(resource.id, spv::DecorationBinding);
+		reflectedResource.descriptorCount = descriptorCount;
+		reflectedResource.name = name;
+
+		outReflection.resources.emplace_back(reflectedResource);
 	}
 
-	void ShaderProgram_VK::LoadUniformBuffer(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo)
+	void ShaderProgram_VK::LoadResourceBinding(const ShaderReflection_VK& reflection)
 	{
-		uint32_t count = 0;
-
-		for (auto& buffer : shaderRes.uniform_buffers)
+		for (auto& resource : reflection.resources)
 		{
-			VkDescriptorSetLayoutBinding binding{};
-			binding.descriptorCount = 1; // Alert: not sure if this is correct for uniform blocks
-			binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			binding.stageFlags = ShaderTypeConvertToStageBits(shaderType);
-			binding.binding = spvCompiler.get_decoration(buffer.id, spv::DecorationBinding);
-			binding.pImmutableSamplers = nullptr;
-
-			if (descPoolCreateInfo.recordedLayoutBindings.find(binding.binding) == descPoolCreateInfo.recordedLayoutBindings.end())
+			if (IsBindlessTableResource(resource))
 			{
-				descPoolCreateInfo.recordedLayoutBindings.emplace(binding.binding, descPoolCreateInfo.descSetLayoutBindings.size());
-				descPoolCreateInfo.descSetLayoutBindings.emplace_back(binding);
-				count++;
+				m_usesBindlessResourceTable = true;
+				continue;
 			}
-			else // Update stage flags
-			{
-				descPoolCreateInfo.descSetLayoutBindings[descPoolCreateInfo.recordedLayoutBindings.at(binding.binding)].stageFlags |= binding.stageFlags;
-			}
-		}
-
-		if (count > 0)
-		{
-			if (descPoolCreateInfo.recordedPoolSizes.find(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER) == descPoolCreateInfo.recordedPoolSizes.end())
-			{
-				VkDescriptorPoolSize poolSize{};
-				poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-				poolSize.descriptorCount = descPoolCreateInfo.maxDescSetCount * count;
 
-				descPoolCreateInfo.recordedPoolSizes[VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER] = descPoolCreateInfo.descSetPoolSizes.size(); // Record index
-				descPoolCreateInfo.descSetPoolSizes.emplace_back(poolSize);
-			}
-			else
-			{
-				descPoolCreateInfo.descSetPoolSizes[descPoolCreateInfo.recordedPoolSizes.at(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER)].descriptorCount += descPoolCreateInfo.maxDescSetCount * count;
-			}
+			RecordResourceBinding(resource.type, resource.binding, resource.name.c_str());
 		}
 	}
 
-	void ShaderProgram_VK::LoadSeparateSampler(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo)
+	void ShaderProgram_VK::RecordResourceBinding(EShaderResourceType_VK type, uint32_t binding, const char* name)
 	{
-		uint32_t count = 0;
-
-		for (auto& sampler : shaderRes.separate_samplers)
+		ShaderParamID id = MatchShaderParamID(name);
+		if (id == INVALID_SHADER_PARAM_ID)
 		{
-			VkDescriptorSetLayoutBinding binding{};
-			binding.descriptorCount = 1;
-			binding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
-			binding.stageFlags = ShaderTypeConvertToStageBits(shaderType);
-			binding.binding = spvCompiler.get_decoration(sampler.id, spv::DecorationBinding);
-			binding.pImmutableSamplers = nullptr;
-
-			if (descPoolCreateInfo.recordedLayoutBindings.find(binding.binding) == descPoolCreateInfo.recordedLayoutBindings.end())
-			{
-				descPoolCreateInfo.recordedLayoutBindings.emplace(binding.binding, descPoolCreateInfo.descSetLayoutBindings.size());
-				descPoolCreateInfo.descSetLayoutBindings.emplace_back(binding);
-				count++;
-			}
-			else
-			{
-				descPoolCreateInfo.descSetLayoutBindings[descPoolCreateInfo.recordedLayoutBindings.at(binding.binding)].stageFlags |= binding.stageFlags;
-			}
+			return;
 		}
 
-		if (count > 0)
-		{
-			if (descPoolCreateInfo.recordedPoolSizes.find(VK_DESCRIPTOR_TYPE_SAMPLER) == descPoolCreateInfo.recordedPoolSizes.end())
-			{
-				VkDescriptorPoolSize poolSize{};
-				poolSize.type = VK_DESCRIPTOR_TYPE_SAMPLER;
-				poolSize.descriptorCount = descPoolCreateInfo.maxDescSetCount * count;
-
-				descPoolCreateInfo.recordedPoolSizes[VK_DESCRIPTOR_TYPE_SAMPLER] = descPoolCreateInfo.descSetPoolSizes.size(); // Record index
-				descPoolCreateInfo.descSetPoolSizes.emplace_back(poolSize);
-			}
-			else
-			{
-				descPoolCreateInfo.descSetPoolSizes[descPoolCreateInfo.recordedPoolSizes.at(VK_DESCRIPTOR_TYPE_SAMPLER)].descriptorCount += descPoolCreateInfo.maxDescSetCount * count;
-			}
-		}
+		m_resourceTable[id].type = type;
+		m_resourceTable[id].binding = binding;
+		m_resourceTable[id].id = id;
 	}
 
-	void ShaderProgram_VK::LoadSeparateImage(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo)
+	void ShaderProgram_VK::LoadResourceDescriptor(const ShaderReflection_VK& reflection, DescriptorPoolCreateInfo& descPoolCreateInfo)
 	{
-		uint32_t count = 0;
-
-		for (auto& image : shaderRes.separate_images)
-		{
-			VkDescriptorSetLayoutBinding binding{};
-			binding.descriptorCount = 1;
-			binding.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE; // https://github.com/KhronosGroup/SPIRV-Cross/wiki/Reflection-API-user-guide
-			binding.stageFlags = ShaderTypeConvertToStageBits(shaderType);
-			binding.binding = spvCompiler.get_decoration(image.id, spv::DecorationBinding);
-			binding.pImmutableSamplers = nullptr;
-
-			if (descPoolCreateInfo.recordedLayoutBindings.find(binding.binding) == descPoolCreateInfo.recordedLayoutBindings.end())
-			{
-				descPoolCreateInfo.recordedLayoutBindings.emplace(binding.binding, descPoolCreateInfo.descSetLayoutBindings.size());
-				descPoolCreateInfo.descSetLayoutBindings.emplace_back(binding);
-				count++;
-			}
-			else
-			{
-				descPoolCreateInfo.descSetLayoutBindings[descPoolCreateInfo.recordedLayoutBindings.at(binding.binding)].stageFlags |= binding.stageFlags;
-			}
-		}
+		// TODO: eliminate duplicate descriptor set create info
 
-		if (count > 0)
+		for (uint32_t typeIndex = 0; typeIndex < (uint32_t)EShaderResourceType_VK::COUNT; typeIndex++)
 		{
-			if (descPoolCreateInfo.recordedPoolSizes.find(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE) == descPoolCreateInfo.recordedPoolSizes.end())
-			{
-				VkDescriptorPoolSize poolSize{};
-				poolSize.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-				poolSize.descriptorCount = descPoolCreateInfo.maxDescSetCount * count;
+			EShaderResourceType_VK resourceType = (EShaderResourceType_VK)typeIndex;
+			uint32_t count = 0;
 
-				descPoolCreateInfo.recordedPoolSizes[VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE] = descPoolCreateInfo.descSetPoolSizes.size(); // Record index
-				descPoolCreateInfo.descSetPoolSizes.emplace_back(poolSize);
-			}
-			else
+			for (auto& resource : reflection.resources)
 			{
-				descPoolCreateInfo.descSetPoolSizes[descPoolCreateInfo.recordedPoolSizes.at(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE)].descriptorCount += descPoolCreateInfo.maxDescSetCount * count;
+				if (resource.type != resourceType || IsBindlessTableResource(resource))
+				{
+					continue;
+				}
+
+				VkDescriptorSetLayoutBinding binding{};
+				binding.descriptorCount = resource.descriptorCount;
+				binding.descriptorType = ResourceTypeConvertToDescriptorType(resourceType);
+				binding.stageFlags = reflection.stage;
+				binding.binding = resource.binding;
+				binding.pImmutableSamplers = nullptr;
+
+				if (descPoolCreateInfo.recordedLayoutBindings.find(binding.binding) == descPoolCreateInfo.recordedLayoutBindings.end())
+				{
+					descPoolCreateInfo.recordedLayoutBindings.emplace(binding.binding, descPoolCreateInfo.descSetLayoutBindings.size());
+					descPoolCreateInfo.descSetLayoutBindings.emplace_back(binding);
+					count += binding.descriptorCount;
+				}
+				else // Update stage flags
+				{
+					descPoolCreateInfo.descSetLayoutBindings[descPoolCreateInfo.recordedLayoutBindings.at(binding.binding)].stageFlags |= binding.stageFlags;
+				}
 			}
-		}
-	}
 
-	void ShaderProgram_VK::LoadImageSampler(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo)
-	{
-		uint32_t count = 0;
-
-		for (auto& sampledImage : shaderRes.sampled_images)
-		{
-			VkDescriptorSetLayoutBinding binding{};
-			binding.descriptorCount = 1;
-			binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			binding.stageFlags = ShaderTypeConvertToStageBits(shaderType);
-			binding.binding = spvCompiler.get_decoration(sampledImage.id, spv::DecorationBinding);
-			binding.pImmutableSamplers = nullptr;
-
-			if (descPoolCreateInfo.recordedLayoutBindings.find(binding.binding) == descPoolCreateInfo.recordedLayoutBindings.end())
-			{
-				descPoolCreateInfo.recordedLayoutBindings.emplace(binding.binding, descPoolCreateInfo.descSetLayoutBindings.size());
-				descPoolCreateInfo.descSetLayoutBindings.emplace_back(binding);
-				count++;
-			}
-			else // Update stage flags
+			if (count > 0)
 			{
-				descPoolCreateInfo.descSetLayoutBindings[descPoolCreateInfo.recordedLayoutBindings.at(binding.binding)].stageFlags |= binding.stageFlags;
+				VkDescriptorType descriptorType = ResourceTypeConvertToDescriptorType(resourceType);
+
+				if (descPoolCreateInfo.recordedPoolSizes.find(descriptorType) == descPoolCreateInfo.recordedPoolSizes.end())
+				{
+					VkDescriptorPoolSize poolSize{};
+					poolSize.type = descriptorType;
+					poolSize.descriptorCount = descPoolCreateInfo.maxDescSetCount * count;
+
+					descPoolCreateInfo.recordedPoolSizes[descriptorType] = descPoolCreateInfo.descSetPoolSizes.size(); // Record index
+					descPoolCreateInfo.descSetPoolSizes.emplace_back(poolSize);
+				}
+				else
+				{
+					descPoolCreateInfo.descSetPoolSizes[descPoolCreateInfo.recordedPoolSizes.at(descriptorType)].descriptorCount += descPoolCreateInfo.maxDescSetCount * count;
+				}
 			}
 		}
 
-		if (count > 0)
-		{
-			if (descPoolCreateInfo.recordedPoolSizes.find(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER) == descPoolCreateInfo.recordedPoolSizes.end())
-			{
-				VkDescriptorPoolSize poolSize{};
-				poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-				poolSize.descriptorCount = descPoolCreateInfo.maxDescSetCount * count;
-
-				descPoolCreateInfo.recordedPoolSizes[VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER] = descPoolCreateInfo.descSetPoolSizes.size(); // Record index
-				descPoolCreateInfo.descSetPoolSizes.emplace_back(poolSize);
-			}
-			else
-			{
-				descPoolCreateInfo.descSetPoolSizes[descPoolCreateInfo.recordedPoolSizes.at(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)].descriptorCount += descPoolCreateInfo.maxDescSetCount * count;
-			}
-		}
+		// TODO: handle subpass inputs
 	}
 
-	void ShaderProgram_VK::CreateDescriptorSetLayout(const DescriptorPoolCreateInfo& descPoolCreateInfo)
+	void ShaderProgram_VK::LoadPushConstant(const ShaderReflection_VK& reflection)
 	{
-		CE_NEW(m_pDescriptorSetLayout, DescriptorSetLayout_VK, m_pLogicalDevice, descPoolCreateInfo.descSetLayoutBindings);
+		m_pushConstantSize = std::max<uint32_t>(m_pushConstantSize, reflection.pushConstantSize);
 	}
 
-	void ShaderProgram_VK::CreateNewDescriptorPool()
+	bool ShaderProgram_VK::IsBindlessTableResource(const ShaderReflectedResource_VK& resource) const
 	{
-		auto pNewPool = m_pLogicalDevice->pDescriptorAllocator->CreateDescriptorPool(m_descriptorPoolCreateInfo.maxDescSetCount, m_descriptorPoolCreateInfo.descSetPoolSizes);
-		m_descriptorPools.push_back(pNewPool);
+		return resource.set == BindlessResourceTable_VK::DESCRIPTOR_SET_INDEX;
 	}
 
-	void ShaderProgram_VK::AllocateDescriptorSet(uint32_t count)
+	void ShaderProgram_VK::CreateDescriptorSetLayout(const DescriptorPoolCreateInfo& descPoolCreateInfo)
 	{
-		// m_descriptorSetGetMutex is already locked in GetDescriptorSet, so we don't need to lock it here
-
-		std::vector<VkDescriptorSetLayout> layouts(count, *m_pDescriptorSetLayout->GetDescriptorSetLayout());
-
-		for (auto& pPool : m_descriptorPools)
-		{
-			if (pPool->RemainingCapacity() >= count)
-			{
-				pPool->AllocateDescriptorSets(layouts, m_descriptorSets);
-				return;
-			}
-		}
-
-		// All pools are full, create a new one
-
-		CreateNewDescriptorPool();
-		m_descriptorPools.back()->AllocateDescriptorSets(layouts, m_descriptorSets);
+		CE_NEW(m_pDescriptorSetLayout, DescriptorSetLayout_VK, m_pLogicalDevice, descPoolCreateInfo.descSetLayoutBindings);
 	}
 
 	void ShaderProgram_VK::UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos)
 	{
-		DEBUG_ASSERT_CE(!m_descriptorPools.empty());
-
-		m_descriptorPools[0]->UpdateDescriptorSets(updateInfos); // UpdateDescriptorSets does not use pool data, thus we can use any pool
+		m_pLogicalDevice->pDescriptorAllocator->UpdateDescriptorSets(updateInfos);
 	}
 
 	uint32_t ShaderProgram_VK::GetParamTypeSize(const spirv_cross::SPIRType& type)
@@ -600,4 +532,37 @@ namespace Engine
 
 		return VK_SHADER_STAGE_ALL_GRAPHICS;
 	}
+
+	VkDescriptorType ShaderProgram_VK::ResourceTypeConvertToDescriptorType(EShaderResourceType_VK resourceType)
+	{
+		switch (resourceType)
+		{
+		case EShaderResourceType_VK::Uniform:
+			return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+
+		case EShaderResourceType_VK::SeparateSampler:
+			return VK_DESCRIPTOR_TYPE_SAMPLER;
+
+		case EShaderResourceType_VK::SeparateImage:
+			return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE; // https://github.com/KhronosGroup/SPIRV-Cross/wiki/Reflection-API-user-guide
+
+		case EShaderResourceType_VK::SampledImage:
+			return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+
+		case EShaderResourceType_VK::StorageBuffer:
+			return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+		case EShaderResourceType_VK::StorageImage:
+			return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+
+		case EShaderResourceType_VK::SubpassInput:
+			return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+
+		default:
+			throw std::runtime_error("Vulkan: unhandled shader resource type.");
+			break;
+		}
+
+		return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+	}
 }
\ No newline at end of file
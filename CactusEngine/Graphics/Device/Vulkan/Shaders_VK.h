@@ -2,6 +2,7 @@
 #include "GraphicsResources.h"
 #include "UploadAllocator_VK.h"
 #include "DescriptorAllocator_VK.h"
+#include "ShaderReflectionCache_VK.h"
 
 #include <spirv_cross.hpp>
 #include <unordered_map>
@@ -27,6 +28,7 @@ namespace Engine
 		friend class ShaderProgram_VK;
 		friend class VertexShader_VK;
 		friend class FragmentShader_VK;
+		friend class ComputeShader_VK;
 	};
 
 	class VertexShader_VK : public VertexShader
@@ -53,17 +55,16 @@ namespace Engine
 		RawShader_VK* m_pShaderImpl;
 	};
 
-	enum class EShaderResourceType_VK
+	class ComputeShader_VK : public ComputeShader
 	{
-		Uniform = 0,
-		SeparateSampler,
-		SeparateImage,
-		SampledImage,
-		StorageBuffer,
-		StorageImage,
-		SubpassInput,
-		AccelerationStructure,
-		COUNT
+	public:
+		ComputeShader_VK(LogicalDevice_VK* pDevice, VkShaderModule shaderModule, std::vector<char>& rawCode, const char* entry = "main");
+		~ComputeShader_VK() = default;
+
+		RawShader_VK* GetShaderImpl() const;
+
+	private:
+		RawShader_VK* m_pShaderImpl;
 	};
 
 	class ShaderProgram_VK : public ShaderProgram
@@ -72,24 +73,26 @@ namespace Engine
 		ShaderProgram_VK(GraphicsHardwareInterface_VK* pDevice, LogicalDevice_VK* pLogicalDevice, uint32_t shaderCount, ...); // Could also use a pointer array instead of variadic arguments
 		~ShaderProgram_VK();
 
-		uint32_t GetParamBinding(const char* paramName) const override;
+		uint32_t GetParamBinding(ShaderParamID paramID) const override;
 
 		uint32_t GetStageCount() const;
 		const VkPipelineShaderStageCreateInfo* GetShaderStageCreateInfos() const;
 
-		DescriptorSet_VK* GetDescriptorSet();
+		VkDescriptorSet GetDescriptorSet(); // Transient set, valid for current frame only
 		const DescriptorSetLayout_VK* GetDescriptorSetLayout() const;
 		void UpdateDescriptorSets(const std::vector<DesciptorUpdateInfo_VK>& updateInfos);
 
-	private:
-
-		const uint32_t DESCRIPTOR_POOL_CAPACITY = 512; // Maximal number of descriptor sets that can be allocated from a single pool
+		bool UsesBindlessResourceTable() const;
+		bool GetPushConstantRange(VkPushConstantRange& outRange) const; // Returns false if no push constant is declared
+		uint32_t GetPushConstantSize() const;
+		VkPipelineBindPoint GetPipelineBindPoint() const;
 
+	private:
 		struct ResourceDescription
 		{
 			EShaderResourceType_VK type;
 			uint32_t binding;
-			const char* name;
+			ShaderParamID id;
 		};
 
 		struct DescriptorPoolCreateInfo
@@ -106,42 +109,37 @@ namespace Engine
 	private:
 		// Shader reflection functions
 		void ReflectResources(const RawShader_VK* pShader, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void LoadResourceBinding(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes);
-		void LoadResourceDescriptor(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void LoadUniformBuffer(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void LoadSeparateSampler(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void LoadSeparateImage(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void LoadImageSampler(const spirv_cross::Compiler& spvCompiler, const spirv_cross::ShaderResources& shaderRes, EShaderType shaderType, DescriptorPoolCreateInfo& descPoolCreateInfo);
-		// TODO: handle storage buffers
-		// TODO: handle storage textures
+		void ReflectWithCompiler(const RawShader_VK* pShader, ShaderReflection_VK& outReflection); // Invokes SPIRV-Cross, only needed on reflection cache misses
+		void RecordReflectedResource(const spirv_cross::Compiler& spvCompiler, const spirv_cross::Resource& resource, EShaderResourceType_VK type, const std::string& name, uint32_t descriptorCount, ShaderReflection_VK& outReflection);
+		void LoadResourceBinding(const ShaderReflection_VK& reflection);
+		void RecordResourceBinding(EShaderResourceType_VK type, uint32_t binding, const char* name);
+		void LoadResourceDescriptor(const ShaderReflection_VK& reflection, DescriptorPoolCreateInfo& descPoolCreateInfo);
+		void LoadPushConstant(const ShaderReflection_VK& reflection);
+		bool IsBindlessTableResource(const ShaderReflectedResource_VK& resource) const;
 		// TODO: handle subpass inputs
 
-		// Descriptor pool functions
+		// Descriptor set functions
 		void CreateDescriptorSetLayout(const DescriptorPoolCreateInfo& descPoolCreateInfo);
-		void CreateNewDescriptorPool();
-		void AllocateDescriptorSet(uint32_t count);
 
 		// Converter functions
 		uint32_t GetParamTypeSize(const spirv_cross::SPIRType& type);
 		EDataType BasicTypeConvert(const spirv_cross::SPIRType& type);
 		EShaderType ShaderStageBitsConvert(VkShaderStageFlagBits vkShaderStageBits);
 		VkShaderStageFlagBits ShaderTypeConvertToStageBits(EShaderType shaderType);
+		VkDescriptorType ResourceTypeConvertToDescriptorType(EShaderResourceType_VK resourceType);
 
 	private:
 		LogicalDevice_VK* m_pLogicalDevice;
 
-		// Using char pointer as key would benefit runtime performance, but would reduce initialization speed as we need to match pointer by string contents
-		std::unordered_map<const char*, ResourceDescription> m_resourceTable;
+		// Indexed by shader parameter ID; names are only matched once during reflection
+		std::vector<ResourceDescription> m_resourceTable;
 
 		DescriptorSetLayout_VK* m_pDescriptorSetLayout;
 		DescriptorPoolCreateInfo m_descriptorPoolCreateInfo;
 
-		std::vector<DescriptorPool_VK*> m_descriptorPools;
-		std::vector<DescriptorSet_VK*> m_descriptorSets; // Descriptor sets are allocated from pools, and are recycled when they are no longer in use
-
-		uint32_t m_descriptorSetAccessIndex;
-		mutable std::mutex m_descriptorSetGetMutex;
-
 		std::vector<VkPipelineShaderStageCreateInfo> m_pipelineShaderStageCreateInfos;
+
+		bool m_usesBindlessResourceTable; // Resources declared in bindless descriptor set are provided by device, not by shader parameter table
+		uint32_t m_pushConstantSize;
 	};
 }
\ No newline at end of file
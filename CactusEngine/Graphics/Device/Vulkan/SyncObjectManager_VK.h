@@ -52,6 +52,7 @@ namespace Engine
 
 		friend class SyncObjectManager_VK;
 		friend class CommandManager_VK;
+		friend class UploadManager_VK;
 	};
 
 	// TODO: add fallback VkFence support
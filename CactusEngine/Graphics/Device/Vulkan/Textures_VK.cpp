@@ -64,6 +64,22 @@ namespace Engine
 		{
 			LOG_ERROR("Vulkan: failed to create image view for texture 2D.");
 		}
+
+		if (createInfo.usage & VK_IMAGE_USAGE_STORAGE_BIT)
+		{
+			viewCreateInfo.format = GetStorageCompatibleFormat_VK(createInfo.format);
+			viewCreateInfo.subresourceRange.levelCount = 1;
+
+			m_mipStorageViews.resize(createInfo.mipLevels, VK_NULL_HANDLE);
+			for (uint32_t i = 0; i < createInfo.mipLevels; i++)
+			{
+				viewCreateInfo.subresourceRange.baseMipLevel = i;
+				if (vkCreateImageView(m_pDevice->logicalDevice, &viewCreateInfo, nullptr, &m_mipStorageViews[i]) != VK_SUCCESS)
+				{
+					LOG_ERROR("Vulkan: failed to create storage image view for texture 2D.");
+				}
+			}
+		}
 	}
 
 	Texture2D_VK::Texture2D_VK()
@@ -86,13 +102,18 @@ namespace Engine
 
 	Texture2D_VK::~Texture2D_VK()
 	{
+		if (m_pDevice && m_pDevice->pBindlessResourceTable)
+		{
+			m_pDevice->pBindlessResourceTable->UnregisterTexture(GetResourceID());
+		}
+
 		if (m_image != VK_NULL_HANDLE)
 		{
 			if (m_allocatorType == EAllocatorType_VK::VMA)
 			{
 				m_pDevice->pUploadAllocator->FreeImage(m_image, m_allocation);
 			}
-			else if (m_allocatorType == EAllocatorType_VK::VK)
+			else if (m_allocatorType == EAllocatorType_VK::VK || m_allocatorType == EAllocatorType_VK::VMA_Aliasing)
 			{
 				vkDestroyImage(m_pDevice->logicalDevice, m_image, nullptr);
 			}
@@ -104,6 +125,12 @@ namespace Engine
 			vkDestroyImageView(m_pDevice->logicalDevice, m_imageView, nullptr);
 			m_imageView = VK_NULL_HANDLE;
 		}
+
+		for (auto& mipView : m_mipStorageViews)
+		{
+			vkDestroyImageView(m_pDevice->logicalDevice, mipView, nullptr);
+		}
+		m_mipStorageViews.clear();
 	}
 
 	bool Texture2D_VK::HasSampler() const
@@ -157,6 +184,27 @@ namespace Engine
 		}
 	}
 
+	TransientMemoryBlock_VK::TransientMemoryBlock_VK(LogicalDevice_VK* pDevice, const DeviceMemoryRequirements& requirements)
+		: m_pDevice(pDevice),
+		m_allocation(VK_NULL_HANDLE)
+	{
+		DEBUG_ASSERT_CE(pDevice);
+
+		VkMemoryRequirements memoryRequirements{};
+		memoryRequirements.size = requirements.size;
+		memoryRequirements.alignment = requirements.alignment;
+		memoryRequirements.memoryTypeBits = requirements.memoryTypeBits;
+
+		m_pDevice->pUploadAllocator->AllocateMemory(memoryRequirements, VMA_MEMORY_USAGE_GPU_ONLY, m_allocation);
+		MarkSizeInByte((uint32_t)requirements.size);
+	}
+
+	TransientMemoryBlock_VK::~TransientMemoryBlock_VK()
+	{
+		// Alert: all textures placed into this block must no longer be in use
+		m_pDevice->pUploadAllocator->FreeMemory(m_allocation);
+	}
+
 	FrameBuffer_VK::FrameBuffer_VK(LogicalDevice_VK* pDevice)
 		: m_pDevice(pDevice),
 		m_frameBuffer(VK_NULL_HANDLE)
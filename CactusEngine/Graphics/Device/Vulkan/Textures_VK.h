@@ -9,6 +9,7 @@ namespace Engine
 		None = 0,
 		VK,  // Native Vulkan allocation
 		VMA, // Managed by Vulkan Memory Allocator (VMA) library
+		VMA_Aliasing, // Placed into a VMA allocation owned by another object
 		COUNT
 	};
 
@@ -51,6 +52,8 @@ namespace Engine
 		uint32_t			m_mipLevels;
 		VkImageAspectFlags	m_aspect;
 
+		std::vector<VkImageView> m_mipStorageViews; // One view per mip level, only created if the texture can be accessed as storage image
+
 		EAllocatorType_VK m_allocatorType;
 
 		Sampler_VK* m_pSampler;
@@ -60,6 +63,8 @@ namespace Engine
 		friend class GraphicsHardwareInterface_VK;
 		friend class CommandBuffer_VK;
 		friend class UploadAllocator_VK;
+		friend class MipmapGenerator_VK;
+		friend class UploadManager_VK;
 	};
 
 	class RenderTarget2D_VK : public Texture2D_VK
@@ -72,6 +77,19 @@ namespace Engine
 		bool m_isSwapchainImage;
 	};
 
+	class TransientMemoryBlock_VK : public TransientMemoryBlock
+	{
+	public:
+		TransientMemoryBlock_VK(LogicalDevice_VK* pDevice, const DeviceMemoryRequirements& requirements);
+		~TransientMemoryBlock_VK();
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		VmaAllocation m_allocation;
+
+		friend class GraphicsHardwareInterface_VK;
+	};
+
 	class FrameBuffer_VK : public FrameBuffer
 	{
 	public:
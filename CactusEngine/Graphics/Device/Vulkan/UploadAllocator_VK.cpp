@@ -7,12 +7,84 @@
 #include "CommandManager_VK.h"
 #include "Buffers_VK.h"
 #include "Textures_VK.h"
+#include "LogUtility.h"
+
+#include <string>
 
 namespace Engine
 {
-	UploadAllocator_VK::UploadAllocator_VK(LogicalDevice_VK* pDevice, VkInstance instance)
-		: m_pDevice(pDevice)
+	static EMemoryCategory GetBufferMemoryCategory(const RawBufferCreateInfo_VK& createInfo)
+	{
+		if ((createInfo.usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT)) != 0)
+		{
+			return EMemoryCategory::Mesh;
+		}
+		if ((createInfo.usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) != 0)
+		{
+			return EMemoryCategory::Uniform;
+		}
+		if (createInfo.usage == VK_BUFFER_USAGE_TRANSFER_SRC_BIT && createInfo.memoryUsage == VMA_MEMORY_USAGE_CPU_ONLY)
+		{
+			return EMemoryCategory::Staging;
+		}
+		return EMemoryCategory::Other;
+	}
+
+	static EMemoryCategory GetImageMemoryCategory(const Texture2DCreateInfo_VK& createInfo)
+	{
+		if ((createInfo.usage & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT)) != 0)
+		{
+			return EMemoryCategory::RenderTarget;
+		}
+		return EMemoryCategory::Texture;
+	}
+
+	static const char* GetMemoryCategoryName(EMemoryCategory category)
+	{
+		switch (category)
+		{
+		case EMemoryCategory::Mesh:
+			return "mesh";
+		case EMemoryCategory::Texture:
+			return "texture";
+		case EMemoryCategory::RenderTarget:
+			return "render target";
+		case EMemoryCategory::Uniform:
+			return "uniform";
+		case EMemoryCategory::Staging:
+			return "staging";
+		default:
+			return "other";
+		}
+	}
+
+	static std::string ToMegabytes(uint64_t bytes)
+	{
+		return std::to_string(bytes / (1024 * 1024)) + " MB";
+	}
+
+	UploadAllocator_VK::UploadAllocator_VK(LogicalDevice_VK* pDevice, VkInstance instance, bool enableMemoryBudget, uint32_t maxFramesInFlight)
+		: m_pDevice(pDevice),
+		m_maxFramesInFlight(maxFramesInFlight),
+		m_frameCount(0),
+		m_isMemoryBudgetSupported(enableMemoryBudget),
+		m_movablePool(VK_NULL_HANDLE),
+		m_defragmentationContext(VK_NULL_HANDLE),
+		m_defragmentationPass{},
+		m_defragmentationStage(EDefragmentationStage_VK::Idle),
+		m_defragmentationStageFrame(0),
+		m_defragmentedBytes(0)
 	{
+		for (uint32_t i = 0; i < (uint32_t)EMemoryCategory::COUNT; i++)
+		{
+			m_categoryBytes[i] = 0;
+			m_categoryAllocationCounts[i] = 0;
+		}
+
+		auto pGraphicsConfig = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics);
+		m_budgetWarningRatio = pGraphicsConfig->GetMemoryBudgetWarningRatio();
+		m_enableDefragmentation = pGraphicsConfig->GetMemoryDefragmentation();
+
 		VmaAllocatorCreateInfo createInfo{};
 		createInfo.physicalDevice = pDevice->physicalDevice;
 		createInfo.device = pDevice->logicalDevice;
@@ -51,16 +123,65 @@ namespace Engine
 
 		createInfo.pVulkanFunctions = &volkFunctions;
 
-		// TODO: integrate MemoryAllocationTracker
+		if (m_isMemoryBudgetSupported)
+		{
+			createInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+		}
 
 		if (vmaCreateAllocator(&createInfo, &m_allocator) != VK_SUCCESS)
 		{
 			throw std::runtime_error("Vulkan: Failed to create VMA allocator.");
 		}
+
+		const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+		vmaGetMemoryProperties(m_allocator, &pMemoryProperties);
+		m_heapsOverBudget.resize(pMemoryProperties->memoryHeapCount, false);
+
+		if (m_enableDefragmentation)
+		{
+			// Buffers are created with transfer source usage in this pool, so that they can be copied to their new location
+			VkBufferCreateInfo sampleBufferCreateInfo{};
+			sampleBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			sampleBufferCreateInfo.size = 1024;
+			sampleBufferCreateInfo.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+			VmaAllocationCreateInfo sampleAllocationInfo{};
+			sampleAllocationInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+			VmaPoolCreateInfo poolCreateInfo{};
+			if (vmaFindMemoryTypeIndexForBufferInfo(m_allocator, &sampleBufferCreateInfo, &sampleAllocationInfo, &poolCreateInfo.memoryTypeIndex) != VK_SUCCESS
+				|| vmaCreatePool(m_allocator, &poolCreateInfo, &m_movablePool) != VK_SUCCESS)
+			{
+				LOG_WARNING("Vulkan: Failed to create movable memory pool, device memory defragmentation is disabled.");
+				m_movablePool = VK_NULL_HANDLE;
+			}
+		}
 	}
 
 	UploadAllocator_VK::~UploadAllocator_VK()
 	{
+		if (m_defragmentationContext != VK_NULL_HANDLE)
+		{
+			// Device is expected to be idle by now, so an ongoing pass can be completed at once
+			if (m_defragmentationStage == EDefragmentationStage_VK::Copying)
+			{
+				SwapDefragmentedBuffers();
+			}
+			if (m_defragmentationStage == EDefragmentationStage_VK::Retiring)
+			{
+				EndDefragmentationPass();
+			}
+			if (m_defragmentationContext != VK_NULL_HANDLE)
+			{
+				FinishDefragmentation();
+			}
+		}
+
+		if (m_movablePool != VK_NULL_HANDLE)
+		{
+			vmaDestroyPool(m_allocator, m_movablePool);
+		}
+
 		vmaDestroyAllocator(m_allocator);
 	}
 
@@ -77,8 +198,23 @@ namespace Engine
 		VmaAllocationCreateInfo allocationInfo{};
 		allocationInfo.usage = createInfo.memoryUsage;
 
+		EMemoryCategory category = GetBufferMemoryCategory(createInfo);
+		bool isMovable = m_movablePool != VK_NULL_HANDLE && category == EMemoryCategory::Mesh && createInfo.memoryUsage == VMA_MEMORY_USAGE_GPU_ONLY;
+		if (isMovable)
+		{
+			bufferCreateInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+			allocationInfo.pool = m_movablePool;
+		}
+
 		if (vmaCreateBuffer(m_allocator, &bufferCreateInfo, &allocationInfo, &rawBuffer.m_buffer, &rawBuffer.m_allocation, nullptr) == VK_SUCCESS)
 		{
+			TrackAllocation(rawBuffer.m_allocation, category);
+
+			if (isMovable)
+			{
+				std::lock_guard<std::mutex> guard(m_defragmentationMutex);
+				m_movableBuffers[rawBuffer.m_allocation] = { &rawBuffer, bufferCreateInfo.usage };
+			}
 			return true;
 		}
 
@@ -91,20 +227,7 @@ namespace Engine
 		DEBUG_ASSERT_CE(m_allocator != VK_NULL_HANDLE);
 
 		VkImageCreateInfo imageCreateInfo{};
-		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
-		imageCreateInfo.extent = { createInfo.extent.width, createInfo.extent.height, 1 };
-		imageCreateInfo.mipLevels = createInfo.mipLevels;
-		imageCreateInfo.arrayLayers = 1;
-		imageCreateInfo.format = createInfo.format;
-		imageCreateInfo.tiling = createInfo.tiling;
-		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		imageCreateInfo.usage = createInfo.usage;
-		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
-		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-		VmaAllocationCreateInfo allocationInfo{};
-		allocationInfo.usage = createInfo.memoryUsage;
+		FillImageCreateInfo(createInfo, imageCreateInfo);
 
 		texture2d.m_width = createInfo.extent.width;
 		texture2d.m_height = createInfo.extent.height;
@@ -112,8 +235,25 @@ namespace Engine
 		texture2d.m_format = createInfo.format;
 		texture2d.m_mipLevels = createInfo.mipLevels;
 
+		if (createInfo.aliasingAllocation != VK_NULL_HANDLE)
+		{
+			// Image does not take ownership of the allocation
+			if (vmaCreateAliasingImage(m_allocator, createInfo.aliasingAllocation, &imageCreateInfo, &texture2d.m_image) == VK_SUCCESS)
+			{
+				texture2d.m_allocatorType = EAllocatorType_VK::VMA_Aliasing;
+				return true;
+			}
+
+			throw std::runtime_error("Vulkan: Failed to create aliasing texture 2D.");
+			return false;
+		}
+
+		VmaAllocationCreateInfo allocationInfo{};
+		allocationInfo.usage = createInfo.memoryUsage;
+
 		if (vmaCreateImage(m_allocator, &imageCreateInfo, &allocationInfo, &texture2d.m_image, &texture2d.m_allocation, nullptr) == VK_SUCCESS)
 		{
+			TrackAllocation(texture2d.m_allocation, GetImageMemoryCategory(createInfo));
 			return true;
 		}
 
@@ -121,6 +261,41 @@ namespace Engine
 		return false;
 	}
 
+	void UploadAllocator_VK::GetTexture2DMemoryRequirements(const Texture2DCreateInfo_VK& createInfo, VkMemoryRequirements& outRequirements)
+	{
+		VkImageCreateInfo imageCreateInfo{};
+		FillImageCreateInfo(createInfo, imageCreateInfo);
+
+		// Requirements are queried from a temporary image, as vkGetDeviceImageMemoryRequirements is not guaranteed under Vulkan 1.2
+		VkImage image = VK_NULL_HANDLE;
+		if (vkCreateImage(m_pDevice->logicalDevice, &imageCreateInfo, nullptr, &image) != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: Failed to query texture 2D memory requirements.");
+			return;
+		}
+
+		vkGetImageMemoryRequirements(m_pDevice->logicalDevice, image, &outRequirements);
+		vkDestroyImage(m_pDevice->logicalDevice, image, nullptr);
+	}
+
+	bool UploadAllocator_VK::AllocateMemory(const VkMemoryRequirements& requirements, VmaMemoryUsage memoryUsage, VmaAllocation& allocation)
+	{
+		DEBUG_ASSERT_CE(m_allocator != VK_NULL_HANDLE);
+
+		VmaAllocationCreateInfo allocationInfo{};
+		allocationInfo.usage = memoryUsage;
+
+		if (vmaAllocateMemory(m_allocator, &requirements, &allocationInfo, &allocation, nullptr) == VK_SUCCESS)
+		{
+			// Standalone memory is only allocated for render graph intermediate textures to alias
+			TrackAllocation(allocation, EMemoryCategory::RenderTarget);
+			return true;
+		}
+
+		throw std::runtime_error("Vulkan: Failed to allocate device memory.");
+		return false;
+	}
+
 	bool UploadAllocator_VK::MapMemory(VmaAllocation& allocation, void** mappedData)
 	{
 		if (vmaMapMemory(m_allocator, allocation, mappedData) != VK_SUCCESS)
@@ -139,12 +314,361 @@ namespace Engine
 	void UploadAllocator_VK::FreeBuffer(VkBuffer& buffer, VmaAllocation& allocation)
 	{
 		DEBUG_ASSERT_CE(m_allocator != VK_NULL_HANDLE && buffer != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE);
+
+		if (m_movablePool != VK_NULL_HANDLE)
+		{
+			std::lock_guard<std::mutex> guard(m_defragmentationMutex);
+			m_movableBuffers.erase(allocation);
+
+			// Allocation that is being moved is released by the end of defragmentation pass, along with both of its buffers
+			for (uint32_t i = 0; i < (uint32_t)m_bufferMoves.size(); i++)
+			{
+				if (m_defragmentationPass.pMoves[i].srcAllocation == allocation)
+				{
+					// Ignored moves have no copy in flight
+					if (m_bufferMoves[i].srcBuffer == VK_NULL_HANDLE)
+					{
+						vkDestroyBuffer(m_pDevice->logicalDevice, buffer, nullptr);
+					}
+
+					m_defragmentationPass.pMoves[i].operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+					m_bufferMoves[i].pBuffer = nullptr;
+
+					UntrackAllocation(allocation);
+					return;
+				}
+			}
+		}
+
+		UntrackAllocation(allocation);
 		vmaDestroyBuffer(m_allocator, buffer, allocation);
 	}
 
 	void UploadAllocator_VK::FreeImage(VkImage& image, VmaAllocation& allocation)
 	{
 		DEBUG_ASSERT_CE(m_allocator != VK_NULL_HANDLE && image != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE);
+		UntrackAllocation(allocation);
 		vmaDestroyImage(m_allocator, image, allocation);
 	}
+
+	void UploadAllocator_VK::FreeMemory(VmaAllocation& allocation)
+	{
+		DEBUG_ASSERT_CE(m_allocator != VK_NULL_HANDLE && allocation != VK_NULL_HANDLE);
+		UntrackAllocation(allocation);
+		vmaFreeMemory(m_allocator, allocation);
+		allocation = VK_NULL_HANDLE;
+	}
+
+	void UploadAllocator_VK::GetMemoryStatistics(DeviceMemoryStatistics& outStatistics) const
+	{
+		const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+		vmaGetMemoryProperties(m_allocator, &pMemoryProperties);
+
+		std::vector<VmaBudget> budgets(pMemoryProperties->memoryHeapCount);
+		vmaGetHeapBudgets(m_allocator, budgets.data());
+
+		outStatistics.heaps.resize(pMemoryProperties->memoryHeapCount);
+		outStatistics.blockBytes = 0;
+		outStatistics.allocationBytes = 0;
+
+		for (uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; i++)
+		{
+			outStatistics.heaps[i].size = pMemoryProperties->memoryHeaps[i].size;
+			outStatistics.heaps[i].usage = budgets[i].usage;
+			outStatistics.heaps[i].budget = budgets[i].budget;
+			outStatistics.heaps[i].isDeviceLocal = (pMemoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+
+			outStatistics.blockBytes += budgets[i].statistics.blockBytes;
+			outStatistics.allocationBytes += budgets[i].statistics.allocationBytes;
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)EMemoryCategory::COUNT; i++)
+		{
+			outStatistics.categoryBytes[i] = m_categoryBytes[i].load();
+			outStatistics.categoryAllocationCounts[i] = m_categoryAllocationCounts[i].load();
+		}
+
+		outStatistics.defragmentedBytes = m_defragmentedBytes.load();
+		outStatistics.isBudgetSupported = m_isMemoryBudgetSupported;
+	}
+
+	void UploadAllocator_VK::AdvanceFrame()
+	{
+		m_frameCount++;
+		vmaSetCurrentFrameIndex(m_allocator, (uint32_t)m_frameCount);
+
+		if (m_frameCount % BUDGET_CHECK_INTERVAL == 0)
+		{
+			CheckMemoryBudget();
+		}
+
+		if (m_movablePool == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> guard(m_defragmentationMutex);
+
+		// Each stage waits until frames that were in flight when it began have retired
+		switch (m_defragmentationStage)
+		{
+		case EDefragmentationStage_VK::Idle:
+		{
+			// Passes of the same defragmentation run back to back
+			if (m_defragmentationContext != VK_NULL_HANDLE || m_frameCount >= m_defragmentationStageFrame + DEFRAGMENTATION_INTERVAL)
+			{
+				BeginDefragmentationPass();
+			}
+			break;
+		}
+		case EDefragmentationStage_VK::Copying:
+		{
+			if (m_frameCount >= m_defragmentationStageFrame + m_maxFramesInFlight)
+			{
+				SwapDefragmentedBuffers();
+			}
+			break;
+		}
+		case EDefragmentationStage_VK::Retiring:
+		{
+			if (m_frameCount >= m_defragmentationStageFrame + m_maxFramesInFlight)
+			{
+				EndDefragmentationPass();
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	void UploadAllocator_VK::FillImageCreateInfo(const Texture2DCreateInfo_VK& createInfo, VkImageCreateInfo& outImageCreateInfo) const
+	{
+		outImageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		outImageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+		outImageCreateInfo.extent = { createInfo.extent.width, createInfo.extent.height, 1 };
+		outImageCreateInfo.mipLevels = createInfo.mipLevels;
+		outImageCreateInfo.arrayLayers = 1;
+		outImageCreateInfo.format = createInfo.format;
+		outImageCreateInfo.tiling = createInfo.tiling;
+		outImageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		outImageCreateInfo.usage = createInfo.usage;
+		outImageCreateInfo.flags = createInfo.flags;
+		outImageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		outImageCreateInfo.sharingMode = createInfo.sharingMode;
+		outImageCreateInfo.queueFamilyIndexCount = (uint32_t)createInfo.queueFamilyIndices.size();
+		outImageCreateInfo.pQueueFamilyIndices = createInfo.queueFamilyIndices.empty() ? nullptr : createInfo.queueFamilyIndices.data();
+	}
+
+	void UploadAllocator_VK::TrackAllocation(VmaAllocation allocation, EMemoryCategory category)
+	{
+		VmaAllocationInfo allocationInfo{};
+		vmaGetAllocationInfo(m_allocator, allocation, &allocationInfo);
+
+		// Category is stored with an offset, so that allocations without user data are told apart
+		vmaSetAllocationUserData(m_allocator, allocation, reinterpret_cast<void*>((uintptr_t)category + 1));
+
+		m_categoryBytes[(uint32_t)category] += allocationInfo.size;
+		m_categoryAllocationCounts[(uint32_t)category]++;
+	}
+
+	void UploadAllocator_VK::UntrackAllocation(VmaAllocation allocation)
+	{
+		VmaAllocationInfo allocationInfo{};
+		vmaGetAllocationInfo(m_allocator, allocation, &allocationInfo);
+
+		if (allocationInfo.pUserData == nullptr)
+		{
+			return;
+		}
+
+		uint32_t category = (uint32_t)(reinterpret_cast<uintptr_t>(allocationInfo.pUserData) - 1);
+		m_categoryBytes[category] -= allocationInfo.size;
+		m_categoryAllocationCounts[category]--;
+	}
+
+	void UploadAllocator_VK::CheckMemoryBudget()
+	{
+		const VkPhysicalDeviceMemoryProperties* pMemoryProperties = nullptr;
+		vmaGetMemoryProperties(m_allocator, &pMemoryProperties);
+
+		std::vector<VmaBudget> budgets(pMemoryProperties->memoryHeapCount);
+		vmaGetHeapBudgets(m_allocator, budgets.data());
+
+		for (uint32_t i = 0; i < pMemoryProperties->memoryHeapCount; i++)
+		{
+			bool isOverThreshold = budgets[i].budget > 0 && budgets[i].usage > (VkDeviceSize)(budgets[i].budget * m_budgetWarningRatio);
+
+			if (isOverThreshold && !m_heapsOverBudget[i])
+			{
+				std::string categoryTotals;
+				for (uint32_t j = 0; j < (uint32_t)EMemoryCategory::COUNT; j++)
+				{
+					categoryTotals += (j == 0 ? "" : ", ") + (std::string)GetMemoryCategoryName((EMemoryCategory)j) + " " + ToMegabytes(m_categoryBytes[j].load());
+				}
+
+				LOG_WARNING("Vulkan: Memory heap " + std::to_string(i) + " usage " + ToMegabytes(budgets[i].usage) + " is approaching its budget of " + ToMegabytes(budgets[i].budget)
+					+ " (" + categoryTotals + ").");
+			}
+
+			m_heapsOverBudget[i] = isOverThreshold;
+		}
+	}
+
+	void UploadAllocator_VK::BeginDefragmentationPass()
+	{
+		if (m_defragmentationContext == VK_NULL_HANDLE)
+		{
+			VmaDefragmentationInfo defragmentationInfo{};
+			defragmentationInfo.flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_FAST_BIT;
+			defragmentationInfo.pool = m_movablePool;
+			defragmentationInfo.maxBytesPerPass = DEFRAGMENTATION_MAX_BYTES_PER_PASS;
+			defragmentationInfo.maxAllocationsPerPass = DEFRAGMENTATION_MAX_ALLOCATIONS_PER_PASS;
+
+			if (vmaBeginDefragmentation(m_allocator, &defragmentationInfo, &m_defragmentationContext) != VK_SUCCESS)
+			{
+				LOG_WARNING("Vulkan: Failed to begin device memory defragmentation.");
+				m_defragmentationContext = VK_NULL_HANDLE;
+				m_defragmentationStageFrame = m_frameCount;
+				return;
+			}
+		}
+
+		if (vmaBeginDefragmentationPass(m_allocator, m_defragmentationContext, &m_defragmentationPass) != VK_INCOMPLETE)
+		{
+			// Nothing left to move
+			FinishDefragmentation();
+			return;
+		}
+
+		auto pCmdBuffer = m_pDevice->pImplicitCmdBuffer;
+		std::vector<VkBufferMemoryBarrier> barriers;
+
+		m_bufferMoves.resize(m_defragmentationPass.moveCount);
+		for (uint32_t i = 0; i < m_defragmentationPass.moveCount; i++)
+		{
+			auto& move = m_defragmentationPass.pMoves[i];
+			m_bufferMoves[i] = { nullptr, VK_NULL_HANDLE, VK_NULL_HANDLE };
+
+			// Buffers whose data has not yet arrived on graphics queue stay in place
+			auto itr = m_movableBuffers.find(move.srcAllocation);
+			if (itr == m_movableBuffers.end()
+				|| (m_pDevice->pUploadManager != nullptr && !m_pDevice->pUploadManager->IsUploadComplete(itr->second.pBuffer->GetUploadValue())))
+			{
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+				continue;
+			}
+
+			RawBuffer_VK* pBuffer = itr->second.pBuffer;
+
+			VkBufferCreateInfo bufferCreateInfo{};
+			bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			bufferCreateInfo.size = pBuffer->m_deviceSize;
+			bufferCreateInfo.usage = itr->second.usage;
+			bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			VkBuffer dstBuffer = VK_NULL_HANDLE;
+			if (vkCreateBuffer(m_pDevice->logicalDevice, &bufferCreateInfo, nullptr, &dstBuffer) != VK_SUCCESS)
+			{
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+				continue;
+			}
+			if (vmaBindBufferMemory(m_allocator, move.dstTmpAllocation, dstBuffer) != VK_SUCCESS)
+			{
+				vkDestroyBuffer(m_pDevice->logicalDevice, dstBuffer, nullptr);
+				move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+				continue;
+			}
+
+			m_bufferMoves[i] = { pBuffer, pBuffer->m_buffer, dstBuffer };
+
+			VkBufferCopy copyRegion{};
+			copyRegion.srcOffset = 0;
+			copyRegion.dstOffset = 0;
+			copyRegion.size = pBuffer->m_deviceSize;
+
+			pCmdBuffer->CopyBufferToBuffer(pBuffer->m_buffer, dstBuffer, copyRegion);
+
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.buffer = dstBuffer;
+			barrier.offset = 0;
+			barrier.size = VK_WHOLE_SIZE;
+			barriers.push_back(barrier);
+		}
+
+		if (barriers.empty())
+		{
+			// Every move was ignored, there is nothing to wait for
+			EndDefragmentationPass();
+			return;
+		}
+
+		pCmdBuffer->PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, barriers, {});
+
+		m_defragmentationStage = EDefragmentationStage_VK::Copying;
+		m_defragmentationStageFrame = m_frameCount;
+	}
+
+	void UploadAllocator_VK::SwapDefragmentedBuffers()
+	{
+		// Frames recorded from now on bind buffers at new location
+		for (auto& bufferMove : m_bufferMoves)
+		{
+			if (bufferMove.pBuffer != nullptr)
+			{
+				bufferMove.pBuffer->m_buffer = bufferMove.dstBuffer;
+				m_defragmentedBytes += bufferMove.pBuffer->m_deviceSize;
+			}
+		}
+
+		m_defragmentationStage = EDefragmentationStage_VK::Retiring;
+		m_defragmentationStageFrame = m_frameCount;
+	}
+
+	void UploadAllocator_VK::EndDefragmentationPass()
+	{
+		for (auto& bufferMove : m_bufferMoves)
+		{
+			if (bufferMove.srcBuffer == VK_NULL_HANDLE)
+			{
+				continue;
+			}
+
+			vkDestroyBuffer(m_pDevice->logicalDevice, bufferMove.srcBuffer, nullptr);
+			if (bufferMove.pBuffer == nullptr)
+			{
+				vkDestroyBuffer(m_pDevice->logicalDevice, bufferMove.dstBuffer, nullptr);
+			}
+		}
+		m_bufferMoves.clear();
+
+		// Source allocations now refer to new memory, and old memory is released
+		VkResult result = vmaEndDefragmentationPass(m_allocator, m_defragmentationContext, &m_defragmentationPass);
+
+		m_defragmentationStage = EDefragmentationStage_VK::Idle;
+		m_defragmentationStageFrame = m_frameCount;
+
+		if (result == VK_SUCCESS)
+		{
+			FinishDefragmentation();
+		}
+	}
+
+	void UploadAllocator_VK::FinishDefragmentation()
+	{
+		VmaDefragmentationStats stats{};
+		vmaEndDefragmentation(m_allocator, m_defragmentationContext, &stats);
+		m_defragmentationContext = VK_NULL_HANDLE;
+		m_defragmentationStageFrame = m_frameCount;
+
+		if (stats.bytesFreed > 0)
+		{
+			DEBUG_LOG_MESSAGE("Vulkan: Defragmentation moved " + ToMegabytes(stats.bytesMoved) + " and released " + ToMegabytes(stats.bytesFreed) + " of device memory.");
+		}
+	}
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include "VulkanIncludes.h"
+#include "GraphicsResources.h"
 
 #include <vk_mem_alloc.h>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 namespace Engine
 {
@@ -15,7 +19,11 @@ namespace Engine
 		VkImageAspectFlags	aspect = VK_IMAGE_ASPECT_COLOR_BIT;
 		VkImageViewType		viewType = VK_IMAGE_VIEW_TYPE_2D;
 		VkImageUsageFlags	usage = 0;
+		VkImageCreateFlags	flags = 0;
 		VmaMemoryUsage		memoryUsage = VMA_MEMORY_USAGE_UNKNOWN;
+		VmaAllocation		aliasingAllocation = VK_NULL_HANDLE; // If specified, image is placed into this allocation, which is owned elsewhere
+		VkSharingMode		sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		std::vector<uint32_t> queueFamilyIndices; // Only used by concurrent sharing mode
 	};
 
 	struct RawBufferCreateInfo_VK
@@ -35,20 +43,89 @@ namespace Engine
 	class UploadAllocator_VK
 	{
 	public:
-		UploadAllocator_VK(LogicalDevice_VK* pDevice, VkInstance instance);
+		UploadAllocator_VK(LogicalDevice_VK* pDevice, VkInstance instance, bool enableMemoryBudget, uint32_t maxFramesInFlight);
 		~UploadAllocator_VK();
 
 		bool CreateBuffer(const RawBufferCreateInfo_VK& createInfo, RawBuffer_VK& rawBuffer);
 		bool CreateTexture2D(const Texture2DCreateInfo_VK& createInfo, Texture2D_VK& texture2d);
+		void GetTexture2DMemoryRequirements(const Texture2DCreateInfo_VK& createInfo, VkMemoryRequirements& outRequirements);
+
+		bool AllocateMemory(const VkMemoryRequirements& requirements, VmaMemoryUsage memoryUsage, VmaAllocation& allocation);
 
 		bool MapMemory(VmaAllocation& allocation, void** mappedData);
 		void UnmapMemory(VmaAllocation& allocation);
 
 		void FreeBuffer(VkBuffer& buffer, VmaAllocation& allocation);
 		void FreeImage(VkImage& image, VmaAllocation& allocation);
+		void FreeMemory(VmaAllocation& allocation);
+
+		void GetMemoryStatistics(DeviceMemoryStatistics& outStatistics) const;
+		void AdvanceFrame(); // Should be called once per frame after the oldest frame in flight has retired
 
 	private:
+		void FillImageCreateInfo(const Texture2DCreateInfo_VK& createInfo, VkImageCreateInfo& outImageCreateInfo) const;
+
+		void TrackAllocation(VmaAllocation allocation, EMemoryCategory category);
+		void UntrackAllocation(VmaAllocation allocation);
+
+		void CheckMemoryBudget();
+
+		void BeginDefragmentationPass();
+		void SwapDefragmentedBuffers();
+		void EndDefragmentationPass();
+		void FinishDefragmentation();
+
+	public:
+		const uint32_t BUDGET_CHECK_INTERVAL = 30; // In frames
+		const uint32_t DEFRAGMENTATION_INTERVAL = 120; // In frames, between the end of one defragmentation and the beginning of next
+		const VkDeviceSize DEFRAGMENTATION_MAX_BYTES_PER_PASS = 8 * 1024 * 1024;
+		const uint32_t DEFRAGMENTATION_MAX_ALLOCATIONS_PER_PASS = 64;
+
+	private:
+		enum class EDefragmentationStage_VK
+		{
+			Idle = 0,
+			Copying,  // Buffers at new location are being filled by GPU, resources still refer to old buffers
+			Retiring, // Resources refer to new buffers, old buffers may still be read by frames in flight
+			COUNT
+		};
+
+		struct MovableBuffer_VK
+		{
+			RawBuffer_VK*		pBuffer;
+			VkBufferUsageFlags	usage;
+		};
+
+		struct BufferMove_VK
+		{
+			RawBuffer_VK*	pBuffer; // Null if the buffer was freed during the pass
+			VkBuffer		srcBuffer;
+			VkBuffer		dstBuffer;
+		};
+
 		LogicalDevice_VK* m_pDevice;
 		VmaAllocator m_allocator;
+		uint32_t m_maxFramesInFlight;
+		uint64_t m_frameCount;
+
+		bool m_isMemoryBudgetSupported;
+		float m_budgetWarningRatio;
+		std::vector<bool> m_heapsOverBudget; // Each heap only warns once until its usage drops below threshold again
+
+		std::atomic<uint64_t> m_categoryBytes[(uint32_t)EMemoryCategory::COUNT];
+		std::atomic<uint32_t> m_categoryAllocationCounts[(uint32_t)EMemoryCategory::COUNT];
+
+		// Only device local mesh buffers are movable, they are created in a dedicated pool which is the only one defragmented
+		// Textures are not moved, since their views are referenced by descriptor sets and bindless resource table
+		bool m_enableDefragmentation;
+		VmaPool m_movablePool;
+		std::mutex m_defragmentationMutex;
+		std::unordered_map<VmaAllocation, MovableBuffer_VK> m_movableBuffers;
+		VmaDefragmentationContext m_defragmentationContext;
+		VmaDefragmentationPassMoveInfo m_defragmentationPass;
+		std::vector<BufferMove_VK> m_bufferMoves; // Parallel to moves of current defragmentation pass
+		EDefragmentationStage_VK m_defragmentationStage;
+		uint64_t m_defragmentationStageFrame;
+		std::atomic<uint64_t> m_defragmentedBytes;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,495 @@
+#include "UploadManager_VK.h"
+#include "GraphicsHardwareInterface_VK.h"
+#include "Buffers_VK.h"
+#include "Textures_VK.h"
+#include "LogUtility.h"
+#include "MemoryAllocator.h"
+
+#include <cstring>
+
+namespace Engine
+{
+	UploadManager_VK::UploadManager_VK(LogicalDevice_VK* pDevice)
+		: m_pDevice(pDevice),
+		m_pCommandPool(nullptr),
+		m_pStagingRing(nullptr),
+		m_pMappedRing(nullptr),
+		m_ringHead(0),
+		m_ringUsedSize(0),
+		m_pRecordingCmdBuffer(nullptr),
+		m_recordingRingUsage(0),
+		m_recordingUploadValue(1),
+		m_openReservationCount(0),
+		m_acquiredUploadValue(0)
+	{
+		DEBUG_ASSERT_CE(m_pDevice->pTransferCommandManager != nullptr);
+		DEBUG_ASSERT_CE(m_pDevice->transferQueue.queueFamilyIndex != m_pDevice->graphicsQueue.queueFamilyIndex);
+
+		m_pCommandPool = m_pDevice->pTransferCommandManager->RequestExternalCommandPool();
+
+		RawBufferCreateInfo_VK ringCreateInfo{};
+		ringCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		ringCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+		ringCreateInfo.size = STAGING_RING_SIZE;
+
+		CE_NEW(m_pStagingRing, RawBuffer_VK, m_pDevice->pUploadAllocator, ringCreateInfo);
+
+		void* pMappedData = nullptr;
+		if (!m_pDevice->pUploadAllocator->MapMemory(m_pStagingRing->m_allocation, &pMappedData))
+		{
+			throw std::runtime_error("Vulkan: failed to map upload staging ring.");
+			return;
+		}
+		m_pMappedRing = (uint8_t*)pMappedData;
+	}
+
+	UploadManager_VK::~UploadManager_VK()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_pDevice->pTransferCommandManager->WaitWorkingQueueIdle();
+
+		for (auto& batch : m_inFlightBatches)
+		{
+			for (auto& pBuffer : batch.dedicatedStagingBuffers)
+			{
+				CE_DELETE(pBuffer);
+			}
+		}
+		for (auto& pBuffer : m_recordingDedicatedBuffers)
+		{
+			CE_DELETE(pBuffer);
+		}
+
+		m_pDevice->pUploadAllocator->UnmapMemory(m_pStagingRing->m_allocation);
+		CE_SAFE_DELETE(m_pStagingRing);
+		CE_SAFE_DELETE(m_pCommandPool);
+	}
+
+	uint64_t UploadManager_VK::UploadBuffer(const void* pData, VkDeviceSize size, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// Staging memory is written first, as it may submit the open batch when ring is full
+		const RawBuffer_VK* pStagingBuffer = nullptr;
+		VkDeviceSize stagingOffset = WriteStagingData(pData, size, pStagingBuffer);
+
+		RecordBufferCopy(pStagingBuffer, stagingOffset, size, pDstBuffer, dstStages, dstAccess);
+
+		return m_recordingUploadValue;
+	}
+
+	uint64_t UploadManager_VK::UploadTexture2D(const void* pData, VkDeviceSize size, Texture2D_VK* pDstTexture, const std::vector<VkBufferImageCopy>& regions, VkImageLayout newLayout, uint32_t appliedStages, bool generateMipmap)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const RawBuffer_VK* pStagingBuffer = nullptr;
+		VkDeviceSize stagingOffset = WriteStagingData(pData, size, pStagingBuffer);
+
+		std::vector<VkBufferImageCopy> copyRegions = regions;
+		for (auto& region : copyRegions)
+		{
+			region.bufferOffset += stagingOffset;
+		}
+
+		CommandBuffer_VK* pCmdBuffer = GetRecordingCommandBuffer();
+		pCmdBuffer->TransitionImageLayout(pDstTexture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0);
+		pCmdBuffer->CopyBufferToTexture2D(pStagingBuffer, pDstTexture, copyRegions);
+
+		// Layout stays in transfer destination until acquired by graphics queue, where mipmap generation is done
+		TextureAcquire acquire{};
+		acquire.pTexture = pDstTexture;
+		acquire.newLayout = newLayout;
+		acquire.appliedStages = appliedStages;
+		acquire.generateMipmap = generateMipmap;
+		m_recordingTextureAcquires.emplace_back(acquire);
+
+		return m_recordingUploadValue;
+	}
+
+	UploadManager_VK::StagingReservation UploadManager_VK::ReserveStagingMemory(VkDeviceSize size)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		StagingReservation reservation = AllocateStagingMemory(size);
+		m_openReservationCount++;
+
+		return reservation;
+	}
+
+	uint64_t UploadManager_VK::CommitBufferUpload(const StagingReservation& reservation, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		DEBUG_ASSERT_CE(m_openReservationCount > 0);
+
+		if (reservation.isDedicated)
+		{
+			VmaAllocation allocation = reservation.pStagingBuffer->m_allocation;
+			m_pDevice->pUploadAllocator->UnmapMemory(allocation);
+		}
+
+		// Open batch has been held back since reservation, so the copy ends up in the same batch that owns the staging memory
+		RecordBufferCopy(reservation.pStagingBuffer, reservation.offset, reservation.size, pDstBuffer, dstStages, dstAccess);
+		m_openReservationCount--;
+
+		return m_recordingUploadValue;
+	}
+
+	void UploadManager_VK::SubmitPendingUploads()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		SubmitOpenBatch();
+		RetireCompletedBatches(false);
+	}
+
+	void UploadManager_VK::AcquirePendingUploads()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		SubmitOpenBatch();
+		RetireCompletedBatches(false);
+
+		if (m_pendingAcquireBatches.empty())
+		{
+			return;
+		}
+
+		CommandBuffer_VK* pGraphicsCmdBuffer = m_pDevice->pGraphicsCommandManager->RequestPrimaryCommandBuffer();
+		pGraphicsCmdBuffer->m_usageFlags = (uint32_t)ECommandBufferUsageFlagBits_VK::Upload;
+
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		VkPipelineStageFlags dstStages = 0;
+
+		for (auto& batch : m_pendingAcquireBatches)
+		{
+			// Only the acquisition waits for the batch, later submissions are ordered after it by the pipeline barrier
+			pGraphicsCmdBuffer->WaitSemaphore(batch.pSemaphore);
+
+			for (auto& acquire : batch.bufferAcquires)
+			{
+				VkBufferMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = acquire.dstAccess;
+				barrier.srcQueueFamilyIndex = m_pDevice->transferQueue.queueFamilyIndex;
+				barrier.dstQueueFamilyIndex = m_pDevice->graphicsQueue.queueFamilyIndex;
+				barrier.buffer = acquire.pBuffer->m_buffer;
+				barrier.offset = 0;
+				barrier.size = VK_WHOLE_SIZE;
+
+				bufferBarriers.emplace_back(barrier);
+				dstStages |= acquire.dstStages;
+			}
+
+			for (auto& acquire : batch.textureAcquires)
+			{
+				VkImageMemoryBarrier barrier{};
+				barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+				barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+				barrier.srcQueueFamilyIndex = m_pDevice->transferQueue.queueFamilyIndex;
+				barrier.dstQueueFamilyIndex = m_pDevice->graphicsQueue.queueFamilyIndex;
+				barrier.image = acquire.pTexture->m_image;
+				barrier.subresourceRange.aspectMask = acquire.pTexture->m_aspect;
+				barrier.subresourceRange.baseMipLevel = 0;
+				barrier.subresourceRange.levelCount = acquire.pTexture->m_mipLevels;
+				barrier.subresourceRange.baseArrayLayer = 0;
+				barrier.subresourceRange.layerCount = 1;
+
+				imageBarriers.emplace_back(barrier);
+				dstStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+			}
+		}
+
+		pGraphicsCmdBuffer->PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, dstStages, bufferBarriers, imageBarriers);
+
+		for (auto& batch : m_pendingAcquireBatches)
+		{
+			for (auto& acquire : batch.textureAcquires)
+			{
+				if (acquire.generateMipmap)
+				{
+					// Layout transition for all levels are included
+					pGraphicsCmdBuffer->GenerateMipmap(acquire.pTexture, acquire.newLayout, acquire.appliedStages);
+				}
+				else if (acquire.newLayout != VK_IMAGE_LAYOUT_UNDEFINED)
+				{
+					pGraphicsCmdBuffer->TransitionImageLayout(acquire.pTexture, acquire.newLayout, acquire.appliedStages);
+				}
+			}
+		}
+
+		// Submitted by itself so that it precedes every command buffer in the following submission, including those recorded earlier
+		m_pDevice->pGraphicsCommandManager->SubmitCommandBuffers(m_pDevice->pSyncObjectManager->RequestTimelineSemaphore(), (uint32_t)ECommandBufferUsageFlagBits_VK::Upload);
+
+		m_acquiredUploadValue = m_pendingAcquireBatches.back().uploadValue;
+		m_pendingAcquireBatches.clear();
+	}
+
+	bool UploadManager_VK::IsUploadComplete(uint64_t uploadValue) const
+	{
+		return uploadValue <= m_acquiredUploadValue.load();
+	}
+
+	CommandBuffer_VK* UploadManager_VK::GetRecordingCommandBuffer()
+	{
+		if (m_pRecordingCmdBuffer == nullptr)
+		{
+			m_pRecordingCmdBuffer = m_pCommandPool->RequestPrimaryCommandBuffer();
+		}
+		return m_pRecordingCmdBuffer;
+	}
+
+	VkDeviceSize UploadManager_VK::WriteStagingData(const void* pData, VkDeviceSize size, const RawBuffer_VK*& pOutStagingBuffer)
+	{
+		StagingReservation reservation = AllocateStagingMemory(size);
+
+		memcpy(reservation.pMappedData, pData, size);
+		if (reservation.isDedicated)
+		{
+			VmaAllocation allocation = reservation.pStagingBuffer->m_allocation;
+			m_pDevice->pUploadAllocator->UnmapMemory(allocation);
+		}
+
+		pOutStagingBuffer = reservation.pStagingBuffer;
+		return reservation.offset;
+	}
+
+	UploadManager_VK::StagingReservation UploadManager_VK::AllocateStagingMemory(VkDeviceSize size)
+	{
+		StagingReservation reservation{};
+		reservation.size = size;
+
+		if (size <= STAGING_RING_SIZE)
+		{
+			RetireCompletedBatches(false);
+
+			// Open batch cannot be submitted to make room while staging memory it owns is still being written
+			bool isAllocated = TryAllocateFromRing(size, reservation.offset);
+			while (!isAllocated && m_openReservationCount == 0)
+			{
+				// Alert: this blocks the calling thread, but only when uploads are recorded faster than transfer queue can consume them
+				SubmitOpenBatch();
+				RetireCompletedBatches(true);
+				isAllocated = TryAllocateFromRing(size, reservation.offset);
+			}
+
+			if (isAllocated)
+			{
+				reservation.pStagingBuffer = m_pStagingRing;
+				reservation.pMappedData = m_pMappedRing + reservation.offset;
+				reservation.isDedicated = false;
+				return reservation;
+			}
+		}
+
+		RawBufferCreateInfo_VK bufferCreateInfo{};
+		bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+		bufferCreateInfo.memoryUsage = VMA_MEMORY_USAGE_CPU_ONLY;
+		bufferCreateInfo.size = size;
+
+		RawBuffer_VK* pStagingBuffer;
+		CE_NEW(pStagingBuffer, RawBuffer_VK, m_pDevice->pUploadAllocator, bufferCreateInfo);
+
+		m_pDevice->pUploadAllocator->MapMemory(pStagingBuffer->m_allocation, &reservation.pMappedData);
+
+		m_recordingDedicatedBuffers.emplace_back(pStagingBuffer);
+		reservation.pStagingBuffer = pStagingBuffer;
+		reservation.offset = 0;
+		reservation.isDedicated = true;
+		return reservation;
+	}
+
+	void UploadManager_VK::RecordBufferCopy(const RawBuffer_VK* pStagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess)
+	{
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = stagingOffset;
+		copyRegion.dstOffset = 0;
+		copyRegion.size = size;
+
+		GetRecordingCommandBuffer()->CopyBufferToBuffer(pStagingBuffer, pDstBuffer, copyRegion);
+
+		BufferAcquire acquire{};
+		acquire.pBuffer = pDstBuffer;
+		acquire.dstStages = dstStages;
+		acquire.dstAccess = dstAccess;
+		m_recordingBufferAcquires.emplace_back(acquire);
+	}
+
+	bool UploadManager_VK::TryAllocateFromRing(VkDeviceSize size, VkDeviceSize& outOffset)
+	{
+		VkDeviceSize alignedSize = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+
+		// Allocations never straddle the end of the ring, the remaining space is skipped instead
+		VkDeviceSize padding = (m_ringHead + alignedSize > STAGING_RING_SIZE) ? STAGING_RING_SIZE - m_ringHead : 0;
+		if (m_ringUsedSize + padding + alignedSize > STAGING_RING_SIZE)
+		{
+			return false;
+		}
+
+		outOffset = (padding > 0) ? 0 : m_ringHead;
+		m_ringHead = (outOffset + alignedSize) % STAGING_RING_SIZE;
+		m_ringUsedSize += padding + alignedSize;
+		m_recordingRingUsage += padding + alignedSize;
+
+		return true;
+	}
+
+	void UploadManager_VK::SubmitOpenBatch()
+	{
+		// Batch with open reservations is picked up by a later submission instead
+		if (m_pRecordingCmdBuffer == nullptr || m_openReservationCount > 0)
+		{
+			return;
+		}
+
+		RecordReleaseBarriers();
+		m_pRecordingCmdBuffer->EndCommandBuffer();
+
+		TimelineSemaphore_VK* pSemaphore = m_pDevice->pSyncObjectManager->RequestTimelineSemaphore();
+		pSemaphore->waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		uint64_t signalValue = pSemaphore->m_signalValue;
+
+		VkTimelineSemaphoreSubmitInfo timelineSemaphoreSubmitInfo{};
+		timelineSemaphoreSubmitInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineSemaphoreSubmitInfo.signalSemaphoreValueCount = 1;
+		timelineSemaphoreSubmitInfo.pSignalSemaphoreValues = &signalValue;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineSemaphoreSubmitInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &m_pRecordingCmdBuffer->m_commandBuffer;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &pSemaphore->semaphore;
+
+		VkResult result;
+		{
+			// Transfer command manager submits to the same queue
+			std::lock_guard<std::mutex> guard(m_pDevice->pTransferCommandManager->GetWorkingQueueMutex());
+			result = vkQueueSubmit(m_pDevice->transferQueue.queue, 1, &submitInfo, VK_NULL_HANDLE);
+		}
+		if (result != VK_SUCCESS)
+		{
+			throw std::runtime_error("Vulkan: failed to submit upload batch.");
+			return;
+		}
+
+		m_pRecordingCmdBuffer->m_isRecording = false;
+		m_pRecordingCmdBuffer->m_inExecution = true;
+
+		InFlightBatch inFlightBatch{};
+		inFlightBatch.semaphore = pSemaphore->semaphore;
+		inFlightBatch.signalValue = signalValue;
+		inFlightBatch.ringUsage = m_recordingRingUsage;
+		inFlightBatch.pCmdBuffer = m_pRecordingCmdBuffer;
+		inFlightBatch.dedicatedStagingBuffers.swap(m_recordingDedicatedBuffers);
+		m_inFlightBatches.emplace_back(inFlightBatch);
+
+		PendingAcquireBatch acquireBatch{};
+		acquireBatch.uploadValue = m_recordingUploadValue;
+		acquireBatch.pSemaphore = pSemaphore;
+		acquireBatch.bufferAcquires.swap(m_recordingBufferAcquires);
+		acquireBatch.textureAcquires.swap(m_recordingTextureAcquires);
+		m_pendingAcquireBatches.emplace_back(acquireBatch);
+
+		m_pRecordingCmdBuffer = nullptr;
+		m_recordingRingUsage = 0;
+		m_recordingUploadValue++;
+	}
+
+	void UploadManager_VK::RetireCompletedBatches(bool waitOldest)
+	{
+		if (waitOldest && !m_inFlightBatches.empty())
+		{
+			VkSemaphoreWaitInfo waitInfo{};
+			waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+			waitInfo.semaphoreCount = 1;
+			waitInfo.pSemaphores = &m_inFlightBatches.front().semaphore;
+			waitInfo.pValues = &m_inFlightBatches.front().signalValue;
+
+			if (vkWaitSemaphores(m_pDevice->logicalDevice, &waitInfo, BATCH_TIMEOUT) != VK_SUCCESS)
+			{
+				throw std::runtime_error("Vulkan: upload batch timeout.");
+			}
+		}
+
+		// Semaphore could have been handed over and reused by then, which only moves its counter further
+		while (!m_inFlightBatches.empty())
+		{
+			InFlightBatch& batch = m_inFlightBatches.front();
+
+			uint64_t counterValue = 0;
+			vkGetSemaphoreCounterValue(m_pDevice->logicalDevice, batch.semaphore, &counterValue);
+			if (counterValue < batch.signalValue)
+			{
+				break;
+			}
+
+			m_ringUsedSize -= batch.ringUsage;
+
+			batch.pCmdBuffer->m_inExecution = false;
+			m_pCommandPool->m_freeCommandBuffers.Push(batch.pCmdBuffer);
+
+			for (auto& pBuffer : batch.dedicatedStagingBuffers)
+			{
+				CE_DELETE(pBuffer);
+			}
+
+			m_inFlightBatches.pop_front();
+		}
+
+		if (m_ringUsedSize == 0)
+		{
+			m_ringHead = 0;
+		}
+	}
+
+	void UploadManager_VK::RecordReleaseBarriers()
+	{
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+
+		for (auto& acquire : m_recordingBufferAcquires)
+		{
+			VkBufferMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			barrier.srcQueueFamilyIndex = m_pDevice->transferQueue.queueFamilyIndex;
+			barrier.dstQueueFamilyIndex = m_pDevice->graphicsQueue.queueFamilyIndex;
+			barrier.buffer = acquire.pBuffer->m_buffer;
+			barrier.offset = 0;
+			barrier.size = VK_WHOLE_SIZE;
+
+			bufferBarriers.emplace_back(barrier);
+		}
+
+		for (auto& acquire : m_recordingTextureAcquires)
+		{
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = m_pDevice->transferQueue.queueFamilyIndex;
+			barrier.dstQueueFamilyIndex = m_pDevice->graphicsQueue.queueFamilyIndex;
+			barrier.image = acquire.pTexture->m_image;
+			barrier.subresourceRange.aspectMask = acquire.pTexture->m_aspect;
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = acquire.pTexture->m_mipLevels;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+
+			imageBarriers.emplace_back(barrier);
+		}
+
+		m_pRecordingCmdBuffer->PipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, bufferBarriers, imageBarriers);
+	}
+}
\ No newline at end of file
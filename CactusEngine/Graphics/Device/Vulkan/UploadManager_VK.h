@@ -0,0 +1,123 @@
+#pragma once
+#include "NoCopy.h"
+#include "VulkanIncludes.h"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+
+namespace Engine
+{
+	struct LogicalDevice_VK;
+	class  RawBuffer_VK;
+	class  Texture2D_VK;
+	class  CommandBuffer_VK;
+	class  CommandPool_VK;
+	class  TimelineSemaphore_VK;
+
+	// Uploads resource data through a persistently mapped staging ring, copies are batched and submitted to the dedicated transfer queue
+	// Ownership of uploaded resources is released by transfer queue and acquired by the next graphics submission, which waits for the batch on GPU
+	// Each batch takes a value on the upload timeline, a resource is ready once the value it was recorded with has been acquired
+	class UploadManager_VK : public NoCopy
+	{
+	public:
+		UploadManager_VK(LogicalDevice_VK* pDevice);
+		~UploadManager_VK();
+
+		// Recording functions can be called from any thread, returned value is the upload timeline value the resource is ready at
+		uint64_t UploadBuffer(const void* pData, VkDeviceSize size, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+		uint64_t UploadTexture2D(const void* pData, VkDeviceSize size, Texture2D_VK* pDstTexture, const std::vector<VkBufferImageCopy>& regions, VkImageLayout newLayout, uint32_t appliedStages, bool generateMipmap); // Buffer offsets of regions are relative to data
+
+		// Staging memory can also be written in place by the caller, which saves the intermediate copy of generated data
+		// Upload lock is not held in between, so the caller is free to split the writing into jobs
+		// Alert: open batch is not submitted until all reservations are committed, a reservation should be committed as soon as it is written
+		struct StagingReservation
+		{
+			const RawBuffer_VK* pStagingBuffer;
+			VkDeviceSize		offset;
+			VkDeviceSize		size;
+			void*				pMappedData; // Aligned to STAGING_ALIGNMENT
+			bool				isDedicated;
+		};
+
+		StagingReservation ReserveStagingMemory(VkDeviceSize size);
+		uint64_t CommitBufferUpload(const StagingReservation& reservation, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+
+		void SubmitPendingUploads();
+		void AcquirePendingUploads(); // Must be called before each graphics queue submission that could use the uploaded resources
+
+		bool IsUploadComplete(uint64_t uploadValue) const;
+
+	private:
+		struct BufferAcquire
+		{
+			RawBuffer_VK*		 pBuffer;
+			VkPipelineStageFlags dstStages;
+			VkAccessFlags		 dstAccess;
+		};
+
+		struct TextureAcquire
+		{
+			Texture2D_VK* pTexture;
+			VkImageLayout newLayout;
+			uint32_t	  appliedStages;
+			bool		  generateMipmap;
+		};
+
+		struct PendingAcquireBatch
+		{
+			uint64_t uploadValue;
+			TimelineSemaphore_VK* pSemaphore; // Handed over to graphics command buffer once acquired
+			std::vector<BufferAcquire>	bufferAcquires;
+			std::vector<TextureAcquire> textureAcquires;
+		};
+
+		struct InFlightBatch
+		{
+			VkSemaphore		  semaphore;
+			uint64_t		  signalValue;
+			VkDeviceSize	  ringUsage; // Including the padding skipped at the end of the ring
+			CommandBuffer_VK* pCmdBuffer;
+			std::vector<RawBuffer_VK*> dedicatedStagingBuffers;
+		};
+
+	private:
+		CommandBuffer_VK* GetRecordingCommandBuffer();
+		VkDeviceSize WriteStagingData(const void* pData, VkDeviceSize size, const RawBuffer_VK*& pOutStagingBuffer); // Returns offset into the output staging buffer
+		StagingReservation AllocateStagingMemory(VkDeviceSize size); // Dedicated staging buffers are returned mapped
+		void RecordBufferCopy(const RawBuffer_VK* pStagingBuffer, VkDeviceSize stagingOffset, VkDeviceSize size, RawBuffer_VK* pDstBuffer, VkPipelineStageFlags dstStages, VkAccessFlags dstAccess);
+		bool TryAllocateFromRing(VkDeviceSize size, VkDeviceSize& outOffset);
+		void SubmitOpenBatch();
+		void RetireCompletedBatches(bool waitOldest);
+		void RecordReleaseBarriers();
+
+	public:
+		static const VkDeviceSize STAGING_RING_SIZE = 64 * 1024 * 1024; // Larger uploads fall back to dedicated staging buffers
+		static const VkDeviceSize STAGING_ALIGNMENT = 16; // Satisfies buffer-image copy offset requirement of all texture formats, including 16-byte compressed blocks
+		static const uint64_t BATCH_TIMEOUT = 3000000000; // 3 seconds, in nanoseconds
+
+	private:
+		LogicalDevice_VK* m_pDevice;
+		CommandPool_VK* m_pCommandPool; // Allocated from transfer queue family
+		std::mutex m_mutex;
+
+		RawBuffer_VK* m_pStagingRing;
+		uint8_t* m_pMappedRing;
+		VkDeviceSize m_ringHead;
+		VkDeviceSize m_ringUsedSize;
+
+		// Open batch, recorded until submitted
+		CommandBuffer_VK* m_pRecordingCmdBuffer;
+		VkDeviceSize m_recordingRingUsage;
+		std::vector<RawBuffer_VK*> m_recordingDedicatedBuffers;
+		std::vector<BufferAcquire> m_recordingBufferAcquires;
+		std::vector<TextureAcquire> m_recordingTextureAcquires;
+		uint64_t m_recordingUploadValue;
+		uint32_t m_openReservationCount; // Open batch is held back while any staging memory it owns is still being written
+
+		std::deque<InFlightBatch> m_inFlightBatches; // Staging memory is reclaimed in submission order
+		std::vector<PendingAcquireBatch> m_pendingAcquireBatches;
+		std::atomic<uint64_t> m_acquiredUploadValue;
+	};
+}
\ No newline at end of file
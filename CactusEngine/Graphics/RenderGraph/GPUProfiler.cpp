@@ -0,0 +1,233 @@
+#include "GPUProfiler.h"
+#include "LogUtility.h"
+#include "MemoryAllocator.h"
+#include "Timer.h"
+
+#include <fstream>
+#include <iomanip>
+#include <cstring>
+
+namespace Engine
+{
+	GPUProfiler::GPUProfiler(GraphicsDevice* pDevice)
+		: m_pDevice(pDevice),
+		m_pQueryPool(nullptr),
+		m_framesInFlight(0)
+	{
+
+	}
+
+	GPUProfiler::~GPUProfiler()
+	{
+		CE_SAFE_DELETE(m_pQueryPool);
+	}
+
+	uint32_t GPUProfiler::RegisterScope(const char* pName)
+	{
+		DEBUG_ASSERT_CE(m_pQueryPool == nullptr);
+
+		m_scopeNames.push_back(pName);
+		return (uint32_t)m_scopeNames.size() - 1;
+	}
+
+	void GPUProfiler::Initialize(uint32_t framesInFlight)
+	{
+		if (!m_pDevice->IsTimestampQuerySupported() || m_scopeNames.empty())
+		{
+			return;
+		}
+
+		m_framesInFlight = framesInFlight;
+		m_scopeRecorded.assign(framesInFlight * m_scopeNames.size(), 0);
+		m_slotFrames.assign(framesInFlight, 0);
+
+		// Each scope has a begin and an end timestamp in every frame slot
+		m_pDevice->CreateTimestampQueryPool(framesInFlight * (uint32_t)m_scopeNames.size() * 2, m_pQueryPool);
+	}
+
+	bool GPUProfiler::IsEnabled() const
+	{
+		return m_pQueryPool != nullptr;
+	}
+
+	void GPUProfiler::BeginFrame(uint32_t frameIndex)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		uint32_t scopeCount = (uint32_t)m_scopeNames.size();
+		uint8_t* pRecorded = &m_scopeRecorded[frameIndex * scopeCount];
+
+		FrameSample sample{};
+		sample.frame = m_slotFrames[frameIndex];
+		sample.scopeTimes.assign(scopeCount, -1.0f);
+
+		std::vector<uint64_t> timestamps;
+		m_pDevice->GetTimestampResults(m_pQueryPool, frameIndex * scopeCount * 2, scopeCount * 2, timestamps);
+
+		bool hasResult = false;
+		for (uint32_t i = 0; i < scopeCount; i++)
+		{
+			if (!pRecorded[i])
+			{
+				continue;
+			}
+			pRecorded[i] = 0;
+
+			uint64_t begin = timestamps[i * 2];
+			uint64_t end = timestamps[i * 2 + 1];
+
+			// Alert: a scope is dropped if its timestamps wrapped around within the frame
+			if (begin != GraphicsDevice::TIMESTAMP_UNAVAILABLE && end != GraphicsDevice::TIMESTAMP_UNAVAILABLE && end >= begin)
+			{
+				sample.scopeTimes[i] = (end - begin) * 1e-6f;
+				hasResult = true;
+			}
+		}
+
+		if (hasResult)
+		{
+			std::lock_guard<std::mutex> guard(m_historyMutex);
+			m_history.emplace_back(std::move(sample));
+			if (m_history.size() > HISTORY_LENGTH)
+			{
+				m_history.pop_front();
+			}
+		}
+
+		m_slotFrames[frameIndex] = Timer::GetCurrentFrame();
+	}
+
+	void GPUProfiler::BeginScope(uint32_t scope, uint32_t frameIndex, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		uint32_t queryIndex = (frameIndex * (uint32_t)m_scopeNames.size() + scope) * 2;
+		m_pDevice->ResetTimestampQueries(m_pQueryPool, queryIndex, 2, pCommandBuffer);
+		m_pDevice->WriteTimestamp(m_pQueryPool, queryIndex, false, pCommandBuffer);
+	}
+
+	void GPUProfiler::EndScope(uint32_t scope, uint32_t frameIndex, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		if (!IsEnabled())
+		{
+			return;
+		}
+
+		uint32_t queryIndex = (frameIndex * (uint32_t)m_scopeNames.size() + scope) * 2;
+		m_pDevice->WriteTimestamp(m_pQueryPool, queryIndex + 1, true, pCommandBuffer);
+
+		// Scopes of a frame slot are recorded by different threads, but each of them only writes its own flag
+		m_scopeRecorded[frameIndex * m_scopeNames.size() + scope] = 1;
+	}
+
+	uint32_t GPUProfiler::GetScopeCount() const
+	{
+		return (uint32_t)m_scopeNames.size();
+	}
+
+	const char* GPUProfiler::GetScopeName(uint32_t scope) const
+	{
+		DEBUG_ASSERT_CE(scope < m_scopeNames.size());
+		return m_scopeNames[scope];
+	}
+
+	bool GPUProfiler::GetScopeHistory(const char* pName, std::vector<float>& outTimes) const
+	{
+		int32_t scope = FindScope(pName);
+		if (scope < 0)
+		{
+			return false;
+		}
+
+		std::lock_guard<std::mutex> guard(m_historyMutex);
+		outTimes.resize(m_history.size());
+		for (uint32_t i = 0; i < m_history.size(); i++)
+		{
+			outTimes[i] = m_history[i].scopeTimes[scope];
+		}
+		return true;
+	}
+
+	float GPUProfiler::GetAverageTime(const char* pName) const
+	{
+		int32_t scope = FindScope(pName);
+		if (scope < 0)
+		{
+			return 0.0f;
+		}
+
+		std::lock_guard<std::mutex> guard(m_historyMutex);
+		float totalTime = 0.0f;
+		uint32_t sampleCount = 0;
+		for (auto& sample : m_history)
+		{
+			if (sample.scopeTimes[scope] >= 0.0f)
+			{
+				totalTime += sample.scopeTimes[scope];
+				sampleCount++;
+			}
+		}
+		return sampleCount > 0 ? totalTime / sampleCount : 0.0f;
+	}
+
+	bool GPUProfiler::DumpToCSV(const char* pFilePath) const
+	{
+		std::ofstream fileWriter(pFilePath, std::ios::trunc);
+		if (fileWriter.fail())
+		{
+			LOG_ERROR((std::string)"Cannot write GPU profiling results to " + pFilePath);
+			return false;
+		}
+
+		fileWriter << "Frame";
+		for (auto pName : m_scopeNames)
+		{
+			fileWriter << "," << pName;
+		}
+		fileWriter << "\n" << std::fixed << std::setprecision(4);
+
+		{
+			// Times are in milliseconds, cells are left empty for scopes not recorded in that frame
+			std::lock_guard<std::mutex> guard(m_historyMutex);
+			for (auto& sample : m_history)
+			{
+				fileWriter << sample.frame;
+				for (float time : sample.scopeTimes)
+				{
+					fileWriter << ",";
+					if (time >= 0.0f)
+					{
+						fileWriter << time;
+					}
+				}
+				fileWriter << "\n";
+			}
+		}
+
+		fileWriter.close();
+		if (fileWriter.fail())
+		{
+			LOG_ERROR((std::string)"Cannot write GPU profiling results to " + pFilePath);
+			return false;
+		}
+		return true;
+	}
+
+	int32_t GPUProfiler::FindScope(const char* pName) const
+	{
+		for (uint32_t i = 0; i < m_scopeNames.size(); i++)
+		{
+			if (strcmp(m_scopeNames[i], pName) == 0)
+			{
+				return (int32_t)i;
+			}
+		}
+		return -1;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+#include "GraphicsDevice.h"
+#include "NoCopy.h"
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+
+namespace Engine
+{
+	// Measures GPU execution time of scopes recorded into command buffers, render graph opens one scope per render node
+	// Results of a frame are resolved when its frame slot is reused, so the history lags behind by the number of frames in flight
+	class GPUProfiler : public NoCopy
+	{
+	public:
+		GPUProfiler(GraphicsDevice* pDevice);
+		~GPUProfiler();
+
+		uint32_t RegisterScope(const char* pName); // Scopes must be registered before initialization
+		void Initialize(uint32_t framesInFlight);  // Profiler stays disabled if device does not support timestamp queries
+		bool IsEnabled() const;
+
+		void BeginFrame(uint32_t frameIndex); // Resolves timestamps previously written in this frame slot, its commands must have finished execution
+		void BeginScope(uint32_t scope, uint32_t frameIndex, GraphicsCommandBuffer* pCommandBuffer); // Must be recorded outside of render pass
+		void EndScope(uint32_t scope, uint32_t frameIndex, GraphicsCommandBuffer* pCommandBuffer);
+
+		uint32_t GetScopeCount() const;
+		const char* GetScopeName(uint32_t scope) const;
+		bool GetScopeHistory(const char* pName, std::vector<float>& outTimes) const; // In milliseconds, oldest first, negative for frames in which the scope was not recorded
+		float GetAverageTime(const char* pName) const; // In milliseconds, over recorded frames in history
+
+		bool DumpToCSV(const char* pFilePath) const; // One row per resolved frame, one column per scope
+
+	private:
+		int32_t FindScope(const char* pName) const;
+
+	public:
+		static const uint32_t HISTORY_LENGTH = 512; // In frames
+
+	private:
+		struct FrameSample
+		{
+			uint64_t frame;
+			std::vector<float> scopeTimes;
+		};
+
+		GraphicsDevice* m_pDevice;
+		TimestampQueryPool* m_pQueryPool;
+		uint32_t m_framesInFlight;
+
+		std::vector<const char*> m_scopeNames;
+		std::vector<uint8_t> m_scopeRecorded; // Per frame slot and scope, set once both timestamps of the scope are recorded
+		std::vector<uint64_t> m_slotFrames;	  // Frame number each slot was last recorded in
+
+		mutable std::mutex m_historyMutex;
+		std::deque<FrameSample> m_history;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "MeshletCuller.h"
+#include "JobSystem.h"
+#include "LogUtility.h"
+
+namespace Engine
+{
+	bool MeshletCuller::CullMesh(const Mesh* pMesh, const Matrix4x4& modelMatrix, const Matrix4x4& viewProjectionMatrix, const Vector3& viewVector, bool isOrthographic)
+	{
+		auto pMeshlets = pMesh->GetMeshlets();
+		if (pMeshlets->empty())
+		{
+			return false;
+		}
+
+		// Planes are extracted from model-view-projection matrix, so that tests run in object space without transforming any bounds
+		// Alert: normal cone test assumes model matrix has uniform scale
+		CullingView view{};
+		Matrix4x4 mvp = viewProjectionMatrix * modelMatrix;
+		Vector4 rows[4];
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			rows[i] = Vector4(mvp[0][i], mvp[1][i], mvp[2][i], mvp[3][i]);
+		}
+		view.planes[0] = rows[3] + rows[0];
+		view.planes[1] = rows[3] - rows[0];
+		view.planes[2] = rows[3] + rows[1];
+		view.planes[3] = rows[3] - rows[1];
+		view.planes[4] = rows[3] + rows[2];
+		view.planes[5] = rows[3] - rows[2];
+		for (auto& plane : view.planes)
+		{
+			float length = glm::length(Vector3(plane));
+			plane = length > 0 ? plane / length : Vector4(0, 0, 0, 1);
+		}
+
+		Matrix4x4 inverseModelMatrix = glm::inverse(modelMatrix);
+		view.isOrthographic = isOrthographic;
+		view.viewVector = isOrthographic
+			? glm::normalize(Vector3(inverseModelMatrix * Vector4(viewVector, 0.0f)))
+			: Vector3(inverseModelMatrix * Vector4(viewVector, 1.0f));
+
+		uint32_t meshletCount = (uint32_t)pMeshlets->size();
+		m_meshletVisibility.resize(meshletCount);
+
+		auto cullMeshlet = [this, pMeshlets, &view](uint32_t index)
+		{
+			m_meshletVisibility[index] = IsMeshletVisible(pMeshlets->at(index), view) ? 1 : 0;
+		};
+
+		if (meshletCount > CULLING_BATCH_SIZE)
+		{
+			JobSystem::ParallelFor(meshletCount, CULLING_BATCH_SIZE, cullMeshlet);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < meshletCount; ++i)
+			{
+				cullMeshlet(i);
+			}
+		}
+
+		// Compact visible meshlets into as few draws as possible, meshlets are ordered so that neighbors can be merged
+		auto pSubMeshes = pMesh->GetSubMeshes();
+		m_drawRanges.resize(pSubMeshes->size());
+		for (auto& ranges : m_drawRanges)
+		{
+			ranges.clear();
+		}
+
+		m_visibleMeshletCount = 0;
+		for (uint32_t i = 0; i < meshletCount; ++i)
+		{
+			if (!m_meshletVisibility[i])
+			{
+				continue;
+			}
+			m_visibleMeshletCount++;
+
+			auto& meshlet = pMeshlets->at(i);
+			if (meshlet.m_subMeshIndex >= m_drawRanges.size())
+			{
+				continue;
+			}
+
+			auto& ranges = m_drawRanges[meshlet.m_subMeshIndex];
+			if (!ranges.empty() && ranges.back().m_baseIndex + ranges.back().m_numIndices == meshlet.m_baseIndex)
+			{
+				ranges.back().m_numIndices += meshlet.m_numIndices;
+			}
+			else
+			{
+				SubMesh range{};
+				range.m_baseIndex = meshlet.m_baseIndex;
+				range.m_numIndices = meshlet.m_numIndices;
+				range.m_baseVertex = pSubMeshes->at(meshlet.m_subMeshIndex).m_baseVertex;
+				ranges.emplace_back(range);
+			}
+		}
+
+		return true;
+	}
+
+	const std::vector<SubMesh>& MeshletCuller::GetDrawRanges(uint32_t subMeshIndex) const
+	{
+		DEBUG_ASSERT_CE(subMeshIndex < m_drawRanges.size());
+		return m_drawRanges[subMeshIndex];
+	}
+
+	uint32_t MeshletCuller::GetVisibleMeshletCount() const
+	{
+		return m_visibleMeshletCount;
+	}
+
+	bool MeshletCuller::IsMeshletVisible(const Meshlet& meshlet, const CullingView& view)
+	{
+		for (auto& plane : view.planes)
+		{
+			if (glm::dot(Vector3(plane), meshlet.m_center) + plane.w < -meshlet.m_radius)
+			{
+				return false;
+			}
+		}
+
+		// All triangles are back facing if the whole bounding sphere is outside of the cone apex region
+		if (view.isOrthographic)
+		{
+			return meshlet.m_coneCutoff >= 1.0f || glm::dot(view.viewVector, meshlet.m_coneAxis) < meshlet.m_coneCutoff;
+		}
+
+		Vector3 toCenter = meshlet.m_center - view.viewVector;
+		return glm::dot(toCenter, meshlet.m_coneAxis) < meshlet.m_coneCutoff * glm::length(toCenter) + meshlet.m_radius;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "Mesh.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	// Culls meshlets of a mesh against view frustum and by their normal cones, visible meshlets are merged into index ranges per submesh
+	// Each render node owns its culler, results are valid until the next call
+	class MeshletCuller
+	{
+	public:
+		MeshletCuller() = default;
+		~MeshletCuller() = default;
+
+		// Returns false if the mesh has no meshlets, in which case submeshes should be drawn whole
+		// View vector is the camera position for perspective views, or the view direction for orthographic views, both in world space
+		bool CullMesh(const Mesh* pMesh, const Matrix4x4& modelMatrix, const Matrix4x4& viewProjectionMatrix, const Vector3& viewVector, bool isOrthographic);
+		const std::vector<SubMesh>& GetDrawRanges(uint32_t subMeshIndex) const; // Base vertex of ranges is the one of the submesh
+
+		uint32_t GetVisibleMeshletCount() const;
+
+	private:
+		struct CullingView
+		{
+			Vector4 planes[6]; // Object space frustum planes, normalized, pointing inwards
+			Vector3 viewVector; // Object space camera position, or view direction if orthographic
+			bool	isOrthographic;
+		};
+
+		static bool IsMeshletVisible(const Meshlet& meshlet, const CullingView& view);
+
+	public:
+		static const uint32_t CULLING_BATCH_SIZE = 256; // Meshlets tested per job, meshes with fewer meshlets are culled on calling thread
+
+	private:
+		std::vector<uint8_t> m_meshletVisibility;
+		std::vector<std::vector<SubMesh>> m_drawRanges;
+		uint32_t m_visibleMeshletCount = 0;
+	};
+}
\ No newline at end of file
@@ -25,9 +25,12 @@ namespace Engine
 		m_inputResourceNames[INPUT_GBUFFER_POSITION] = nullptr;
 		m_inputResourceNames[INPUT_DEPTH_TEXTURE] = nullptr;
 
-		// Reserve by 512 KB; this should be enough for most cases
-		// Assuming each light source takes up 512 bytes, this would be enough for 1024 light sources until a new region is allocated
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 512 * 1024);
+		m_inputResourceAccesses[INPUT_GBUFFER_COLOR] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_GBUFFER_NORMAL] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_GBUFFER_POSITION] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_DEPTH_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void DeferredLightingRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -41,7 +44,7 @@ namespace Engine
 		colorDesc.storeOp = EAttachmentOperation::Store;
 		colorDesc.stencilLoadOp = EAttachmentOperation::None;
 		colorDesc.stencilStoreOp = EAttachmentOperation::None;
-		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ShaderReadOnly;
+		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ColorAttachment;
 		colorDesc.usageLayout = EImageLayout::ColorAttachment;
 		colorDesc.finalLayout = colorDesc.initialLayout;
 		colorDesc.type = EAttachmentType::Color;
@@ -158,11 +161,8 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void DeferredLightingRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void DeferredLightingRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
-		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
-
 		// Color output
 
 		if (!m_outputToSwapchain)
@@ -170,15 +170,27 @@ namespace Engine
 			Texture2DCreateInfo texCreateInfo{};
 			texCreateInfo.generateMipmap = false;
 			texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-			texCreateInfo.textureWidth = width;
-			texCreateInfo.textureHeight = height;
+			texCreateInfo.textureWidth = initInfo.width * initInfo.renderScale;
+			texCreateInfo.textureHeight = initInfo.height * initInfo.renderScale;
 			texCreateInfo.format = initInfo.colorFormat;
 			texCreateInfo.textureType = ETextureType::ColorAttachment;
-			texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
 
+			DeclareTransientTexture(OUTPUT_COLOR_TEXTURE, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
+		}
+	}
+
+	void DeferredLightingRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
+
+		// Color output
+
+		if (!m_outputToSwapchain)
+		{
 			for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 			{
-				m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorOutput);
+				CreateTransientTexture(OUTPUT_COLOR_TEXTURE, i, m_frameResources[i].m_pColorOutput);
 				m_graphResources[i]->Add(OUTPUT_COLOR_TEXTURE, m_frameResources[i].m_pColorOutput);
 			}
 		}
@@ -204,30 +216,34 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 		ShaderParameterTable shaderParamTable{};
 
 		m_pDevice->BeginRenderPass(m_pRenderPassObject, frameResources.m_pFrameBuffer, pCommandBuffer);
 
-		DirectionalLighting(pGraphResources, pCommandBuffer, shaderParamTable);
+		DirectionalLighting(pGraphResources, renderContext, pCommandBuffer, shaderParamTable);
 		RegularLighting(pGraphResources, renderContext, pCommandBuffer, shaderParamTable);
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
 	}
 
-	void DeferredLightingRenderNode::DirectionalLighting(RenderGraphResource* pGraphResources, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable)
+	void DeferredLightingRenderNode::DirectionalLighting(RenderGraphResource* pGraphResources, const RenderContext& renderContext, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable)
 	{
 		// Prepare shader
 		auto pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::DeferredLighting_Directional);
-		auto pGBufferColorTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_COLOR));
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GCOLOR_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferColorTexture);
+		auto pGBufferColorTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_COLOR));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GCOLOR_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferColorTexture);
 
 		// Draw
 		m_pDevice->BindGraphicsPipeline(GetGraphicsPipeline((uint32_t)EBuiltInShaderProgramType::DeferredLighting_Directional), pCommandBuffer);
 		m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
-		m_pDevice->DrawFullScreenQuad(pCommandBuffer);
+		m_pDevice->DrawFullScreenQuad(pCommandBuffer, GetInputTexCoordScale(renderContext));
 	}
 
 	void DeferredLightingRenderNode::RegularLighting(RenderGraphResource* pGraphResources, const RenderContext& renderContext, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable)
@@ -242,10 +258,10 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		// Get input textures
-		auto pGBufferColorTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_COLOR));
-		auto pGBufferNormalTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_NORMAL));
-		auto pGBufferPositionTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_POSITION));
-		auto pSceneDepthTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_DEPTH_TEXTURE));
+		auto pGBufferColorTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_COLOR));
+		auto pGBufferNormalTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_NORMAL));
+		auto pGBufferPositionTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_POSITION));
+		auto pSceneDepthTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_DEPTH_TEXTURE));
 
 		// Update camera uniform buffers
 
@@ -297,6 +313,8 @@ namespace Engine
 			UBLightSourceProperties ubLightSourceProperties{};
 
 			ubTransformMatrices.modelMatrix = pTransformComp->GetModelMatrix();
+			ubTransformMatrices.positionScale = lightProfile.pVolumeMesh->GetPositionScale();
+			ubTransformMatrices.positionOffset = lightProfile.pVolumeMesh->GetPositionOffset();
 			transformMatrices_UB.UpdateBufferData(&ubTransformMatrices);
 
 			ubLightSourceProperties.source = Vector4(pTransformComp->GetPosition(), (int)lightProfile.sourceType);
@@ -313,16 +331,16 @@ namespace Engine
 
 			shaderParamTable.Clear();
 
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
 
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::LIGHTSOURCE_PROPERTIES), EDescriptorType::UniformBuffer, &lightSourceProperties_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::LIGHTSOURCE_PROPERTIES), EDescriptorType::UniformBuffer, &lightSourceProperties_UB);
 
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GCOLOR_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferColorTexture);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GNORMAL_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferNormalTexture);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GPOSITION_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferPositionTexture);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler, pSceneDepthTexture);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GCOLOR_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferColorTexture);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GNORMAL_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferNormalTexture);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GPOSITION_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferPositionTexture);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler, pSceneDepthTexture);
 
 			m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
@@ -342,7 +360,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		if (m_outputToSwapchain)
 		{
@@ -10,6 +10,7 @@ namespace Engine
 
 	protected:
 		void CreateConstantResources(const RenderNodeConfiguration& initInfo) override;
+		void DeclareTransientResources(const RenderNodeConfiguration& initInfo) override;
 		void CreateMutableResources(const RenderNodeConfiguration& initInfo) override;
 		void DestroyMutableResources() override;
 
@@ -21,7 +22,7 @@ namespace Engine
 		GraphicsPipelineObject* GetGraphicsPipeline(uint32_t key) override;
 
 	private:
-		void DirectionalLighting(RenderGraphResource* pGraphResources, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable);
+		void DirectionalLighting(RenderGraphResource* pGraphResources, const RenderContext& renderContext, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable);
 		void RegularLighting(RenderGraphResource* pGraphResources, const RenderContext& renderContext, GraphicsCommandBuffer* pCommandBuffer, ShaderParameterTable& shaderParamTable);
 
 		void CreateMutableTextures(const RenderNodeConfiguration& initInfo);
@@ -11,14 +11,19 @@ namespace Engine
 	const char* DepthOfFieldRenderNode::INPUT_COLOR_TEXTURE = "DOFInputColorTexture";
 	const char* DepthOfFieldRenderNode::INPUT_GBUFFER_POSITION = "DOFInputGBufferPosition";
 
+	const char* DepthOfFieldRenderNode::INTERNAL_INPUT_MIPMAP = "DOFInputMipmapTexture";
+	const char* DepthOfFieldRenderNode::INTERNAL_COLOR_OUTPUT = "DOFColorOutputTexture";
+
 	DepthOfFieldRenderNode::DepthOfFieldRenderNode(std::vector<RenderGraphResource*>& graphResources, BaseRenderer* pRenderer)
 		: RenderNode(graphResources, pRenderer)
 	{
 		m_inputResourceNames[INPUT_COLOR_TEXTURE] = nullptr;
 		m_inputResourceNames[INPUT_GBUFFER_POSITION] = nullptr;
 
-		// Reserve 2 KB; more than enough for this node
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 2 * 1024);
+		m_inputResourceAccesses[INPUT_COLOR_TEXTURE] = ETextureAccessType::TransferRead;
+		m_inputResourceAccesses[INPUT_GBUFFER_POSITION] = ETextureAccessType::FragmentShaderRead;
+
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void DepthOfFieldRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -32,7 +37,7 @@ namespace Engine
 		colorDesc.storeOp = EAttachmentOperation::Store;
 		colorDesc.stencilLoadOp = EAttachmentOperation::None;
 		colorDesc.stencilStoreOp = EAttachmentOperation::None;
-		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ShaderReadOnly;
+		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ColorAttachment;
 		colorDesc.usageLayout = EImageLayout::ColorAttachment;
 		colorDesc.finalLayout = colorDesc.initialLayout;
 		colorDesc.type = EAttachmentType::Color;
@@ -124,34 +129,43 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void DepthOfFieldRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void DepthOfFieldRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
-		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
-
 		Texture2DCreateInfo texCreateInfo{};
 		texCreateInfo.generateMipmap = false;
 		texCreateInfo.reserveMipmapMemory = true;
 		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-		texCreateInfo.textureWidth = width;
-		texCreateInfo.textureHeight = height;
+		texCreateInfo.textureWidth = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		texCreateInfo.textureHeight = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
 		texCreateInfo.format = initInfo.colorFormat;
 		texCreateInfo.textureType = ETextureType::SampledImage;
-		texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
 
-		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
-		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorInputMipmap);
-		}
+		DeclareTransientTexture(INTERNAL_INPUT_MIPMAP, texCreateInfo, ETextureAccessType::FragmentShaderRead); // Copy and mipmap generation transition it on their own
 
 		if (!m_outputToSwapchain)
 		{
 			texCreateInfo.reserveMipmapMemory = false;
 			texCreateInfo.textureType = ETextureType::ColorAttachment;
 
+			DeclareTransientTexture(INTERNAL_COLOR_OUTPUT, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
+		}
+	}
+
+	void DepthOfFieldRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
+
+		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
+		{
+			CreateTransientTexture(INTERNAL_INPUT_MIPMAP, i, m_frameResources[i].m_pColorInputMipmap);
+		}
+
+		if (!m_outputToSwapchain)
+		{
 			for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 			{
-				m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorOutput);
+				CreateTransientTexture(INTERNAL_COLOR_OUTPUT, i, m_frameResources[i].m_pColorOutput);
 			}
 		}
 
@@ -183,6 +197,9 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 		ShaderParameterTable shaderParamTable{};
 
 		// Prepare uniform buffers
@@ -204,7 +221,7 @@ namespace Engine
 		cameraProperties_UB.UpdateBufferData(&ubCameraProperties);
 
 		// Generate color input mipmap
-		m_pDevice->CopyTexture2D((Texture2D*)(pGraphResources->Get(m_inputResourceNames.at(INPUT_COLOR_TEXTURE))), frameResources.m_pColorInputMipmap, pCommandBuffer);
+		m_pDevice->CopyTexture2D((Texture2D*)(pGraphResources->Get(m_inputResourceHandles.at(INPUT_COLOR_TEXTURE))), frameResources.m_pColorInputMipmap, pCommandBuffer);
 		m_pDevice->GenerateMipmap(frameResources.m_pColorInputMipmap, pCommandBuffer);
 
 		// Execute render pass
@@ -216,21 +233,22 @@ namespace Engine
 
 		auto pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::DOF);
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler, frameResources.m_pColorInputMipmap);
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GPOSITION_TEXTURE), EDescriptorType::CombinedImageSampler,
-			pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_POSITION)));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler, frameResources.m_pColorInputMipmap);
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GPOSITION_TEXTURE), EDescriptorType::CombinedImageSampler,
+			pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_POSITION)));
 
 		m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
 		// Draw
-		m_pDevice->DrawFullScreenQuad(pCommandBuffer);
+		m_pDevice->DrawFullScreenQuad(pCommandBuffer, GetInputTexCoordScale(renderContext));
 		m_pDevice->EndRenderPass(pCommandBuffer);
 
 		// Submission
 
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -242,7 +260,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		if (m_outputToSwapchain)
 		{
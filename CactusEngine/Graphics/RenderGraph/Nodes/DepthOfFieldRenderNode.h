@@ -10,6 +10,7 @@ namespace Engine
 
 	protected:
 		void CreateConstantResources(const RenderNodeConfiguration& initInfo) override;
+		void DeclareTransientResources(const RenderNodeConfiguration& initInfo) override;
 		void CreateMutableResources(const RenderNodeConfiguration& initInfo) override;
 		void DestroyMutableResources() override;
 
@@ -28,6 +29,9 @@ namespace Engine
 		static const char* INPUT_GBUFFER_POSITION;
 
 	private:
+		static const char* INTERNAL_INPUT_MIPMAP;
+		static const char* INTERNAL_COLOR_OUTPUT;
+
 		struct FrameResources
 		{
 			FrameResources()
@@ -9,14 +9,14 @@ namespace Engine
 	const char* GBufferRenderNode::OUTPUT_NORMAL_GBUFFER = "NormalGBufferTexture";
 	const char* GBufferRenderNode::OUTPUT_POSITION_GBUFFER = "PositionGBufferTexture";
 
+	const char* GBufferRenderNode::INTERNAL_DEPTH_BUFFER = "GBufferDepthTexture";
+
 	const ETextureFormat GBUFFER_COLOR_FORMAT = ETextureFormat::RGBA32F;
 
 	GBufferRenderNode::GBufferRenderNode(std::vector<RenderGraphResource*>& graphResources, BaseRenderer* pRenderer)
 		: RenderNode(graphResources, pRenderer)
 	{
-		// Reserve by 1 MB; this should be enough for most cases
-		// Assuming each mesh takes up 512 bytes, this would be enough for 2048 meshes until a new region is allocated
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 1 * 1024 * 1024);
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void GBufferRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -32,9 +32,9 @@ namespace Engine
 		normalDesc.storeOp = EAttachmentOperation::Store;
 		normalDesc.stencilLoadOp = EAttachmentOperation::None;
 		normalDesc.stencilStoreOp = EAttachmentOperation::None;
-		normalDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		normalDesc.initialLayout = EImageLayout::ColorAttachment;
 		normalDesc.usageLayout = EImageLayout::ColorAttachment;
-		normalDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		normalDesc.finalLayout = EImageLayout::ColorAttachment;
 		normalDesc.type = EAttachmentType::Color;
 		normalDesc.index = 0;
 
@@ -45,9 +45,9 @@ namespace Engine
 		positionDesc.storeOp = EAttachmentOperation::Store;
 		positionDesc.stencilLoadOp = EAttachmentOperation::None;
 		positionDesc.stencilStoreOp = EAttachmentOperation::None;
-		positionDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		positionDesc.initialLayout = EImageLayout::ColorAttachment;
 		positionDesc.usageLayout = EImageLayout::ColorAttachment;
-		positionDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		positionDesc.finalLayout = EImageLayout::ColorAttachment;
 		positionDesc.type = EAttachmentType::Color;
 		positionDesc.index = 1;
 
@@ -151,40 +151,44 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void GBufferRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void GBufferRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = initInfo.width * initInfo.renderScale;
-		uint32_t height = initInfo.height * initInfo.renderScale;
-
 		// GBuffer color textures
 
 		Texture2DCreateInfo texCreateInfo{};
 		texCreateInfo.generateMipmap = false;
 		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-		texCreateInfo.textureWidth = width;
-		texCreateInfo.textureHeight = height;
+		texCreateInfo.textureWidth = initInfo.width * initInfo.renderScale;
+		texCreateInfo.textureHeight = initInfo.height * initInfo.renderScale;
 		texCreateInfo.format = GBUFFER_COLOR_FORMAT;
 		texCreateInfo.textureType = ETextureType::ColorAttachment;
-		texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
-
-		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
-		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pNormalOutput);
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pPositionOutput);
 
-			m_graphResources[i]->Add(OUTPUT_NORMAL_GBUFFER, m_frameResources[i].m_pNormalOutput);
-			m_graphResources[i]->Add(OUTPUT_POSITION_GBUFFER, m_frameResources[i].m_pPositionOutput);
-		}
+		DeclareTransientTexture(OUTPUT_NORMAL_GBUFFER, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
+		DeclareTransientTexture(OUTPUT_POSITION_GBUFFER, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
 
 		// Depth attachment
 
 		texCreateInfo.format = initInfo.depthFormat;
 		texCreateInfo.textureType = ETextureType::DepthAttachment;
-		texCreateInfo.initialLayout = EImageLayout::DepthStencilAttachment;
+
+		DeclareTransientTexture(INTERNAL_DEPTH_BUFFER, texCreateInfo, ETextureAccessType::DepthStencilAttachmentWrite);
+	}
+
+	void GBufferRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = initInfo.width * initInfo.renderScale;
+		uint32_t height = initInfo.height * initInfo.renderScale;
+
+		// GBuffer color textures and depth attachment
 
 		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pDepthBuffer);
+			CreateTransientTexture(OUTPUT_NORMAL_GBUFFER, i, m_frameResources[i].m_pNormalOutput);
+			CreateTransientTexture(OUTPUT_POSITION_GBUFFER, i, m_frameResources[i].m_pPositionOutput);
+			CreateTransientTexture(INTERNAL_DEPTH_BUFFER, i, m_frameResources[i].m_pDepthBuffer);
+
+			m_graphResources[i]->Add(OUTPUT_NORMAL_GBUFFER, m_frameResources[i].m_pNormalOutput);
+			m_graphResources[i]->Add(OUTPUT_POSITION_GBUFFER, m_frameResources[i].m_pPositionOutput);
 		}
 
 		// Frame buffer
@@ -216,6 +220,9 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 		// Use normal-only shader for all meshes. Alert: This will invalidate vertex shader animation
 		auto pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::GBuffer);
 		ShaderParameterTable shaderParamTable{};
@@ -240,6 +247,8 @@ namespace Engine
 		m_pDevice->BeginRenderPass(m_pRenderPassObject, frameResources.m_pFrameBuffer, pCommandBuffer);
 		m_pDevice->BindGraphicsPipeline(GetGraphicsPipeline((uint32_t)EBuiltInShaderProgramType::GBuffer), pCommandBuffer);
 
+		bool enableMeshletCulling = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMeshletCulling();
+
 		for (auto& entity : *renderContext.pOpaqueDrawList)
 		{
 			auto pTransformComp = (TransformComponent*)entity->GetComponent(EComponentType::Transform);
@@ -254,6 +263,14 @@ namespace Engine
 			{
 				continue;
 			}
+
+			// Meshlets outside of view or facing away are skipped, meshes without meshlets are drawn whole
+			bool useMeshletRanges = enableMeshletCulling && m_meshletCuller.CullMesh(pMesh, pTransformComp->GetModelMatrix(), projectionMat * viewMat, cameraPos, false);
+			if (useMeshletRanges && m_meshletCuller.GetVisibleMeshletCount() == 0)
+			{
+				continue;
+			}
+
 			m_pDevice->SetVertexBuffer(pMesh->GetVertexBuffer(), pCommandBuffer);
 
 			// Update uniform buffer
@@ -264,14 +281,16 @@ namespace Engine
 
 			ubTransformMatrices.modelMatrix = pTransformComp->GetModelMatrix();
 			ubTransformMatrices.normalMatrix = pTransformComp->GetNormalMatrix();
+			ubTransformMatrices.positionScale = pMesh->GetPositionScale();
+			ubTransformMatrices.positionOffset = pMesh->GetPositionOffset();
 			transformMatrices_UB.UpdateBufferData(&ubTransformMatrices);
 
 			// Update shader resources
 
 			shaderParamTable.Clear();
 
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
-			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+			shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
 
 			m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
@@ -289,13 +308,14 @@ namespace Engine
 					continue;
 				}
 
-				m_pDevice->DrawPrimitive(pSubMeshes->at(i).m_numIndices, pSubMeshes->at(i).m_baseIndex, pSubMeshes->at(i).m_baseVertex, pCommandBuffer);
+				DrawSubMesh(pMesh, i, useMeshletRanges, pCommandBuffer);
 			}
 		}
 
 		// End pass and submit
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -307,7 +327,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		m_defaultPipelineStates.pViewportState->UpdateResolution(width * m_configuration.renderScale, height * m_configuration.renderScale);
 	}
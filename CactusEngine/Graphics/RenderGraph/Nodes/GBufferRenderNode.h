@@ -10,6 +10,7 @@ namespace Engine
 
 	protected:
 		void CreateConstantResources(const RenderNodeConfiguration& initInfo) override;
+		void DeclareTransientResources(const RenderNodeConfiguration& initInfo) override;
 		void CreateMutableResources(const RenderNodeConfiguration& initInfo) override;
 		void DestroyMutableResources() override;
 
@@ -28,6 +29,8 @@ namespace Engine
 		static const char* OUTPUT_POSITION_GBUFFER;
 
 	private:
+		static const char* INTERNAL_DEPTH_BUFFER;
+
 		struct FrameResources
 		{
 			FrameResources()
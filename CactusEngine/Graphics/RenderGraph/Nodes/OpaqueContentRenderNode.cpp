@@ -18,9 +18,10 @@ namespace Engine
 		m_inputResourceNames[INPUT_GBUFFER_NORMAL] = nullptr;
 		m_inputResourceNames[INPUT_SHADOW_MAP] = nullptr;
 
-		// Reserve by 1 MB; this should be enough for most cases
-		// Assuming each mesh takes up 512 bytes, this would be enough for 2048 meshes until a new region is allocated
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 1 * 1024 * 1024);
+		m_inputResourceAccesses[INPUT_GBUFFER_NORMAL] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_SHADOW_MAP] = ETextureAccessType::FragmentShaderRead;
+
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void OpaqueContentRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -34,7 +35,7 @@ namespace Engine
 		colorDesc.storeOp = EAttachmentOperation::Store;
 		colorDesc.stencilLoadOp = EAttachmentOperation::None;
 		colorDesc.stencilStoreOp = EAttachmentOperation::None;
-		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ShaderReadOnly;
+		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ColorAttachment;
 		colorDesc.usageLayout = EImageLayout::ColorAttachment;
 		colorDesc.finalLayout = colorDesc.initialLayout;
 		colorDesc.type = EAttachmentType::Color;
@@ -47,9 +48,9 @@ namespace Engine
 		depthDesc.storeOp = EAttachmentOperation::Store;
 		depthDesc.stencilLoadOp = EAttachmentOperation::None;
 		depthDesc.stencilStoreOp = EAttachmentOperation::None;
-		depthDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.initialLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.usageLayout = EImageLayout::DepthStencilAttachment;
-		depthDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.finalLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.type = EAttachmentType::Depth;
 		depthDesc.index = 1;
 
@@ -138,28 +139,21 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void OpaqueContentRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void OpaqueContentRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
-		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
-
 		// Color output and shadow mark output
 
 		Texture2DCreateInfo texCreateInfo{};
 		texCreateInfo.generateMipmap = false;
 		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-		texCreateInfo.textureWidth = width;
-		texCreateInfo.textureHeight = height;
+		texCreateInfo.textureWidth = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		texCreateInfo.textureHeight = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
 		texCreateInfo.format = ETextureFormat::RGBA8_SRGB;
 		texCreateInfo.textureType = ETextureType::ColorAttachment;
-		texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
 
 		if (!m_outputToSwapchain)
 		{
-			for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
-			{
-				m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorOutput);
-			}
+			DeclareTransientTexture(OUTPUT_COLOR_TEXTURE, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
 		}
 
 		// Depth output
@@ -167,9 +161,29 @@ namespace Engine
 		texCreateInfo.format = initInfo.depthFormat;
 		texCreateInfo.textureType = ETextureType::DepthAttachment;
 
+		DeclareTransientTexture(OUTPUT_DEPTH_TEXTURE, texCreateInfo, ETextureAccessType::DepthStencilAttachmentWrite);
+	}
+
+	void OpaqueContentRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
+
+		// Color output and shadow mark output
+
+		if (!m_outputToSwapchain)
+		{
+			for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
+			{
+				CreateTransientTexture(OUTPUT_COLOR_TEXTURE, i, m_frameResources[i].m_pColorOutput);
+			}
+		}
+
+		// Depth output
+
 		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pDepthOutput);
+			CreateTransientTexture(OUTPUT_DEPTH_TEXTURE, i, m_frameResources[i].m_pDepthOutput);
 
 			m_graphResources[i]->Add(OUTPUT_COLOR_TEXTURE, m_frameResources[i].m_pColorOutput);
 			m_graphResources[i]->Add(OUTPUT_DEPTH_TEXTURE, m_frameResources[i].m_pDepthOutput);
@@ -205,16 +219,23 @@ namespace Engine
 		m_pUniformBufferAllocator->ResetReservedRegion();
 		auto& frameResources = m_frameResources[m_frameIndex];
 
-		auto pGBufferNormalTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_GBUFFER_NORMAL));
-		auto pShadowMapTexture = (Texture2D*)pGraphResources->Get(m_inputResourceNames.at(INPUT_SHADOW_MAP));
+		auto pGBufferNormalTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_GBUFFER_NORMAL));
+		auto pShadowMapTexture = (Texture2D*)pGraphResources->Get(m_inputResourceHandles.at(INPUT_SHADOW_MAP));
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 
 		ShaderProgram* pShaderProgram = nullptr;
 		EBuiltInShaderProgramType lastUsedShaderProgramType = EBuiltInShaderProgramType::NONE;
 		ShaderParameterTable shaderParamTable{};
 		ESamplerAnisotropyLevel samplerAFLevel = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetTextureAnisotropyLevel();
 
+		// With bindless texturing, material resources are fetched by index and per entity descriptors only need to be updated once
+		bool useBindless = m_pDevice->IsBindlessTexturingEnabled();
+		bool entityParamsDirty = true;
+
 		// Prepare camera & light uniform buffers
 
 		UniformBuffer cameraMatrices_UB = m_pUniformBufferAllocator->GetUniformBuffer(sizeof(UBCameraMatrices));
@@ -249,6 +270,8 @@ namespace Engine
 
 		m_pDevice->BeginRenderPass(m_pRenderPassObject, frameResources.m_pFrameBuffer, pCommandBuffer);
 
+		bool enableMeshletCulling = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMeshletCulling();
+
 		for (auto& entity : *renderContext.pOpaqueDrawList)
 		{
 			// Skip non-mesh entities
@@ -268,6 +291,14 @@ namespace Engine
 			{
 				continue;
 			}
+
+			// Meshlets outside of view or facing away are skipped, meshes without meshlets are drawn whole
+			bool useMeshletRanges = enableMeshletCulling && m_meshletCuller.CullMesh(pMesh, pTransformComp->GetModelMatrix(), projectionMat * viewMat, cameraPos, false);
+			if (useMeshletRanges && m_meshletCuller.GetVisibleMeshletCount() == 0)
+			{
+				continue;
+			}
+
 			m_pDevice->SetVertexBuffer(pMesh->GetVertexBuffer(), pCommandBuffer);
 
 			// Update per mesh uniform
@@ -278,7 +309,10 @@ namespace Engine
 
 			ubTransformMatrices.modelMatrix = pTransformComp->GetModelMatrix();
 			ubTransformMatrices.normalMatrix = pTransformComp->GetNormalMatrix();
+			ubTransformMatrices.positionScale = pMesh->GetPositionScale();
+			ubTransformMatrices.positionOffset = pMesh->GetPositionOffset();
 			transformMatrices_UB.UpdateBufferData(&ubTransformMatrices);
+			entityParamsDirty = true;
 
 			// Draw submeshes
 			auto pSubMeshes = pMesh->GetSubMeshes();
@@ -299,6 +333,35 @@ namespace Engine
 					m_pDevice->BindGraphicsPipeline(GetGraphicsPipeline((uint32_t)shaderType), pCommandBuffer);
 					pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(shaderType);
 					lastUsedShaderProgramType = shaderType;
+					entityParamsDirty = true;
+				}
+
+				if (useBindless)
+				{
+					DEBUG_ASSERT_CE(pShaderProgram != nullptr);
+
+					if (entityParamsDirty)
+					{
+						shaderParamTable.Clear();
+
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::LIGHTSPACE_TRANSFORM_MATRIX), EDescriptorType::UniformBuffer, &lightSpaceTransformMatrix_UB);
+
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GNORMAL_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferNormalTexture);
+						shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::SHADOWMAP_DEPTH_TEXTURE), EDescriptorType::CombinedImageSampler, pShadowMapTexture);
+
+						m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
+						entityParamsDirty = false;
+					}
+
+					m_pDevice->SetBindlessMaterialIndex(pMaterial->GetBindlessIndex(), pCommandBuffer);
+
+					// Draw
+					DrawSubMesh(pMesh, i, useMeshletRanges, pCommandBuffer);
+					continue;
 				}
 
 				// Update per submesh uniform
@@ -317,21 +380,24 @@ namespace Engine
 				shaderParamTable.Clear();
 				DEBUG_ASSERT_CE(pShaderProgram != nullptr);
 				
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX), EDescriptorType::UniformBuffer, &lightSpaceTransformMatrix_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::LIGHTSPACE_TRANSFORM_MATRIX), EDescriptorType::UniformBuffer, &lightSpaceTransformMatrix_UB);
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES), EDescriptorType::UniformBuffer, &materialNumericalProperties_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::MATERIAL_NUMERICAL_PROPERTIES), EDescriptorType::UniformBuffer, &materialNumericalProperties_UB);
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::GNORMAL_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferNormalTexture);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::SHADOWMAP_DEPTH_TEXTURE), EDescriptorType::CombinedImageSampler, pShadowMapTexture);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::GNORMAL_TEXTURE), EDescriptorType::CombinedImageSampler, pGBufferNormalTexture);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::SHADOWMAP_DEPTH_TEXTURE), EDescriptorType::CombinedImageSampler, pShadowMapTexture);
 
 				auto pAlbedoTexture = pMaterial->GetTexture(EMaterialTextureType::Albedo);
 				if (pAlbedoTexture)
 				{
-					pAlbedoTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
-					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
+					if (!pAlbedoTexture->HasSampler())
+					{
+						pAlbedoTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
+					}
+					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
 				}
 
 				auto pToneTexture = pMaterial->GetTexture(EMaterialTextureType::Tone);
@@ -341,19 +407,20 @@ namespace Engine
 					{
 						pToneTexture->SetSampler(m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None));
 					}
-					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TONE_TEXTURE), EDescriptorType::CombinedImageSampler, pToneTexture);
+					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TONE_TEXTURE), EDescriptorType::CombinedImageSampler, pToneTexture);
 				}
 
 				m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
 				// Draw
-				m_pDevice->DrawPrimitive(pSubMeshes->at(i).m_numIndices, pSubMeshes->at(i).m_baseIndex, pSubMeshes->at(i).m_baseVertex, pCommandBuffer);
+				DrawSubMesh(pMesh, i, useMeshletRanges, pCommandBuffer);
 			}
 		}
 
 		// End pass and submit
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -365,7 +432,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		if (m_outputToSwapchain)
 		{
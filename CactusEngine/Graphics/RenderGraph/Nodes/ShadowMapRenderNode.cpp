@@ -9,11 +9,10 @@ namespace Engine
 	const char* ShadowMapRenderNode::OUTPUT_DEPTH_TEXTURE = "ShadowMapDepthTexture";
 
 	ShadowMapRenderNode::ShadowMapRenderNode(std::vector<RenderGraphResource*> graphResources, BaseRenderer* pRenderer)
-		: RenderNode(graphResources, pRenderer)
+		: RenderNode(graphResources, pRenderer),
+		m_pVertexInputState_PositionOnly(nullptr)
 	{
-		// Reserve by 512 KB; this should be enough for most cases
-		// Assuming each mesh takes up 256 bytes, this would be enough for 2048 meshes until a new region is allocated
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 512 * 1024);
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void ShadowMapRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -29,9 +28,9 @@ namespace Engine
 		depthDesc.storeOp = EAttachmentOperation::Store;
 		depthDesc.stencilLoadOp = EAttachmentOperation::None;
 		depthDesc.stencilStoreOp = EAttachmentOperation::None;
-		depthDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.initialLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.usageLayout = EImageLayout::DepthStencilAttachment;
-		depthDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.finalLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.type = EAttachmentType::Depth;
 		depthDesc.index = 0;
 
@@ -51,6 +50,13 @@ namespace Engine
 
 		m_pDevice->CreatePipelineVertexInputState(vertexInputStateCreateInfo, m_defaultPipelineStates.pVertexInputState);
 
+		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPositionStream())
+		{
+			PipelineVertexInputStateCreateInfo positionOnlyVertexInputStateCreateInfo = GetPositionOnlyVertexInputStateCreateInfo();
+
+			m_pDevice->CreatePipelineVertexInputState(positionOnlyVertexInputStateCreateInfo, m_pVertexInputState_PositionOnly);
+		}
+
 		// Input assembly state
 
 		PipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo{};
@@ -103,6 +109,21 @@ namespace Engine
 		m_pDevice->CreatePipelineViewportState(viewportStateCreateInfo, m_defaultPipelineStates.pViewportState);
 	}
 
+	void ShadowMapRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
+	{
+		// Depth texture
+
+		Texture2DCreateInfo texCreateInfo{};
+		texCreateInfo.generateMipmap = false;
+		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
+		texCreateInfo.textureWidth = SHADOW_MAP_RESOLUTION * initInfo.renderScale;
+		texCreateInfo.textureHeight = SHADOW_MAP_RESOLUTION * initInfo.renderScale;
+		texCreateInfo.format = initInfo.depthFormat;
+		texCreateInfo.textureType = ETextureType::DepthAttachment;
+
+		DeclareTransientTexture(OUTPUT_DEPTH_TEXTURE, texCreateInfo, ETextureAccessType::DepthStencilAttachmentWrite);
+	}
+
 	void ShadowMapRenderNode::CreateMutableResources(const RenderNodeConfiguration& initInfo)
 	{
 		m_frameResources.resize(initInfo.framesInFlight);
@@ -119,18 +140,9 @@ namespace Engine
 	{
 		// Depth texture
 
-		Texture2DCreateInfo texCreateInfo{};
-		texCreateInfo.generateMipmap = false;
-		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-		texCreateInfo.textureWidth = SHADOW_MAP_RESOLUTION * initInfo.renderScale;
-		texCreateInfo.textureHeight = SHADOW_MAP_RESOLUTION * initInfo.renderScale;
-		texCreateInfo.format = initInfo.depthFormat;
-		texCreateInfo.textureType = ETextureType::DepthAttachment;
-		texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
-
 		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pDepthOutput);
+			CreateTransientTexture(OUTPUT_DEPTH_TEXTURE, i, m_frameResources[i].m_pDepthOutput);
 			m_graphResources[i]->Add(OUTPUT_DEPTH_TEXTURE, m_frameResources[i].m_pDepthOutput);
 		}
 
@@ -154,8 +166,11 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
 
-		auto pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::ShadowMap);
+		auto pCutoutShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::ShadowMap);
+		auto pPositionOnlyShaderProgram = m_pVertexInputState_PositionOnly != nullptr ? (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::ShadowMap_PositionOnly) : nullptr;
 		ShaderParameterTable shaderParamTable{};
 
 		// Prepare uniform buffer
@@ -181,6 +196,9 @@ namespace Engine
 
 		m_pDevice->BeginRenderPass(m_pRenderPassObject, frameResources.m_pFrameBuffer, pCommandBuffer);
 		m_pDevice->BindGraphicsPipeline(GetGraphicsPipeline((uint32_t)EBuiltInShaderProgramType::ShadowMap), pCommandBuffer);
+		EBuiltInShaderProgramType boundProgramType = EBuiltInShaderProgramType::ShadowMap;
+
+		bool enableMeshletCulling = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMeshletCulling();
 
 		for (auto& entity : *renderContext.pOpaqueDrawList)
 		{
@@ -198,7 +216,16 @@ namespace Engine
 			{
 				continue;
 			}
+
+			// Meshlets outside of view or facing away are skipped, meshes without meshlets are drawn whole
+			bool useMeshletRanges = enableMeshletCulling && m_meshletCuller.CullMesh(pMesh, pTransformComp->GetModelMatrix(), lightSpaceMatrix, -glm::normalize(lightDir), true);
+			if (useMeshletRanges && m_meshletCuller.GetVisibleMeshletCount() == 0)
+			{
+				continue;
+			}
+
 			m_pDevice->SetVertexBuffer(pMesh->GetVertexBuffer(), pCommandBuffer);	
+			bool hasPositionStream = pMesh->GetVertexBuffer()->HasPositionStream() && m_pVertexInputState_PositionOnly != nullptr;
 
 			// Update uniform buffer
 
@@ -207,6 +234,8 @@ namespace Engine
 			UBTransformMatrices ubTransformMatrices{};
 
 			ubTransformMatrices.modelMatrix = pTransformComp->GetModelMatrix();
+			ubTransformMatrices.positionScale = pMesh->GetPositionScale();
+			ubTransformMatrices.positionOffset = pMesh->GetPositionOffset();
 			transformMatrices_UB.UpdateBufferData(&ubTransformMatrices);
 
 			// Draw submeshes
@@ -221,30 +250,41 @@ namespace Engine
 					continue;
 				}
 
+				// Casters without transparent texels need no alpha cutout, so only their positions are fetched
+				auto pAlbedoTexture = pMaterial->GetTexture(EMaterialTextureType::Albedo);
+				bool usePositionOnly = hasPositionStream && (!pAlbedoTexture || !pAlbedoTexture->HasTransparentTexels());
+
+				EBuiltInShaderProgramType programType = usePositionOnly ? EBuiltInShaderProgramType::ShadowMap_PositionOnly : EBuiltInShaderProgramType::ShadowMap;
+				if (programType != boundProgramType)
+				{
+					m_pDevice->BindGraphicsPipeline(GetGraphicsPipeline((uint32_t)programType), pCommandBuffer);
+					boundProgramType = programType;
+				}
+				auto pShaderProgram = usePositionOnly ? pPositionOnlyShaderProgram : pCutoutShaderProgram;
+
 				// Update shader resources
 
 				shaderParamTable.Clear();
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX), EDescriptorType::UniformBuffer, &lightSpaceTransformMatrix_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::LIGHTSPACE_TRANSFORM_MATRIX), EDescriptorType::UniformBuffer, &lightSpaceTransformMatrix_UB);
 
-				auto pAlbedoTexture = pMaterial->GetTexture(EMaterialTextureType::Albedo);
-				if (pAlbedoTexture)
+				if (pAlbedoTexture && !usePositionOnly)
 				{
-					pAlbedoTexture->SetSampler(m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None));
-					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
+					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
 				}
 
 				m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
 				// Draw
-				m_pDevice->DrawPrimitive(pSubMeshes->at(i).m_numIndices, pSubMeshes->at(i).m_baseIndex, pSubMeshes->at(i).m_baseVertex, pCommandBuffer);
+				DrawSubMesh(pMesh, i, useMeshletRanges, pCommandBuffer);
 			}
 		}
 
 		// End pass and submit
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -257,8 +297,8 @@ namespace Engine
 		//m_configuration.width = width;
 		//m_configuration.height = height;
 
-		//DestroyMutableTextures();
-		//CreateMutableTextures(m_configuration);
+		// Shadow map size is unchanged, but transient memory is replanned for the whole graph
+		DestroyMutableTextures();
 	}
 
 	void ShadowMapRenderNode::DestroyMutableTextures()
@@ -273,5 +313,40 @@ namespace Engine
 	void ShadowMapRenderNode::PrebuildGraphicsPipelines()
 	{
 		GetGraphicsPipeline((uint32_t)EBuiltInShaderProgramType::ShadowMap);
+		if (m_pVertexInputState_PositionOnly != nullptr)
+		{
+			GetGraphicsPipeline((uint32_t)EBuiltInShaderProgramType::ShadowMap_PositionOnly);
+		}
+	}
+
+	GraphicsPipelineObject* ShadowMapRenderNode::GetGraphicsPipeline(uint32_t key)
+	{
+		if (key != (uint32_t)EBuiltInShaderProgramType::ShadowMap_PositionOnly)
+		{
+			return RenderNode::GetGraphicsPipeline(key);
+		}
+
+		if (m_graphicsPipelines.find(key) != m_graphicsPipelines.end())
+		{
+			return m_graphicsPipelines.at(key);
+		}
+
+		// Same states as default pipeline except for vertex input
+		GraphicsPipelineCreateInfo pipelineCreateInfo{};
+		pipelineCreateInfo.pShaderProgram = m_pRenderer->GetRenderingSystem()->GetShaderProgramByType(EBuiltInShaderProgramType::ShadowMap_PositionOnly);
+		pipelineCreateInfo.pVertexInputState = m_pVertexInputState_PositionOnly;
+		pipelineCreateInfo.pInputAssemblyState = m_defaultPipelineStates.pInputAssemblyState;
+		pipelineCreateInfo.pColorBlendState = m_defaultPipelineStates.pColorBlendState;
+		pipelineCreateInfo.pRasterizationState = m_defaultPipelineStates.pRasterizationState;
+		pipelineCreateInfo.pDepthStencilState = m_defaultPipelineStates.pDepthStencilState;
+		pipelineCreateInfo.pMultisampleState = m_defaultPipelineStates.pMultisampleState;
+		pipelineCreateInfo.pViewportState = m_defaultPipelineStates.pViewportState;
+		pipelineCreateInfo.pRenderPass = m_pRenderPassObject;
+
+		GraphicsPipelineObject* pPipeline = nullptr;
+		m_pDevice->CreateGraphicsPipelineObject(pipelineCreateInfo, pPipeline);
+		m_graphicsPipelines.emplace(key, pPipeline);
+
+		return pPipeline;
 	}
 }
\ No newline at end of file
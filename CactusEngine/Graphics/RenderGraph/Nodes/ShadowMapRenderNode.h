@@ -10,6 +10,7 @@ namespace Engine
 
 	protected:
 		void CreateConstantResources(const RenderNodeConfiguration& initInfo) override;
+		void DeclareTransientResources(const RenderNodeConfiguration& initInfo) override;
 		void CreateMutableResources(const RenderNodeConfiguration& initInfo) override;
 		void DestroyMutableResources() override;
 
@@ -18,6 +19,7 @@ namespace Engine
 		void UpdateResolution(uint32_t width, uint32_t height) override;
 
 		void PrebuildGraphicsPipelines() override;
+		GraphicsPipelineObject* GetGraphicsPipeline(uint32_t key) override;
 
 	private:
 		void CreateMutableTextures(const RenderNodeConfiguration& initInfo);
@@ -50,5 +52,7 @@ namespace Engine
 			Texture2D* m_pDepthOutput;
 		};
 		std::vector<FrameResources> m_frameResources;
+
+		PipelineVertexInputState* m_pVertexInputState_PositionOnly; // Null if meshes are created without position stream
 	};
 }
\ No newline at end of file
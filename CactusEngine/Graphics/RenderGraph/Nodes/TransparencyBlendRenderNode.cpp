@@ -21,6 +21,11 @@ namespace Engine
 		m_inputResourceNames[INPUT_TRANSPARENCY_COLOR_TEXTURE] = nullptr;
 		m_inputResourceNames[INPUT_TRANSPARENCY_DEPTH_TEXTURE] = nullptr;
 
+		m_inputResourceAccesses[INPUT_OPQAUE_COLOR_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_OPQAUE_DEPTH_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_TRANSPARENCY_COLOR_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_TRANSPARENCY_DEPTH_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+
 		// This node does not require UniformBufferAllocator
 	}
 
@@ -35,7 +40,7 @@ namespace Engine
 		colorDesc.storeOp = EAttachmentOperation::Store;
 		colorDesc.stencilLoadOp = EAttachmentOperation::None;
 		colorDesc.stencilStoreOp = EAttachmentOperation::None;
-		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ShaderReadOnly;
+		colorDesc.initialLayout = m_outputToSwapchain ? EImageLayout::PresentSrc : EImageLayout::ColorAttachment;
 		colorDesc.usageLayout = EImageLayout::ColorAttachment;
 		colorDesc.finalLayout = colorDesc.initialLayout;
 		colorDesc.type = EAttachmentType::Color;
@@ -127,11 +132,8 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void TransparencyBlendRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void TransparencyBlendRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
-		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
-
 		// Color output
 
 		if (!m_outputToSwapchain)
@@ -139,15 +141,27 @@ namespace Engine
 			Texture2DCreateInfo texCreateInfo{};
 			texCreateInfo.generateMipmap = false;
 			texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-			texCreateInfo.textureWidth = width;
-			texCreateInfo.textureHeight = height;
+			texCreateInfo.textureWidth = initInfo.width * initInfo.renderScale;
+			texCreateInfo.textureHeight = initInfo.height * initInfo.renderScale;
 			texCreateInfo.format = initInfo.colorFormat;
 			texCreateInfo.textureType = ETextureType::ColorAttachment;
-			texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
 
+			DeclareTransientTexture(OUTPUT_COLOR_TEXTURE, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
+		}
+	}
+
+	void TransparencyBlendRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = m_outputToSwapchain ? initInfo.width : initInfo.width * initInfo.renderScale;
+		uint32_t height = m_outputToSwapchain ? initInfo.height : initInfo.height * initInfo.renderScale;
+
+		// Color output
+
+		if (!m_outputToSwapchain)
+		{
 			for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 			{
-				m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorOutput);
+				CreateTransientTexture(OUTPUT_COLOR_TEXTURE, i, m_frameResources[i].m_pColorOutput);
 				m_graphResources[i]->Add(OUTPUT_COLOR_TEXTURE, m_frameResources[i].m_pColorOutput);
 			}
 		}
@@ -172,6 +186,9 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 
 		auto pShaderProgram = (m_pRenderer->GetRenderingSystem())->GetShaderProgramByType(EBuiltInShaderProgramType::DepthBased_ColorBlend_2);
 		ShaderParameterTable shaderParamTable{};
@@ -182,26 +199,27 @@ namespace Engine
 
 		// Update shader resources
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler,
-			pGraphResources->Get(m_inputResourceNames.at(INPUT_OPQAUE_DEPTH_TEXTURE)));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler,
+			pGraphResources->Get(m_inputResourceHandles.at(INPUT_OPQAUE_DEPTH_TEXTURE)));
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler,
-			pGraphResources->Get(m_inputResourceNames.at(INPUT_OPQAUE_COLOR_TEXTURE)));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler,
+			pGraphResources->Get(m_inputResourceHandles.at(INPUT_OPQAUE_COLOR_TEXTURE)));
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::DEPTH_TEXTURE_2), EDescriptorType::CombinedImageSampler,
-			pGraphResources->Get(m_inputResourceNames.at(INPUT_TRANSPARENCY_DEPTH_TEXTURE)));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::DEPTH_TEXTURE_2), EDescriptorType::CombinedImageSampler,
+			pGraphResources->Get(m_inputResourceHandles.at(INPUT_TRANSPARENCY_DEPTH_TEXTURE)));
 
-		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::COLOR_TEXTURE_2), EDescriptorType::CombinedImageSampler,
-			pGraphResources->Get(m_inputResourceNames.at(INPUT_TRANSPARENCY_COLOR_TEXTURE)));
+		shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::COLOR_TEXTURE_2), EDescriptorType::CombinedImageSampler,
+			pGraphResources->Get(m_inputResourceHandles.at(INPUT_TRANSPARENCY_COLOR_TEXTURE)));
 
 		m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
 		// Draw
-		m_pDevice->DrawFullScreenQuad(pCommandBuffer);
+		m_pDevice->DrawFullScreenQuad(pCommandBuffer, GetInputTexCoordScale(renderContext));
 
 		// End pass
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -213,7 +231,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		if (m_outputToSwapchain)
 		{
@@ -10,6 +10,7 @@ namespace Engine
 
 	protected:
 		void CreateConstantResources(const RenderNodeConfiguration& initInfo) override;
+		void DeclareTransientResources(const RenderNodeConfiguration& initInfo) override;
 		void CreateMutableResources(const RenderNodeConfiguration& initInfo) override;
 		void DestroyMutableResources() override;
 
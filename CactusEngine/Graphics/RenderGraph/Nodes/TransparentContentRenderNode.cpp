@@ -19,9 +19,10 @@ namespace Engine
 		m_inputResourceNames[INPUT_COLOR_TEXTURE] = nullptr;
 		m_inputResourceNames[INPUT_BACKGROUND_DEPTH] = nullptr;
 
-		// Reserve by 512 KB; this should be enough for most cases
-		// Assuming each mesh takes up 512 bytes, this would be enough for 1024 meshes until a new region is allocated
-		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager(), 512 * 1024);
+		m_inputResourceAccesses[INPUT_COLOR_TEXTURE] = ETextureAccessType::FragmentShaderRead;
+		m_inputResourceAccesses[INPUT_BACKGROUND_DEPTH] = ETextureAccessType::FragmentShaderRead;
+
+		CE_NEW(m_pUniformBufferAllocator, UniformBufferConcurrentAllocator, pRenderer->GetBufferManager());
 	}
 
 	void TransparentContentRenderNode::CreateConstantResources(const RenderNodeConfiguration& initInfo)
@@ -37,9 +38,9 @@ namespace Engine
 		colorDesc.storeOp = EAttachmentOperation::Store;
 		colorDesc.stencilLoadOp = EAttachmentOperation::None;
 		colorDesc.stencilStoreOp = EAttachmentOperation::None;
-		colorDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		colorDesc.initialLayout = EImageLayout::ColorAttachment;
 		colorDesc.usageLayout = EImageLayout::ColorAttachment;
-		colorDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		colorDesc.finalLayout = EImageLayout::ColorAttachment;
 		colorDesc.type = EAttachmentType::Color;
 		colorDesc.index = 0;
 
@@ -50,9 +51,9 @@ namespace Engine
 		depthDesc.storeOp = EAttachmentOperation::Store;
 		depthDesc.stencilLoadOp = EAttachmentOperation::None;
 		depthDesc.stencilStoreOp = EAttachmentOperation::None;
-		depthDesc.initialLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.initialLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.usageLayout = EImageLayout::DepthStencilAttachment;
-		depthDesc.finalLayout = EImageLayout::ShaderReadOnly;
+		depthDesc.finalLayout = EImageLayout::DepthStencilAttachment;
 		depthDesc.type = EAttachmentType::Depth;
 		depthDesc.index = 1;
 
@@ -141,34 +142,39 @@ namespace Engine
 		m_frameResources.resize(0);
 	}
 
-	void TransparentContentRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	void TransparentContentRenderNode::DeclareTransientResources(const RenderNodeConfiguration& initInfo)
 	{
-		uint32_t width = initInfo.width * initInfo.renderScale;
-		uint32_t height = initInfo.height * initInfo.renderScale;
-
 		// Color and depth texture
 
 		Texture2DCreateInfo texCreateInfo{};
 		texCreateInfo.generateMipmap = false;
 		texCreateInfo.pSampler = m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None);
-		texCreateInfo.textureWidth = width;
-		texCreateInfo.textureHeight = height;
+		texCreateInfo.textureWidth = initInfo.width * initInfo.renderScale;
+		texCreateInfo.textureHeight = initInfo.height * initInfo.renderScale;
 		texCreateInfo.format = ETextureFormat::RGBA8_SRGB;
 		texCreateInfo.textureType = ETextureType::ColorAttachment;
-		texCreateInfo.initialLayout = EImageLayout::ShaderReadOnly;
 
-		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
-		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pColorOutput);
-			m_graphResources[i]->Add(OUTPUT_COLOR_TEXTURE, m_frameResources[i].m_pColorOutput);
-		}
+		DeclareTransientTexture(OUTPUT_COLOR_TEXTURE, texCreateInfo, ETextureAccessType::ColorAttachmentWrite);
 
 		texCreateInfo.format = initInfo.depthFormat;
 		texCreateInfo.textureType = ETextureType::DepthAttachment;
 
+		DeclareTransientTexture(OUTPUT_DEPTH_TEXTURE, texCreateInfo, ETextureAccessType::DepthStencilAttachmentWrite);
+	}
+
+	void TransparentContentRenderNode::CreateMutableTextures(const RenderNodeConfiguration& initInfo)
+	{
+		uint32_t width = initInfo.width * initInfo.renderScale;
+		uint32_t height = initInfo.height * initInfo.renderScale;
+
+		// Color and depth texture
+
 		for (uint32_t i = 0; i < initInfo.framesInFlight; ++i)
 		{
-			m_pDevice->CreateTexture2D(texCreateInfo, m_frameResources[i].m_pDepthOutput);
+			CreateTransientTexture(OUTPUT_COLOR_TEXTURE, i, m_frameResources[i].m_pColorOutput);
+			CreateTransientTexture(OUTPUT_DEPTH_TEXTURE, i, m_frameResources[i].m_pDepthOutput);
+
+			m_graphResources[i]->Add(OUTPUT_COLOR_TEXTURE, m_frameResources[i].m_pColorOutput);
 			m_graphResources[i]->Add(OUTPUT_DEPTH_TEXTURE, m_frameResources[i].m_pDepthOutput);
 		}
 
@@ -200,6 +206,9 @@ namespace Engine
 		auto& frameResources = m_frameResources[m_frameIndex];
 
 		GraphicsCommandBuffer* pCommandBuffer = m_pDevice->RequestCommandBuffer(cmdContext.pCommandPool);
+		BeginProfilingScope(pCommandBuffer);
+		RecordResourceBarriers(pCommandBuffer);
+		UpdateDynamicRenderArea(renderContext);
 
 		ShaderProgram* pShaderProgram = nullptr;
 		EBuiltInShaderProgramType lastUsedShaderProgramType = EBuiltInShaderProgramType::NONE;
@@ -235,6 +244,8 @@ namespace Engine
 
 		m_pDevice->BeginRenderPass(m_pRenderPassObject, frameResources.m_pFrameBuffer, pCommandBuffer);
 
+		bool enableMeshletCulling = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMeshletCulling();
+
 		for (auto& entity : *renderContext.pTransparentDrawList)
 		{
 			auto pMaterialComp = (MaterialComponent*)entity->GetComponent(EComponentType::Material);
@@ -251,6 +262,14 @@ namespace Engine
 			{
 				continue;
 			}
+
+			// Meshlets outside of view or facing away are skipped, meshes without meshlets are drawn whole
+			bool useMeshletRanges = enableMeshletCulling && m_meshletCuller.CullMesh(pMesh, pTransformComp->GetModelMatrix(), projectionMat * viewMat, cameraPos, false);
+			if (useMeshletRanges && m_meshletCuller.GetVisibleMeshletCount() == 0)
+			{
+				continue;
+			}
+
 			m_pDevice->SetVertexBuffer(pMesh->GetVertexBuffer(), pCommandBuffer);
 
 			// Update transform uniform
@@ -261,6 +280,8 @@ namespace Engine
 
 			ubTransformMatrices.modelMatrix = pTransformComp->GetModelMatrix();
 			ubTransformMatrices.normalMatrix = pTransformComp->GetNormalMatrix();
+			ubTransformMatrices.positionScale = pMesh->GetPositionScale();
+			ubTransformMatrices.positionOffset = pMesh->GetPositionOffset();
 			transformMatrices_UB.UpdateBufferData(&ubTransformMatrices);
 
 			// Draw submeshes
@@ -298,43 +319,50 @@ namespace Engine
 				DEBUG_ASSERT_CE(pShaderProgram != nullptr);
 				shaderParamTable.Clear();
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_MATRICES), EDescriptorType::UniformBuffer, &cameraMatrices_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::CAMERA_PROPERTIES), EDescriptorType::UniformBuffer, &cameraProperties_UB);
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::SYSTEM_VARIABLES), EDescriptorType::UniformBuffer, &systemVariables_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::SYSTEM_VARIABLES), EDescriptorType::UniformBuffer, &systemVariables_UB);
 				
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES), EDescriptorType::UniformBuffer, &materialNumericalProperties_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::TRANSFORM_MATRICES), EDescriptorType::UniformBuffer, &transformMatrices_UB);
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::MATERIAL_NUMERICAL_PROPERTIES), EDescriptorType::UniformBuffer, &materialNumericalProperties_UB);
 
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler,
-					pGraphResources->Get(m_inputResourceNames.at(INPUT_BACKGROUND_DEPTH)));
-				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler,
-					pGraphResources->Get(m_inputResourceNames.at(INPUT_COLOR_TEXTURE)));
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::DEPTH_TEXTURE_1), EDescriptorType::CombinedImageSampler,
+					pGraphResources->Get(m_inputResourceHandles.at(INPUT_BACKGROUND_DEPTH)));
+				shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::COLOR_TEXTURE_1), EDescriptorType::CombinedImageSampler,
+					pGraphResources->Get(m_inputResourceHandles.at(INPUT_COLOR_TEXTURE)));
 
 				auto pAlbedoTexture = pMaterial->GetTexture(EMaterialTextureType::Albedo);
 				if (pAlbedoTexture)
 				{
-					pAlbedoTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
-					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
+					if (!pAlbedoTexture->HasSampler())
+					{
+						pAlbedoTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
+					}
+					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::ALBEDO_TEXTURE), EDescriptorType::CombinedImageSampler, pAlbedoTexture);
 				}
 
 				auto pNoiseTexture = pMaterial->GetTexture(EMaterialTextureType::Noise);
 				if (pNoiseTexture)
 				{
-					pNoiseTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
-					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamNames::NOISE_TEXTURE_1), EDescriptorType::CombinedImageSampler, pNoiseTexture);
+					if (!pNoiseTexture->HasSampler())
+					{
+						pNoiseTexture->SetSampler(m_pDevice->GetTextureSampler(samplerAFLevel));
+					}
+					shaderParamTable.AddEntry(pShaderProgram->GetParamBinding(ShaderParamIDs::NOISE_TEXTURE_1), EDescriptorType::CombinedImageSampler, pNoiseTexture);
 				}
 
 				m_pDevice->UpdateShaderParameter(pShaderProgram, &shaderParamTable, pCommandBuffer);
 
 				// Draw
-				m_pDevice->DrawPrimitive(pSubMeshes->at(i).m_numIndices, pSubMeshes->at(i).m_baseIndex, pSubMeshes->at(i).m_baseVertex, pCommandBuffer);
+				DrawSubMesh(pMesh, i, useMeshletRanges, pCommandBuffer);
 			}
 		}
 
 		// End pass and submit
 
 		m_pDevice->EndRenderPass(pCommandBuffer);
+		EndProfilingScope(pCommandBuffer);
 		m_pDevice->EndCommandBuffer(pCommandBuffer);
 
 		m_pRenderer->WriteCommandRecordList(m_pName, pCommandBuffer);
@@ -346,7 +374,6 @@ namespace Engine
 		m_configuration.height = height;
 
 		DestroyMutableTextures();
-		CreateMutableTextures(m_configuration);
 
 		m_defaultPipelineStates.pViewportState->UpdateResolution(width * m_configuration.renderScale, height * m_configuration.renderScale);
 	}
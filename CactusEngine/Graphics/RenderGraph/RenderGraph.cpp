@@ -5,23 +5,55 @@
 #include "GraphicsDevice.h"
 #include "LogUtility.h"
 #include "RenderingSystem.h"
+#include "Timer.h"
+
+#include <algorithm>
 
 namespace Engine
 {
 	const uint32_t DEFAULT_MAXDRAWCALL = 256;
 
+	std::unordered_map<std::string, RenderGraphResourceHandle> RenderGraphResource::m_handleRegistry;
+	std::vector<std::string> RenderGraphResource::m_registeredNames;
+	std::mutex RenderGraphResource::m_registryMutex;
+
+	RenderGraphResourceHandle RenderGraphResource::GetHandle(const char* name)
+	{
+		DEBUG_ASSERT_CE(name != nullptr);
+		std::lock_guard<std::mutex> guard(m_registryMutex);
+
+		auto itr = m_handleRegistry.find(name);
+		if (itr != m_handleRegistry.end())
+		{
+			return itr->second;
+		}
+
+		RenderGraphResourceHandle handle = (RenderGraphResourceHandle)m_registeredNames.size();
+		m_registeredNames.emplace_back(name);
+		m_handleRegistry.emplace(name, handle);
+
+		return handle;
+	}
+
 	void RenderGraphResource::Add(const char* name, RawResource* pResource)
 	{
-		m_renderResources[name] = pResource;
+		RenderGraphResourceHandle handle = GetHandle(name);
+		if (handle >= m_renderResources.size())
+		{
+			m_renderResources.resize(handle + 1, nullptr);
+		}
+		m_renderResources[handle] = pResource;
 	}
 
-	RawResource* RenderGraphResource::Get(const char* name) const
+	RawResource* RenderGraphResource::Get(RenderGraphResourceHandle handle) const
 	{
-		if (m_renderResources.find(name) != m_renderResources.end())
+		if (handle < m_renderResources.size() && m_renderResources[handle] != nullptr)
 		{
-			return m_renderResources.at(name);
+			return m_renderResources[handle];
 		}
-		LOG_ERROR((std::string)"Couldn't find resource: " + name);
+
+		std::lock_guard<std::mutex> guard(m_registryMutex);
+		LOG_ERROR((std::string)"Couldn't find resource: " + (handle < m_registeredNames.size() ? m_registeredNames[handle] : std::to_string(handle)));
 		return nullptr;
 	}
 
@@ -30,15 +62,20 @@ namespace Engine
 		m_pDevice(m_pRenderer->GetGraphicsDevice()),
 		m_eGraphicsDeviceType(m_pDevice->GetGraphicsAPIType()),
 		m_finishedExecution(false),
+		m_pendingPrevNodeCount(0),
 		m_pName(nullptr),
 		m_graphResources(graphResources),
 		m_frameIndex(0),
 		m_pSwapchainImages(nullptr),
 		m_outputToSwapchain(false),
+		m_pProfiler(nullptr),
+		m_profilerScope(0),
 		m_defaultPipelineStates{},
 		m_renderContext{},
 		m_cmdContext{},
 		m_pRenderPassObject(nullptr),
+		m_queueType(EQueueType::Graphics),
+		m_isCulled(false),
 		m_configuration()
 	{
 		
@@ -73,8 +110,126 @@ namespace Engine
 	{
 		m_configuration = initInfo;
 
+		ResolveInputResourceHandles();
+
 		CreateConstantResources(initInfo);
-		CreateMutableResources(initInfo);
+		CollectTransientResources();
+	}
+
+	void RenderNode::ResolveInputResourceHandles()
+	{
+		m_inputResourceHandles.clear();
+
+		for (auto& input : m_inputResourceNames)
+		{
+			if (input.second == nullptr)
+			{
+				LOG_WARNING((std::string)"Render node input is not connected: " + input.first);
+				m_inputResourceHandles[input.first] = INVALID_RENDER_GRAPH_RESOURCE_HANDLE;
+				continue;
+			}
+			m_inputResourceHandles[input.first] = RenderGraphResource::GetHandle(input.second);
+		}
+	}
+
+	void RenderNode::CollectTransientResources()
+	{
+		m_transientTextures.clear();
+		DeclareTransientResources(m_configuration);
+	}
+
+	void RenderNode::DeclareTransientTexture(const char* pName, const Texture2DCreateInfo& createInfo, ETextureAccessType access)
+	{
+		DEBUG_ASSERT_CE(m_transientTextures.find(pName) == m_transientTextures.end());
+		DEBUG_ASSERT_CE(createInfo.pTextureData == nullptr && !createInfo.generateMipmap);
+		DEBUG_ASSERT_CE(access != ETextureAccessType::Undefined);
+
+		TransientTextureDeclaration declaration{};
+		declaration.createInfo = createInfo;
+		declaration.access = access;
+		declaration.consumerAccess = ETextureAccessType::Undefined;
+		declaration.pPrevResident = nullptr;
+		declaration.isAliased = false;
+
+		m_transientTextures.emplace(pName, declaration);
+	}
+
+	void RenderNode::CreateTransientTexture(const char* pName, uint32_t frameIndex, Texture2D*& pOutput)
+	{
+		DEBUG_ASSERT_CE(m_transientTextures.find(pName) != m_transientTextures.end());
+
+		auto& declaration = m_transientTextures.at(pName);
+		DEBUG_ASSERT_MESSAGE_CE(frameIndex < declaration.memoryBlocks.size(), "Render graph is not compiled.");
+
+		Texture2DCreateInfo createInfo = declaration.createInfo;
+		createInfo.pTransientMemory = declaration.memoryBlocks[frameIndex];
+		createInfo.initialLayout = GetTextureAccessLayout(declaration.GetLastAccess()); // Where the planned barriers expect it to be
+
+		m_pDevice->CreateTexture2D(createInfo, pOutput);
+		declaration.textures[frameIndex] = pOutput;
+	}
+
+	void RenderNode::RecordResourceBarriers(GraphicsCommandBuffer* pCommandBuffer)
+	{
+		if (m_resourceBarriers.empty())
+		{
+			return;
+		}
+
+		std::vector<TextureBarrierDescription> barriers(m_resourceBarriers.size());
+		for (uint32_t i = 0; i < m_resourceBarriers.size(); i++)
+		{
+			barriers[i].pTexture = m_resourceBarriers[i].pDeclaration->textures[m_frameIndex];
+			barriers[i].srcAccess = m_resourceBarriers[i].srcAccess;
+			barriers[i].dstAccess = m_resourceBarriers[i].dstAccess;
+			barriers[i].discardContent = m_resourceBarriers[i].discardContent;
+			barriers[i].crossQueue = m_resourceBarriers[i].crossQueue;
+		}
+
+		m_pDevice->TextureBarriers(barriers, pCommandBuffer);
+	}
+
+	void RenderNode::BeginProfilingScope(GraphicsCommandBuffer* pCommandBuffer)
+	{
+		m_pProfiler->BeginScope(m_profilerScope, m_frameIndex, pCommandBuffer);
+	}
+
+	void RenderNode::EndProfilingScope(GraphicsCommandBuffer* pCommandBuffer)
+	{
+		m_pProfiler->EndScope(m_profilerScope, m_frameIndex, pCommandBuffer);
+	}
+
+	void RenderNode::UpdateDynamicRenderArea(const RenderContext& renderContext)
+	{
+		if (m_outputToSwapchain)
+		{
+			return;
+		}
+
+		uint32_t width = 0, height = 0;
+		GetDynamicRenderAreaExtent(renderContext, width, height);
+
+		// Viewport state is only read by this node when recording, so it can be modified per frame
+		m_defaultPipelineStates.pViewportState->UpdateResolution(width, height);
+	}
+
+	Vector2 RenderNode::GetInputTexCoordScale(const RenderContext& renderContext) const
+	{
+		uint32_t width = 0, height = 0;
+		GetDynamicRenderAreaExtent(renderContext, width, height);
+
+		uint32_t allocatedWidth = std::max<uint32_t>(m_configuration.width * m_configuration.renderScale, 1);
+		uint32_t allocatedHeight = std::max<uint32_t>(m_configuration.height * m_configuration.renderScale, 1);
+
+		return Vector2((float)width / allocatedWidth, (float)height / allocatedHeight);
+	}
+
+	void RenderNode::GetDynamicRenderAreaExtent(const RenderContext& renderContext, uint32_t& outWidth, uint32_t& outHeight) const
+	{
+		float scale = m_configuration.renderScale * std::clamp(renderContext.dynamicResolutionScale, 0.0f, 1.0f);
+
+		outWidth = std::max<uint32_t>(m_configuration.width * scale, 1);
+		outHeight = std::max<uint32_t>(m_configuration.height * scale, 1);
 	}
 
 	void RenderNode::ExecuteSequential()
@@ -87,7 +242,10 @@ namespace Engine
 			}
 		}
 
-		RenderPassFunction(m_graphResources[m_frameIndex], m_renderContext, m_cmdContext);
+		if (!m_isCulled)
+		{
+			RenderPassFunction(m_graphResources[m_frameIndex], m_renderContext, m_cmdContext);
+		}
 		m_finishedExecution = true;
 
 		for (auto& pNode : m_nextNodes)
@@ -98,40 +256,46 @@ namespace Engine
 
 	void RenderNode::ExecuteParallel()
 	{
-		RenderPassFunction(m_graphResources[m_frameIndex], m_renderContext, m_cmdContext);
+		if (!m_isCulled)
+		{
+			RenderPassFunction(m_graphResources[m_frameIndex], m_renderContext, m_cmdContext);
+		}
 		m_finishedExecution = true;
 	}
 
 	PipelineVertexInputStateCreateInfo RenderNode::GetDefaultVertexInputStateCreateInfo() const
 	{
+		// Vertex layout is uniform across all meshes, so that pipelines do not need to be specialized per mesh
+		bool isQuantized = m_pDevice->IsVertexQuantizationEnabled();
+
 		VertexInputBindingDescription vertexInputBindingDesc{};
-		vertexInputBindingDesc.binding = 0;
-		vertexInputBindingDesc.stride = VertexBufferCreateInfo::interleavedStride;
+		vertexInputBindingDesc.binding = GraphicsDevice::VERTEX_BINDING;
+		vertexInputBindingDesc.stride = isQuantized ? VertexBufferCreateInfo::quantizedStride : VertexBufferCreateInfo::interleavedStride;
 		vertexInputBindingDesc.inputRate = EVertexInputRate::PerVertex;
 
 		VertexInputAttributeDescription positionAttributeDesc{};
 		positionAttributeDesc.binding = vertexInputBindingDesc.binding;
 		positionAttributeDesc.location = GraphicsDevice::ATTRIB_POSITION_LOCATION;
-		positionAttributeDesc.offset = VertexBufferCreateInfo::positionOffset;
-		positionAttributeDesc.format = ETextureFormat::RGB32F;
+		positionAttributeDesc.offset = isQuantized ? VertexBufferCreateInfo::quantizedPositionOffset : VertexBufferCreateInfo::positionOffset;
+		positionAttributeDesc.format = isQuantized ? ETextureFormat::RGBA16_UNORM : ETextureFormat::RGB32F;
 
 		VertexInputAttributeDescription normalAttributeDesc{};
 		normalAttributeDesc.binding = vertexInputBindingDesc.binding;
 		normalAttributeDesc.location = GraphicsDevice::ATTRIB_NORMAL_LOCATION;
-		normalAttributeDesc.offset = VertexBufferCreateInfo::normalOffset;
-		normalAttributeDesc.format = ETextureFormat::RGB32F;
+		normalAttributeDesc.offset = isQuantized ? VertexBufferCreateInfo::quantizedNormalOffset : VertexBufferCreateInfo::normalOffset;
+		normalAttributeDesc.format = isQuantized ? ETextureFormat::RGB10A2_SNORM : ETextureFormat::RGB32F;
 
 		VertexInputAttributeDescription texcoordAttributeDesc{};
 		texcoordAttributeDesc.binding = vertexInputBindingDesc.binding;
 		texcoordAttributeDesc.location = GraphicsDevice::ATTRIB_TEXCOORD_LOCATION;
-		texcoordAttributeDesc.offset = VertexBufferCreateInfo::texcoordOffset;
-		texcoordAttributeDesc.format = ETextureFormat::RG32F;
+		texcoordAttributeDesc.offset = isQuantized ? VertexBufferCreateInfo::quantizedTexcoordOffset : VertexBufferCreateInfo::texcoordOffset;
+		texcoordAttributeDesc.format = isQuantized ? ETextureFormat::RG16F : ETextureFormat::RG32F;
 
 		VertexInputAttributeDescription tangentAttributeDesc{};
 		tangentAttributeDesc.binding = vertexInputBindingDesc.binding;
 		tangentAttributeDesc.location = GraphicsDevice::ATTRIB_TANGENT_LOCATION;
-		tangentAttributeDesc.offset = VertexBufferCreateInfo::tangentOffset;
-		tangentAttributeDesc.format = ETextureFormat::RGB32F;
+		tangentAttributeDesc.offset = isQuantized ? VertexBufferCreateInfo::quantizedTangentOffset : VertexBufferCreateInfo::tangentOffset;
+		tangentAttributeDesc.format = isQuantized ? ETextureFormat::RGB10A2_SNORM : ETextureFormat::RGB32F;
 
 		PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
 		vertexInputStateCreateInfo.bindingDescs = { vertexInputBindingDesc };
@@ -140,6 +304,43 @@ namespace Engine
 		return vertexInputStateCreateInfo;
 	}
 
+	PipelineVertexInputStateCreateInfo RenderNode::GetPositionOnlyVertexInputStateCreateInfo() const
+	{
+		bool isQuantized = m_pDevice->IsVertexQuantizationEnabled();
+
+		VertexInputBindingDescription vertexInputBindingDesc{};
+		vertexInputBindingDesc.binding = GraphicsDevice::POSITION_STREAM_BINDING;
+		vertexInputBindingDesc.stride = isQuantized ? VertexBufferCreateInfo::quantizedPositionStreamStride : VertexBufferCreateInfo::positionStreamStride;
+		vertexInputBindingDesc.inputRate = EVertexInputRate::PerVertex;
+
+		VertexInputAttributeDescription positionAttributeDesc{};
+		positionAttributeDesc.binding = vertexInputBindingDesc.binding;
+		positionAttributeDesc.location = GraphicsDevice::ATTRIB_POSITION_LOCATION;
+		positionAttributeDesc.offset = 0;
+		positionAttributeDesc.format = isQuantized ? ETextureFormat::RGBA16_UNORM : ETextureFormat::RGB32F;
+
+		PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo{};
+		vertexInputStateCreateInfo.bindingDescs = { vertexInputBindingDesc };
+		vertexInputStateCreateInfo.attributeDescs = { positionAttributeDesc };
+
+		return vertexInputStateCreateInfo;
+	}
+
+	void RenderNode::DrawSubMesh(const Mesh* pMesh, uint32_t subMeshIndex, bool useMeshletRanges, GraphicsCommandBuffer* pCommandBuffer)
+	{
+		if (useMeshletRanges)
+		{
+			for (auto& range : m_meshletCuller.GetDrawRanges(subMeshIndex))
+			{
+				m_pDevice->DrawPrimitive(range.m_numIndices, range.m_baseIndex, range.m_baseVertex, pCommandBuffer);
+			}
+			return;
+		}
+
+		auto& subMesh = pMesh->GetSubMeshes()->at(subMeshIndex);
+		m_pDevice->DrawPrimitive(subMesh.m_numIndices, subMesh.m_baseIndex, subMesh.m_baseVertex, pCommandBuffer);
+	}
+
 	void RenderNode::DestroyConstantResources()
 	{
 		CE_SAFE_DELETE(m_pUniformBufferAllocator);
@@ -185,26 +386,26 @@ namespace Engine
 
 	RenderGraph::RenderGraph(GraphicsDevice* pDevice)
 		: m_pDevice(pDevice),
-		m_isRunning(true),
-		m_executionThreadCount(0)
+		m_transientMemorySize(0),
+		m_transientMemoryRequested(0),
+		m_gpuProfiler(pDevice)
 	{
 
 	}
 
 	RenderGraph::~RenderGraph()
 	{
-		m_isRunning = false;
+		JobSystem::WaitForCounter(&m_executionCounter);
 
-		for (uint32_t i = 0; i < m_executionThreadCount; i++)
-		{
-			m_executionThreads[i].join();
-		}
+		ReleaseTransientMemory();
 	}
 
 	void RenderGraph::AddRenderNode(const char* name, RenderNode* pNode)
 	{
 		m_nodes.emplace(name, pNode);
 		m_nodes[name]->m_pName = name;
+		m_nodes[name]->m_pProfiler = &m_gpuProfiler;
+		m_nodes[name]->m_profilerScope = m_gpuProfiler.RegisterScope(name);
 	}
 
 	void RenderGraph::SetupRenderNodes()
@@ -224,12 +425,89 @@ namespace Engine
 		{
 			node.second->Setup(initInfo);
 		}
+
+		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetGPUProfiling())
+		{
+			m_gpuProfiler.Initialize(initInfo.framesInFlight);
+		}
+
+		// Resource declarations are available after setup, the graph can be compiled from here
+
+		CullRenderNodes();
+		BuildRenderNodePriorities();
+		CompileTransientResources();
+		CompileResourceBarriers();
+
+		for (auto& node : m_nodes)
+		{
+			if (!node.second->m_isCulled)
+			{
+				node.second->CreateMutableResources(initInfo);
+			}
+		}
+	}
+
+	void RenderGraph::CullRenderNodes()
+	{
+		// Nodes presenting to swapchain are always kept, other nodes are kept only if a kept node reads their outputs
+
+		std::unordered_map<RenderGraphResourceHandle, RenderNode*> producers;
+		std::queue<RenderNode*> keptNodes;
+
+		for (auto& pNode : m_nodes)
+		{
+			for (auto& declaration : pNode.second->m_transientTextures)
+			{
+				producers[RenderGraphResource::GetHandle(declaration.first)] = pNode.second;
+			}
+
+			pNode.second->m_isCulled = !pNode.second->m_outputToSwapchain;
+			if (pNode.second->m_outputToSwapchain)
+			{
+				keptNodes.push(pNode.second);
+			}
+		}
+
+		if (keptNodes.empty())
+		{
+			// Graph output is consumed externally, nothing can be culled safely
+			for (auto& pNode : m_nodes)
+			{
+				pNode.second->m_isCulled = false;
+			}
+			return;
+		}
+
+		while (!keptNodes.empty())
+		{
+			RenderNode* pNode = keptNodes.front();
+			keptNodes.pop();
+
+			for (auto& input : pNode->m_inputResourceHandles)
+			{
+				auto itr = producers.find(input.second);
+				if (itr != producers.end() && itr->second->m_isCulled)
+				{
+					itr->second->m_isCulled = false;
+					keptNodes.push(itr->second);
+				}
+			}
+		}
+
+		for (auto& pNode : m_nodes)
+		{
+			if (pNode.second->m_isCulled)
+			{
+				LOG_MESSAGE((std::string)"Render node is culled since none of its outputs is consumed: " + pNode.first);
+			}
+		}
 	}
 
 	void RenderGraph::BuildRenderNodePriorities()
 	{
 		m_renderNodePriorities.clear();
 		m_nodePriorityDependencies.clear();
+		m_nodePriorityQueueTypes.clear();
 
 		// Find all starting nodes
 		std::queue<RenderNode*> startingNodes;
@@ -257,11 +535,15 @@ namespace Engine
 			pNode.second->m_finishedExecution = false;
 		}
 
+		// Culled nodes are not submitted
+		traverseResult.erase(std::remove_if(traverseResult.begin(), traverseResult.end(), [](const RenderNode* pNode) { return pNode->m_isCulled; }), traverseResult.end());
+
 		// Assign priority by traverse sequence
 		uint32_t assignedPriority = 0;
 		for (uint32_t i = 0; i < traverseResult.size(); i++)
 		{
 			m_renderNodePriorities[traverseResult[i]->m_pName] = assignedPriority;
+			m_nodePriorityQueueTypes.emplace_back(IsAsyncComputeNode(traverseResult[i]) ? EQueueType::Compute : EQueueType::Graphics);
 			assignedPriority++;
 		}
 
@@ -271,69 +553,77 @@ namespace Engine
 			m_nodePriorityDependencies[m_renderNodePriorities[traverseResult[i]->m_pName]] = std::vector<uint32_t>();
 			for (auto pNode : traverseResult[i]->m_prevNodes)
 			{
-				m_nodePriorityDependencies[m_renderNodePriorities[traverseResult[i]->m_pName]].emplace_back(m_renderNodePriorities[pNode->m_pName]);
+				if (!pNode->m_isCulled)
+				{
+					m_nodePriorityDependencies[m_renderNodePriorities[traverseResult[i]->m_pName]].emplace_back(m_renderNodePriorities[pNode->m_pName]);
+				}
 			}
 		}
 	}
 
 	void RenderGraph::PrebuildPipelines()
 	{
+		int64_t startTime = Timer::TimeSinceStartUp();
+
+		// Pipeline objects are owned by each node, so nodes can build theirs in parallel
+		JobCounter prebuildCounter;
 		for (auto& node : m_nodes)
 		{
-			node.second->PrebuildGraphicsPipelines();
+			if (!node.second->m_isCulled)
+			{
+				RenderNode* pNode = node.second;
+				JobSystem::Schedule([pNode]()
+					{
+						pNode->PrebuildGraphicsPipelines();
+					},
+					&prebuildCounter);
+			}
 		}
+		JobSystem::WaitForCounter(&prebuildCounter);
+
+		// Mostly determined by whether device pipeline cache is warm
+		LOG_MESSAGE("Render graph prebuilt pipelines in " + std::to_string((Timer::TimeSinceStartUp() - startTime) / 1000000) + " ms.");
 	}
 
-	void RenderGraph::InitExecutionThreads()
+	void RenderGraph::InitExecutionContexts()
 	{
-		m_executionThreadCount = 4; // Default max 4 threads
-		m_executionThreadCount = std::min<uint32_t>(std::thread::hardware_concurrency() - 2, m_executionThreadCount); // -2 for main thread and render thread
-		m_executionThreadCount = std::max<uint32_t>(m_executionThreadCount, 1);
-#if defined(DEBUG_MODE_CE)
-		if (m_executionThreadCount == 1)
-		{
-			LOG_MESSAGE("Hardware concurrency is very low, render graph execution will be suboptimal.");
-		}
-#endif
-
-		for (uint32_t i = 0; i < m_executionThreadCount; i++)
+		m_executionContexts.resize(JobSystem::GetThreadSlotCount());
+		for (auto& cmdContext : m_executionContexts)
 		{
-			m_executionThreads.emplace_back(&RenderGraph::ExecuteRenderNodesParallel, this);
+			cmdContext.pCommandPool = m_pDevice->RequestExternalCommandPool(EQueueType::Graphics);
+			cmdContext.pTransferCommandPool = m_pDevice->RequestExternalCommandPool(EQueueType::Transfer);
+			cmdContext.pComputeCommandPool = m_pDevice->RequestExternalCommandPool(EQueueType::Compute);
 		}
 	}
 
 	void RenderGraph::BeginRenderPassesParallel(const RenderContext& context, uint32_t frameIndex)
 	{
-		DEBUG_ASSERT_MESSAGE_CE(m_executionThreadCount > 0, "Render graph threads are uninitialized.");
+		DEBUG_ASSERT_MESSAGE_CE(!m_executionContexts.empty(), "Render graph execution contexts are uninitialized.");
+
+		// Commands previously recorded in this frame slot have finished, as the frame in flight using it has retired
+		m_gpuProfiler.BeginFrame(frameIndex);
 
 		for (auto& pNode : m_nodes)
 		{
 			pNode.second->m_renderContext = context;
 			pNode.second->m_finishedExecution = false;
 			pNode.second->m_frameIndex = frameIndex;
-
-			if (pNode.second->m_prevNodes.empty())
-			{
-				m_startingNodes.push(pNode.second);
-			}
+			pNode.second->m_pendingPrevNodeCount = (uint32_t)pNode.second->m_prevNodes.size();
 		}
 
+		// Nodes that has no previous dependencies are scheduled first, the rest are scheduled by their last finished previous node
+		for (auto& pNode : m_nodes)
 		{
-			std::lock_guard<std::mutex> guard(m_nodeExecutionMutex);
-
-			while (!m_startingNodes.empty())
-			{
-				EnqueueRenderNode(m_startingNodes.front());
-				m_startingNodes.pop();
-			}
-
-			for (auto& pNode : m_nodes)
+			if (pNode.second->m_prevNodes.empty())
 			{
-				pNode.second->m_finishedExecution = false;
+				ScheduleRenderNode(pNode.second);
 			}
 		}
+	}
 
-		m_nodeExecutionCv.notify_all();
+	void RenderGraph::WaitRenderPasses()
+	{
+		JobSystem::WaitForCounter(&m_executionCounter);
 	}
 
 	RenderNode* RenderGraph::GetNodeByName(const char* name) const
@@ -348,7 +638,7 @@ namespace Engine
 
 	uint32_t RenderGraph::GetRenderNodeCount() const
 	{
-		return m_nodes.size();
+		return m_renderNodePriorities.size();
 	}
 
 	void RenderGraph::UpdateResolution(uint32_t width, uint32_t height)
@@ -357,50 +647,352 @@ namespace Engine
 		{
 			pNode.second->UpdateResolution(width, height);
 		}
+
+		// Texture sizes have changed, so memory sharing needs to be planned again
+		for (auto& pNode : m_nodes)
+		{
+			pNode.second->CollectTransientResources();
+		}
+
+		CompileTransientResources();
+		CompileResourceBarriers();
+
+		for (auto& pNode : m_nodes)
+		{
+			if (!pNode.second->m_isCulled)
+			{
+				pNode.second->CreateMutableResources(pNode.second->m_configuration);
+			}
+		}
 	}
 
-	void RenderGraph::ExecuteRenderNodesParallel()
+	uint64_t RenderGraph::GetTransientMemorySize() const
 	{
-		CommandContext cmdContext{};
-		cmdContext.pCommandPool = m_pDevice->RequestExternalCommandPool(EQueueType::Graphics);
-		cmdContext.pTransferCommandPool = m_pDevice->RequestExternalCommandPool(EQueueType::Transfer);
+		return m_transientMemorySize;
+	}
 
-		RenderNode* pNode = nullptr;
-		while (m_isRunning)
+	uint64_t RenderGraph::GetTransientMemorySaved() const
+	{
+		return m_transientMemoryRequested - m_transientMemorySize;
+	}
+
+	const GPUProfiler* RenderGraph::GetGPUProfiler() const
+	{
+		return &m_gpuProfiler;
+	}
+
+	void RenderGraph::CompileTransientResources()
+	{
+		DEBUG_ASSERT_MESSAGE_CE(!m_renderNodePriorities.empty(), "Render node priorities must be built before compiling transient resources.");
+
+		ReleaseTransientMemory();
+
+		struct TransientTextureRecord
+		{
+			RenderNode::TransientTextureDeclaration* pDeclaration;
+			DeviceMemoryRequirements requirements;
+			uint32_t firstUse; // Submit priority of the declaring node
+			uint32_t lastUse;  // Submit priority of the last node reading it
+			bool asyncComputeAccess; // Accessed by a node on async compute queue
+		};
+
+		struct MemoryBlockRecord
 		{
+			DeviceMemoryRequirements requirements;
+			std::vector<const TransientTextureRecord*> residents;
+			bool dedicated;
+		};
+
+		// Lifetime of each transient texture is the submit priority range between its producer and last consumer
+
+		std::vector<TransientTextureRecord> textureRecords;
+		for (auto& pNode : m_nodes)
+		{
+			if (pNode.second->m_isCulled)
 			{
-				std::unique_lock<std::mutex> lock(m_nodeExecutionMutex);
-				m_nodeExecutionCv.wait(lock, [this]() { return !m_executionNodeQueue.Empty(); });
+				continue;
 			}
 
-			while (m_executionNodeQueue.TryPop(pNode))
+			uint32_t producerPriority = m_renderNodePriorities.at(pNode.first);
+
+			for (auto& declaration : pNode.second->m_transientTextures)
 			{
-				pNode->m_cmdContext = cmdContext;
-				pNode->ExecuteParallel();
+				TransientTextureRecord record{};
+				record.pDeclaration = &declaration.second;
+				record.firstUse = producerPriority;
+				record.lastUse = producerPriority;
+				record.asyncComputeAccess = IsAsyncComputeNode(pNode.second);
+
+				RenderGraphResourceHandle handle = RenderGraphResource::GetHandle(declaration.first);
+				for (auto& pConsumer : m_nodes)
+				{
+					if (pConsumer.second->m_isCulled)
+					{
+						continue;
+					}
+
+					for (auto& input : pConsumer.second->m_inputResourceHandles)
+					{
+						if (input.second == handle)
+						{
+							record.lastUse = std::max<uint32_t>(record.lastUse, m_renderNodePriorities.at(pConsumer.first));
+							record.asyncComputeAccess |= IsAsyncComputeNode(pConsumer.second);
+						}
+					}
+				}
+
+				// Sharing mode affects memory requirements, so it has to be decided before querying them
+				declaration.second.createInfo.enableAsyncComputeAccess = record.asyncComputeAccess;
+
+				m_pDevice->GetTexture2DMemoryRequirements(declaration.second.createInfo, record.requirements);
+				textureRecords.emplace_back(record);
+			}
+		}
+
+		// Greedily place larger textures first, each block is sized to its largest resident
+
+		std::sort(textureRecords.begin(), textureRecords.end(),
+			[](const TransientTextureRecord& lhs, const TransientTextureRecord& rhs)
+			{
+				if (lhs.requirements.size != rhs.requirements.size)
+				{
+					return lhs.requirements.size > rhs.requirements.size;
+				}
+				return lhs.firstUse < rhs.firstUse;
+			});
+
+		bool enableAliasing = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetTransientResourceAliasing();
+
+		std::vector<MemoryBlockRecord> blockRecords;
+		for (const auto& record : textureRecords)
+		{
+			uint32_t blockIndex = (uint32_t)blockRecords.size();
+
+			// Submit priorities do not reflect execution order across queues, so textures touched by async compute never share memory
+			if (enableAliasing && !record.asyncComputeAccess)
+			{
+				for (uint32_t i = 0; i < blockRecords.size(); i++)
+				{
+					if (blockRecords[i].dedicated || (blockRecords[i].requirements.memoryTypeBits & record.requirements.memoryTypeBits) == 0)
+					{
+						continue;
+					}
+
+					bool overlapped = false;
+					for (auto pResident : blockRecords[i].residents)
+					{
+						if (pResident->firstUse <= record.lastUse && record.firstUse <= pResident->lastUse)
+						{
+							overlapped = true;
+							break;
+						}
+					}
+
+					if (!overlapped)
+					{
+						blockIndex = i;
+						break;
+					}
+				}
+			}
 
-				std::this_thread::yield();
+			if (blockIndex == blockRecords.size())
+			{
+				blockRecords.emplace_back();
+				blockRecords[blockIndex].requirements = record.requirements;
+				blockRecords[blockIndex].dedicated = record.asyncComputeAccess;
+			}
+			else
+			{
+				auto& requirements = blockRecords[blockIndex].requirements;
+				requirements.size = std::max<uint64_t>(requirements.size, record.requirements.size);
+				requirements.alignment = std::max<uint64_t>(requirements.alignment, record.requirements.alignment);
+				requirements.memoryTypeBits &= record.requirements.memoryTypeBits;
 			}
+			blockRecords[blockIndex].residents.emplace_back(&record);
 		}
+
+		// Frames in flight can overlap on GPU, so each frame gets its own set of blocks
+
+		uint32_t framesInFlight = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight();
+
+		for (const auto& record : textureRecords)
+		{
+			record.pDeclaration->memoryBlocks.resize(framesInFlight, nullptr);
+			record.pDeclaration->textures.resize(framesInFlight, nullptr);
+			m_transientMemoryRequested += record.requirements.size * framesInFlight;
+		}
+
+		for (const auto& block : blockRecords)
+		{
+			for (uint32_t i = 0; i < framesInFlight; i++)
+			{
+				TransientMemoryBlock* pMemoryBlock = nullptr;
+				m_pDevice->CreateTransientMemoryBlock(block.requirements, pMemoryBlock);
+				m_transientMemoryBlocks.emplace_back(pMemoryBlock);
+
+				for (auto pResident : block.residents)
+				{
+					pResident->pDeclaration->memoryBlocks[i] = pMemoryBlock;
+				}
+			}
+
+			// Residents never overlap, so ordering them by first use gives the sequence they take over the memory in
+			std::vector<const TransientTextureRecord*> residents = block.residents;
+			std::sort(residents.begin(), residents.end(),
+				[](const TransientTextureRecord* lhs, const TransientTextureRecord* rhs)
+				{
+					return lhs->firstUse < rhs->firstUse;
+				});
+
+			for (uint32_t i = 0; i < residents.size(); i++)
+			{
+				residents[i]->pDeclaration->pPrevResident = (i > 0) ? residents[i - 1]->pDeclaration : nullptr;
+				residents[i]->pDeclaration->isAliased = residents.size() > 1;
+			}
+
+			m_transientMemorySize += block.requirements.size * framesInFlight;
+		}
+
+		LOG_MESSAGE("Render graph placed " + std::to_string(textureRecords.size()) + " transient textures into " + std::to_string(blockRecords.size()) + " memory blocks per frame, "
+			+ std::to_string(m_transientMemorySize >> 20) + " MB allocated, " + std::to_string(GetTransientMemorySaved() >> 20) + " MB saved by aliasing.");
 	}
 
-	void RenderGraph::EnqueueRenderNode(RenderNode* pNode)
+	void RenderGraph::CompileResourceBarriers()
 	{
-		// Enqueue render nodes by dependency sequence
-		for (auto& pPrevNode : pNode->m_prevNodes)
+		// Each transient texture gets at most two barriers per frame, both recorded at the beginning of the node that needs them:
+		// the producer discards previous content when entering its own layout, and the first consumer makes the writes visible to all consumers
+
+		std::unordered_map<const RenderNode::TransientTextureDeclaration*, RenderNode*> firstConsumers;
+
+		for (auto& pProducer : m_nodes)
 		{
-			if (!pPrevNode->m_finishedExecution) // m_finishedExecution is being used as traversal flag here
+			pProducer.second->m_resourceBarriers.clear();
+
+			if (pProducer.second->m_isCulled)
 			{
-				return;
+				continue;
+			}
+
+			for (auto& declaration : pProducer.second->m_transientTextures)
+			{
+				RenderGraphResourceHandle handle = RenderGraphResource::GetHandle(declaration.first);
+				declaration.second.consumerAccess = ETextureAccessType::Undefined;
+
+				for (auto& pConsumer : m_nodes)
+				{
+					if (pConsumer.second->m_isCulled || pConsumer.second == pProducer.second)
+					{
+						continue;
+					}
+
+					for (auto& input : pConsumer.second->m_inputResourceHandles)
+					{
+						if (input.second != handle)
+						{
+							continue;
+						}
+
+						ETextureAccessType access = pConsumer.second->m_inputResourceAccesses.at(input.first);
+						DEBUG_ASSERT_CE(access != ETextureAccessType::Undefined && !IsTextureWriteAccess(access));
+
+						if (declaration.second.consumerAccess == ETextureAccessType::Undefined)
+						{
+							declaration.second.consumerAccess = access;
+						}
+						else if (declaration.second.consumerAccess != access)
+						{
+							// Consumers disagree on layout, the ones not sampling it have to transition on their own
+							declaration.second.consumerAccess = ETextureAccessType::FragmentShaderRead;
+						}
+
+						auto itr = firstConsumers.find(&declaration.second);
+						if (itr == firstConsumers.end() || m_renderNodePriorities.at(pConsumer.first) < m_renderNodePriorities.at(itr->second->m_pName))
+						{
+							firstConsumers[&declaration.second] = pConsumer.second;
+						}
+					}
+				}
 			}
 		}
 
-		m_executionNodeQueue.Push(pNode);
-		pNode->m_finishedExecution = true;
+		for (auto& pProducer : m_nodes)
+		{
+			if (pProducer.second->m_isCulled)
+			{
+				continue;
+			}
 
-		for (auto& pNextNode : pNode->m_nextNodes)
+			for (auto& declaration : pProducer.second->m_transientTextures)
+			{
+				// Content from the previous frame is never needed, and the frame fence has already covered work from that frame.
+				// But the memory may have been used by another texture earlier in this frame, or by later residents in the previous frame
+				const auto pPrevResident = declaration.second.pPrevResident;
+				if (declaration.second.isAliased || GetTextureAccessLayout(declaration.second.GetLastAccess()) != GetTextureAccessLayout(declaration.second.access))
+				{
+					RenderNode::ResourceBarrier barrier{};
+					barrier.pDeclaration = &declaration.second;
+					barrier.srcAccess = pPrevResident ? pPrevResident->GetLastAccess() : ETextureAccessType::Undefined;
+					barrier.dstAccess = declaration.second.access;
+					barrier.discardContent = true;
+					barrier.crossQueue = false; // Memory is dedicated if async compute accesses it, so previous resident is always on the same queue
+
+					pProducer.second->m_resourceBarriers.emplace_back(barrier);
+				}
+
+				// Nothing to wait for if the producer only reads it in the same layout
+				auto itr = firstConsumers.find(&declaration.second);
+				if (itr != firstConsumers.end()
+					&& (IsTextureWriteAccess(declaration.second.access) || GetTextureAccessLayout(declaration.second.access) != GetTextureAccessLayout(declaration.second.consumerAccess)))
+				{
+					RenderNode::ResourceBarrier barrier{};
+					barrier.pDeclaration = &declaration.second;
+					barrier.srcAccess = declaration.second.access;
+					barrier.dstAccess = declaration.second.consumerAccess;
+					barrier.discardContent = false;
+					// Alert: consumers on a different queue than the first consumer are not ordered against its transition, so a texture should be consumed on one queue only
+					barrier.crossQueue = IsAsyncComputeNode(pProducer.second) != IsAsyncComputeNode(itr->second);
+
+					itr->second->m_resourceBarriers.emplace_back(barrier);
+				}
+			}
+		}
+	}
+
+	void RenderGraph::ReleaseTransientMemory()
+	{
+		// Alert: textures placed into these blocks must have been destroyed or no longer be used
+		for (auto& pMemoryBlock : m_transientMemoryBlocks)
 		{
-			EnqueueRenderNode(pNextNode);
+			CE_DELETE(pMemoryBlock);
 		}
+		m_transientMemoryBlocks.clear();
+
+		m_transientMemorySize = 0;
+		m_transientMemoryRequested = 0;
+	}
+
+	bool RenderGraph::IsAsyncComputeNode(const RenderNode* pNode) const
+	{
+		return pNode->m_queueType == EQueueType::Compute && m_pDevice->IsAsyncComputeEnabled();
+	}
+
+	void RenderGraph::ScheduleRenderNode(RenderNode* pNode)
+	{
+		JobSystem::Schedule([this, pNode]()
+			{
+				pNode->m_cmdContext = m_executionContexts[JobSystem::GetCurrentThreadSlot()];
+				pNode->ExecuteParallel();
+
+				for (auto& pNextNode : pNode->m_nextNodes)
+				{
+					if (pNextNode->m_pendingPrevNodeCount.fetch_sub(1) == 1)
+					{
+						ScheduleRenderNode(pNextNode);
+					}
+				}
+			},
+			&m_executionCounter);
 	}
 
 	void RenderGraph::TraverseRenderNode(RenderNode* pNode, std::vector<RenderNode*>& output)
@@ -3,10 +3,13 @@
 #include "GraphicsDevice.h"
 #include "BuiltInShaderType.h"
 #include "NoCopy.h"
-#include "SafeQueue.h"
+#include "JobSystem.h"
+#include "MeshletCuller.h"
+#include "GPUProfiler.h"
 
 #include <queue>
 #include <mutex>
+#include <string>
 
 namespace Engine
 {
@@ -14,14 +17,25 @@ namespace Engine
 	class BaseRenderer;
 	class RenderGraph;
 
+	typedef uint32_t RenderGraphResourceHandle;
+
+	static const RenderGraphResourceHandle INVALID_RENDER_GRAPH_RESOURCE_HANDLE = 0xFFFFFFFF;
+
 	class RenderGraphResource
 	{
 	public:
+		// Handles are assigned by name contents and shared by all resource tables, so they only need to be resolved once when building the graph
+		static RenderGraphResourceHandle GetHandle(const char* name);
+
 		void Add(const char* name, RawResource* pResource);
-		RawResource* Get(const char* name) const;
+		RawResource* Get(RenderGraphResourceHandle handle) const;
 
 	private:
-		std::unordered_map<const char*, RawResource*> m_renderResources;
+		std::vector<RawResource*> m_renderResources; // Indexed by handle
+
+		static std::unordered_map<std::string, RenderGraphResourceHandle> m_handleRegistry;
+		static std::vector<std::string> m_registeredNames;
+		static std::mutex m_registryMutex;
 	};
 
 	struct RenderContext
@@ -30,12 +44,14 @@ namespace Engine
 		const std::vector<BaseEntity*>* pTransparentDrawList;
 		const std::vector<BaseEntity*>* pLightDrawList;
 		const BaseEntity* pCamera;
+		float dynamicResolutionScale; // Portion of render targets rendered this frame on each axis, 1.0 if dynamic resolution is disabled
 	};
 
 	struct CommandContext
 	{
 		GraphicsCommandPool* pCommandPool;
 		GraphicsCommandPool* pTransferCommandPool;
+		GraphicsCommandPool* pComputeCommandPool; // Same as graphics command pool if async compute is not available
 	};
 	
 	struct RenderNodeConfiguration
@@ -62,20 +78,44 @@ namespace Engine
 
 	protected:
 		void Setup(const RenderNodeConfiguration& initInfo);
+		void ResolveInputResourceHandles();
+		void CollectTransientResources();
+
+		// Transient textures only live within a frame, their memory may be shared with other transient textures once the graph is compiled
+		// Access is how the declaring node itself uses the texture, layouts required by consumers are derived from their input declarations
+		void DeclareTransientTexture(const char* pName, const Texture2DCreateInfo& createInfo, ETextureAccessType access);
+		void CreateTransientTexture(const char* pName, uint32_t frameIndex, Texture2D*& pOutput); // Only valid after render graph compilation
+		void RecordResourceBarriers(GraphicsCommandBuffer* pCommandBuffer); // Must be recorded before any graph resource is accessed in the node
+
+		// Brackets GPU work of the node for profiling, begin should be recorded first and end right before the command buffer is ended
+		void BeginProfilingScope(GraphicsCommandBuffer* pCommandBuffer);
+		void EndProfilingScope(GraphicsCommandBuffer* pCommandBuffer);
+
+		// With dynamic resolution, render targets keep their size and only a sub-rect anchored at origin is rendered each frame
+		// Viewport has to be updated before binding pipelines, nodes writing to swapchain always render to the whole image
+		void UpdateDynamicRenderArea(const RenderContext& renderContext);
+		Vector2 GetInputTexCoordScale(const RenderContext& renderContext) const; // Maps full-screen texture coordinates to the valid sub-rect of input textures
+
+		void GetDynamicRenderAreaExtent(const RenderContext& renderContext, uint32_t& outWidth, uint32_t& outHeight) const;
 
 		void ExecuteSequential();
 		void ExecuteParallel();
 
 		PipelineVertexInputStateCreateInfo GetDefaultVertexInputStateCreateInfo() const;
+		PipelineVertexInputStateCreateInfo GetPositionOnlyVertexInputStateCreateInfo() const; // For depth-only pipelines, reads position stream of meshes that have one
+
+		// Draws visible ranges from the last m_meshletCuller result if useMeshletRanges is set, otherwise the whole submesh
+		void DrawSubMesh(const Mesh* pMesh, uint32_t subMeshIndex, bool useMeshletRanges, GraphicsCommandBuffer* pCommandBuffer);
 
 		virtual void CreateConstantResources(const RenderNodeConfiguration& initInfo) = 0; // Pipeline objects that are constant
+		virtual void DeclareTransientResources(const RenderNodeConfiguration& initInfo) {}
 		virtual void CreateMutableResources(const RenderNodeConfiguration& initInfo) = 0;  // Render textures, etc. that can be changed depending on external settings
 		virtual void DestroyMutableResources() {}
 		virtual void DestroyConstantResources();
 
 		virtual void RenderPassFunction(RenderGraphResource* pGraphResources, const RenderContext& renderContext, const CommandContext& cmdContext) = 0;
 
-		virtual void UpdateResolution(uint32_t width, uint32_t height) = 0;
+		virtual void UpdateResolution(uint32_t width, uint32_t height) = 0; // Mutable resources are recreated by render graph afterwards
 
 		virtual void PrebuildGraphicsPipelines() = 0;
 		virtual GraphicsPipelineObject* GetGraphicsPipeline(uint32_t key);
@@ -92,6 +132,7 @@ namespace Engine
 		std::vector<RenderNode*> m_prevNodes;
 		std::vector<RenderNode*> m_nextNodes;
 		bool m_finishedExecution;
+		std::atomic<uint32_t> m_pendingPrevNodeCount; // For parallel execution, node is scheduled when it reaches zero
 
 		std::vector<RenderGraphResource*> m_graphResources;
 		uint32_t m_frameIndex;
@@ -99,6 +140,11 @@ namespace Engine
 		std::vector<Texture2D*>* m_pSwapchainImages;
 		bool m_outputToSwapchain;
 
+		MeshletCuller m_meshletCuller;
+
+		GPUProfiler* m_pProfiler;
+		uint32_t m_profilerScope;
+
 		struct DefaultGraphicsPipelineStates
 		{
 			DefaultGraphicsPipelineStates()
@@ -136,8 +182,39 @@ namespace Engine
 		CommandContext m_cmdContext;
 
 		RenderPassObject* m_pRenderPassObject; // This can be null if a node is compute only
+		EQueueType m_queueType; // Compute nodes should record into compute command pool, so they can overlap with graphics work on async compute queue
+
+		struct TransientTextureDeclaration
+		{
+			Texture2DCreateInfo createInfo;
+			ETextureAccessType access;
+			ETextureAccessType consumerAccess; // Undefined if no other node reads it
+			std::vector<TransientMemoryBlock*> memoryBlocks; // Per frame, assigned by render graph compilation
+			std::vector<Texture2D*> textures; // Per frame, owned by the declaring node
+			const TransientTextureDeclaration* pPrevResident; // Texture that used the same memory earlier in the frame
+			bool isAliased; // Memory is shared with other textures, so its content and layout do not survive to the next frame
+
+			ETextureAccessType GetLastAccess() const // The texture stays in this layout between frames
+			{
+				return consumerAccess != ETextureAccessType::Undefined ? consumerAccess : access;
+			}
+		};
+		std::unordered_map<const char*, TransientTextureDeclaration> m_transientTextures;
+
+		struct ResourceBarrier
+		{
+			const TransientTextureDeclaration* pDeclaration;
+			ETextureAccessType srcAccess;
+			ETextureAccessType dstAccess;
+			bool discardContent;
+			bool crossQueue;
+		};
+		std::vector<ResourceBarrier> m_resourceBarriers; // Planned by render graph
+		bool m_isCulled; // None of the outputs is consumed, so the node is not executed
 
 		std::unordered_map<const char*, const char*> m_inputResourceNames;
+		std::unordered_map<const char*, ETextureAccessType> m_inputResourceAccesses; // Input slot - how the node reads it
+		std::unordered_map<const char*, RenderGraphResourceHandle> m_inputResourceHandles; // Input slot - resolved resource handle
 		std::unordered_map<uint32_t, GraphicsPipelineObject*> m_graphicsPipelines; // Key usually is the shader type, but ultimately it's determined by each render node
 																				   // (e.g. might reuse same shader with a different render pass)
 
@@ -154,37 +231,51 @@ namespace Engine
 
 		void AddRenderNode(const char* name, RenderNode* pNode);
 		void SetupRenderNodes();
-		void BuildRenderNodePriorities();
 		void PrebuildPipelines();
-		void InitExecutionThreads();
+		void InitExecutionContexts();
 
 		void BeginRenderPassesParallel(const RenderContext& context, uint32_t frameIndex);
+		void WaitRenderPasses(); // Executes other pending jobs while waiting
 
 		RenderNode* GetNodeByName(const char* name) const;
-		uint32_t GetRenderNodeCount() const;
+		uint32_t GetRenderNodeCount() const; // Culled nodes are not counted
 
 		void UpdateResolution(uint32_t width, uint32_t height);
 
+		uint64_t GetTransientMemorySize() const;
+		uint64_t GetTransientMemorySaved() const;
+
+		const GPUProfiler* GetGPUProfiler() const; // Holds GPU time history of each render node if GPU profiling is enabled
+
 	private:
-		void ExecuteRenderNodesParallel();
-		void EnqueueRenderNode(RenderNode* pNode);
+		void CullRenderNodes();
+		void BuildRenderNodePriorities();
+		void CompileTransientResources();
+		void CompileResourceBarriers();
+		void ReleaseTransientMemory();
+
+		bool IsAsyncComputeNode(const RenderNode* pNode) const;
+
+		void ScheduleRenderNode(RenderNode* pNode);
 		void TraverseRenderNode(RenderNode* pNode, std::vector<RenderNode*>& output);
 
 	public:
 		std::unordered_map<const char*, uint32_t> m_renderNodePriorities; // Render Node Name - Submit Priority
 		std::unordered_map<uint32_t, std::vector<uint32_t>> m_nodePriorityDependencies; // Submit Priority - Dependent Submit Priority
+		std::vector<EQueueType> m_nodePriorityQueueTypes; // Indexed by submit priority, the queue each node's command buffer is submitted to
 
 	private:
 		GraphicsDevice* m_pDevice;
 		std::unordered_map<const char*, RenderNode*> m_nodes;
-		std::queue<RenderNode*> m_startingNodes; // Nodes that has no previous dependencies
-		bool m_isRunning;
-
-		// For parallel node execution	
-		uint32_t m_executionThreadCount;
-		std::vector<std::thread> m_executionThreads;
-		std::mutex m_nodeExecutionMutex;
-		std::condition_variable m_nodeExecutionCv;
-		SafeQueue<RenderNode*> m_executionNodeQueue;
+
+		std::vector<TransientMemoryBlock*> m_transientMemoryBlocks;
+		uint64_t m_transientMemorySize;
+		uint64_t m_transientMemoryRequested; // Total size if every transient texture had its own memory
+
+		// For parallel node execution
+		std::vector<CommandContext> m_executionContexts; // One per job system thread slot, as command pools cannot be shared across threads
+		JobCounter m_executionCounter;
+
+		GPUProfiler m_gpuProfiler;
 	};
 }
\ No newline at end of file
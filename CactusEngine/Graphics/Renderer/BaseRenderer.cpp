@@ -13,7 +13,7 @@ namespace Engine
 		m_pSystem(pSystem),
 		m_eGraphicsDeviceType(pDevice->GetGraphicsAPIType()),
 		m_finishedNodeCount(0),
-		m_commandRecordFinished(false)
+		m_submittedNodeCount(0)
 	{
 		uint32_t maxFramesInFlight = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight();
 		m_graphResources.resize(maxFramesInFlight);
@@ -37,22 +37,43 @@ namespace Engine
 			item = nullptr;
 		}
 		m_finishedNodeCount = 0;
-		m_commandRecordFinished = false;
+		m_submittedNodeCount = 0;
+
+		m_nodeWaitSemaphores.resize(m_commandRecordReadyList.size());
+		for (auto& semaphores : m_nodeWaitSemaphores)
+		{
+			semaphores.clear();
+		}
 
 		m_pBufferManager->SetCurrentFrameIndex(frameIndex);
 		m_pBufferManager->ResetBufferAllocation();
 
 		m_pRenderGraph->BeginRenderPassesParallel(renderContext, frameIndex);
 
+		// Submit async recorded command buffers by correct sequence, as soon as all nodes before them in priority order are recorded
+		// so that GPU can execute earlier passes while later passes are still being recorded
+		// Alert: every render node must write its command buffer each frame, otherwise submission would stall here
+		uint32_t nodeCount = (uint32_t)m_commandRecordReadyList.size();
+		while (m_submittedNodeCount < nodeCount)
 		{
-			std::unique_lock<std::mutex> lock(m_commandRecordListWriteMutex);
-			m_commandRecordListCv.wait(lock, [this]() { return m_commandRecordFinished; });
+			uint32_t readyNodeCount = m_submittedNodeCount;
+			{
+				std::unique_lock<std::mutex> lock(m_commandRecordListWriteMutex);
+				m_commandRecordListCv.wait(lock, [this]() { return m_commandRecordReadyList[m_submittedNodeCount] != nullptr; });
+
+				while (readyNodeCount < nodeCount && m_commandRecordReadyList[readyNodeCount] != nullptr)
+				{
+					++readyNodeCount;
+				}
+			}
+
+			SubmitCommandRecordList(m_submittedNodeCount, readyNodeCount);
+			m_submittedNodeCount = readyNodeCount;
 		}
 
-		// Submit async recorded command buffers by correct sequence
-		// One batch per frame
-		m_pDevice->ReturnMultipleExternalCommandBuffer(m_commandRecordReadyList);
-		m_pDevice->FlushCommands(false, false);
+		m_pRenderGraph->WaitRenderPasses();
+
+		DEBUG_ASSERT_CE(m_finishedNodeCount == m_pRenderGraph->GetRenderNodeCount());
 	}
 
 	void BaseRenderer::WriteCommandRecordList(const char* pNodeName, GraphicsCommandBuffer* pCommandBuffer)
@@ -65,12 +86,8 @@ namespace Engine
 			++m_finishedNodeCount;
 
 			DEBUG_ASSERT_CE(m_finishedNodeCount <= m_pRenderGraph->GetRenderNodeCount()); // Check for overwriting
-			if (m_finishedNodeCount == m_pRenderGraph->GetRenderNodeCount())
-			{
-				m_commandRecordFinished = true;
-				m_commandRecordListCv.notify_one();
-			}
 		}
+		m_commandRecordListCv.notify_one();
 	}
 
 	ERendererType BaseRenderer::GetRendererType() const
@@ -114,6 +131,69 @@ namespace Engine
 		m_pRenderGraph->UpdateResolution(width, height);
 	}
 
+	void BaseRenderer::SubmitCommandRecordList(uint32_t beginPriority, uint32_t endPriority)
+	{
+		// Consecutive command buffers on the same queue are submitted as one batch, batches on different queues are chained by semaphores
+		// Same queue batches need no semaphore since pipeline barriers already respect submission order
+		const auto& queueTypes = m_pRenderGraph->m_nodePriorityQueueTypes;
+		DEBUG_ASSERT_CE(queueTypes.size() == m_commandRecordReadyList.size());
+
+		std::vector<GraphicsCommandBuffer*> batchCommandBuffers;
+		uint32_t batchBegin = beginPriority;
+		while (batchBegin < endPriority)
+		{
+			uint32_t batchEnd = batchBegin + 1;
+			while (batchEnd < endPriority && queueTypes[batchEnd] == queueTypes[batchBegin])
+			{
+				++batchEnd;
+			}
+
+			// Semaphores are waited by the first command buffer of the batch, each one has exactly one waiter so it can be recycled with it
+			for (uint32_t priority = batchBegin; priority < batchEnd; priority++)
+			{
+				for (auto pSemaphore : m_nodeWaitSemaphores[priority])
+				{
+					m_pDevice->CommandWaitSemaphore(m_commandRecordReadyList[batchBegin], pSemaphore);
+				}
+				m_nodeWaitSemaphores[priority].clear();
+			}
+
+			// Later nodes on the other queue that depend on this batch haven't been submitted yet, signal one semaphore for each of them
+			for (uint32_t priority = batchEnd; priority < (uint32_t)queueTypes.size(); priority++)
+			{
+				if (queueTypes[priority] == queueTypes[batchBegin])
+				{
+					continue;
+				}
+
+				for (uint32_t dependency : m_pRenderGraph->m_nodePriorityDependencies[priority])
+				{
+					if (dependency >= batchBegin && dependency < batchEnd)
+					{
+						auto pSemaphore = m_pDevice->RequestGraphicsSemaphore(ESemaphoreWaitStage::AllCommands);
+						m_pDevice->CommandSignalSemaphore(m_commandRecordReadyList[batchEnd - 1], pSemaphore);
+						m_nodeWaitSemaphores[priority].emplace_back(pSemaphore);
+						break;
+					}
+				}
+			}
+
+			batchCommandBuffers.assign(m_commandRecordReadyList.begin() + batchBegin, m_commandRecordReadyList.begin() + batchEnd);
+			m_pDevice->ReturnMultipleExternalCommandBuffer(batchCommandBuffers);
+
+			if (queueTypes[batchBegin] == EQueueType::Compute)
+			{
+				m_pDevice->FlushComputeCommands(false);
+			}
+			else
+			{
+				m_pDevice->FlushCommands(false, false);
+			}
+
+			batchBegin = batchEnd;
+		}
+	}
+
 	void BaseRenderer::ObtainSwapchainImages()
 	{
 		m_swapchainImages.clear();
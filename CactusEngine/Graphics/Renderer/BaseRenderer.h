@@ -5,6 +5,8 @@
 #include <unordered_map>
 #include <queue>
 #include <vector>
+#include <mutex>
+#include <condition_variable>
 
 namespace Engine
 {
@@ -13,6 +15,7 @@ namespace Engine
 	class RenderGraph;
 	class GraphicsDevice;
 	class GraphicsCommandBuffer;
+	class GraphicsSemaphore;
 	class RenderGraphResource;
 	class Texture2D;
 	class UniformBufferManager;
@@ -48,6 +51,9 @@ namespace Engine
 	protected:
 		void ObtainSwapchainImages();
 
+	private:
+		void SubmitCommandRecordList(uint32_t beginPriority, uint32_t endPriority); // Submits recorded command buffers within [beginPriority, endPriority)
+
 	protected:
 		ERendererType	 m_rendererType;
 		uint32_t		 m_renderPriority; // 0 is the highest priority
@@ -64,7 +70,8 @@ namespace Engine
 		std::mutex m_commandRecordListWriteMutex;
 		std::condition_variable m_commandRecordListCv;
 		uint32_t m_finishedNodeCount;
-		bool m_commandRecordFinished;
+		uint32_t m_submittedNodeCount; // Command buffers are submitted in priority order, nodes below this priority have been submitted
+		std::vector<std::vector<GraphicsSemaphore*>> m_nodeWaitSemaphores; // Indexed by submit priority, signaled by previously submitted nodes on the other queue
 
 		UniformBufferManager* m_pBufferManager;
 	};
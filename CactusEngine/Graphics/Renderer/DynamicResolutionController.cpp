@@ -0,0 +1,68 @@
+#include "DynamicResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Engine
+{
+	DynamicResolutionController::DynamicResolutionController(float targetFrameTime, float minScale, float maxScale)
+		: m_targetFrameTime(targetFrameTime),
+		m_minScale(std::min(minScale, maxScale)),
+		m_maxScale(maxScale),
+		m_scale(maxScale),
+		m_frameTimeHistory{},
+		m_historyCount(0)
+	{
+
+	}
+
+	void DynamicResolutionController::AddFrameTime(float frameTime)
+	{
+		m_frameTimeHistory[m_historyCount++] = frameTime;
+
+		if (m_historyCount < FRAME_HISTORY_SIZE)
+		{
+			return;
+		}
+
+		// Frames in history were all rendered with current scale, start over once scale changes
+		m_historyCount = 0;
+
+		float averageFrameTime = GetAverageFrameTime();
+		if (averageFrameTime <= 0.0f
+			|| (averageFrameTime <= m_targetFrameTime * (1.0f + FRAME_TIME_TOLERANCE) && averageFrameTime >= m_targetFrameTime * (1.0f - FRAME_TIME_TOLERANCE)))
+		{
+			return;
+		}
+
+		// Alert: frame time also includes work that does not scale with resolution, so the estimate overshoots when that part dominates
+		float estimatedScale = m_scale * std::sqrt(m_targetFrameTime / averageFrameTime);
+		float newScale = std::clamp(m_scale + (estimatedScale - m_scale) * SCALE_ADJUSTMENT_RATE, m_minScale, m_maxScale);
+
+		if (std::abs(newScale - m_scale) >= MIN_SCALE_STEP || newScale == m_minScale || newScale == m_maxScale)
+		{
+			m_scale = newScale;
+		}
+	}
+
+	float DynamicResolutionController::GetScale() const
+	{
+		return m_scale;
+	}
+
+	void DynamicResolutionController::Reset()
+	{
+		m_scale = m_maxScale;
+		m_historyCount = 0;
+	}
+
+	float DynamicResolutionController::GetAverageFrameTime() const
+	{
+		float sum = 0.0f;
+		for (uint32_t i = 0; i < FRAME_HISTORY_SIZE; ++i)
+		{
+			sum += m_frameTimeHistory[i];
+		}
+		return sum / FRAME_HISTORY_SIZE;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+namespace Engine
+{
+	// Picks the portion of render targets to be rendered each frame, so that frame time stays close to target
+	// Shading cost is assumed to be proportional to pixel count, which is the square of the scale
+	class DynamicResolutionController
+	{
+	public:
+		DynamicResolutionController(float targetFrameTime, float minScale, float maxScale = 1.0f); // Frame time in milliseconds
+
+		void AddFrameTime(float frameTime); // In milliseconds
+		float GetScale() const;				// Applied to both axes of render targets
+		void Reset();
+
+	private:
+		float GetAverageFrameTime() const;
+
+	public:
+		static const uint32_t FRAME_HISTORY_SIZE = 8; // Scale is only updated after this many frames are rendered with the same scale
+		static constexpr float FRAME_TIME_TOLERANCE = 0.1f; // Small fluctuations around target do not change scale, so that resolution does not visibly flicker
+		static constexpr float SCALE_ADJUSTMENT_RATE = 0.5f; // Fraction of the estimated change applied at once
+		static constexpr float MIN_SCALE_STEP = 0.02f;
+
+	private:
+		float m_targetFrameTime;
+		float m_minScale;
+		float m_maxScale;
+		float m_scale;
+
+		float m_frameTimeHistory[FRAME_HISTORY_SIZE];
+		uint32_t m_historyCount;
+	};
+}
\ No newline at end of file
@@ -69,10 +69,9 @@ namespace Engine
 
 		// Initialize render graph
 
-		m_pRenderGraph->InitExecutionThreads();
+		m_pRenderGraph->InitExecutionContexts();
 
 		m_pRenderGraph->SetupRenderNodes();
-		m_pRenderGraph->BuildRenderNodePriorities();
 
 		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPrebuildShadersAndPipelines())
 		{
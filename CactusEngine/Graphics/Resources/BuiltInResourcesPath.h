@@ -8,6 +8,7 @@ namespace Engine
 
 		static const char* SHADER_VERTEX_BASIC_VK = "Assets/Shader/SPIRV/Basic_vert.spv";
 		static const char* SHADER_FRAGMENT_BASIC_VK = "Assets/Shader/SPIRV/Basic_frag.spv";
+		static const char* SHADER_FRAGMENT_BASIC_BINDLESS_VK = "Assets/Shader/SPIRV/Basic_Bindless_frag.spv";
 		static const char* SHADER_VERTEX_BASIC_TRANSPARENT_VK = "Assets/Shader/SPIRV/Basic_Transparent_vert.spv";
 		static const char* SHADER_FRAGMENT_BASIC_TRANSPARENT_VK = "Assets/Shader/SPIRV/Basic_Transparent_frag.spv";
 
@@ -23,12 +24,24 @@ namespace Engine
 
 		static const char* SHADER_VERTEX_ANIMESTYLE_VK = "Assets/Shader/SPIRV/AnimeStyle_vert.spv";
 		static const char* SHADER_FRAGMENT_ANIMESTYLE_VK = "Assets/Shader/SPIRV/AnimeStyle_frag.spv";
+		static const char* SHADER_FRAGMENT_ANIMESTYLE_BINDLESS_VK = "Assets/Shader/SPIRV/AnimeStyle_Bindless_frag.spv";
 
 		static const char* SHADER_VERTEX_SHADOWMAP_VK = "Assets/Shader/SPIRV/ShadowMap_vert.spv";
 		static const char* SHADER_FRAGMENT_SHADOWMAP_VK = "Assets/Shader/SPIRV/ShadowMap_frag.spv";
+		static const char* SHADER_VERTEX_SHADOWMAP_POSITION_ONLY_VK = "Assets/Shader/SPIRV/ShadowMap_PositionOnly_vert.spv";
+		static const char* SHADER_FRAGMENT_SHADOWMAP_POSITION_ONLY_VK = "Assets/Shader/SPIRV/ShadowMap_PositionOnly_frag.spv";
 
 		static const char* SHADER_VERTEX_DEFERRED_LIGHTING_VK = "Assets/Shader/SPIRV/LightDeferred_vert.spv";
 		static const char* SHADER_FRAGMENT_DEFERRED_LIGHTING_VK = "Assets/Shader/SPIRV/LightDeferred_frag.spv";
 		static const char* SHADER_FRAGMENT_DEFERRED_LIGHTING_DIR_VK = "Assets/Shader/SPIRV/LightDeferred_Directional_frag.spv";
+
+		static const char* SHADER_COMPUTE_MIPMAP_GENERATION_VK = "Assets/Shader/SPIRV/MipmapGeneration_comp.spv";
+
+		static const char* PIPELINE_CACHE_VK = "Cache/PipelineCache_VK.bin";
+		static const char* SHADER_REFLECTION_CACHE_DIRECTORY_VK = "Cache/ShaderReflection_VK/";
+
+		// Cooked assets
+
+		static const char* TEXTURE_CACHE_DIRECTORY = "Cache/Textures/";
 	}
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "BasicMathTypes.h"
 #include "LogUtility.h"
 
+#include <cstdint>
+#include <cstring>
+
 namespace Engine
 {
 	enum class EBuiltInShaderProgramType
@@ -17,6 +20,7 @@ namespace Engine
 		DOF,
 		DeferredLighting,
 		DeferredLighting_Directional,
+		ShadowMap_PositionOnly,
 		COUNT
 	};
 
@@ -40,6 +44,8 @@ namespace Engine
 	{
 		Matrix4x4 modelMatrix;
 		Matrix4x4 normalMatrix;
+		Vector4	  positionScale; // Decodes vertex position from quantized layout, identity for float layout
+		Vector4	  positionOffset;
 	};
 
 	struct alignas(UNIFORM_BUFFER_ALIGNMENT_CE) UBCameraMatrices
@@ -86,142 +92,231 @@ namespace Engine
 		float	radius;
 	};
 
+	// Storage block structures, laid out as std430
+
+	static const uint32_t BINDLESS_INVALID_INDEX = 0xFFFFFFFF;
+
+	struct alignas(16) BindlessMaterialRecord
+	{
+		Vector4	 albedoColor;
+		float	 anisotropy;
+		float	 roughness;
+		uint32_t albedoTextureIndex;
+		uint32_t toneTextureIndex;
+	};
+
+	typedef uint32_t ShaderParamID;
+
+	static constexpr ShaderParamID INVALID_SHADER_PARAM_ID = 0xFFFFFFFF;
+
+	// Dense parameter slots; shader programs resolve reflected bindings into a table indexed by these
+	namespace ShaderParamIDs
+	{
+		static constexpr ShaderParamID TRANSFORM_MATRICES = 0;
+		static constexpr ShaderParamID CAMERA_MATRICES = 1;
+		static constexpr ShaderParamID LIGHTSPACE_TRANSFORM_MATRIX = 2;
+		static constexpr ShaderParamID MATERIAL_NUMERICAL_PROPERTIES = 3;
+		static constexpr ShaderParamID CAMERA_PROPERTIES = 4;
+		static constexpr ShaderParamID LIGHTSOURCE_PROPERTIES = 5;
+		static constexpr ShaderParamID SYSTEM_VARIABLES = 6;
+		static constexpr ShaderParamID CONTROL_VARIABLES = 7;
+		static constexpr ShaderParamID SHADOWMAP_DEPTH_TEXTURE = 8;
+		static constexpr ShaderParamID ALBEDO_TEXTURE = 9;
+		static constexpr ShaderParamID GCOLOR_TEXTURE = 10;
+		static constexpr ShaderParamID GNORMAL_TEXTURE = 11;
+		static constexpr ShaderParamID GPOSITION_TEXTURE = 12;
+		static constexpr ShaderParamID DEPTH_TEXTURE_1 = 13;
+		static constexpr ShaderParamID DEPTH_TEXTURE_2 = 14;
+		static constexpr ShaderParamID COLOR_TEXTURE_1 = 15;
+		static constexpr ShaderParamID COLOR_TEXTURE_2 = 16;
+		static constexpr ShaderParamID TONE_TEXTURE = 17;
+		static constexpr ShaderParamID NOISE_TEXTURE_1 = 18;
+		static constexpr ShaderParamID NOISE_TEXTURE_2 = 19;
+		static constexpr ShaderParamID MASK_TEXTURE_1 = 20;
+		static constexpr ShaderParamID MASK_TEXTURE_2 = 21;
+		static constexpr ShaderParamID MIPMAP_LEVEL_IMAGES = 22;
+		static constexpr ShaderParamID MIPMAP_GENERATION_COUNTERS = 23;
+
+		static constexpr ShaderParamID COUNT = 24;
+	}
+
 	namespace ShaderParamNames
 	{
 		// Uniform blocks
 
-		static const char* TRANSFORM_MATRICES = "TransformMatrices";
-		static const char* CAMERA_MATRICES = "CameraMatrices";
-		static const char* LIGHTSPACE_TRANSFORM_MATRIX = "LightSpaceTransformMatrix";
+		static constexpr const char* TRANSFORM_MATRICES = "TransformMatrices";
+		static constexpr const char* CAMERA_MATRICES = "CameraMatrices";
+		static constexpr const char* LIGHTSPACE_TRANSFORM_MATRIX = "LightSpaceTransformMatrix";
 
-		static const char* MATERIAL_NUMERICAL_PROPERTIES = "MaterialNumericalProperties";
+		static constexpr const char* MATERIAL_NUMERICAL_PROPERTIES = "MaterialNumericalProperties";
 
-		static const char* CAMERA_PROPERTIES = "CameraProperties";
+		static constexpr const char* CAMERA_PROPERTIES = "CameraProperties";
 
-		static const char* LIGHTSOURCE_PROPERTIES = "LightSourceProperties";
+		static constexpr const char* LIGHTSOURCE_PROPERTIES = "LightSourceProperties";
 
-		static const char* SYSTEM_VARIABLES = "SystemVariables";
-		static const char* CONTROL_VARIABLES = "ControlVariables";
+		static constexpr const char* SYSTEM_VARIABLES = "SystemVariables";
+		static constexpr const char* CONTROL_VARIABLES = "ControlVariables";
 
 		// Combined image samplers
 
-		static const char* SHADOWMAP_DEPTH_TEXTURE = "ShadowMapDepthTexture";
+		static constexpr const char* SHADOWMAP_DEPTH_TEXTURE = "ShadowMapDepthTexture";
 
-		static const char* ALBEDO_TEXTURE = "AlbedoTexture";
+		static constexpr const char* ALBEDO_TEXTURE = "AlbedoTexture";
 
-		static const char* GCOLOR_TEXTURE = "GColorTexture";
-		static const char* GNORMAL_TEXTURE = "GNormalTexture";
-		static const char* GPOSITION_TEXTURE = "GPositionTexture";
+		static constexpr const char* GCOLOR_TEXTURE = "GColorTexture";
+		static constexpr const char* GNORMAL_TEXTURE = "GNormalTexture";
+		static constexpr const char* GPOSITION_TEXTURE = "GPositionTexture";
 
-		static const char* DEPTH_TEXTURE_1 = "DepthTexture_1";
-		static const char* DEPTH_TEXTURE_2 = "DepthTexture_2";
+		static constexpr const char* DEPTH_TEXTURE_1 = "DepthTexture_1";
+		static constexpr const char* DEPTH_TEXTURE_2 = "DepthTexture_2";
 
-		static const char* COLOR_TEXTURE_1 = "ColorTexture_1";
-		static const char* COLOR_TEXTURE_2 = "ColorTexture_2";
+		static constexpr const char* COLOR_TEXTURE_1 = "ColorTexture_1";
+		static constexpr const char* COLOR_TEXTURE_2 = "ColorTexture_2";
 
-		static const char* TONE_TEXTURE = "ToneTexture";
+		static constexpr const char* TONE_TEXTURE = "ToneTexture";
 
-		static const char* NOISE_TEXTURE_1 = "NoiseTexture_1";
-		static const char* NOISE_TEXTURE_2 = "NoiseTexture_2";
+		static constexpr const char* NOISE_TEXTURE_1 = "NoiseTexture_1";
+		static constexpr const char* NOISE_TEXTURE_2 = "NoiseTexture_2";
 
-		static const char* MASK_TEXTURE_1 = "MaskTexture_1";
-		static const char* MASK_TEXTURE_2 = "MaskTexture_2";
+		static constexpr const char* MASK_TEXTURE_1 = "MaskTexture_1";
+		static constexpr const char* MASK_TEXTURE_2 = "MaskTexture_2";
+
+		// Storage images and buffers
+
+		static constexpr const char* MIPMAP_LEVEL_IMAGES = "MipmapLevelImages";
+		static constexpr const char* MIPMAP_GENERATION_COUNTERS = "MipmapGenerationCounters";
 	}
 
-	// TODO: optimize the speed of the matching process, this linear search is very slow
-	static const char* MatchShaderParamName(const char* cstr)
+	static constexpr const char* SHADER_PARAM_NAME_TABLE[ShaderParamIDs::COUNT] =
 	{
-		if (std::strcmp(ShaderParamNames::TRANSFORM_MATRICES, cstr) == 0)
-		{
-			return ShaderParamNames::TRANSFORM_MATRICES;
-		}
-		if (std::strcmp(ShaderParamNames::CAMERA_MATRICES, cstr) == 0)
-		{
-			return ShaderParamNames::CAMERA_MATRICES;
-		}
-		if (std::strcmp(ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX, cstr) == 0)
-		{
-			return ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX;
-		}
-		if (std::strcmp(ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES, cstr) == 0)
-		{
-			return ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES;
-		}
-		if (std::strcmp(ShaderParamNames::CAMERA_PROPERTIES, cstr) == 0)
-		{
-			return ShaderParamNames::CAMERA_PROPERTIES;
-		}
-		if (std::strcmp(ShaderParamNames::LIGHTSOURCE_PROPERTIES, cstr) == 0)
-		{
-			return ShaderParamNames::LIGHTSOURCE_PROPERTIES;
-		}
-		if (std::strcmp(ShaderParamNames::SYSTEM_VARIABLES, cstr) == 0)
-		{
-			return ShaderParamNames::SYSTEM_VARIABLES;
-		}
-		if (std::strcmp(ShaderParamNames::CONTROL_VARIABLES, cstr) == 0)
-		{
-			return ShaderParamNames::CONTROL_VARIABLES;
-		}
+		ShaderParamNames::TRANSFORM_MATRICES,
+		ShaderParamNames::CAMERA_MATRICES,
+		ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX,
+		ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES,
+		ShaderParamNames::CAMERA_PROPERTIES,
+		ShaderParamNames::LIGHTSOURCE_PROPERTIES,
+		ShaderParamNames::SYSTEM_VARIABLES,
+		ShaderParamNames::CONTROL_VARIABLES,
+		ShaderParamNames::SHADOWMAP_DEPTH_TEXTURE,
+		ShaderParamNames::ALBEDO_TEXTURE,
+		ShaderParamNames::GCOLOR_TEXTURE,
+		ShaderParamNames::GNORMAL_TEXTURE,
+		ShaderParamNames::GPOSITION_TEXTURE,
+		ShaderParamNames::DEPTH_TEXTURE_1,
+		ShaderParamNames::DEPTH_TEXTURE_2,
+		ShaderParamNames::COLOR_TEXTURE_1,
+		ShaderParamNames::COLOR_TEXTURE_2,
+		ShaderParamNames::TONE_TEXTURE,
+		ShaderParamNames::NOISE_TEXTURE_1,
+		ShaderParamNames::NOISE_TEXTURE_2,
+		ShaderParamNames::MASK_TEXTURE_1,
+		ShaderParamNames::MASK_TEXTURE_2,
+		ShaderParamNames::MIPMAP_LEVEL_IMAGES,
+		ShaderParamNames::MIPMAP_GENERATION_COUNTERS
+	};
 
-		if (std::strcmp(ShaderParamNames::SHADOWMAP_DEPTH_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::SHADOWMAP_DEPTH_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::ALBEDO_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::ALBEDO_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::GCOLOR_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::GCOLOR_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::GNORMAL_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::GNORMAL_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::GPOSITION_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::GPOSITION_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::DEPTH_TEXTURE_1, cstr) == 0)
-		{
-			return ShaderParamNames::DEPTH_TEXTURE_1;
-		}
-		if (std::strcmp(ShaderParamNames::DEPTH_TEXTURE_2, cstr) == 0)
-		{
-			return ShaderParamNames::DEPTH_TEXTURE_2;
-		}
-		if (std::strcmp(ShaderParamNames::COLOR_TEXTURE_1, cstr) == 0)
-		{
-			return ShaderParamNames::COLOR_TEXTURE_1;
-		}
-		if (std::strcmp(ShaderParamNames::COLOR_TEXTURE_2, cstr) == 0)
-		{
-			return ShaderParamNames::COLOR_TEXTURE_2;
-		}
-		if (std::strcmp(ShaderParamNames::TONE_TEXTURE, cstr) == 0)
-		{
-			return ShaderParamNames::TONE_TEXTURE;
-		}
-		if (std::strcmp(ShaderParamNames::NOISE_TEXTURE_1, cstr) == 0)
-		{
-			return ShaderParamNames::NOISE_TEXTURE_1;
-		}
-		if (std::strcmp(ShaderParamNames::NOISE_TEXTURE_2, cstr) == 0)
+	// 32-bit FNV-1a, usable in constant expressions
+	constexpr uint32_t HashShaderParamName(const char* str)
+	{
+		uint32_t hash = 2166136261u;
+		while (*str)
 		{
-			return ShaderParamNames::NOISE_TEXTURE_2;
+			hash ^= (uint32_t)(unsigned char)(*str++);
+			hash *= 16777619u;
 		}
-		if (std::strcmp(ShaderParamNames::MASK_TEXTURE_1, cstr) == 0)
+		return hash;
+	}
+
+	// Only called during shader reflection; built-in name hashes are computed at compile time, so colliding names would fail to compile
+	static ShaderParamID MatchShaderParamID(const char* cstr)
+	{
+		ShaderParamID id = INVALID_SHADER_PARAM_ID;
+
+		switch (HashShaderParamName(cstr))
 		{
-			return ShaderParamNames::MASK_TEXTURE_1;
+		case HashShaderParamName(ShaderParamNames::TRANSFORM_MATRICES):
+			id = ShaderParamIDs::TRANSFORM_MATRICES;
+			break;
+		case HashShaderParamName(ShaderParamNames::CAMERA_MATRICES):
+			id = ShaderParamIDs::CAMERA_MATRICES;
+			break;
+		case HashShaderParamName(ShaderParamNames::LIGHTSPACE_TRANSFORM_MATRIX):
+			id = ShaderParamIDs::LIGHTSPACE_TRANSFORM_MATRIX;
+			break;
+		case HashShaderParamName(ShaderParamNames::MATERIAL_NUMERICAL_PROPERTIES):
+			id = ShaderParamIDs::MATERIAL_NUMERICAL_PROPERTIES;
+			break;
+		case HashShaderParamName(ShaderParamNames::CAMERA_PROPERTIES):
+			id = ShaderParamIDs::CAMERA_PROPERTIES;
+			break;
+		case HashShaderParamName(ShaderParamNames::LIGHTSOURCE_PROPERTIES):
+			id = ShaderParamIDs::LIGHTSOURCE_PROPERTIES;
+			break;
+		case HashShaderParamName(ShaderParamNames::SYSTEM_VARIABLES):
+			id = ShaderParamIDs::SYSTEM_VARIABLES;
+			break;
+		case HashShaderParamName(ShaderParamNames::CONTROL_VARIABLES):
+			id = ShaderParamIDs::CONTROL_VARIABLES;
+			break;
+		case HashShaderParamName(ShaderParamNames::SHADOWMAP_DEPTH_TEXTURE):
+			id = ShaderParamIDs::SHADOWMAP_DEPTH_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::ALBEDO_TEXTURE):
+			id = ShaderParamIDs::ALBEDO_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::GCOLOR_TEXTURE):
+			id = ShaderParamIDs::GCOLOR_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::GNORMAL_TEXTURE):
+			id = ShaderParamIDs::GNORMAL_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::GPOSITION_TEXTURE):
+			id = ShaderParamIDs::GPOSITION_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::DEPTH_TEXTURE_1):
+			id = ShaderParamIDs::DEPTH_TEXTURE_1;
+			break;
+		case HashShaderParamName(ShaderParamNames::DEPTH_TEXTURE_2):
+			id = ShaderParamIDs::DEPTH_TEXTURE_2;
+			break;
+		case HashShaderParamName(ShaderParamNames::COLOR_TEXTURE_1):
+			id = ShaderParamIDs::COLOR_TEXTURE_1;
+			break;
+		case HashShaderParamName(ShaderParamNames::COLOR_TEXTURE_2):
+			id = ShaderParamIDs::COLOR_TEXTURE_2;
+			break;
+		case HashShaderParamName(ShaderParamNames::TONE_TEXTURE):
+			id = ShaderParamIDs::TONE_TEXTURE;
+			break;
+		case HashShaderParamName(ShaderParamNames::NOISE_TEXTURE_1):
+			id = ShaderParamIDs::NOISE_TEXTURE_1;
+			break;
+		case HashShaderParamName(ShaderParamNames::NOISE_TEXTURE_2):
+			id = ShaderParamIDs::NOISE_TEXTURE_2;
+			break;
+		case HashShaderParamName(ShaderParamNames::MASK_TEXTURE_1):
+			id = ShaderParamIDs::MASK_TEXTURE_1;
+			break;
+		case HashShaderParamName(ShaderParamNames::MASK_TEXTURE_2):
+			id = ShaderParamIDs::MASK_TEXTURE_2;
+			break;
+		case HashShaderParamName(ShaderParamNames::MIPMAP_LEVEL_IMAGES):
+			id = ShaderParamIDs::MIPMAP_LEVEL_IMAGES;
+			break;
+		case HashShaderParamName(ShaderParamNames::MIPMAP_GENERATION_COUNTERS):
+			id = ShaderParamIDs::MIPMAP_GENERATION_COUNTERS;
+			break;
+		default:
+			break;
 		}
-		if (std::strcmp(ShaderParamNames::MASK_TEXTURE_2, cstr) == 0)
+
+		// Guard against foreign names sharing a hash with a built-in one
+		if (id != INVALID_SHADER_PARAM_ID && std::strcmp(SHADER_PARAM_NAME_TABLE[id], cstr) == 0)
 		{
-			return ShaderParamNames::MASK_TEXTURE_2;
+			return id;
 		}
 
 		LOG_ERROR((std::string)"Unhandled shader parameter name: " + cstr);
-		return nullptr;
+		return INVALID_SHADER_PARAM_ID;
 	}
 }
\ No newline at end of file
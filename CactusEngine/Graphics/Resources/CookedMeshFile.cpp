@@ -0,0 +1,175 @@
+#include "CookedMeshFile.h"
+#include "LogUtility.h"
+#include "FileUtility.h"
+
+#include <filesystem>
+#include <cstring>
+
+namespace Engine
+{
+	static_assert(sizeof(SubMesh) == 3 * sizeof(uint32_t), "Submesh table is stored as raw structs.");
+	static_assert(sizeof(Meshlet) == 11 * sizeof(uint32_t), "Meshlet table is stored as raw structs.");
+
+	bool CookedMeshFile::Open(const char* filePath, uint64_t sourceKey, bool isQuantized)
+	{
+		Close();
+
+		if (!m_mappedFile.Open(filePath))
+		{
+			return false;
+		}
+
+		const uint8_t* pData = m_mappedFile.GetData();
+		size_t fileSize = m_mappedFile.GetSize();
+
+		if (fileSize < sizeof(FileHeader))
+		{
+			Close();
+			return false;
+		}
+
+		memcpy(&m_header, pData, sizeof(FileHeader));
+
+		if (m_header.magic != FILE_MAGIC || m_header.version != FILE_VERSION || m_header.sourceKey != sourceKey
+			|| m_header.vertexStride != (isQuantized ? VertexBufferCreateInfo::quantizedStride : VertexBufferCreateInfo::interleavedStride)
+			|| (m_header.indexSize != sizeof(uint16_t) && m_header.indexSize != sizeof(int)))
+		{
+			Close();
+			return false;
+		}
+
+		uint64_t subMeshTableSize = (uint64_t)m_header.subMeshCount * sizeof(SubMesh);
+		uint64_t meshletTableSize = (uint64_t)m_header.meshletCount * sizeof(Meshlet);
+		uint64_t vertexDataSize = (uint64_t)m_header.vertexCount * m_header.vertexStride;
+		uint64_t indexDataSize = (uint64_t)m_header.indexCount * m_header.indexSize;
+
+		if (m_header.subMeshTableOffset + subMeshTableSize > fileSize || m_header.meshletTableOffset + meshletTableSize > fileSize || m_header.vertexDataOffset + vertexDataSize > fileSize || m_header.indexDataOffset + indexDataSize > fileSize
+			|| m_header.vertexDataOffset % DATA_ALIGNMENT != 0 || m_header.indexDataOffset % DATA_ALIGNMENT != 0)
+		{
+			LOG_WARNING("Corrupted cooked mesh file: " + std::string(filePath));
+			Close();
+			return false;
+		}
+
+		m_subMeshes.resize(m_header.subMeshCount);
+		memcpy(m_subMeshes.data(), pData + m_header.subMeshTableOffset, subMeshTableSize);
+
+		m_meshlets.resize(m_header.meshletCount);
+		memcpy(m_meshlets.data(), pData + m_header.meshletTableOffset, meshletTableSize);
+
+		return true;
+	}
+
+	void CookedMeshFile::Close()
+	{
+		m_mappedFile.Close();
+		m_header = {};
+		m_subMeshes.clear();
+		m_meshlets.clear();
+	}
+
+	uint32_t CookedMeshFile::GetVertexCount() const
+	{
+		return m_header.vertexCount;
+	}
+
+	uint32_t CookedMeshFile::GetIndexCount() const
+	{
+		return m_header.indexCount;
+	}
+
+	const void* CookedMeshFile::GetVertexData() const
+	{
+		return (const void*)(m_mappedFile.GetData() + m_header.vertexDataOffset);
+	}
+
+	const void* CookedMeshFile::GetIndexData() const
+	{
+		return (const void*)(m_mappedFile.GetData() + m_header.indexDataOffset);
+	}
+
+	bool CookedMeshFile::UsesShortIndices() const
+	{
+		return m_header.indexSize == sizeof(uint16_t);
+	}
+
+	const std::vector<SubMesh>& CookedMeshFile::GetSubMeshes() const
+	{
+		return m_subMeshes;
+	}
+
+	const std::vector<Meshlet>& CookedMeshFile::GetMeshlets() const
+	{
+		return m_meshlets;
+	}
+
+	Vector3 CookedMeshFile::GetBoundsMin() const
+	{
+		return Vector3(m_header.boundsMin[0], m_header.boundsMin[1], m_header.boundsMin[2]);
+	}
+
+	Vector3 CookedMeshFile::GetBoundsMax() const
+	{
+		return Vector3(m_header.boundsMax[0], m_header.boundsMax[1], m_header.boundsMax[2]);
+	}
+
+	uint64_t CookedMeshFile::ComputeSourceKey(const char* sourcePath, uint32_t importFlags)
+	{
+		std::error_code errorCode;
+		uint64_t values[3] =
+		{
+			(uint64_t)std::filesystem::file_size(sourcePath, errorCode),
+			(uint64_t)std::filesystem::last_write_time(sourcePath, errorCode).time_since_epoch().count(),
+			(uint64_t)importFlags
+		};
+
+		return FileUtility::HashFNV1a64(values, sizeof(values));
+	}
+
+	std::string CookedMeshFile::GetCookedFilePath(const char* sourcePath, bool isQuantized)
+	{
+		return std::string(sourcePath) + (isQuantized ? ".qcmesh" : ".cmesh");
+	}
+
+	bool CookedMeshFile::Write(const char* filePath, uint64_t sourceKey, const void* pVertexData, bool isQuantized, uint32_t vertexCount, const void* pIndexData, bool useShortIndices, uint32_t indexCount,
+		const std::vector<SubMesh>& subMeshes, const std::vector<Meshlet>& meshlets, const Vector3& boundsMin, const Vector3& boundsMax)
+	{
+		auto alignOffset = [](uint64_t offset)
+		{
+			return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+		};
+
+		FileHeader header{};
+		header.magic = FILE_MAGIC;
+		header.version = FILE_VERSION;
+		header.sourceKey = sourceKey;
+		header.vertexStride = isQuantized ? VertexBufferCreateInfo::quantizedStride : VertexBufferCreateInfo::interleavedStride;
+		header.vertexCount = vertexCount;
+		header.indexCount = indexCount;
+		header.subMeshCount = (uint32_t)subMeshes.size();
+		header.meshletCount = (uint32_t)meshlets.size();
+		header.indexSize = useShortIndices ? sizeof(uint16_t) : sizeof(int);
+		for (uint32_t i = 0; i < 3; ++i)
+		{
+			header.boundsMin[i] = boundsMin[i];
+			header.boundsMax[i] = boundsMax[i];
+		}
+		header.subMeshTableOffset = sizeof(FileHeader);
+		header.meshletTableOffset = header.subMeshTableOffset + subMeshes.size() * sizeof(SubMesh);
+		header.vertexDataOffset = alignOffset(header.meshletTableOffset + meshlets.size() * sizeof(Meshlet));
+		header.indexDataOffset = alignOffset(header.vertexDataOffset + (uint64_t)vertexCount * header.vertexStride);
+
+		return FileUtility::WriteFileAtomic(filePath, [&](std::ostream& fileWriter)
+			{
+				static const char padding[DATA_ALIGNMENT] = {};
+
+				fileWriter.write((const char*)&header, sizeof(FileHeader));
+				fileWriter.write((const char*)subMeshes.data(), subMeshes.size() * sizeof(SubMesh));
+				fileWriter.write((const char*)meshlets.data(), meshlets.size() * sizeof(Meshlet));
+				fileWriter.write(padding, header.vertexDataOffset - (header.meshletTableOffset + meshlets.size() * sizeof(Meshlet)));
+				fileWriter.write((const char*)pVertexData, (uint64_t)vertexCount * header.vertexStride);
+				fileWriter.write(padding, header.indexDataOffset - (header.vertexDataOffset + (uint64_t)vertexCount * header.vertexStride));
+				fileWriter.write((const char*)pIndexData, (uint64_t)indexCount * header.indexSize);
+			});
+	}
+}
\ No newline at end of file
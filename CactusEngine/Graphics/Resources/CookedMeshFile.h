@@ -0,0 +1,70 @@
+#pragma once
+#include "Mesh.h"
+#include "MappedFile.h"
+#include "NoCopy.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	// Engine specific mesh container with pre-interleaved vertex and index blobs, cached next to the source model
+	// Vertex and index data are read straight from the memory mapped file
+	class CookedMeshFile : public NoCopy
+	{
+	public:
+		CookedMeshFile() = default;
+		~CookedMeshFile() = default;
+
+		bool Open(const char* filePath, uint64_t sourceKey, bool isQuantized); // Returns false if the file is missing, corrupted or was cooked from a different source or vertex layout
+		void Close();
+
+		uint32_t GetVertexCount() const;
+		uint32_t GetIndexCount() const;
+		const void* GetVertexData() const;
+		const void* GetIndexData() const;
+		bool UsesShortIndices() const;
+		const std::vector<SubMesh>& GetSubMeshes() const;
+		const std::vector<Meshlet>& GetMeshlets() const;
+		Vector3 GetBoundsMin() const;
+		Vector3 GetBoundsMax() const;
+
+		// Source file size and modification time are hashed instead of its content, so that validating the cache does not cost a full read of the source
+		static uint64_t ComputeSourceKey(const char* sourcePath, uint32_t importFlags);
+		static std::string GetCookedFilePath(const char* sourcePath, bool isQuantized); // Each vertex layout is cooked into its own file, so toggling quantization does not invalidate the other
+
+		static bool Write(const char* filePath, uint64_t sourceKey, const void* pVertexData, bool isQuantized, uint32_t vertexCount, const void* pIndexData, bool useShortIndices, uint32_t indexCount,
+			const std::vector<SubMesh>& subMeshes, const std::vector<Meshlet>& meshlets, const Vector3& boundsMin, const Vector3& boundsMax);
+
+	private:
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t sourceKey;
+			uint32_t vertexStride; // Also identifies the vertex layout
+			uint32_t vertexCount;
+			uint32_t indexCount;
+			uint32_t subMeshCount;
+			uint32_t indexSize; // 2 or 4 bytes
+			uint32_t meshletCount;
+			float	 boundsMin[3];
+			float	 boundsMax[3];
+			uint64_t subMeshTableOffset;
+			uint64_t meshletTableOffset;
+			uint64_t vertexDataOffset;
+			uint64_t indexDataOffset;
+		};
+
+	public:
+		static const uint32_t FILE_MAGIC = 0x48534D43; // "CMSH"
+		static const uint32_t FILE_VERSION = 3; // Bump whenever the layout or vertex format changes
+		static const uint32_t DATA_ALIGNMENT = 16;
+
+	private:
+		MappedFile m_mappedFile;
+		FileHeader m_header;
+		std::vector<SubMesh> m_subMeshes;
+		std::vector<Meshlet> m_meshlets;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "ExternalMesh.h"
 #include "GraphicsApplication.h"
+#include "GraphicsDevice.h"
+#include "CookedMeshFile.h"
+#include "MeshOptimizer.h"
+#include "JobSystem.h"
 
 // Integration with Assimp
 #include <assimp/scene.h>
@@ -10,6 +14,9 @@ namespace Engine
 {
 	static Assimp::Importer gImporter;
 
+	// Alert: check these import flags when models seem incorrect
+	static const uint32_t IMPORT_FLAGS = aiProcessPreset_TargetRealtime_Quality | aiProcess_PreTransformVertices | aiProcess_FlipUVs;
+
 	ExternalMesh::ExternalMesh(const char* filePath)
 		: Mesh(((GraphicsApplication*)gpGlobal->GetCurrentApplication())->GetGraphicsDevice())
 	{
@@ -18,15 +25,48 @@ namespace Engine
 
 	void ExternalMesh::LoadMeshFromFile(const char* filePath)
 	{
-		// Load model with Assimp importer
+		m_filePath.assign(filePath);
+		m_type = EBuiltInMeshType::External;
+
+		// Cooked mesh is keyed by source file and import flags, Assimp only runs if it is missing or outdated
+		uint64_t sourceKey = CookedMeshFile::ComputeSourceKey(filePath, IMPORT_FLAGS);
+		bool isQuantized = m_pDevice->IsVertexQuantizationEnabled();
+		if (LoadCookedMesh(CookedMeshFile::GetCookedFilePath(filePath, isQuantized).c_str(), sourceKey, isQuantized))
+		{
+			return;
+		}
+
+		ImportMesh(filePath, sourceKey, isQuantized);
+	}
+
+	bool ExternalMesh::LoadCookedMesh(const char* cookedPath, uint64_t sourceKey, bool isQuantized)
+	{
+		CookedMeshFile cookedFile;
+		if (!cookedFile.Open(cookedPath, sourceKey, isQuantized))
+		{
+			return false;
+		}
+
+		m_subMeshes = cookedFile.GetSubMeshes();
+		m_meshlets = cookedFile.GetMeshlets();
+		m_boundsMin = cookedFile.GetBoundsMin();
+		m_boundsMax = cookedFile.GetBoundsMax();
 
-		// Alert: check these import flags when models seem incorrect
-		const aiScene* scene = gImporter.ReadFile(filePath, aiProcessPreset_TargetRealtime_Quality | aiProcess_PreTransformVertices | aiProcess_FlipUVs);
+		// Vertex data is copied into staging memory before this returns, so the file can be unmapped right after
+		CreateVertexBufferFromInterleavedData(cookedFile.GetVertexData(), cookedFile.GetVertexCount(), cookedFile.GetIndexData(), cookedFile.GetIndexCount(), isQuantized, cookedFile.UsesShortIndices());
+
+		return true;
+	}
+
+	bool ExternalMesh::ImportMesh(const char* filePath, uint64_t sourceKey, bool isQuantized)
+	{
+		// Load model with Assimp importer
+		const aiScene* scene = gImporter.ReadFile(filePath, IMPORT_FLAGS);
 
 		if (!scene)
 		{
 			LOG_ERROR((std::string)"Could not read file: " + filePath);
-			return;
+			return false;
 		}
 
 		size_t totalNumSubMeshes = scene->mNumMeshes;
@@ -46,69 +86,89 @@ namespace Engine
 			totalNumIndices += (size_t)scene->mMeshes[i]->mNumFaces * 3;
 		}
 
-		std::vector<int>   indices(totalNumIndices);
-		std::vector<float> vertices(totalNumVertices * 3);
-		std::vector<float> normals(totalNumVertices * 3);
-		std::vector<float> texcoords(totalNumVertices * 2);
-		std::vector<float> tangents(totalNumVertices * 3);
+		// Attributes are interleaved as they are read, which is the layout optimizer and cooked file work on
+		// Missing attributes are left as zero
+		const uint32_t elementStride = VertexBufferCreateInfo::interleavedStride / sizeof(float);
 
-		uint32_t faceIndex = 0;
-		uint32_t vertexOffset = 0;
-		uint32_t normalOffset = 0;
-		uint32_t texcoordOffset = 0;
-		uint32_t tangentOffset = 0;
+		std::vector<int>   indices(totalNumIndices);
+		std::vector<float> interleavedVertices(totalNumVertices * elementStride);
 
 		// Buffer data
-		for (uint32_t i = 0; i < totalNumSubMeshes; ++i)
+		auto readSubMesh = [&](uint32_t i)
 		{
 			aiMesh* mesh = scene->mMeshes[i];
 
 			// Indices
-			uint32_t numFaces = mesh->mNumFaces;
-			for (uint32_t j = 0; j < numFaces; ++j)
+			int* pIndices = &indices[m_subMeshes[i].m_baseIndex];
+			for (uint32_t j = 0; j < mesh->mNumFaces; ++j)
 			{
-				memcpy(&indices[faceIndex], mesh->mFaces[j].mIndices, 3 * sizeof(uint32_t));
-				faceIndex += 3;
+				memcpy(pIndices + (size_t)j * 3, mesh->mFaces[j].mIndices, 3 * sizeof(uint32_t));
 			}
 
 			// Vertices
-			if (mesh->HasPositions())
+			float* pVertex = &interleavedVertices[(size_t)m_subMeshes[i].m_baseVertex * elementStride];
+			for (uint32_t j = 0; j < mesh->mNumVertices; ++j, pVertex += elementStride)
 			{
-				const size_t size = 3 * sizeof(float) * mesh->mNumVertices;
-				memcpy(&vertices[vertexOffset], mesh->mVertices, size);
-				vertexOffset += 3 * mesh->mNumVertices;
-			}
-
-			// Normals
-			if (mesh->HasNormals())
-			{
-				const size_t size = 3 * sizeof(float) * mesh->mNumVertices;
-				memcpy(&normals[normalOffset], mesh->mNormals, size);
-				normalOffset += 3 * mesh->mNumVertices;
-			}
-
-			// Texcoords
-			if (mesh->HasTextureCoords(0))
-			{
-				for (uint32_t j = 0; j < mesh->mNumVertices; ++j)
+				if (mesh->HasPositions())
 				{
-					texcoords[(uint64_t)j * 2 + texcoordOffset] = mesh->mTextureCoords[0][j].x;
-					texcoords[(uint64_t)j * 2 + 1 + texcoordOffset] = mesh->mTextureCoords[0][j].y;
+					memcpy(pVertex, &mesh->mVertices[j], 3 * sizeof(float));
+				}
+				if (mesh->HasNormals())
+				{
+					memcpy(pVertex + 3, &mesh->mNormals[j], 3 * sizeof(float));
+				}
+				if (mesh->HasTextureCoords(0))
+				{
+					pVertex[6] = mesh->mTextureCoords[0][j].x;
+					pVertex[7] = mesh->mTextureCoords[0][j].y;
+				}
+				if (mesh->HasTangentsAndBitangents())
+				{
+					memcpy(pVertex + 8, &mesh->mTangents[j], 3 * sizeof(float));
 				}
-				texcoordOffset += 2 * mesh->mNumVertices;
 			}
+		};
 
-			// Tangents
-			if (mesh->HasTangentsAndBitangents())
-			{
-				const size_t size = 3 * sizeof(float) * mesh->mNumVertices;
-				memcpy(&tangents[tangentOffset], mesh->mTangents, size);
-				tangentOffset += 3 * mesh->mNumVertices;
-			}
+		JobSystem::ParallelFor((uint32_t)totalNumSubMeshes, 1, readSubMesh);
+
+		gImporter.FreeScene();
+
+		UpdateBounds(interleavedVertices.data(), (uint32_t)totalNumVertices, elementStride);
+
+		// Triangle and vertex order are optimized once here, cooked mesh keeps the result
+		MeshStatistics originalStatistics = MeshOptimizer::AnalyzeMesh(interleavedVertices, indices, m_subMeshes);
+		MeshOptimizer::OptimizeMesh(interleavedVertices, indices, m_subMeshes);
+		MeshStatistics optimizedStatistics = MeshOptimizer::AnalyzeMesh(interleavedVertices, indices, m_subMeshes);
+		MeshOptimizer::BuildMeshlets(interleavedVertices, indices, m_subMeshes, m_meshlets);
+
+		std::vector<uint16_t> shortIndices;
+		const void* pIndexData = indices.data();
+		bool useShortIndices = MeshOptimizer::CanUseShortIndices(indices, m_subMeshes);
+		if (useShortIndices)
+		{
+			shortIndices = MeshOptimizer::ConvertToShortIndices(indices);
+			pIndexData = shortIndices.data();
 		}
 
-		m_filePath.assign(filePath);
-		m_type = EBuiltInMeshType::External;
-		CreateVertexBufferFromVertices(vertices, normals, texcoords, tangents, indices);
+		LOG_MESSAGE((std::string)"Optimized mesh " + filePath + ": ACMR " + std::to_string(originalStatistics.acmr) + " -> " + std::to_string(optimizedStatistics.acmr)
+			+ ", ATVR " + std::to_string(originalStatistics.atvr) + " -> " + std::to_string(optimizedStatistics.atvr)
+			+ ", overdraw " + std::to_string(originalStatistics.overdraw) + " -> " + std::to_string(optimizedStatistics.overdraw)
+			+ (useShortIndices ? ", 16-bit indices, " : ", 32-bit indices, ") + std::to_string(m_meshlets.size()) + " meshlets");
+
+		std::vector<uint8_t> quantizedVertices;
+		const void* pVertexData = interleavedVertices.data();
+		if (isQuantized)
+		{
+			quantizedVertices = VertexBufferCreateInfo::QuantizeInterleavedData(interleavedVertices.data(), (uint32_t)totalNumVertices, m_boundsMin, m_boundsMax);
+			pVertexData = quantizedVertices.data();
+		}
+
+		// Failing to cook only costs the import time on next load
+		CookedMeshFile::Write(CookedMeshFile::GetCookedFilePath(filePath, isQuantized).c_str(), sourceKey, pVertexData, isQuantized, (uint32_t)totalNumVertices,
+			pIndexData, useShortIndices, (uint32_t)totalNumIndices, m_subMeshes, m_meshlets, m_boundsMin, m_boundsMax);
+
+		CreateVertexBufferFromInterleavedData(pVertexData, (uint32_t)totalNumVertices, pIndexData, (uint32_t)totalNumIndices, isQuantized, useShortIndices);
+
+		return true;
 	}
 }
\ No newline at end of file
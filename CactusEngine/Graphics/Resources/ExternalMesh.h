@@ -11,5 +11,7 @@ namespace Engine
 
 	private:
 		void LoadMeshFromFile(const char* filePath);
+		bool LoadCookedMesh(const char* cookedPath, uint64_t sourceKey, bool isQuantized);
+		bool ImportMesh(const char* filePath, uint64_t sourceKey, bool isQuantized); // Imported mesh is cooked for subsequent loads
 	};
 }
\ No newline at end of file
@@ -1,4 +1,10 @@
 #include "GraphicsResources.h"
+#include "JobSystem.h"
+
+#include <glm/gtc/packing.hpp>
+#include <emmintrin.h>
+#include <algorithm>
+#include <cstring>
 
 namespace Engine
 {
@@ -6,6 +12,7 @@ namespace Engine
 
 	RawResource::RawResource()
 		: m_sizeInBytes(0),
+		m_uploadValue(0),
 		m_resourceID(m_assignedID++)
 	{
 		
@@ -26,6 +33,16 @@ namespace Engine
 		m_sizeInBytes = size;
 	}
 
+	void RawResource::MarkUploadValue(uint64_t value)
+	{
+		m_uploadValue = value;
+	}
+
+	uint64_t RawResource::GetUploadValue() const
+	{
+		return m_uploadValue;
+	}
+
 	FrameBuffer::FrameBuffer()
 		: m_width(0),
 		m_height(0)
@@ -43,43 +60,226 @@ namespace Engine
 		return m_height;
 	}
 
-	std::vector<float> VertexBufferCreateInfo::ConvertToInterleavedData() const
+	static const uint32_t STREAMING_BLOCK_VERTICES = 4; // Block size of both layouts is then a multiple of 16 bytes
+	static const uint32_t VERTEX_WRITE_BATCH_SIZE = 16384; // Vertices per job, a multiple of streaming block
+	static const uint32_t INTERLEAVED_ELEMENT_COUNT = VertexBufferCreateInfo::interleavedStride / sizeof(float);
+
+	static Vector3 GetInverseExtent(const Vector3& boundsMin, const Vector3& boundsMax)
 	{
-		uint32_t elementStride = 11; // Keep in sync with the layout below
-		std::vector<float> interleavedVertices(elementStride * (size_t)(positionDataCount / 3));
+		// Flat axes would otherwise divide by zero, their positions are all encoded as 0
+		Vector3 extent = boundsMax - boundsMin;
+		return Vector3(extent.x > 0 ? 1.0f / extent.x : 0, extent.y > 0 ? 1.0f / extent.y : 0, extent.z > 0 ? 1.0f / extent.z : 0);
+	}
 
-		// Layout : [ position | normal | texcoord | tangent ]
+	static void QuantizeVertex(const float* pVertex, const Vector3& boundsMin, const Vector3& inverseExtent, uint8_t* pOutput)
+	{
+		uint64_t position = glm::packUnorm4x16(Vector4((Vector3(pVertex[0], pVertex[1], pVertex[2]) - boundsMin) * inverseExtent, 0.0f));
+		uint32_t normal = glm::packSnorm3x10_1x2(Vector4(pVertex[3], pVertex[4], pVertex[5], 0.0f));
+		uint32_t texcoord = glm::packHalf2x16(Vector2(pVertex[6], pVertex[7]));
+		uint32_t tangent = glm::packSnorm3x10_1x2(Vector4(pVertex[8], pVertex[9], pVertex[10], 0.0f));
+
+		memcpy(pOutput + VertexBufferCreateInfo::quantizedPositionOffset, &position, sizeof(uint64_t));
+		memcpy(pOutput + VertexBufferCreateInfo::quantizedNormalOffset, &normal, sizeof(uint32_t));
+		memcpy(pOutput + VertexBufferCreateInfo::quantizedTexcoordOffset, &texcoord, sizeof(uint32_t));
+		memcpy(pOutput + VertexBufferCreateInfo::quantizedTangentOffset, &tangent, sizeof(uint32_t));
+	}
 
-		// TODO: optimize this process
+	// Layout : [ position | normal | texcoord | tangent ], missing attributes are filled with zero
+	static void GatherVertex(const VertexBufferCreateInfo& createInfo, uint32_t index, float* pOutput)
+	{
+		auto gatherAttribute = [index](const float* pData, uint32_t dataCount, uint32_t componentCount, float* pAttribute)
+		{
+			if (index < dataCount / componentCount)
+			{
+				memcpy(pAttribute, pData + (size_t)index * componentCount, componentCount * sizeof(float));
+			}
+			else
+			{
+				memset(pAttribute, 0, componentCount * sizeof(float));
+			}
+		};
 
-		for (uint32_t i = 0; i < positionDataCount / 3; i++)
+		gatherAttribute(createInfo.pPositionData, createInfo.positionDataCount, 3, pOutput);
+		gatherAttribute(createInfo.pNormalData, createInfo.normalDataCount, 3, pOutput + 3);
+		gatherAttribute(createInfo.pTexcoordData, createInfo.texcoordDataCount, 2, pOutput + 6);
+		gatherAttribute(createInfo.pTangentData, createInfo.tangentDataCount, 3, pOutput + 8);
+	}
+
+	static void WriteVertexRange(const VertexBufferCreateInfo& createInfo, const Vector3& inverseExtent, uint32_t beginVertex, uint32_t endVertex, uint8_t* pOutput, bool useStreamingStores)
+	{
+		uint32_t stride = createInfo.GetVertexStride();
+		uint8_t* pDst = pOutput + (size_t)stride * beginVertex;
+
+		auto writeVertex = [&](uint32_t index, uint8_t* pVertexOutput)
 		{
-			interleavedVertices[(size_t)elementStride * i] = pPositionData[i * 3];
-			interleavedVertices[(size_t)elementStride * i + 1] = pPositionData[i * 3 + 1];
-			interleavedVertices[(size_t)elementStride * i + 2] = pPositionData[i * 3 + 2];
+			if (createInfo.isQuantized)
+			{
+				float vertex[INTERLEAVED_ELEMENT_COUNT];
+				GatherVertex(createInfo, index, vertex);
+				QuantizeVertex(vertex, createInfo.quantizationBoundsMin, inverseExtent, pVertexOutput);
+			}
+			else
+			{
+				GatherVertex(createInfo, index, (float*)pVertexOutput);
+			}
+		};
+
+		uint32_t index = beginVertex;
+
+		if (useStreamingStores)
+		{
+			// Output is usually write-combined staging memory that is never read back by CPU,
+			// so vertices are assembled in a small cached block and written with non-temporal stores bypassing cache
+			alignas(16) uint8_t block[STREAMING_BLOCK_VERTICES * VertexBufferCreateInfo::interleavedStride];
+			uint32_t blockSize = STREAMING_BLOCK_VERTICES * stride;
+
+			for (; index + STREAMING_BLOCK_VERTICES <= endVertex; index += STREAMING_BLOCK_VERTICES)
+			{
+				for (uint32_t i = 0; i < STREAMING_BLOCK_VERTICES; ++i)
+				{
+					writeVertex(index + i, block + (size_t)stride * i);
+				}
+
+				for (uint32_t offset = 0; offset < blockSize; offset += 16)
+				{
+					_mm_stream_si128((__m128i*)(pDst + offset), _mm_load_si128((const __m128i*)(block + offset)));
+				}
+				pDst += blockSize;
+			}
+
+			// Non-temporal stores are weakly ordered, they have to be visible before the upload is recorded
+			_mm_sfence();
 		}
 
-		for (uint32_t i = 0; i < normalDataCount / 3; i++)
+		for (; index < endVertex; ++index)
 		{
-			interleavedVertices[(size_t)elementStride * i + 3] = pNormalData[i * 3];
-			interleavedVertices[(size_t)elementStride * i + 4] = pNormalData[i * 3 + 1];
-			interleavedVertices[(size_t)elementStride * i + 5] = pNormalData[i * 3 + 2];
+			alignas(16) uint8_t vertex[VertexBufferCreateInfo::interleavedStride];
+			writeVertex(index, vertex);
+			memcpy(pDst, vertex, stride);
+			pDst += stride;
 		}
+	}
+
+	uint32_t VertexBufferCreateInfo::GetVertexCount() const
+	{
+		return pInterleavedVertexData != nullptr ? interleavedVertexCount : positionDataCount / 3;
+	}
+
+	uint32_t VertexBufferCreateInfo::GetVertexStride() const
+	{
+		return isQuantized ? quantizedStride : interleavedStride;
+	}
 
-		for (uint32_t i = 0; i < texcoordDataCount / 2; i++)
+	void VertexBufferCreateInfo::WriteVertexData(void* pOutput) const
+	{
+		uint32_t vertexCount = GetVertexCount();
+		uint32_t stride = GetVertexStride();
+		uint32_t batchCount = (vertexCount + VERTEX_WRITE_BATCH_SIZE - 1) / VERTEX_WRITE_BATCH_SIZE;
+
+		if (pInterleavedVertexData != nullptr)
 		{
-			interleavedVertices[(size_t)elementStride * i + 6] = pTexcoordData[i * 2];
-			interleavedVertices[(size_t)elementStride * i + 7] = pTexcoordData[i * 2 + 1];
+			// Already in final layout, a plain copy per batch is as fast as it gets
+			auto copyBatch = [&](uint32_t batchIndex)
+			{
+				size_t offset = (size_t)batchIndex * VERTEX_WRITE_BATCH_SIZE * stride;
+				size_t size = (size_t)std::min(VERTEX_WRITE_BATCH_SIZE, vertexCount - batchIndex * VERTEX_WRITE_BATCH_SIZE) * stride;
+				memcpy((uint8_t*)pOutput + offset, (const uint8_t*)pInterleavedVertexData + offset, size);
+			};
+
+			if (batchCount > 1)
+			{
+				JobSystem::ParallelFor(batchCount, 1, copyBatch);
+			}
+			else if (batchCount == 1)
+			{
+				copyBatch(0);
+			}
+			return;
+		}
+
+		Vector3 inverseExtent = GetInverseExtent(quantizationBoundsMin, quantizationBoundsMax);
+
+		// Batches start at multiples of the streaming block, which keeps their output 16-byte aligned if the base is
+		bool useStreamingStores = ((uintptr_t)pOutput & 15) == 0;
+
+		auto writeBatch = [&](uint32_t batchIndex)
+		{
+			uint32_t beginVertex = batchIndex * VERTEX_WRITE_BATCH_SIZE;
+			uint32_t endVertex = std::min(beginVertex + VERTEX_WRITE_BATCH_SIZE, vertexCount);
+			WriteVertexRange(*this, inverseExtent, beginVertex, endVertex, (uint8_t*)pOutput, useStreamingStores);
+		};
+
+		if (batchCount > 1)
+		{
+			JobSystem::ParallelFor(batchCount, 1, writeBatch);
+		}
+		else if (batchCount == 1)
+		{
+			writeBatch(0);
+		}
+	}
+
+	uint32_t VertexBufferCreateInfo::GetPositionStreamStride() const
+	{
+		return isQuantized ? quantizedPositionStreamStride : positionStreamStride;
+	}
+
+	void VertexBufferCreateInfo::WritePositionStreamData(void* pOutput) const
+	{
+		uint32_t vertexCount = GetVertexCount();
+		uint32_t stride = GetPositionStreamStride();
+		uint32_t batchCount = (vertexCount + VERTEX_WRITE_BATCH_SIZE - 1) / VERTEX_WRITE_BATCH_SIZE;
+
+		// Positions are at the start of both interleaved layouts
+		uint32_t sourceStride = GetVertexStride();
+		Vector3 inverseExtent = GetInverseExtent(quantizationBoundsMin, quantizationBoundsMax);
+
+		auto writeBatch = [&](uint32_t batchIndex)
+		{
+			uint32_t beginVertex = batchIndex * VERTEX_WRITE_BATCH_SIZE;
+			uint32_t endVertex = std::min(beginVertex + VERTEX_WRITE_BATCH_SIZE, vertexCount);
+			uint8_t* pDst = (uint8_t*)pOutput + (size_t)stride * beginVertex;
+
+			for (uint32_t i = beginVertex; i < endVertex; ++i, pDst += stride)
+			{
+				if (pInterleavedVertexData != nullptr)
+				{
+					memcpy(pDst, (const uint8_t*)pInterleavedVertexData + (size_t)sourceStride * i, stride);
+				}
+				else if (isQuantized)
+				{
+					const float* pPosition = pPositionData + (size_t)i * 3;
+					uint64_t position = glm::packUnorm4x16(Vector4((Vector3(pPosition[0], pPosition[1], pPosition[2]) - quantizationBoundsMin) * inverseExtent, 0.0f));
+					memcpy(pDst, &position, sizeof(uint64_t));
+				}
+				else
+				{
+					memcpy(pDst, pPositionData + (size_t)i * 3, stride);
+				}
+			}
+		};
+
+		if (batchCount > 1)
+		{
+			JobSystem::ParallelFor(batchCount, 1, writeBatch);
+		}
+		else if (batchCount == 1)
+		{
+			writeBatch(0);
 		}
+	}
+
+	std::vector<uint8_t> VertexBufferCreateInfo::QuantizeInterleavedData(const float* pInterleavedData, uint32_t vertexCount, const Vector3& boundsMin, const Vector3& boundsMax)
+	{
+		std::vector<uint8_t> quantizedVertices((size_t)quantizedStride * vertexCount);
+		Vector3 inverseExtent = GetInverseExtent(boundsMin, boundsMax);
 
-		for (uint32_t i = 0; i < tangentDataCount / 3; i++)
+		for (uint32_t i = 0; i < vertexCount; i++)
 		{
-			interleavedVertices[(size_t)elementStride * i + 8] = pTangentData[i * 3];
-			interleavedVertices[(size_t)elementStride * i + 9] = pTangentData[i * 3 + 1];
-			interleavedVertices[(size_t)elementStride * i + 10] = pTangentData[i * 3 + 2];
+			QuantizeVertex(pInterleavedData + (size_t)INTERLEAVED_ELEMENT_COUNT * i, boundsMin, inverseExtent, quantizedVertices.data() + (size_t)quantizedStride * i);
 		}
 
-		return interleavedVertices;
+		return quantizedVertices;
 	}
 
 	void VertexBuffer::SetNumberOfIndices(uint32_t count)
@@ -92,6 +292,11 @@ namespace Engine
 		return m_numberOfIndices;
 	}
 
+	bool VertexBuffer::HasPositionStream() const
+	{
+		return m_hasPositionStream;
+	}
+
 	Texture2D::Texture2D(ETexture2DSource source)
 		: m_source(source),
 		m_height(0),
@@ -131,6 +336,11 @@ namespace Engine
 		return m_filePath.c_str();
 	}
 
+	bool Texture2D::HasTransparentTexels() const
+	{
+		return true;
+	}
+
 	ETexture2DSource Texture2D::QuerySource() const
 	{
 		return m_source;
@@ -141,39 +351,32 @@ namespace Engine
 		m_currentFrameIndex = index;
 	}
 
-	UniformBufferConcurrentAllocator::UniformBufferConcurrentAllocator(UniformBufferManager* pBufferManager, uint32_t reservedSize)
+	UniformBufferConcurrentAllocator::UniformBufferConcurrentAllocator(UniformBufferManager* pBufferManager)
 		: m_pBufferManager(pBufferManager),
-		m_reservedSize(reservedSize)
+		m_currentRegion{}
 	{
 
 	}
 
 	UniformBuffer UniformBufferConcurrentAllocator::GetUniformBuffer(uint32_t size)
 	{
-		// Fast path: try to allocate in thread reserved regions
-		for (auto& region : m_reservedRegions)
+		// Fast path: allocate in current block
+		if (m_currentRegion.pParentBuffer && m_currentRegion.availableSize >= size)
 		{
-			if (region.availableSize >= size)
-			{
-				UniformBuffer buffer = m_pBufferManager->GetUniformBuffer(region, size);
-				// Region's available size is updated in GetUniformBuffer
-				return buffer;
-			}
+			UniformBuffer buffer = m_pBufferManager->GetUniformBuffer(m_currentRegion, size);
+			// Region's available size is updated in GetUniformBuffer
+			return buffer;
 		}
 
-		// Slow path: no suitable region found, reserve a new one
+		// Slow path: current block is used up, carve out a new one
+		m_currentRegion = m_pBufferManager->ReserveBufferRegion(std::max(size, BLOCK_SIZE));
 
-		UniformBufferReservedRegion region = m_pBufferManager->ReserveBufferRegion(m_reservedSize);
-		UniformBuffer buffer = m_pBufferManager->GetUniformBuffer(region, size);
-
-		m_reservedRegions.push_back(std::move(region));
-
-		return buffer;
+		return m_pBufferManager->GetUniformBuffer(m_currentRegion, size);
 	}
 
 	void UniformBufferConcurrentAllocator::ResetReservedRegion()
 	{
-		m_reservedRegions.clear();
+		m_currentRegion = {};
 	}
 
 	Shader::Shader(EShaderType type)
@@ -196,6 +399,11 @@ namespace Engine
 	{
 	}
 
+	ComputeShader::ComputeShader()
+		: Shader(EShaderType::Compute)
+	{
+	}
+
 	ShaderProgram::ShaderProgram(uint32_t shaderStages)
 		: m_shaderStages(shaderStages),
 		m_programID(-1),
@@ -1,6 +1,7 @@
 #pragma once
 #include "SharedTypes.h"
 #include "BasicMathTypes.h"
+#include "BuiltInShaderType.h"
 
 #include <cstdint>
 #include <vector>
@@ -21,12 +22,16 @@ namespace Engine
 		virtual void MarkSizeInByte(uint32_t size);
 		virtual uint32_t GetSizeInBytes() const;
 
+		void MarkUploadValue(uint64_t value);
+		uint64_t GetUploadValue() const; // Resource data is only valid on GPU after graphics device reports this value complete
+
 	protected:
 		RawResource();
 
 	protected:
 		uint64_t m_resourceID;
 		uint32_t m_sizeInBytes;
+		uint64_t m_uploadValue; // 0 if resource data was uploaded immediately
 
 	private:
 		static uint64_t m_assignedID;
@@ -34,8 +39,17 @@ namespace Engine
 
 	struct VertexBufferCreateInfo
 	{
-		int*	 pIndexData;
-		uint32_t indexDataCount;
+		const void* pIndexData; // 32-bit signed integers, or 16-bit unsigned if useShortIndices is set
+		uint32_t	indexDataCount;
+		bool		useShortIndices;
+
+		const void* pInterleavedVertexData; // Optional, already in one of the interleaved layouts below, per-attribute data is ignored if set
+		uint32_t	interleavedVertexCount;
+		bool		isQuantized; // Interleaved data is in quantized layout, or per-attribute data is to be written in it
+
+		// Positions of per-attribute data are normalized to these bounds when written in quantized layout
+		Vector3 quantizationBoundsMin;
+		Vector3 quantizationBoundsMax;
 
 		float*	 pPositionData;
 		uint32_t positionDataCount;
@@ -55,7 +69,25 @@ namespace Engine
 
 		static const uint32_t interleavedStride = 11 * sizeof(float); // 3 + 3 + 2 + 3
 
-		std::vector<float> ConvertToInterleavedData() const; // This would not pack index
+		// Quantized layout : [ position RGBA16_UNORM | normal RGB10A2_SNORM | texcoord RG16F | tangent RGB10A2_SNORM ]
+		// Positions are normalized to mesh bounds and decoded in vertex shader
+		static const uint32_t quantizedPositionOffset = 0;
+		static const uint32_t quantizedNormalOffset = 8;
+		static const uint32_t quantizedTexcoordOffset = 12;
+		static const uint32_t quantizedTangentOffset = 16;
+		static const uint32_t quantizedStride = 20;
+
+		// Depth-only passes can bind a tightly packed copy of positions instead, in the same format as the interleaved layout
+		bool createPositionStream;
+		static const uint32_t positionStreamStride = 3 * sizeof(float);
+		static const uint32_t quantizedPositionStreamStride = 8;
+
+		uint32_t GetVertexCount() const;
+		uint32_t GetVertexStride() const;
+		void WriteVertexData(void* pOutput) const; // Writes vertices in the selected layout straight to output, e.g. mapped staging memory. This would not pack index
+		uint32_t GetPositionStreamStride() const;
+		void WritePositionStreamData(void* pOutput) const;
+		static std::vector<uint8_t> QuantizeInterleavedData(const float* pInterleavedData, uint32_t vertexCount, const Vector3& boundsMin, const Vector3& boundsMax);
 	};
 
 	class VertexBuffer : public RawResource
@@ -64,11 +96,14 @@ namespace Engine
 		void SetNumberOfIndices(uint32_t count);
 		uint32_t GetNumberOfIndices() const;
 
+		bool HasPositionStream() const;
+
 	protected:
 		VertexBuffer() = default;
 
 	protected:
 		uint32_t m_numberOfIndices;
+		bool m_hasPositionStream;
 	};
 
 	struct TextureSamplerCreateInfo
@@ -92,9 +127,53 @@ namespace Engine
 		TextureSampler() = default;
 	};
 
+	struct DeviceMemoryRequirements
+	{
+		uint64_t size;
+		uint64_t alignment;
+		uint32_t memoryTypeBits; // Bitmap of device memory types the resource can reside in
+	};
+
+	struct DeviceMemoryHeapStatistics
+	{
+		uint64_t size;
+		uint64_t usage;  // Includes memory allocated by other processes and by the driver if memory budget is supported
+		uint64_t budget; // Estimated amount the application can use without degrading performance
+		bool	 isDeviceLocal;
+	};
+
+	struct DeviceMemoryStatistics
+	{
+		std::vector<DeviceMemoryHeapStatistics> heaps;
+
+		uint64_t categoryBytes[(uint32_t)EMemoryCategory::COUNT];
+		uint32_t categoryAllocationCounts[(uint32_t)EMemoryCategory::COUNT];
+
+		uint64_t blockBytes;	  // Device memory allocated by the engine
+		uint64_t allocationBytes; // Part of it occupied by resources, the rest is fragmented or free
+		uint64_t defragmentedBytes; // Total bytes moved by defragmentation so far
+		bool	 isBudgetSupported;
+	};
+
+	// Device memory that can be shared by resources whose lifetimes do not overlap
+	class TransientMemoryBlock : public RawResource
+	{
+	protected:
+		TransientMemoryBlock() = default;
+	};
+
+	// Slots that command buffers write GPU timestamps into, results are read back on host once the commands have executed
+	class TimestampQueryPool : public RawResource
+	{
+	protected:
+		TimestampQueryPool() = default;
+	};
+
 	struct Texture2DCreateInfo
 	{
 		const void*	   pTextureData;
+		uint32_t	   mipLevelCount; // Number of levels contained in texture data, 0 is treated as 1. Ignored if generateMipmap is true
+		const size_t*  pMipLevelOffsets; // Byte offset of each level into texture data, levels are tightly packed from the base level if not specified
 		uint32_t	   textureWidth;
 		uint32_t	   textureHeight;
 		ETextureFormat format;
@@ -104,6 +183,9 @@ namespace Engine
 											// If generateMipmap is true, this will be ignored as if always true
 		TextureSampler* pSampler;
 		EImageLayout   initialLayout;
+		TransientMemoryBlock* pTransientMemory; // If specified, texture will be placed into this memory block instead of owning a dedicated allocation
+		bool		   enableStorageAccess; // Allow the texture to be bound as storage image in compute shaders
+		bool		   enableAsyncComputeAccess; // Texture will be accessed from both graphics and async compute queue
 	};
 
 	enum class ETexture2DSource
@@ -119,8 +201,8 @@ namespace Engine
 	public:
 		virtual ~Texture2D() = default;
 
-		uint32_t GetWidth() const;
-		uint32_t GetHeight() const;
+		virtual uint32_t GetWidth() const;
+		virtual uint32_t GetHeight() const;
 
 		void SetTextureType(ETextureType type);
 		ETextureType GetTextureType() const;
@@ -132,6 +214,8 @@ namespace Engine
 		virtual void SetSampler(const TextureSampler* pSampler) = 0;
 		virtual TextureSampler* GetSampler() const = 0;
 
+		virtual bool HasTransparentTexels() const; // Conservatively true unless the content is known, alpha cutout could be skipped if false
+
 		ETexture2DSource QuerySource() const;
 
 	protected:
@@ -146,6 +230,15 @@ namespace Engine
 		std::string m_filePath;
 	};
 
+	struct TextureBarrierDescription
+	{
+		Texture2D*		   pTexture;
+		ETextureAccessType srcAccess;
+		ETextureAccessType dstAccess;
+		bool			   discardContent; // Previous content is not needed, the texture is transitioned from undefined layout
+		bool			   crossQueue; // Source access happened on another queue, a semaphore wait already covers it and only the layout transition is needed
+	};
+
 	struct DataTransferBufferCreateInfo
 	{
 		uint32_t	size;
@@ -281,7 +374,7 @@ namespace Engine
 	struct UniformBufferReservedRegion
 	{
 		// Region identifier
-		uint32_t index;
+		BaseUniformBuffer* pParentBuffer;
 		uint32_t offset;
 
 		// Size tracking
@@ -294,16 +387,20 @@ namespace Engine
 	public:
 		virtual ~UniformBufferManager() = default;
 
-		// Safe to be called concurrently, but slow due to locking
+		// Safe to be called concurrently; each call costs one atomic operation
 		virtual UniformBuffer GetUniformBuffer(uint32_t size) = 0;
 
-		// (Almost) Lockless version of GetUniformBuffer, but requires a reserved region
+		// Allocates from a block previously reserved by the calling thread, no synchronization involved
 		virtual UniformBuffer GetUniformBuffer(UniformBufferReservedRegion& region, uint32_t size) = 0;
 		virtual UniformBufferReservedRegion ReserveBufferRegion(uint32_t size) = 0;
 
 		// Unsafe to be called concurrently
 		virtual void ResetBufferAllocation() = 0;
 
+		// Bytes requested during the last use of given frame's buffers, and the maximum ever recorded
+		virtual uint32_t GetHighWaterMark(uint32_t frameIndex) const = 0;
+		virtual uint32_t GetPeakHighWaterMark() const = 0;
+
 		void SetCurrentFrameIndex(uint32_t index);
 
 	protected:
@@ -314,12 +411,12 @@ namespace Engine
 	};
 
 	// A helper class that speeds up uniform buffer allocation from multiple threads
-	// This is achieved by reducing mutex locking through reserving a region of memory for each thread
+	// Small blocks are carved out of the shared buffer and then sub-allocated locally, so contention on the shared bump pointer stays low
+	// Each instance should only be used by one thread at a time
 	class UniformBufferConcurrentAllocator
 	{
 	public:
-		// reservedSize is the size of the reserved region each time, and if the current region is full, a new region of the same size will be allocated automatically
-		UniformBufferConcurrentAllocator(UniformBufferManager* pBufferManager, uint32_t reservedSize);
+		UniformBufferConcurrentAllocator(UniformBufferManager* pBufferManager);
 
 		~UniformBufferConcurrentAllocator() = default;
 
@@ -329,9 +426,9 @@ namespace Engine
 
 	private:
 		UniformBufferManager* m_pBufferManager;
-		uint32_t m_reservedSize;
+		UniformBufferReservedRegion m_currentRegion;
 
-		std::vector<UniformBufferReservedRegion> m_reservedRegions;
+		const uint32_t BLOCK_SIZE = 64 * 1024;
 	};
 
 	class Shader
@@ -365,6 +462,15 @@ namespace Engine
 		FragmentShader();
 	};
 
+	class ComputeShader : public Shader
+	{
+	public:
+		virtual ~ComputeShader() = default;
+
+	protected:
+		ComputeShader();
+	};
+
 	class ShaderProgram
 	{
 	public:
@@ -375,7 +481,7 @@ namespace Engine
 		uint32_t GetProgramID() const;
 		uint32_t GetShaderStages() const;
 
-		virtual uint32_t GetParamBinding(const char* paramName) const = 0;
+		virtual uint32_t GetParamBinding(ShaderParamID paramID) const = 0;
 
 	protected:
 		ShaderProgram(uint32_t shaderStages);
@@ -586,4 +692,18 @@ namespace Engine
 	protected:
 		GraphicsPipelineObject() = default;
 	};
+
+	struct ComputePipelineCreateInfo
+	{
+		ShaderProgram* pShaderProgram;
+	};
+
+	class ComputePipelineObject : public RawResource
+	{
+	public:
+		virtual ~ComputePipelineObject() = default;
+
+	protected:
+		ComputePipelineObject() = default;
+	};
 }
\ No newline at end of file
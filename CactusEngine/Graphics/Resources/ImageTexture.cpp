@@ -1,19 +1,22 @@
 #include "ImageTexture.h"
 #include "GraphicsDevice.h"
 #include "GraphicsApplication.h"
+#include "KTX2File.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
 namespace Engine
 {
-	ImageTexture::ImageTexture(const char* filePath)
-		: Texture2D(ETexture2DSource::ImageTexture)
-	{
-		LoadAndCreateTexture(filePath);
-	}
+	JobCounter ImageTexture::m_sStreamingJobCounter;
 
-	void ImageTexture::LoadAndCreateTexture(const char* filePath)
+	ImageTexture::ImageTexture(const char* filePath, ETextureContent content, bool streamIn)
+		: Texture2D(ETexture2DSource::ImageTexture),
+		m_content(content),
+		m_pTextureImpl(nullptr),
+		m_pLoadedTexture(nullptr),
+		m_hasTransparentTexels(true),
+		m_pSampler(nullptr)
 	{
 		m_pDevice = ((GraphicsApplication*)gpGlobal->GetCurrentApplication())->GetGraphicsDevice();
 
@@ -23,17 +26,74 @@ namespace Engine
 			return;
 		}
 
+		m_filePath.assign(filePath);
+
+		// Assign sampler upfront so that render nodes do not need to modify shared textures while recording
+		m_pSampler = m_pDevice->GetTextureSampler(gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetTextureAnisotropyLevel());
+
+		// Texture creation can only be moved off the calling thread if it does not record into graphics queue
+		if (!streamIn || !m_pDevice->IsAsyncUploadEnabled())
+		{
+			if (!LoadAndCreateTexture())
+			{
+				throw std::runtime_error("Failed to load texture image.");
+			}
+			m_pTextureImpl = m_pLoadedTexture.load();
+			return;
+		}
+
+		m_pTextureImpl = m_pDevice->GetPlaceholderTexture();
+		m_width = m_pTextureImpl.load()->GetWidth();
+		m_height = m_pTextureImpl.load()->GetHeight();
+
+		m_sStreamingJobCounter.Increase();
+		JobSystem::Schedule([this]()
+			{
+				if (!LoadAndCreateTexture())
+				{
+					LOG_ERROR("Failed to load texture image " + m_filePath + ", placeholder texture is kept.");
+				}
+				m_sStreamingJobCounter.Decrease();
+			}, &m_streamingJobCounter);
+	}
+
+	ImageTexture::~ImageTexture()
+	{
+		// Loading job writes to this texture
+		JobSystem::WaitForCounter(&m_streamingJobCounter);
+	}
+
+	void ImageTexture::WaitStreamingJobs()
+	{
+		JobSystem::WaitForCounter(&m_sStreamingJobCounter);
+	}
+
+	bool ImageTexture::LoadAndCreateTexture()
+	{
+		bool isCookedFile = m_filePath.size() >= 5 && m_filePath.compare(m_filePath.size() - 5, 5, ".ktx2") == 0;
+
+		if (isCookedFile || (m_content != ETextureContent::Uncompressed && m_pDevice->IsBlockCompressionSupported()))
+		{
+			if (LoadCompressedTexture(isCookedFile))
+			{
+				return true;
+			}
+
+			if (isCookedFile)
+			{
+				return false;
+			}
+			LOG_WARNING("Failed to load compressed texture for " + m_filePath + ", falling back to uncompressed format.");
+		}
+
 		int32_t texWidth, texHeight, texChannels;
-		stbi_uc* imageData = stbi_load(filePath, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+		stbi_uc* imageData = stbi_load(m_filePath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
 		if (!imageData)
 		{
-			throw std::runtime_error("Failed to load texture image.");
+			return false;
 		}
 
-		m_width = texWidth;
-		m_height = texHeight;
-
 		Texture2DCreateInfo createInfo{};
 		createInfo.textureWidth = texWidth;
 		createInfo.textureHeight = texHeight;
@@ -42,30 +102,159 @@ namespace Engine
 		createInfo.textureType = ETextureType::SampledImage;
 		createInfo.generateMipmap = true;
 		createInfo.initialLayout = EImageLayout::ShaderReadOnly;
+		createInfo.pSampler = m_pSampler;
 
-		m_pDevice->CreateTexture2D(createInfo, m_pTextureImpl);
+		Texture2D* pTexture = nullptr;
+		m_pDevice->CreateTexture2D(createInfo, pTexture);
+
+		bool hasTransparentTexels = false;
+		for (size_t i = 3; i < (size_t)texWidth * texHeight * 4; i += 4)
+		{
+			if (imageData[i] != 255)
+			{
+				hasTransparentTexels = true;
+				break;
+			}
+		}
+		m_hasTransparentTexels = hasTransparentTexels;
 
-		m_filePath.assign(filePath);
 		stbi_image_free(imageData);
+
+		// Readers on other threads take the size from loaded texture, it is complete before being published here
+		m_pLoadedTexture.store(pTexture, std::memory_order_release);
+
+		return true;
+	}
+
+	bool ImageTexture::LoadCompressedTexture(bool isCookedFile)
+	{
+		std::string cookedPath = m_filePath;
+		if (!isCookedFile)
+		{
+			cookedPath = TextureCompressor::GetCookedFilePath(m_filePath.c_str(), m_content);
+			if (!TextureCompressor::IsCookedFileUpToDate(m_filePath.c_str(), cookedPath.c_str())
+				&& !TextureCompressor::CookTexture(m_filePath.c_str(), cookedPath.c_str(), m_content))
+			{
+				return false;
+			}
+		}
+
+		KTX2File cookedFile;
+		if (!cookedFile.Open(cookedPath.c_str()))
+		{
+			return false;
+		}
+
+		if (IsBlockCompressedFormat(cookedFile.GetFormat()) && !m_pDevice->IsBlockCompressionSupported())
+		{
+			LOG_ERROR("Device does not support block compressed format of " + cookedPath);
+			return false;
+		}
+
+		// Levels are stored from the smallest one, data is uploaded straight from the mapped file starting at the lowest level offset
+		uint32_t levelCount = cookedFile.GetLevelCount();
+		const uint8_t* pDataBegin = cookedFile.GetLevelData(0);
+		for (uint32_t level = 1; level < levelCount; ++level)
+		{
+			pDataBegin = std::min(pDataBegin, cookedFile.GetLevelData(level));
+		}
+
+		std::vector<size_t> levelOffsets(levelCount);
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			levelOffsets[level] = cookedFile.GetLevelData(level) - pDataBegin;
+		}
+
+		Texture2DCreateInfo createInfo{};
+		createInfo.textureWidth = cookedFile.GetWidth();
+		createInfo.textureHeight = cookedFile.GetHeight();
+		createInfo.pTextureData = pDataBegin;
+		createInfo.mipLevelCount = levelCount;
+		createInfo.pMipLevelOffsets = levelOffsets.data();
+		createInfo.format = cookedFile.GetFormat();
+		createInfo.textureType = ETextureType::SampledImage;
+		createInfo.generateMipmap = false;
+		createInfo.initialLayout = EImageLayout::ShaderReadOnly;
+		createInfo.pSampler = m_pSampler;
+
+		// Texture data is copied into staging memory before this returns, so the file can be unmapped right after
+		Texture2D* pTexture = nullptr;
+		m_pDevice->CreateTexture2D(createInfo, pTexture);
+
+		// Cooking only picks formats with alpha for images that have transparent texels
+		ETextureFormat format = createInfo.format;
+		m_hasTransparentTexels = format != ETextureFormat::BC1_RGB_UNORM && format != ETextureFormat::BC1_RGB_SRGB
+			&& format != ETextureFormat::BC4_UNORM && format != ETextureFormat::BC5_UNORM;
+
+		m_pLoadedTexture.store(pTexture, std::memory_order_release);
+
+		return true;
 	}
 
 	Texture2D* ImageTexture::GetTexture() const
 	{
-		return m_pTextureImpl;
+		// Whoever queries the texture first after its upload has completed swaps it in
+		IsResident();
+		return m_pTextureImpl.load();
+	}
+
+	bool ImageTexture::IsResident() const
+	{
+		Texture2D* pLoadedTexture = m_pLoadedTexture.load();
+		if (pLoadedTexture == nullptr)
+		{
+			return false;
+		}
+
+		if (m_pTextureImpl.load() != pLoadedTexture)
+		{
+			// Commands recorded after the upload is complete are guaranteed to be submitted after its acquisition on graphics queue
+			if (!m_pDevice->IsUploadComplete(pLoadedTexture->GetUploadValue()))
+			{
+				return false;
+			}
+			m_pTextureImpl = pLoadedTexture;
+		}
+
+		return true;
+	}
+
+	uint32_t ImageTexture::GetWidth() const
+	{
+		Texture2D* pLoadedTexture = m_pLoadedTexture.load(std::memory_order_acquire);
+		return pLoadedTexture != nullptr ? pLoadedTexture->GetWidth() : m_width;
+	}
+
+	uint32_t ImageTexture::GetHeight() const
+	{
+		Texture2D* pLoadedTexture = m_pLoadedTexture.load(std::memory_order_acquire);
+		return pLoadedTexture != nullptr ? pLoadedTexture->GetHeight() : m_height;
+	}
+
+	bool ImageTexture::HasTransparentTexels() const
+	{
+		return m_hasTransparentTexels.load();
 	}
 
 	bool ImageTexture::HasSampler() const
 	{
-		return m_pTextureImpl->HasSampler();
+		return m_pSampler != nullptr;
 	}
 
 	void ImageTexture::SetSampler(const TextureSampler* pSampler)
 	{
-		m_pTextureImpl->SetSampler(pSampler);
+		m_pSampler = (TextureSampler*)pSampler;
+
+		// Placeholder texture is shared, its sampler is left untouched
+		Texture2D* pLoadedTexture = m_pLoadedTexture.load();
+		if (pLoadedTexture != nullptr)
+		{
+			pLoadedTexture->SetSampler(pSampler);
+		}
 	}
 
 	TextureSampler* ImageTexture::GetSampler() const
 	{
-		return m_pTextureImpl->GetSampler();
+		return m_pSampler;
 	}
 }
\ No newline at end of file
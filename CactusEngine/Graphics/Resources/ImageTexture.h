@@ -1,25 +1,49 @@
 #pragma once
 #include "GraphicsResources.h"
+#include "TextureCompressor.h"
+#include "JobSystem.h"
+
+#include <atomic>
 
 namespace Engine
 {
 	class ImageTexture : public Texture2D
 	{
 	public:
-		ImageTexture(const char* filePath);
-		~ImageTexture() = default;
+		// Compressible content is cooked into block compressed KTX2 on first load, .ktx2 files are loaded as is
+		// Streamed in on worker threads if device supports asynchronous upload
+		ImageTexture(const char* filePath, ETextureContent content = ETextureContent::Uncompressed, bool streamIn = true);
+		~ImageTexture();
+
+		Texture2D* GetTexture() const; // Returns placeholder texture until the loaded texture is resident
+		bool IsResident() const;
+
+		// Size of the loaded image once it is loaded, size of placeholder texture before that
+		uint32_t GetWidth() const override;
+		uint32_t GetHeight() const override;
 
-		Texture2D* GetTexture() const;
+		static void WaitStreamingJobs(); // Waits for all textures, must be called before graphics device is shut down
 
 		bool HasSampler() const override;
 		void SetSampler(const TextureSampler* pSampler) override;
 		TextureSampler* GetSampler() const override;
 
+		bool HasTransparentTexels() const override; // Known once the image is loaded
+
 	private:
-		void LoadAndCreateTexture(const char* filePath);
+		bool LoadAndCreateTexture();
+		bool LoadCompressedTexture(bool isCookedFile);
 
 	private:
 		GraphicsDevice* m_pDevice;
-		Texture2D* m_pTextureImpl;
+		ETextureContent m_content;
+		mutable std::atomic<Texture2D*> m_pTextureImpl;
+		std::atomic<Texture2D*> m_pLoadedTexture; // Its data may still be in flight on transfer queue
+		std::atomic<bool> m_hasTransparentTexels;
+		TextureSampler* m_pSampler;
+
+		JobCounter m_streamingJobCounter; // Only this texture's loading job, so that destroying it does not wait for others
+
+		static JobCounter m_sStreamingJobCounter;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+#include "KTX2File.h"
+#include "LogUtility.h"
+#include "FileUtility.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace Engine
+{
+	static const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	// Khronos data format descriptor values used by supported formats
+	static const uint32_t DFD_COLOR_MODEL_RGBSDA = 1;
+	static const uint32_t DFD_COLOR_MODEL_BC1A = 128;
+	static const uint32_t DFD_COLOR_MODEL_BC4 = 131;
+	static const uint32_t DFD_COLOR_MODEL_BC5 = 132;
+	static const uint32_t DFD_COLOR_MODEL_BC7 = 134;
+	static const uint32_t DFD_PRIMARIES_BT709 = 1;
+	static const uint32_t DFD_TRANSFER_LINEAR = 1;
+	static const uint32_t DFD_TRANSFER_SRGB = 2;
+	static const uint32_t DFD_SAMPLE_QUALIFIER_LINEAR = 0x10;
+
+	template<typename T>
+	static T ReadValue(const uint8_t* pData, size_t offset)
+	{
+		T value;
+		memcpy(&value, pData + offset, sizeof(T)); // File offsets are not guaranteed to be aligned
+		return value;
+	}
+
+	template<typename T>
+	static void AppendValue(std::vector<uint8_t>& buffer, T value)
+	{
+		size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		memcpy(buffer.data() + offset, &value, sizeof(T));
+	}
+
+	static uint32_t BlockByteSize(ETextureFormat format)
+	{
+		switch (format)
+		{
+		case ETextureFormat::BC1_RGB_UNORM:
+		case ETextureFormat::BC1_RGB_SRGB:
+		case ETextureFormat::BC4_UNORM:
+			return 8;
+
+		case ETextureFormat::BC5_UNORM:
+		case ETextureFormat::BC7_UNORM:
+		case ETextureFormat::BC7_SRGB:
+			return 16;
+
+		default:
+			return 4; // RGBA8_SRGB, one texel per block
+		}
+	}
+
+	static size_t ExpectedLevelSize(ETextureFormat format, uint32_t width, uint32_t height)
+	{
+		if (IsBlockCompressedFormat(format))
+		{
+			return (size_t)((width + 3) / 4) * ((height + 3) / 4) * BlockByteSize(format);
+		}
+		return (size_t)width * height * BlockByteSize(format);
+	}
+
+	KTX2File::KTX2File()
+		: m_format(ETextureFormat::UNDEFINED),
+		m_width(0),
+		m_height(0)
+	{
+
+	}
+
+	bool KTX2File::Open(const char* filePath)
+	{
+		Close();
+
+		if (!m_mappedFile.Open(filePath))
+		{
+			return false;
+		}
+
+		const uint8_t* pData = m_mappedFile.GetData();
+		size_t fileSize = m_mappedFile.GetSize();
+
+		if (fileSize < HEADER_SIZE || memcmp(pData, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+		{
+			LOG_WARNING("KTX2: invalid file identifier in " + std::string(filePath));
+			Close();
+			return false;
+		}
+
+		uint32_t vkFormat = ReadValue<uint32_t>(pData, 12);
+		uint32_t pixelDepth = ReadValue<uint32_t>(pData, 28);
+		uint32_t layerCount = ReadValue<uint32_t>(pData, 32);
+		uint32_t faceCount = ReadValue<uint32_t>(pData, 36);
+		uint32_t levelCount = ReadValue<uint32_t>(pData, 40);
+		uint32_t supercompressionScheme = ReadValue<uint32_t>(pData, 44);
+
+		m_format = FromVkFormatValue(vkFormat);
+		m_width = ReadValue<uint32_t>(pData, 20);
+		m_height = ReadValue<uint32_t>(pData, 24);
+
+		// A full mip chain has floor(log2(max(width, height))) + 1 levels, more levels would shift level sizes past their bit width
+		uint32_t maxLevelCount = 1;
+		for (uint32_t size = std::max(m_width, m_height); size > 1; size >>= 1)
+		{
+			maxLevelCount++;
+		}
+
+		if (m_format == ETextureFormat::UNDEFINED || m_width == 0 || m_height == 0 || pixelDepth != 0 || layerCount != 0 || faceCount != 1
+			|| levelCount == 0 || levelCount > maxLevelCount || supercompressionScheme != 0 || fileSize < HEADER_SIZE + (size_t)levelCount * LEVEL_INDEX_ENTRY_SIZE)
+		{
+			LOG_WARNING("KTX2: unsupported texture layout in " + std::string(filePath));
+			Close();
+			return false;
+		}
+
+		m_levels.resize(levelCount);
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			size_t entryOffset = HEADER_SIZE + (size_t)level * LEVEL_INDEX_ENTRY_SIZE;
+			m_levels[level].offset = ReadValue<uint64_t>(pData, entryOffset);
+			m_levels[level].length = ReadValue<uint64_t>(pData, entryOffset + 8);
+
+			uint32_t levelWidth = std::max<uint32_t>(m_width >> level, 1);
+			uint32_t levelHeight = std::max<uint32_t>(m_height >> level, 1);
+
+			// Compared without adding offset and length, as the sum could wrap around
+			if (m_levels[level].offset > fileSize || m_levels[level].length > fileSize - m_levels[level].offset
+				|| m_levels[level].length != ExpectedLevelSize(m_format, levelWidth, levelHeight))
+			{
+				LOG_WARNING("KTX2: corrupted level index in " + std::string(filePath));
+				Close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void KTX2File::Close()
+	{
+		m_mappedFile.Close();
+		m_format = ETextureFormat::UNDEFINED;
+		m_width = 0;
+		m_height = 0;
+		m_levels.clear();
+	}
+
+	ETextureFormat KTX2File::GetFormat() const
+	{
+		return m_format;
+	}
+
+	uint32_t KTX2File::GetWidth() const
+	{
+		return m_width;
+	}
+
+	uint32_t KTX2File::GetHeight() const
+	{
+		return m_height;
+	}
+
+	uint32_t KTX2File::GetLevelCount() const
+	{
+		return (uint32_t)m_levels.size();
+	}
+
+	const uint8_t* KTX2File::GetLevelData(uint32_t level) const
+	{
+		DEBUG_ASSERT_CE(level < m_levels.size());
+		return m_mappedFile.GetData() + m_levels[level].offset;
+	}
+
+	size_t KTX2File::GetLevelSize(uint32_t level) const
+	{
+		DEBUG_ASSERT_CE(level < m_levels.size());
+		return (size_t)m_levels[level].length;
+	}
+
+	bool KTX2File::Write(const char* filePath, ETextureFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels)
+	{
+		uint32_t vkFormat = ToVkFormatValue(format);
+		if (vkFormat == 0 || levels.empty())
+		{
+			LOG_ERROR("KTX2: cannot write texture format " + std::to_string((uint32_t)format));
+			return false;
+		}
+
+		uint32_t levelCount = (uint32_t)levels.size();
+		std::vector<uint8_t> dataFormatDescriptor = BuildDataFormatDescriptor(format);
+
+		uint32_t dfdOffset = HEADER_SIZE + levelCount * LEVEL_INDEX_ENTRY_SIZE;
+		uint32_t dfdLength = (uint32_t)dataFormatDescriptor.size();
+
+		// Level data must be aligned to least common multiple of texel block size and 4, smallest level is stored first
+		uint64_t levelAlignment = std::max<uint64_t>(BlockByteSize(format), 4);
+		std::vector<uint64_t> levelOffsets(levelCount);
+		uint64_t fileSize = dfdOffset + dfdLength;
+		for (int32_t level = (int32_t)levelCount - 1; level >= 0; --level)
+		{
+			fileSize = (fileSize + levelAlignment - 1) / levelAlignment * levelAlignment;
+			levelOffsets[level] = fileSize;
+			fileSize += levels[level].size();
+		}
+
+		std::vector<uint8_t> header;
+		header.reserve(dfdOffset + dfdLength);
+		header.insert(header.end(), KTX2_IDENTIFIER, KTX2_IDENTIFIER + sizeof(KTX2_IDENTIFIER));
+		AppendValue<uint32_t>(header, vkFormat);
+		AppendValue<uint32_t>(header, 1); // Type size
+		AppendValue<uint32_t>(header, width);
+		AppendValue<uint32_t>(header, height);
+		AppendValue<uint32_t>(header, 0); // Pixel depth
+		AppendValue<uint32_t>(header, 0); // Layer count
+		AppendValue<uint32_t>(header, 1); // Face count
+		AppendValue<uint32_t>(header, levelCount);
+		AppendValue<uint32_t>(header, 0); // Supercompression scheme
+		AppendValue<uint32_t>(header, dfdOffset);
+		AppendValue<uint32_t>(header, dfdLength);
+		AppendValue<uint32_t>(header, 0); // Key/value data offset
+		AppendValue<uint32_t>(header, 0); // Key/value data length
+		AppendValue<uint64_t>(header, 0); // Supercompression global data offset
+		AppendValue<uint64_t>(header, 0); // Supercompression global data length
+
+		for (uint32_t level = 0; level < levelCount; ++level)
+		{
+			AppendValue<uint64_t>(header, levelOffsets[level]);
+			AppendValue<uint64_t>(header, levels[level].size());
+			AppendValue<uint64_t>(header, levels[level].size()); // Uncompressed length
+		}
+
+		header.insert(header.end(), dataFormatDescriptor.begin(), dataFormatDescriptor.end());
+
+		return FileUtility::WriteFileAtomic(filePath, [&header, &levels, &levelOffsets, levelCount](std::ostream& fileWriter)
+			{
+				fileWriter.write((const char*)header.data(), header.size());
+
+				static const char padding[16] = {};
+				uint64_t writtenSize = header.size();
+				for (int32_t level = (int32_t)levelCount - 1; level >= 0; --level)
+				{
+					fileWriter.write(padding, levelOffsets[level] - writtenSize);
+					fileWriter.write((const char*)levels[level].data(), levels[level].size());
+					writtenSize = levelOffsets[level] + levels[level].size();
+				}
+			});
+	}
+
+	uint32_t KTX2File::ToVkFormatValue(ETextureFormat format)
+	{
+		// Numeric VkFormat values, so that the container does not depend on graphics API headers
+		switch (format)
+		{
+		case ETextureFormat::RGBA8_SRGB:
+			return 43;
+		case ETextureFormat::BC1_RGB_UNORM:
+			return 131;
+		case ETextureFormat::BC1_RGB_SRGB:
+			return 132;
+		case ETextureFormat::BC4_UNORM:
+			return 139;
+		case ETextureFormat::BC5_UNORM:
+			return 141;
+		case ETextureFormat::BC7_UNORM:
+			return 145;
+		case ETextureFormat::BC7_SRGB:
+			return 146;
+		default:
+			return 0;
+		}
+	}
+
+	ETextureFormat KTX2File::FromVkFormatValue(uint32_t vkFormat)
+	{
+		switch (vkFormat)
+		{
+		case 43:
+			return ETextureFormat::RGBA8_SRGB;
+		case 131:
+			return ETextureFormat::BC1_RGB_UNORM;
+		case 132:
+			return ETextureFormat::BC1_RGB_SRGB;
+		case 139:
+			return ETextureFormat::BC4_UNORM;
+		case 141:
+			return ETextureFormat::BC5_UNORM;
+		case 145:
+			return ETextureFormat::BC7_UNORM;
+		case 146:
+			return ETextureFormat::BC7_SRGB;
+		default:
+			return ETextureFormat::UNDEFINED;
+		}
+	}
+
+	std::vector<uint8_t> KTX2File::BuildDataFormatDescriptor(ETextureFormat format)
+	{
+		struct Sample
+		{
+			uint32_t bitOffset;
+			uint32_t bitLength;
+			uint32_t channelType;
+			uint32_t upper;
+		};
+
+		std::vector<Sample> samples;
+		uint32_t colorModel = DFD_COLOR_MODEL_RGBSDA;
+		bool isBlockCompressed = IsBlockCompressedFormat(format);
+		bool isSRGB = format == ETextureFormat::RGBA8_SRGB || format == ETextureFormat::BC1_RGB_SRGB || format == ETextureFormat::BC7_SRGB;
+
+		switch (format)
+		{
+		case ETextureFormat::BC1_RGB_UNORM:
+		case ETextureFormat::BC1_RGB_SRGB:
+			colorModel = DFD_COLOR_MODEL_BC1A;
+			samples.push_back({ 0, 64, 0, 0xFFFFFFFF });
+			break;
+		case ETextureFormat::BC4_UNORM:
+			colorModel = DFD_COLOR_MODEL_BC4;
+			samples.push_back({ 0, 64, 0, 0xFFFFFFFF });
+			break;
+		case ETextureFormat::BC5_UNORM:
+			colorModel = DFD_COLOR_MODEL_BC5;
+			samples.push_back({ 0, 64, 0, 0xFFFFFFFF });
+			samples.push_back({ 64, 64, 1, 0xFFFFFFFF });
+			break;
+		case ETextureFormat::BC7_UNORM:
+		case ETextureFormat::BC7_SRGB:
+			colorModel = DFD_COLOR_MODEL_BC7;
+			samples.push_back({ 0, 128, 0, 0xFFFFFFFF });
+			break;
+		default:
+			samples.push_back({ 0, 8, 0, 255 });
+			samples.push_back({ 8, 8, 1, 255 });
+			samples.push_back({ 16, 8, 2, 255 });
+			samples.push_back({ 24, 8, 15 | (isSRGB ? DFD_SAMPLE_QUALIFIER_LINEAR : 0), 255 }); // Alpha is never sRGB encoded
+			break;
+		}
+
+		uint32_t blockSize = 24 + 16 * (uint32_t)samples.size();
+
+		std::vector<uint8_t> descriptor;
+		AppendValue<uint32_t>(descriptor, 4 + blockSize); // Total size
+		AppendValue<uint32_t>(descriptor, 0); // Khronos vendor, basic descriptor type
+		AppendValue<uint32_t>(descriptor, 2 | (blockSize << 16)); // Version 1.3
+		AppendValue<uint32_t>(descriptor, colorModel | (DFD_PRIMARIES_BT709 << 8) | ((isSRGB ? DFD_TRANSFER_SRGB : DFD_TRANSFER_LINEAR) << 16));
+		AppendValue<uint32_t>(descriptor, isBlockCompressed ? (3 | (3 << 8)) : 0); // Texel block dimensions minus one
+		AppendValue<uint32_t>(descriptor, BlockByteSize(format)); // Bytes in plane 0
+		AppendValue<uint32_t>(descriptor, 0);
+
+		for (auto& sample : samples)
+		{
+			AppendValue<uint32_t>(descriptor, sample.bitOffset | ((sample.bitLength - 1) << 16) | (sample.channelType << 24));
+			AppendValue<uint32_t>(descriptor, 0); // Sample position
+			AppendValue<uint32_t>(descriptor, 0); // Lower
+			AppendValue<uint32_t>(descriptor, sample.upper);
+		}
+
+		return descriptor;
+	}
+}
\ No newline at end of file
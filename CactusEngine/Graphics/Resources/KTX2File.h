@@ -0,0 +1,54 @@
+#pragma once
+#include "SharedTypes.h"
+#include "MappedFile.h"
+#include "NoCopy.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	// Minimal KTX 2.0 container for 2D textures with pre-built mip chain, no supercompression, array layers or cube faces
+	// Level data is read straight from the memory mapped file
+	class KTX2File : public NoCopy
+	{
+	public:
+		KTX2File();
+		~KTX2File() = default;
+
+		bool Open(const char* filePath); // Returns false if the file is missing or uses features outside of above subset
+		void Close();
+
+		ETextureFormat GetFormat() const;
+		uint32_t GetWidth() const;
+		uint32_t GetHeight() const;
+		uint32_t GetLevelCount() const;
+		const uint8_t* GetLevelData(uint32_t level) const;
+		size_t GetLevelSize(uint32_t level) const;
+
+		// Levels are ordered from base level, written via temporary file so that a partially written file is never visible
+		static bool Write(const char* filePath, ETextureFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels);
+
+	private:
+		static uint32_t ToVkFormatValue(ETextureFormat format);
+		static ETextureFormat FromVkFormatValue(uint32_t vkFormat);
+		static std::vector<uint8_t> BuildDataFormatDescriptor(ETextureFormat format);
+
+	public:
+		static const uint32_t HEADER_SIZE = 80;
+		static const uint32_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+	private:
+		struct LevelEntry
+		{
+			uint64_t offset;
+			uint64_t length;
+		};
+
+		MappedFile m_mappedFile;
+		ETextureFormat m_format;
+		uint32_t m_width;
+		uint32_t m_height;
+		std::vector<LevelEntry> m_levels;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Mesh.h"
 #include "GraphicsDevice.h"
+#include "Global.h"
 
 namespace Engine
 {
@@ -7,7 +8,10 @@ namespace Engine
 		: m_pDevice(pDevice),
 		m_pVertexBuffer(nullptr),
 		m_type(EBuiltInMeshType::External),
-		m_planeDimension(0, 0)
+		m_planeDimension(0, 0),
+		m_boundsMin(0),
+		m_boundsMax(0),
+		m_isQuantized(false)
 	{
 
 	}
@@ -22,6 +26,11 @@ namespace Engine
 		return &m_subMeshes;
 	}
 
+	const std::vector<Meshlet>* Mesh::GetMeshlets() const
+	{
+		return &m_meshlets;
+	}
+
 	uint32_t Mesh::GetSubmeshCount() const
 	{
 		return (uint32_t)m_subMeshes.size();
@@ -42,6 +51,31 @@ namespace Engine
 		return m_planeDimension;
 	}
 
+	Vector3 Mesh::GetBoundsMin() const
+	{
+		return m_boundsMin;
+	}
+
+	Vector3 Mesh::GetBoundsMax() const
+	{
+		return m_boundsMax;
+	}
+
+	bool Mesh::IsQuantized() const
+	{
+		return m_isQuantized;
+	}
+
+	Vector4 Mesh::GetPositionScale() const
+	{
+		return m_isQuantized ? Vector4(m_boundsMax - m_boundsMin, 0.0f) : Vector4(1.0f, 1.0f, 1.0f, 0.0f);
+	}
+
+	Vector4 Mesh::GetPositionOffset() const
+	{
+		return m_isQuantized ? Vector4(m_boundsMin, 0.0f) : Vector4(0.0f);
+	}
+
 	void Mesh::CreateVertexBufferFromVertices(std::vector<float>& positions, std::vector<float>& normals, std::vector<float>& texcoords, std::vector<float>& tangents, std::vector<int>& indices)
 	{
 		if (!m_pDevice)
@@ -50,6 +84,8 @@ namespace Engine
 			return;
 		}
 
+		UpdateBounds(positions.data(), (uint32_t)positions.size() / 3, 3);
+
 		VertexBufferCreateInfo createInfo{};
 
 		createInfo.pIndexData = indices.data();
@@ -63,6 +99,57 @@ namespace Engine
 		createInfo.pTangentData = tangents.data();
 		createInfo.tangentDataCount = static_cast<uint32_t>(tangents.size());
 
+		// Device interleaves and quantizes the attributes as they are written to staging memory
+		createInfo.isQuantized = m_pDevice->IsVertexQuantizationEnabled();
+		createInfo.quantizationBoundsMin = m_boundsMin;
+		createInfo.quantizationBoundsMax = m_boundsMax;
+
+		createInfo.createPositionStream = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPositionStream();
+
+		m_isQuantized = createInfo.isQuantized;
+		m_pDevice->CreateVertexBuffer(createInfo, m_pVertexBuffer);
+	}
+
+	void Mesh::CreateVertexBufferFromInterleavedData(const void* pVertexData, uint32_t vertexCount, const void* pIndexData, uint32_t indexCount, bool isQuantized, bool useShortIndices)
+	{
+		if (!m_pDevice)
+		{
+			throw std::runtime_error("Device is not assigned.");
+			return;
+		}
+
+		VertexBufferCreateInfo createInfo{};
+
+		createInfo.pIndexData = pIndexData;
+		createInfo.indexDataCount = indexCount;
+		createInfo.useShortIndices = useShortIndices;
+		createInfo.pInterleavedVertexData = pVertexData;
+		createInfo.interleavedVertexCount = vertexCount;
+		createInfo.isQuantized = isQuantized;
+		createInfo.createPositionStream = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPositionStream();
+
+		m_isQuantized = isQuantized;
 		m_pDevice->CreateVertexBuffer(createInfo, m_pVertexBuffer);
 	}
+
+	void Mesh::UpdateBounds(const float* pPositions, uint32_t vertexCount, uint32_t elementStride)
+	{
+		if (vertexCount == 0)
+		{
+			m_boundsMin = Vector3(0);
+			m_boundsMax = Vector3(0);
+			return;
+		}
+
+		m_boundsMin = Vector3(pPositions[0], pPositions[1], pPositions[2]);
+		m_boundsMax = m_boundsMin;
+
+		for (uint32_t i = 1; i < vertexCount; ++i)
+		{
+			const float* pPosition = pPositions + (size_t)elementStride * i;
+			Vector3 position(pPosition[0], pPosition[1], pPosition[2]);
+			m_boundsMin = glm::min(m_boundsMin, position);
+			m_boundsMax = glm::max(m_boundsMax, position);
+		}
+	}
 }
\ No newline at end of file
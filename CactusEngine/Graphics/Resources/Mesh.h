@@ -12,6 +12,18 @@ namespace Engine
 		uint32_t m_baseVertex;
 	};
 
+	// Contiguous index range inside a submesh that is culled as a unit, built at mesh cook time
+	struct Meshlet
+	{
+		uint32_t m_subMeshIndex;
+		uint32_t m_baseIndex; // Into mesh index buffer, not relative to submesh
+		uint32_t m_numIndices;
+		Vector3	 m_center; // Object space bounding sphere
+		float	 m_radius;
+		Vector3	 m_coneAxis; // Average normal, all triangle normals are within the cone around it
+		float	 m_coneCutoff; // Sine of cone spread angle, 1 if the cone is too wide to ever be back facing
+	};
+
 	class Mesh
 	{
 	public:
@@ -19,23 +31,35 @@ namespace Engine
 
 		VertexBuffer* GetVertexBuffer() const;
 		const std::vector<SubMesh>* GetSubMeshes() const;
+		const std::vector<Meshlet>* GetMeshlets() const; // Empty if the mesh was not clustered, ordered by submesh and index range
 		uint32_t GetSubmeshCount() const;
 		const char* GetFilePath() const;
 		EBuiltInMeshType GetMeshType() const;
 		Vector2 GetPlaneDimenstion() const;
+		Vector3 GetBoundsMin() const; // Object space axis-aligned bounding box
+		Vector3 GetBoundsMax() const;
+		bool IsQuantized() const;
+		Vector4 GetPositionScale() const; // Maps vertex buffer positions to object space, identity if the mesh is not quantized
+		Vector4 GetPositionOffset() const;
 
 	protected:
 		Mesh(GraphicsDevice* pDevice);
 
 		void CreateVertexBufferFromVertices(std::vector<float>& positions, std::vector<float>& normals, std::vector<float>& texcoords, std::vector<float>& tangents, std::vector<int>& indices);
+		void CreateVertexBufferFromInterleavedData(const void* pVertexData, uint32_t vertexCount, const void* pIndexData, uint32_t indexCount, bool isQuantized, bool useShortIndices = false); // Data must be in one of VertexBufferCreateInfo interleaved layouts, bounds must be up to date if quantized
+		void UpdateBounds(const float* pPositions, uint32_t vertexCount, uint32_t elementStride); // Stride in floats, positions could be interleaved with other attributes
 
 	protected:
 		GraphicsDevice* m_pDevice;
 		VertexBuffer* m_pVertexBuffer;
 		std::vector<SubMesh> m_subMeshes;
+		std::vector<Meshlet> m_meshlets;
 
 		std::string m_filePath;
 		EBuiltInMeshType m_type;
 		Vector2 m_planeDimension;
+		Vector3 m_boundsMin;
+		Vector3 m_boundsMax;
+		bool m_isQuantized;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,703 @@
+#include "MeshOptimizer.h"
+#include "LogUtility.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+namespace Engine
+{
+	static const float OVERDRAW_CLUSTER_THRESHOLD = 1.05f; // Clusters are cut where cache efficiency is within this factor of the whole run, higher value trades ACMR for finer sorting
+
+	static float ComputeVertexScore(int cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0;
+		if (cachePosition >= 0)
+		{
+			// Vertices of the last triangle get a fixed score so that strips are not favored over fans
+			score = cachePosition < 3 ? 0.75f : std::pow(1.0f - (cachePosition - 3) * (1.0f / (MeshOptimizer::OPTIMIZATION_CACHE_SIZE - 3)), 1.5f);
+		}
+
+		// Boost vertices with few triangles left so that lone triangles are not left behind
+		return score + 2.0f / std::sqrt((float)remainingTriangles);
+	}
+
+	static uint32_t GetReferencedVertexCount(const int* pIndices, uint32_t indexCount)
+	{
+		int maxIndex = -1;
+		for (uint32_t i = 0; i < indexCount; ++i)
+		{
+			maxIndex = std::max(maxIndex, pIndices[i]);
+		}
+		return (uint32_t)(maxIndex + 1);
+	}
+
+	void MeshOptimizer::OptimizeMesh(std::vector<float>& interleavedVertices, std::vector<int>& indices, const std::vector<SubMesh>& subMeshes)
+	{
+		uint32_t totalVertexCount = (uint32_t)(interleavedVertices.size() / ELEMENT_STRIDE);
+
+		// Alert: submeshes are assumed to own disjoint vertex ranges, which holds for imported meshes
+		for (auto& subMesh : subMeshes)
+		{
+			if (subMesh.m_numIndices < 3 || (size_t)subMesh.m_baseIndex + subMesh.m_numIndices > indices.size())
+			{
+				continue;
+			}
+
+			int* pIndices = indices.data() + subMesh.m_baseIndex;
+			uint32_t vertexCount = GetReferencedVertexCount(pIndices, subMesh.m_numIndices);
+			if ((uint64_t)subMesh.m_baseVertex + vertexCount > totalVertexCount)
+			{
+				LOG_WARNING("Mesh optimization skipped a submesh with out of range indices.");
+				continue;
+			}
+
+			float* pVertices = interleavedVertices.data() + (size_t)subMesh.m_baseVertex * ELEMENT_STRIDE;
+
+			OptimizeVertexCache(pIndices, subMesh.m_numIndices, vertexCount);
+			OptimizeOverdraw(pIndices, subMesh.m_numIndices, pVertices, vertexCount);
+			OptimizeVertexFetch(pVertices, vertexCount, pIndices, subMesh.m_numIndices);
+		}
+	}
+
+	MeshStatistics MeshOptimizer::AnalyzeMesh(const std::vector<float>& interleavedVertices, const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes)
+	{
+		MeshStatistics statistics{};
+
+		uint64_t triangleCount = 0;
+		uint64_t missCount = 0;
+		uint64_t referencedVertexCount = 0;
+
+		std::vector<uint32_t> triangleMisses;
+		std::vector<uint8_t> isReferenced;
+
+		for (auto& subMesh : subMeshes)
+		{
+			if ((size_t)subMesh.m_baseIndex + subMesh.m_numIndices > indices.size())
+			{
+				continue;
+			}
+
+			const int* pIndices = indices.data() + subMesh.m_baseIndex;
+			uint32_t vertexCount = GetReferencedVertexCount(pIndices, subMesh.m_numIndices);
+
+			SimulateVertexCache(pIndices, subMesh.m_numIndices, vertexCount, triangleMisses);
+			for (uint32_t misses : triangleMisses)
+			{
+				missCount += misses;
+			}
+			triangleCount += subMesh.m_numIndices / 3;
+
+			isReferenced.assign(vertexCount, 0);
+			for (uint32_t i = 0; i < subMesh.m_numIndices; ++i)
+			{
+				isReferenced[pIndices[i]] = 1;
+			}
+			referencedVertexCount += std::count(isReferenced.begin(), isReferenced.end(), (uint8_t)1);
+		}
+
+		statistics.acmr = triangleCount > 0 ? (float)missCount / triangleCount : 0;
+		statistics.atvr = referencedVertexCount > 0 ? (float)missCount / referencedVertexCount : 0;
+
+		float shadedPixels = 0;
+		float coveredPixels = 0;
+		for (auto& subMesh : subMeshes)
+		{
+			if ((size_t)subMesh.m_baseIndex + subMesh.m_numIndices > indices.size())
+			{
+				continue;
+			}
+			// Submeshes are measured separately, they are separate draws and could use different pipelines anyway
+			float overdraw = MeasureOverdraw(interleavedVertices.data() + (size_t)subMesh.m_baseVertex * ELEMENT_STRIDE, indices.data() + subMesh.m_baseIndex, subMesh.m_numIndices);
+			shadedPixels += overdraw * subMesh.m_numIndices;
+			coveredPixels += subMesh.m_numIndices;
+		}
+		statistics.overdraw = coveredPixels > 0 ? shadedPixels / coveredPixels : 0;
+
+		return statistics;
+	}
+
+	bool MeshOptimizer::CanUseShortIndices(const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes)
+	{
+		for (auto& subMesh : subMeshes)
+		{
+			if ((size_t)subMesh.m_baseIndex + subMesh.m_numIndices > indices.size()
+				|| GetReferencedVertexCount(indices.data() + subMesh.m_baseIndex, subMesh.m_numIndices) > UINT16_MAX + 1)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<uint16_t> MeshOptimizer::ConvertToShortIndices(const std::vector<int>& indices)
+	{
+		std::vector<uint16_t> shortIndices(indices.size());
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			shortIndices[i] = (uint16_t)indices[i];
+		}
+		return shortIndices;
+	}
+
+	void MeshOptimizer::OptimizeVertexCache(int* pIndices, uint32_t indexCount, uint32_t vertexCount)
+	{
+		uint32_t triangleCount = indexCount / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		// Triangle adjacency of each vertex, the first remainingTriangles entries are the ones not emitted yet
+		std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+		for (uint32_t i = 0; i < triangleCount * 3; ++i)
+		{
+			remainingTriangles[pIndices[i]]++;
+		}
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remainingTriangles[i];
+		}
+
+		std::vector<uint32_t> adjacency(triangleCount * 3);
+		std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (uint32_t i = 0; i < triangleCount * 3; ++i)
+		{
+			adjacency[adjacencyFill[pIndices[i]]++] = i / 3;
+		}
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			vertexScores[i] = ComputeVertexScore(-1, remainingTriangles[i]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<uint8_t> isEmitted(triangleCount, 0);
+		for (uint32_t i = 0; i < triangleCount; ++i)
+		{
+			triangleScores[i] = vertexScores[pIndices[i * 3]] + vertexScores[pIndices[i * 3 + 1]] + vertexScores[pIndices[i * 3 + 2]];
+		}
+
+		std::vector<int> optimizedIndices;
+		optimizedIndices.reserve(triangleCount * 3);
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> nextCache;
+		cache.reserve(OPTIMIZATION_CACHE_SIZE + 3);
+		nextCache.reserve(OPTIMIZATION_CACHE_SIZE + 3);
+
+		uint32_t scanCursor = 0;
+		int bestTriangle = (int)(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+
+		for (uint32_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+		{
+			// Cache ran out of candidates, continue with the next triangle in original order instead of a full scan to keep this linear
+			if (bestTriangle < 0)
+			{
+				while (isEmitted[scanCursor])
+				{
+					scanCursor++;
+				}
+				bestTriangle = (int)scanCursor;
+			}
+
+			const int* pTriangle = pIndices + (size_t)bestTriangle * 3;
+			isEmitted[bestTriangle] = 1;
+
+			nextCache.clear();
+			for (uint32_t i = 0; i < 3; ++i)
+			{
+				uint32_t vertex = (uint32_t)pTriangle[i];
+				optimizedIndices.push_back((int)vertex);
+				if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+				{
+					nextCache.push_back(vertex);
+				}
+
+				// Swap-remove emitted triangle from active adjacency
+				uint32_t* pAdjacency = adjacency.data() + adjacencyOffsets[vertex];
+				uint32_t* pLast = pAdjacency + remainingTriangles[vertex] - 1;
+				*std::find(pAdjacency, pLast, (uint32_t)bestTriangle) = *pLast;
+				remainingTriangles[vertex]--;
+			}
+
+			for (uint32_t vertex : cache)
+			{
+				if (vertex != (uint32_t)pTriangle[0] && vertex != (uint32_t)pTriangle[1] && vertex != (uint32_t)pTriangle[2])
+				{
+					nextCache.push_back(vertex);
+				}
+			}
+			cache.swap(nextCache);
+
+			// Update scores of vertices that moved in or out of cache, and the triangles they belong to
+			bestTriangle = -1;
+			float bestScore = -FLT_MAX;
+
+			for (uint32_t i = 0; i < cache.size(); ++i)
+			{
+				uint32_t vertex = cache[i];
+				cachePositions[vertex] = i < OPTIMIZATION_CACHE_SIZE ? (int)i : -1;
+
+				float newScore = ComputeVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+				float scoreDelta = newScore - vertexScores[vertex];
+				vertexScores[vertex] = newScore;
+
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					uint32_t triangle = adjacency[adjacencyOffsets[vertex] + j];
+					triangleScores[triangle] += scoreDelta;
+				}
+			}
+
+			for (uint32_t i = 0; i < cache.size() && i < OPTIMIZATION_CACHE_SIZE; ++i)
+			{
+				uint32_t vertex = cache[i];
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					uint32_t triangle = adjacency[adjacencyOffsets[vertex] + j];
+					if (triangleScores[triangle] > bestScore)
+					{
+						bestScore = triangleScores[triangle];
+						bestTriangle = (int)triangle;
+					}
+				}
+			}
+
+			if (cache.size() > OPTIMIZATION_CACHE_SIZE)
+			{
+				cache.resize(OPTIMIZATION_CACHE_SIZE);
+			}
+		}
+
+		std::copy(optimizedIndices.begin(), optimizedIndices.end(), pIndices);
+	}
+
+	void MeshOptimizer::OptimizeOverdraw(int* pIndices, uint32_t indexCount, const float* pVertices, uint32_t vertexCount)
+	{
+		uint32_t triangleCount = indexCount / 3;
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> triangleMisses;
+		SimulateVertexCache(pIndices, triangleCount * 3, vertexCount, triangleMisses);
+
+		// Triangles that miss on all vertices start a new cache run, each run is split further where its cache efficiency allows
+		std::vector<uint32_t> clusterStarts;
+		std::vector<uint32_t> insertTimes(vertexCount, 0);
+		uint32_t time = ANALYSIS_CACHE_SIZE + 1;
+		uint32_t runStart = 0;
+		while (runStart < triangleCount)
+		{
+			uint32_t runEnd = runStart + 1;
+			uint32_t runMisses = triangleMisses[runStart];
+			while (runEnd < triangleCount && triangleMisses[runEnd] != 3)
+			{
+				runMisses += triangleMisses[runEnd];
+				runEnd++;
+			}
+
+			float runACMR = (float)runMisses / (runEnd - runStart);
+
+			// Clusters are measured with a cold cache, since they will not follow each other once sorted
+			uint32_t clusterStart = runStart;
+			uint32_t clusterMisses = 0;
+			time += ANALYSIS_CACHE_SIZE + 1;
+			clusterStarts.push_back(runStart);
+			for (uint32_t i = runStart; i < runEnd - 1; ++i)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					uint32_t vertex = (uint32_t)pIndices[i * 3 + k];
+					if (time - insertTimes[vertex] > ANALYSIS_CACHE_SIZE)
+					{
+						insertTimes[vertex] = time++;
+						clusterMisses++;
+					}
+				}
+
+				if ((float)clusterMisses / (i + 1 - clusterStart) <= runACMR * OVERDRAW_CLUSTER_THRESHOLD)
+				{
+					clusterStart = i + 1;
+					clusterMisses = 0;
+					time += ANALYSIS_CACHE_SIZE + 1;
+					clusterStarts.push_back(clusterStart);
+				}
+			}
+
+			runStart = runEnd;
+		}
+
+		if (clusterStarts.size() < 2)
+		{
+			return;
+		}
+
+		auto getPosition = [pVertices](int index)
+		{
+			const float* pPosition = pVertices + (size_t)index * ELEMENT_STRIDE;
+			return Vector3(pPosition[0], pPosition[1], pPosition[2]);
+		};
+
+		// Area weighted centroid and normal of mesh and clusters
+		std::vector<Vector3> clusterCentroids(clusterStarts.size(), Vector3(0));
+		std::vector<Vector3> clusterNormals(clusterStarts.size(), Vector3(0));
+		Vector3 meshCentroid(0);
+		float meshArea = 0;
+
+		for (uint32_t c = 0; c < clusterStarts.size(); ++c)
+		{
+			uint32_t clusterEnd = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+			float clusterArea = 0;
+
+			for (uint32_t i = clusterStarts[c]; i < clusterEnd; ++i)
+			{
+				Vector3 p0 = getPosition(pIndices[i * 3]);
+				Vector3 p1 = getPosition(pIndices[i * 3 + 1]);
+				Vector3 p2 = getPosition(pIndices[i * 3 + 2]);
+
+				Vector3 normal = glm::cross(p1 - p0, p2 - p0);
+				float area = glm::length(normal);
+				Vector3 centroid = (p0 + p1 + p2) * (1.0f / 3.0f);
+
+				clusterCentroids[c] += centroid * area;
+				clusterNormals[c] += normal;
+				clusterArea += area;
+			}
+
+			meshCentroid += clusterCentroids[c];
+			meshArea += clusterArea;
+			clusterCentroids[c] *= clusterArea > 0 ? 1.0f / clusterArea : 0;
+		}
+		meshCentroid *= meshArea > 0 ? 1.0f / meshArea : 0;
+
+		// Clusters facing away from mesh center are most likely to occlude the rest, so they are drawn first
+		std::vector<float> clusterSortKeys(clusterStarts.size());
+		for (uint32_t c = 0; c < clusterStarts.size(); ++c)
+		{
+			float normalLength = glm::length(clusterNormals[c]);
+			clusterSortKeys[c] = normalLength > 0 ? glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / normalLength) : 0;
+		}
+
+		std::vector<uint32_t> clusterOrder(clusterStarts.size());
+		for (uint32_t c = 0; c < clusterOrder.size(); ++c)
+		{
+			clusterOrder[c] = c;
+		}
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&clusterSortKeys](uint32_t lhs, uint32_t rhs)
+			{
+				return clusterSortKeys[lhs] > clusterSortKeys[rhs];
+			});
+
+		std::vector<int> sortedIndices;
+		sortedIndices.reserve(triangleCount * 3);
+		for (uint32_t c : clusterOrder)
+		{
+			uint32_t clusterEnd = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+			sortedIndices.insert(sortedIndices.end(), pIndices + (size_t)clusterStarts[c] * 3, pIndices + (size_t)clusterEnd * 3);
+		}
+
+		std::copy(sortedIndices.begin(), sortedIndices.end(), pIndices);
+	}
+
+	void MeshOptimizer::OptimizeVertexFetch(float* pVertices, uint32_t vertexCount, int* pIndices, uint32_t indexCount)
+	{
+		std::vector<int> remap(vertexCount, -1);
+		int nextVertex = 0;
+
+		for (uint32_t i = 0; i < indexCount; ++i)
+		{
+			if (remap[pIndices[i]] < 0)
+			{
+				remap[pIndices[i]] = nextVertex++;
+			}
+			pIndices[i] = remap[pIndices[i]];
+		}
+
+		// Unreferenced vertices are kept after referenced ones
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			if (remap[i] < 0)
+			{
+				remap[i] = nextVertex++;
+			}
+		}
+
+		std::vector<float> reorderedVertices((size_t)vertexCount * ELEMENT_STRIDE);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			std::copy(pVertices + (size_t)i * ELEMENT_STRIDE, pVertices + (size_t)(i + 1) * ELEMENT_STRIDE, reorderedVertices.data() + (size_t)remap[i] * ELEMENT_STRIDE);
+		}
+
+		std::copy(reorderedVertices.begin(), reorderedVertices.end(), pVertices);
+	}
+
+	void MeshOptimizer::BuildMeshlets(const std::vector<float>& interleavedVertices, const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes, std::vector<Meshlet>& outMeshlets)
+	{
+		outMeshlets.clear();
+
+		uint32_t totalVertexCount = (uint32_t)(interleavedVertices.size() / ELEMENT_STRIDE);
+
+		// Marks vertices already counted by current meshlet
+		std::vector<uint32_t> vertexMarks;
+		uint32_t currentMark = 0;
+
+		for (uint32_t subMeshIndex = 0; subMeshIndex < subMeshes.size(); ++subMeshIndex)
+		{
+			auto& subMesh = subMeshes[subMeshIndex];
+			if ((size_t)subMesh.m_baseIndex + subMesh.m_numIndices > indices.size())
+			{
+				continue;
+			}
+
+			const int* pIndices = indices.data() + subMesh.m_baseIndex;
+			uint32_t vertexCount = GetReferencedVertexCount(pIndices, subMesh.m_numIndices);
+			if ((uint64_t)subMesh.m_baseVertex + vertexCount > totalVertexCount)
+			{
+				continue;
+			}
+
+			const float* pVertices = interleavedVertices.data() + (size_t)subMesh.m_baseVertex * ELEMENT_STRIDE;
+			vertexMarks.assign(vertexCount, 0);
+
+			Meshlet meshlet{};
+			meshlet.m_subMeshIndex = subMeshIndex;
+			meshlet.m_baseIndex = subMesh.m_baseIndex;
+			uint32_t meshletVertexCount = 0;
+			currentMark++;
+
+			for (uint32_t i = 0; i < subMesh.m_numIndices / 3; ++i)
+			{
+				const int* pTriangle = pIndices + (size_t)i * 3;
+
+				uint32_t newVertexCount = 0;
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					bool isDuplicate = (k > 0 && pTriangle[k] == pTriangle[0]) || (k > 1 && pTriangle[k] == pTriangle[1]);
+					if (vertexMarks[pTriangle[k]] != currentMark && !isDuplicate)
+					{
+						newVertexCount++;
+					}
+				}
+
+				if (meshletVertexCount + newVertexCount > MAX_MESHLET_VERTICES || meshlet.m_numIndices / 3 + 1 > MAX_MESHLET_TRIANGLES)
+				{
+					ComputeMeshletBounds(pVertices, indices.data() + meshlet.m_baseIndex, meshlet);
+					outMeshlets.emplace_back(meshlet);
+
+					meshlet.m_baseIndex += meshlet.m_numIndices;
+					meshlet.m_numIndices = 0;
+					meshletVertexCount = 0;
+					currentMark++;
+				}
+
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					if (vertexMarks[pTriangle[k]] != currentMark)
+					{
+						vertexMarks[pTriangle[k]] = currentMark;
+						meshletVertexCount++;
+					}
+				}
+				meshlet.m_numIndices += 3;
+			}
+
+			if (meshlet.m_numIndices > 0)
+			{
+				ComputeMeshletBounds(pVertices, indices.data() + meshlet.m_baseIndex, meshlet);
+				outMeshlets.emplace_back(meshlet);
+			}
+		}
+	}
+
+	void MeshOptimizer::SimulateVertexCache(const int* pIndices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& outTriangleMisses)
+	{
+		// A vertex is in the FIFO cache if less than cache size misses happened since it was inserted
+		std::vector<uint32_t> insertTimes(vertexCount, 0);
+		uint32_t time = ANALYSIS_CACHE_SIZE + 1;
+
+		outTriangleMisses.assign(indexCount / 3, 0);
+		for (uint32_t i = 0; i < indexCount / 3 * 3; ++i)
+		{
+			uint32_t vertex = (uint32_t)pIndices[i];
+			if (time - insertTimes[vertex] > ANALYSIS_CACHE_SIZE)
+			{
+				insertTimes[vertex] = time++;
+				outTriangleMisses[i / 3]++;
+			}
+		}
+	}
+
+	float MeshOptimizer::MeasureOverdraw(const float* pVertices, const int* pIndices, uint32_t indexCount)
+	{
+		uint32_t vertexCount = GetReferencedVertexCount(pIndices, indexCount);
+		if (vertexCount == 0)
+		{
+			return 0;
+		}
+
+		Vector3 boundsMin(FLT_MAX);
+		Vector3 boundsMax(-FLT_MAX);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			Vector3 position(pVertices[(size_t)i * ELEMENT_STRIDE], pVertices[(size_t)i * ELEMENT_STRIDE + 1], pVertices[(size_t)i * ELEMENT_STRIDE + 2]);
+			boundsMin = glm::min(boundsMin, position);
+			boundsMax = glm::max(boundsMax, position);
+		}
+
+		Vector3 extent = boundsMax - boundsMin;
+		float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+		if (maxExtent <= 0)
+		{
+			return 0;
+		}
+		float scale = (OVERDRAW_GRID_SIZE - 1) / maxExtent;
+
+		std::vector<float> depthBuffer(OVERDRAW_GRID_SIZE * OVERDRAW_GRID_SIZE);
+		uint64_t shadedPixels = 0;
+		uint64_t coveredPixels = 0;
+
+		// Orthographic views along both directions of each axis with back face culling, triangles are drawn in index order
+		for (uint32_t view = 0; view < 6; ++view)
+		{
+			uint32_t axis = view / 2;
+			float direction = view % 2 == 0 ? 1.0f : -1.0f;
+			uint32_t axisU = (axis + 1) % 3;
+			uint32_t axisV = (axis + 2) % 3;
+
+			std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+
+			for (uint32_t t = 0; t < indexCount / 3; ++t)
+			{
+				float u[3], v[3], z[3];
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					const float* pPosition = pVertices + (size_t)pIndices[t * 3 + k] * ELEMENT_STRIDE;
+					u[k] = (pPosition[axisU] - boundsMin[axisU]) * scale;
+					v[k] = (pPosition[axisV] - boundsMin[axisV]) * scale;
+					z[k] = (pPosition[axis] - boundsMin[axis]) * direction;
+				}
+
+				// Counter-clockwise front faces, positive area means the face normal points along view direction
+				float area = (u[1] - u[0]) * (v[2] - v[0]) - (u[2] - u[0]) * (v[1] - v[0]);
+				if (area * direction >= 0)
+				{
+					continue;
+				}
+
+				int minX = std::max(0, (int)std::floor(std::min(u[0], std::min(u[1], u[2]))));
+				int maxX = std::min((int)OVERDRAW_GRID_SIZE - 1, (int)std::ceil(std::max(u[0], std::max(u[1], u[2]))));
+				int minY = std::max(0, (int)std::floor(std::min(v[0], std::min(v[1], v[2]))));
+				int maxY = std::min((int)OVERDRAW_GRID_SIZE - 1, (int)std::ceil(std::max(v[0], std::max(v[1], v[2]))));
+
+				float inverseArea = 1.0f / area;
+
+				for (int y = minY; y <= maxY; ++y)
+				{
+					for (int x = minX; x <= maxX; ++x)
+					{
+						float px = x + 0.5f;
+						float py = y + 0.5f;
+
+						float w0 = ((u[2] - u[1]) * (py - v[1]) - (v[2] - v[1]) * (px - u[1])) * inverseArea;
+						float w1 = ((u[0] - u[2]) * (py - v[2]) - (v[0] - v[2]) * (px - u[2])) * inverseArea;
+						float w2 = 1.0f - w0 - w1;
+
+						if (w0 < 0 || w1 < 0 || w2 < 0)
+						{
+							continue;
+						}
+
+						float depth = w0 * z[0] + w1 * z[1] + w2 * z[2];
+						float& storedDepth = depthBuffer[(size_t)y * OVERDRAW_GRID_SIZE + x];
+						if (depth < storedDepth)
+						{
+							if (storedDepth == FLT_MAX)
+							{
+								coveredPixels++;
+							}
+							storedDepth = depth;
+							shadedPixels++;
+						}
+					}
+				}
+			}
+		}
+
+		return coveredPixels > 0 ? (float)shadedPixels / coveredPixels : 0;
+	}
+
+	void MeshOptimizer::ComputeMeshletBounds(const float* pVertices, const int* pIndices, Meshlet& meshlet)
+	{
+		auto getPosition = [pVertices](int index)
+		{
+			const float* pPosition = pVertices + (size_t)index * ELEMENT_STRIDE;
+			return Vector3(pPosition[0], pPosition[1], pPosition[2]);
+		};
+
+		// Sphere around box center is not minimal, but good enough for culling
+		Vector3 boundsMin(FLT_MAX);
+		Vector3 boundsMax(-FLT_MAX);
+		for (uint32_t i = 0; i < meshlet.m_numIndices; ++i)
+		{
+			Vector3 position = getPosition(pIndices[i]);
+			boundsMin = glm::min(boundsMin, position);
+			boundsMax = glm::max(boundsMax, position);
+		}
+
+		meshlet.m_center = (boundsMin + boundsMax) * 0.5f;
+		meshlet.m_radius = 0;
+		for (uint32_t i = 0; i < meshlet.m_numIndices; ++i)
+		{
+			meshlet.m_radius = std::max(meshlet.m_radius, glm::length(getPosition(pIndices[i]) - meshlet.m_center));
+		}
+
+		std::vector<Vector3> normals;
+		normals.reserve(meshlet.m_numIndices / 3);
+		Vector3 normalSum(0);
+		for (uint32_t i = 0; i + 2 < meshlet.m_numIndices; i += 3)
+		{
+			Vector3 p0 = getPosition(pIndices[i]);
+			Vector3 normal = glm::cross(getPosition(pIndices[i + 1]) - p0, getPosition(pIndices[i + 2]) - p0);
+			float length = glm::length(normal);
+			if (length > 0)
+			{
+				normals.emplace_back(normal / length);
+				normalSum += normals.back();
+			}
+		}
+
+		meshlet.m_coneAxis = Vector3(0, 0, 1);
+		meshlet.m_coneCutoff = 1.0f;
+
+		float axisLength = glm::length(normalSum);
+		if (axisLength <= 0)
+		{
+			return;
+		}
+		meshlet.m_coneAxis = normalSum / axisLength;
+
+		float minDot = 1.0f;
+		for (auto& normal : normals)
+		{
+			minDot = std::min(minDot, glm::dot(normal, meshlet.m_coneAxis));
+		}
+
+		// Cones close to a hemisphere would almost never pass the test
+		if (minDot > 0.1f)
+		{
+			meshlet.m_coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include "Mesh.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace Engine
+{
+	struct MeshStatistics
+	{
+		float acmr;		// Average post-transform cache misses per triangle, 0.5 is the lower bound for regular grids, 3 is the worst case
+		float atvr;		// Average transformed vertices per referenced vertex, 1 is optimal
+		float overdraw; // Shaded pixels per covered pixel averaged over axis-aligned views, 1 is optimal
+	};
+
+	// Cook time mesh processing that reorders triangles and vertices for GPU efficiency, rendering result is unchanged
+	// Operates on data in VertexBufferCreateInfo float interleaved layout, submeshes are processed independently and keep their ranges
+	class MeshOptimizer
+	{
+	public:
+		static void OptimizeMesh(std::vector<float>& interleavedVertices, std::vector<int>& indices, const std::vector<SubMesh>& subMeshes);
+		static MeshStatistics AnalyzeMesh(const std::vector<float>& interleavedVertices, const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes);
+
+		// 16-bit indices are usable if every submesh addresses less than 65536 vertices from its base vertex
+		static bool CanUseShortIndices(const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes);
+		static std::vector<uint16_t> ConvertToShortIndices(const std::vector<int>& indices);
+
+		// Partitions each submesh into meshlets in current triangle order, so meshlet index ranges stay contiguous
+		static void BuildMeshlets(const std::vector<float>& interleavedVertices, const std::vector<int>& indices, const std::vector<SubMesh>& subMeshes, std::vector<Meshlet>& outMeshlets);
+
+		// Per submesh stages, indices are relative to vertex data passed in
+		static void OptimizeVertexCache(int* pIndices, uint32_t indexCount, uint32_t vertexCount); // Forsyth's linear-speed algorithm
+		static void OptimizeOverdraw(int* pIndices, uint32_t indexCount, const float* pVertices, uint32_t vertexCount); // Splits cache-optimized order into clusters and sorts them front to back
+		static void OptimizeVertexFetch(float* pVertices, uint32_t vertexCount, int* pIndices, uint32_t indexCount); // Orders vertices by first use
+
+	private:
+		static void SimulateVertexCache(const int* pIndices, uint32_t indexCount, uint32_t vertexCount, std::vector<uint32_t>& outTriangleMisses);
+		static float MeasureOverdraw(const float* pVertices, const int* pIndices, uint32_t indexCount);
+		static void ComputeMeshletBounds(const float* pVertices, const int* pIndices, Meshlet& meshlet);
+
+	public:
+		static const uint32_t ELEMENT_STRIDE = VertexBufferCreateInfo::interleavedStride / sizeof(float);
+		static const uint32_t OPTIMIZATION_CACHE_SIZE = 32; // Modeled LRU cache of Forsyth scoring
+		static const uint32_t ANALYSIS_CACHE_SIZE = 16; // Modeled FIFO cache, conservative for current hardware
+		static const uint32_t OVERDRAW_GRID_SIZE = 256; // Resolution of software rasterizer used for overdraw measurement
+		static const uint32_t MAX_MESHLET_VERTICES = 64;
+		static const uint32_t MAX_MESHLET_TRIANGLES = 124;
+	};
+}
\ No newline at end of file
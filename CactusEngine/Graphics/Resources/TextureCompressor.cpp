@@ -0,0 +1,634 @@
+#include "TextureCompressor.h"
+#include "KTX2File.h"
+#include "BuiltInResourcesPath.h"
+#include "JobSystem.h"
+#include "LogUtility.h"
+#include "FileUtility.h"
+
+#include <stb/stb_image.h>
+
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+namespace Engine
+{
+	static const uint32_t BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	static float SRGBToLinear(uint8_t value)
+	{
+		static float table[256];
+		static bool isTableReady = [&]()
+		{
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				float c = i / 255.0f;
+				table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			return true;
+		}();
+		(void)isTableReady;
+
+		return table[value];
+	}
+
+	static uint8_t LinearToSRGB(float value)
+	{
+		value = std::clamp(value, 0.0f, 1.0f);
+		float c = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+		return (uint8_t)(c * 255.0f + 0.5f);
+	}
+
+	static uint8_t ToUNorm8(float value)
+	{
+		return (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	// Finds mean and principal axis of the texel cloud with power iteration, only the first dimensionCount channels are considered
+	static void ComputePrincipalAxis(const uint8_t texels[16][4], uint32_t dimensionCount, float outMean[4], float outAxis[4])
+	{
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			outMean[c] = 0;
+			outAxis[c] = 0;
+		}
+
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			for (uint32_t c = 0; c < dimensionCount; ++c)
+			{
+				outMean[c] += texels[i][c];
+			}
+		}
+		for (uint32_t c = 0; c < dimensionCount; ++c)
+		{
+			outMean[c] /= 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			float delta[4] = {};
+			for (uint32_t c = 0; c < dimensionCount; ++c)
+			{
+				delta[c] = texels[i][c] - outMean[c];
+			}
+			for (uint32_t row = 0; row < dimensionCount; ++row)
+			{
+				for (uint32_t col = 0; col < dimensionCount; ++col)
+				{
+					covariance[row][col] += delta[row] * delta[col];
+				}
+			}
+		}
+
+		float axis[4] = { 1, 1, 1, 1 };
+		for (uint32_t iteration = 0; iteration < 8; ++iteration)
+		{
+			float nextAxis[4] = {};
+			float length = 0;
+			for (uint32_t row = 0; row < dimensionCount; ++row)
+			{
+				for (uint32_t col = 0; col < dimensionCount; ++col)
+				{
+					nextAxis[row] += covariance[row][col] * axis[col];
+				}
+				length += nextAxis[row] * nextAxis[row];
+			}
+
+			if (length < 1e-12f)
+			{
+				// Uniform block, any axis works
+				return;
+			}
+
+			length = std::sqrt(length);
+			for (uint32_t c = 0; c < dimensionCount; ++c)
+			{
+				axis[c] = nextAxis[c] / length;
+			}
+		}
+
+		for (uint32_t c = 0; c < dimensionCount; ++c)
+		{
+			outAxis[c] = axis[c];
+		}
+	}
+
+	// Endpoints are the texel cloud extents along the principal axis
+	static void ComputeEndpoints(const uint8_t texels[16][4], uint32_t dimensionCount, float outEndpoint0[4], float outEndpoint1[4])
+	{
+		float mean[4], axis[4];
+		ComputePrincipalAxis(texels, dimensionCount, mean, axis);
+
+		float minProjection = 0, maxProjection = 0;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			float projection = 0;
+			for (uint32_t c = 0; c < dimensionCount; ++c)
+			{
+				projection += (texels[i][c] - mean[c]) * axis[c];
+			}
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			outEndpoint0[c] = std::clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+			outEndpoint1[c] = std::clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+		}
+	}
+
+	static uint32_t FindClosestColor(const uint8_t texel[4], const int32_t palette[][4], uint32_t paletteSize, uint32_t channelCount, int32_t* pOutError = nullptr)
+	{
+		uint32_t bestIndex = 0;
+		int32_t bestError = INT32_MAX;
+		for (uint32_t i = 0; i < paletteSize; ++i)
+		{
+			int32_t error = 0;
+			for (uint32_t c = 0; c < channelCount; ++c)
+			{
+				int32_t delta = (int32_t)texel[c] - palette[i][c];
+				error += delta * delta;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				bestIndex = i;
+			}
+		}
+
+		if (pOutError != nullptr)
+		{
+			*pOutError = bestError;
+		}
+		return bestIndex;
+	}
+
+	// Least squares fit of both endpoints to the texels, given the interpolation weight each texel was assigned to
+	static bool RefineEndpoints(const uint8_t texels[16][4], const float weights[16], uint32_t dimensionCount, float outEndpoint0[4], float outEndpoint1[4])
+	{
+		float a00 = 0, a01 = 0, a11 = 0;
+		float b0[4] = {}, b1[4] = {};
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			float w1 = weights[i], w0 = 1.0f - weights[i];
+			a00 += w0 * w0;
+			a01 += w0 * w1;
+			a11 += w1 * w1;
+			for (uint32_t c = 0; c < dimensionCount; ++c)
+			{
+				b0[c] += w0 * texels[i][c];
+				b1[c] += w1 * texels[i][c];
+			}
+		}
+
+		float determinant = a00 * a11 - a01 * a01;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (uint32_t c = 0; c < dimensionCount; ++c)
+		{
+			outEndpoint0[c] = std::clamp((a11 * b0[c] - a01 * b1[c]) / determinant, 0.0f, 255.0f);
+			outEndpoint1[c] = std::clamp((a00 * b1[c] - a01 * b0[c]) / determinant, 0.0f, 255.0f);
+		}
+		return true;
+	}
+
+	std::string TextureCompressor::GetCookedFilePath(const char* sourcePath, ETextureContent content)
+	{
+		// Content type is part of the name since one image can be cooked into different formats
+		uint64_t hash = FileUtility::HashFNV1a64(sourcePath, strlen(sourcePath));
+
+		char fileName[48];
+		snprintf(fileName, sizeof(fileName), "%016llx_%u.ktx2", (unsigned long long)hash, (uint32_t)content);
+		return (std::filesystem::path(BuiltInResourcesPath::TEXTURE_CACHE_DIRECTORY) / fileName).string();
+	}
+
+	bool TextureCompressor::IsCookedFileUpToDate(const char* sourcePath, const char* cookedPath)
+	{
+		std::error_code errorCode;
+		auto cookedTime = std::filesystem::last_write_time(cookedPath, errorCode);
+		if (errorCode)
+		{
+			return false;
+		}
+
+		auto sourceTime = std::filesystem::last_write_time(sourcePath, errorCode);
+		if (errorCode)
+		{
+			// Cooked file can still be used if source asset is not shipped
+			return true;
+		}
+
+		return cookedTime >= sourceTime;
+	}
+
+	bool TextureCompressor::CookTexture(const char* sourcePath, const char* cookedPath, ETextureContent content)
+	{
+		DEBUG_ASSERT_CE(content != ETextureContent::Uncompressed);
+
+		int32_t texWidth, texHeight, texChannels;
+		stbi_uc* imageData = stbi_load(sourcePath, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+
+		if (!imageData)
+		{
+			return false;
+		}
+
+		std::vector<ImageLevel> levels(1);
+		levels[0].width = texWidth;
+		levels[0].height = texHeight;
+		levels[0].pixels.assign(imageData, imageData + (size_t)texWidth * texHeight * 4);
+
+		stbi_image_free(imageData);
+
+		ETextureFormat format = SelectFormat(levels[0], content);
+		GenerateMipChain(levels, content);
+
+		std::vector<std::vector<uint8_t>> compressedLevels(levels.size());
+		for (size_t i = 0; i < levels.size(); ++i)
+		{
+			CompressLevel(levels[i], format, compressedLevels[i]);
+		}
+
+		return KTX2File::Write(cookedPath, format, texWidth, texHeight, compressedLevels);
+	}
+
+	ETextureFormat TextureCompressor::SelectFormat(const ImageLevel& baseLevel, ETextureContent content)
+	{
+		switch (content)
+		{
+		case ETextureContent::Color:
+		{
+			// BC1 has no usable alpha in the formats exposed, so anything translucent takes the larger BC7 blocks
+			for (size_t i = 3; i < baseLevel.pixels.size(); i += 4)
+			{
+				if (baseLevel.pixels[i] != 255)
+				{
+					return ETextureFormat::BC7_SRGB;
+				}
+			}
+			return ETextureFormat::BC1_RGB_SRGB;
+		}
+
+		case ETextureContent::NormalMap:
+			return ETextureFormat::BC5_UNORM;
+
+		case ETextureContent::SingleChannel:
+			return ETextureFormat::BC4_UNORM;
+
+		default:
+			LOG_ERROR("Unhandled texture content type: " + std::to_string((uint32_t)content));
+			return ETextureFormat::BC7_SRGB;
+		}
+	}
+
+	void TextureCompressor::GenerateMipChain(std::vector<ImageLevel>& levels, ETextureContent content)
+	{
+		// Box filtered down to 1x1, same level count as runtime mipmap generation
+		while (levels.back().width > 1 || levels.back().height > 1)
+		{
+			const ImageLevel& source = levels.back();
+
+			ImageLevel next{};
+			next.width = std::max<uint32_t>(source.width / 2, 1);
+			next.height = std::max<uint32_t>(source.height / 2, 1);
+			next.pixels.resize((size_t)next.width * next.height * 4);
+
+			for (uint32_t y = 0; y < next.height; ++y)
+			{
+				for (uint32_t x = 0; x < next.width; ++x)
+				{
+					float sum[4] = {};
+					for (uint32_t sampleY = 0; sampleY < 2; ++sampleY)
+					{
+						for (uint32_t sampleX = 0; sampleX < 2; ++sampleX)
+						{
+							uint32_t sourceX = std::min(x * 2 + sampleX, source.width - 1);
+							uint32_t sourceY = std::min(y * 2 + sampleY, source.height - 1);
+							const uint8_t* pTexel = &source.pixels[((size_t)sourceY * source.width + sourceX) * 4];
+
+							for (uint32_t c = 0; c < 4; ++c)
+							{
+								if (content == ETextureContent::Color && c < 3)
+								{
+									sum[c] += SRGBToLinear(pTexel[c]); // Averaging gamma encoded values would darken the mips
+								}
+								else if (content == ETextureContent::NormalMap && c < 3)
+								{
+									sum[c] += pTexel[c] / 127.5f - 1.0f;
+								}
+								else
+								{
+									sum[c] += pTexel[c] / 255.0f;
+								}
+							}
+						}
+					}
+
+					uint8_t* pOutput = &next.pixels[((size_t)y * next.width + x) * 4];
+
+					if (content == ETextureContent::NormalMap)
+					{
+						float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+						length = length > 1e-6f ? length : 1.0f;
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							pOutput[c] = ToUNorm8(sum[c] / length * 0.5f + 0.5f);
+						}
+					}
+					else
+					{
+						for (uint32_t c = 0; c < 3; ++c)
+						{
+							pOutput[c] = content == ETextureContent::Color ? LinearToSRGB(sum[c] * 0.25f) : ToUNorm8(sum[c] * 0.25f);
+						}
+					}
+					pOutput[3] = ToUNorm8(sum[3] * 0.25f);
+				}
+			}
+
+			levels.emplace_back(std::move(next));
+		}
+	}
+
+	void TextureCompressor::CompressLevel(const ImageLevel& level, ETextureFormat format, std::vector<uint8_t>& outBlocks)
+	{
+		uint32_t blockCountX = (level.width + 3) / 4;
+		uint32_t blockCountY = (level.height + 3) / 4;
+		uint32_t blockSize = (format == ETextureFormat::BC1_RGB_SRGB || format == ETextureFormat::BC1_RGB_UNORM || format == ETextureFormat::BC4_UNORM) ? 8 : 16;
+
+		outBlocks.resize((size_t)blockCountX * blockCountY * blockSize);
+
+		JobSystem::ParallelFor(blockCountY, 4, [&](uint32_t blockY)
+			{
+				uint8_t texels[16][4];
+				for (uint32_t blockX = 0; blockX < blockCountX; ++blockX)
+				{
+					FetchBlock(level, blockX, blockY, texels);
+					uint8_t* pOutput = &outBlocks[((size_t)blockY * blockCountX + blockX) * blockSize];
+
+					switch (format)
+					{
+					case ETextureFormat::BC1_RGB_UNORM:
+					case ETextureFormat::BC1_RGB_SRGB:
+						EncodeBC1(texels, pOutput);
+						break;
+
+					case ETextureFormat::BC4_UNORM:
+						EncodeBC4(texels, 0, pOutput);
+						break;
+
+					case ETextureFormat::BC5_UNORM:
+						EncodeBC4(texels, 0, pOutput);
+						EncodeBC4(texels, 1, pOutput + 8);
+						break;
+
+					default:
+						EncodeBC7Mode6(texels, pOutput);
+						break;
+					}
+				}
+			});
+	}
+
+	void TextureCompressor::FetchBlock(const ImageLevel& level, uint32_t blockX, uint32_t blockY, uint8_t outTexels[16][4])
+	{
+		// Edge texels are repeated for partial blocks
+		for (uint32_t y = 0; y < 4; ++y)
+		{
+			for (uint32_t x = 0; x < 4; ++x)
+			{
+				uint32_t sourceX = std::min(blockX * 4 + x, level.width - 1);
+				uint32_t sourceY = std::min(blockY * 4 + y, level.height - 1);
+				memcpy(outTexels[y * 4 + x], &level.pixels[((size_t)sourceY * level.width + sourceX) * 4], 4);
+			}
+		}
+	}
+
+	void TextureCompressor::EncodeBC1(const uint8_t texels[16][4], uint8_t* pOutput)
+	{
+		static const float PALETTE_WEIGHTS[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+		float endpoints[2][4];
+		ComputeEndpoints(texels, 3, endpoints[0], endpoints[1]);
+
+		uint16_t bestColors[2] = {};
+		uint32_t bestIndices = 0;
+		int32_t bestError = INT32_MAX;
+
+		// Second pass refits the endpoints to the indices found by the first
+		for (uint32_t pass = 0; pass < 2; ++pass)
+		{
+			uint16_t colors[2];
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				uint32_t r = (uint32_t)(endpoints[i][0] * 31.0f / 255.0f + 0.5f);
+				uint32_t g = (uint32_t)(endpoints[i][1] * 63.0f / 255.0f + 0.5f);
+				uint32_t b = (uint32_t)(endpoints[i][2] * 31.0f / 255.0f + 0.5f);
+				colors[i] = (uint16_t)((r << 11) | (g << 5) | b);
+			}
+
+			// Four color mode is selected by color0 > color1
+			if (colors[0] < colors[1])
+			{
+				std::swap(colors[0], colors[1]);
+			}
+
+			int32_t palette[4][4] = {};
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				uint32_t r = (colors[i] >> 11) & 31, g = (colors[i] >> 5) & 63, b = colors[i] & 31;
+				palette[i][0] = (r << 3) | (r >> 2);
+				palette[i][1] = (g << 2) | (g >> 4);
+				palette[i][2] = (b << 3) | (b >> 2);
+			}
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			uint32_t indices = 0;
+			int32_t totalError = 0;
+			float weights[16];
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				int32_t error = 0;
+				uint32_t index = FindClosestColor(texels[i], palette, colors[0] != colors[1] ? 4 : 1, 3, &error);
+				indices |= index << (i * 2);
+				totalError += error;
+				weights[i] = PALETTE_WEIGHTS[index];
+			}
+
+			if (totalError < bestError)
+			{
+				bestError = totalError;
+				bestColors[0] = colors[0];
+				bestColors[1] = colors[1];
+				bestIndices = indices;
+			}
+
+			if (colors[0] == colors[1] || !RefineEndpoints(texels, weights, 3, endpoints[0], endpoints[1]))
+			{
+				break;
+			}
+		}
+
+		memcpy(pOutput, &bestColors[0], 2);
+		memcpy(pOutput + 2, &bestColors[1], 2);
+		memcpy(pOutput + 4, &bestIndices, 4);
+	}
+
+	void TextureCompressor::EncodeBC4(const uint8_t texels[16][4], uint32_t channel, uint8_t* pOutput)
+	{
+		uint8_t minValue = 255, maxValue = 0;
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			minValue = std::min(minValue, texels[i][channel]);
+			maxValue = std::max(maxValue, texels[i][channel]);
+		}
+
+		// Eight value mode is selected by red0 > red1, values are interpolated in between
+		int32_t palette[8][4] = {};
+		palette[0][0] = maxValue;
+		palette[1][0] = minValue;
+		for (uint32_t i = 1; i < 7; ++i)
+		{
+			palette[i + 1][0] = ((7 - i) * maxValue + i * minValue) / 7;
+		}
+
+		uint64_t indices = 0;
+		if (maxValue != minValue)
+		{
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				uint8_t value[4] = { texels[i][channel], 0, 0, 0 };
+				indices |= (uint64_t)FindClosestColor(value, palette, 8, 1) << (i * 3);
+			}
+		}
+
+		pOutput[0] = maxValue;
+		pOutput[1] = minValue;
+		for (uint32_t i = 0; i < 6; ++i)
+		{
+			pOutput[2 + i] = (uint8_t)(indices >> (i * 8));
+		}
+	}
+
+	void TextureCompressor::EncodeBC7Mode6(const uint8_t texels[16][4], uint8_t* pOutput)
+	{
+		// Mode 6: single subset, 7-bit RGBA endpoints with a unique p-bit each, 4-bit indices
+		float endpoints[2][4];
+		ComputeEndpoints(texels, 4, endpoints[0], endpoints[1]);
+
+		uint32_t bestQuantized[2][4] = {};
+		uint32_t bestPBits[2] = {};
+		uint32_t bestIndices[16] = {};
+		int32_t bestError = INT32_MAX;
+
+		// Second pass refits the endpoints to the indices found by the first
+		for (uint32_t pass = 0; pass < 2; ++pass)
+		{
+			uint32_t quantized[2][4];
+			uint32_t pBits[2];
+			for (uint32_t i = 0; i < 2; ++i)
+			{
+				float bestEndpointError = FLT_MAX;
+				for (uint32_t pBit = 0; pBit < 2; ++pBit)
+				{
+					float error = 0;
+					uint32_t candidate[4];
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						candidate[c] = (uint32_t)std::clamp((int32_t)std::lround((endpoints[i][c] - pBit) * 0.5f), 0, 127);
+						float delta = (float)((candidate[c] << 1) | pBit) - endpoints[i][c];
+						error += delta * delta;
+					}
+					if (error < bestEndpointError)
+					{
+						bestEndpointError = error;
+						pBits[i] = pBit;
+						memcpy(quantized[i], candidate, sizeof(candidate));
+					}
+				}
+			}
+
+			int32_t palette[16][4];
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					int32_t e0 = (quantized[0][c] << 1) | pBits[0];
+					int32_t e1 = (quantized[1][c] << 1) | pBits[1];
+					palette[i][c] = ((64 - BC7_WEIGHTS_4[i]) * e0 + BC7_WEIGHTS_4[i] * e1 + 32) >> 6;
+				}
+			}
+
+			uint32_t indices[16];
+			int32_t totalError = 0;
+			float weights[16];
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				int32_t error = 0;
+				indices[i] = FindClosestColor(texels[i], palette, 16, 4, &error);
+				totalError += error;
+				weights[i] = BC7_WEIGHTS_4[indices[i]] / 64.0f;
+			}
+
+			if (totalError < bestError)
+			{
+				bestError = totalError;
+				memcpy(bestQuantized, quantized, sizeof(quantized));
+				memcpy(bestPBits, pBits, sizeof(pBits));
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+
+			if (!RefineEndpoints(texels, weights, 4, endpoints[0], endpoints[1]))
+			{
+				break;
+			}
+		}
+
+		// Most significant index bit of anchor texel is implied zero, endpoints are swapped instead
+		if (bestIndices[0] >= 8)
+		{
+			std::swap(bestQuantized[0], bestQuantized[1]);
+			std::swap(bestPBits[0], bestPBits[1]);
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				bestIndices[i] = 15 - bestIndices[i];
+			}
+		}
+
+		memset(pOutput, 0, 16);
+		uint32_t bitPosition = 0;
+		auto writeBits = [pOutput, &bitPosition](uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; ++i, ++bitPosition)
+			{
+				pOutput[bitPosition >> 3] |= ((value >> i) & 1) << (bitPosition & 7);
+			}
+		};
+
+		writeBits(1 << 6, 7);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			writeBits(bestQuantized[0][c], 7);
+			writeBits(bestQuantized[1][c], 7);
+		}
+		writeBits(bestPBits[0], 1);
+		writeBits(bestPBits[1], 1);
+		writeBits(bestIndices[0], 3);
+		for (uint32_t i = 1; i < 16; ++i)
+		{
+			writeBits(bestIndices[i], 4);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "SharedTypes.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace Engine
+{
+	// Decides which block compressed format an image texture is cooked into
+	enum class ETextureContent
+	{
+		Uncompressed = 0, // Loaded as RGBA8_SRGB with runtime mipmap generation, e.g. lookup ramps that must not be filtered or quantized
+		Color,			  // BC1 if fully opaque, otherwise BC7, both sRGB
+		NormalMap,		  // BC5, only tangent space XY is kept
+		SingleChannel,	  // BC4 from red channel, e.g. roughness or ambient occlusion
+		COUNT
+	};
+
+	// CPU encoder that cooks source images into KTX2 files with full mip chain, block rows are encoded on the job system
+	class TextureCompressor
+	{
+	public:
+		static std::string GetCookedFilePath(const char* sourcePath, ETextureContent content);
+		static bool IsCookedFileUpToDate(const char* sourcePath, const char* cookedPath);
+		static bool CookTexture(const char* sourcePath, const char* cookedPath, ETextureContent content);
+
+	private:
+		struct ImageLevel
+		{
+			uint32_t width;
+			uint32_t height;
+			std::vector<uint8_t> pixels; // RGBA8
+		};
+
+		static ETextureFormat SelectFormat(const ImageLevel& baseLevel, ETextureContent content);
+		static void GenerateMipChain(std::vector<ImageLevel>& levels, ETextureContent content);
+		static void CompressLevel(const ImageLevel& level, ETextureFormat format, std::vector<uint8_t>& outBlocks);
+
+		static void FetchBlock(const ImageLevel& level, uint32_t blockX, uint32_t blockY, uint8_t outTexels[16][4]);
+		static void EncodeBC1(const uint8_t texels[16][4], uint8_t* pOutput);
+		static void EncodeBC4(const uint8_t texels[16][4], uint32_t channel, uint8_t* pOutput);
+		static void EncodeBC7Mode6(const uint8_t texels[16][4], uint8_t* pOutput);
+	};
+}
\ No newline at end of file
@@ -147,6 +147,17 @@ namespace Engine
 					"toneTexturePath"
 				};
 
+				// Tone textures are lookup ramps and noise is sampled per channel, both are kept uncompressed
+				static ETextureContent contentTypes[(uint32_t)EMaterialTextureType::COUNT] =
+				{
+					ETextureContent::Color,
+					ETextureContent::NormalMap,
+					ETextureContent::SingleChannel,
+					ETextureContent::SingleChannel,
+					ETextureContent::Uncompressed,
+					ETextureContent::Uncompressed
+				};
+
 				uint32_t materialCount = component["materialCount"].asUInt();
 
 				for (uint32_t i = 0; i < materialCount; ++i)
@@ -167,7 +178,7 @@ namespace Engine
 							Texture2D* pTexture = nullptr;
 							if (ResourceManagement::LoadedImageTextures.find(subComponent[pathTypes[i]].asString()) == ResourceManagement::LoadedImageTextures.end())
 							{
-								CE_NEW(pTexture, ImageTexture, subComponent[pathTypes[i]].asCString());
+								CE_NEW(pTexture, ImageTexture, subComponent[pathTypes[i]].asCString(), contentTypes[i]);
 								ResourceManagement::LoadedImageTextures.emplace(subComponent[pathTypes[i]].asString(), pTexture);
 							}
 							else
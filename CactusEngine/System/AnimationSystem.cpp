@@ -1,5 +1,8 @@
 #include "AnimationSystem.h"
 #include "AnimationComponent.h"
+#include "JobSystem.h"
+#include "BaseEntity.h"
+#include "LogUtility.h"
 
 namespace Engine
 {
@@ -26,15 +29,32 @@ namespace Engine
 
 	void AnimationSystem::Tick()
 	{
+		m_animationList.clear();
+
 		auto pEntityList = m_pECSWorld->GetEntityList();
 		for (auto itr = pEntityList->begin(); itr != pEntityList->end(); ++itr)
 		{
 			auto pAnimationComp = (AnimationComponent*)itr->second->GetComponent(EComponentType::Animation);
 			if (pAnimationComp)
 			{
-				pAnimationComp->Apply();
+#if defined(DEBUG_MODE_CE)
+				// A component attached to more than one entity would be modified by several animation jobs at once
+				for (auto& component : itr->second->GetComponentList())
+				{
+					DEBUG_ASSERT_MESSAGE_CE(component.second->GetParentEntity() == itr->second, "Animated entity shares a component with another entity.");
+				}
+#endif
+				m_animationList.emplace_back(pAnimationComp);
 			}
 		}
+
+		// Animation functions are plain function pointers that only receive the entity they are attached to, and every
+		// component belongs to exactly one entity (checked above), so jobs of different entities do not touch shared data
+		// Alert: animation functions must not modify other entities or global state
+		JobSystem::ParallelFor((uint32_t)m_animationList.size(), ANIMATION_BATCH_SIZE, [this](uint32_t index)
+			{
+				m_animationList[index]->Apply();
+			});
 	}
 
 	void AnimationSystem::FrameEnd()
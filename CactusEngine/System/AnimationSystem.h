@@ -6,6 +6,8 @@
 
 namespace Engine
 {
+	class AnimationComponent;
+
 	class AnimationSystem : public BaseSystem
 	{
 	public:
@@ -21,5 +23,8 @@ namespace Engine
 
 	private:
 		ECSWorld* m_pECSWorld;
+		std::vector<AnimationComponent*> m_animationList;
+
+		static const uint32_t ANIMATION_BATCH_SIZE = 64;
 	};
 }
\ No newline at end of file
@@ -10,8 +10,12 @@
 #include "GraphicsHardwareInterface_D3D12.h"
 #include "MeshFilterComponent.h"
 #include "MaterialComponent.h"
+#include "ImageTexture.h"
 #include "CameraComponent.h"
 #include "LightComponent.h"
+#include "DynamicResolutionController.h"
+#include "Timer.h"
+#include "JobSystem.h"
 
 namespace Engine
 {
@@ -19,27 +23,47 @@ namespace Engine
 		: m_pECSWorld(pWorld),
 		m_pDevice(nullptr),
 		m_isRunning(true),
+		m_shaderPrograms((uint32_t)EBuiltInShaderProgramType::COUNT),
 		m_activeRenderer(gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetActiveRenderer()),
 		m_rendererTable{},
 		m_frameIndex(0),
 		m_maxFramesInFlight(gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetMaxFramesInFlight()),
 		m_pendingResolutionUpdate(false),
-		m_pauseRendering(false)
+		m_pauseRendering(false),
+		m_pDynamicResolutionController(nullptr)
 	{
-		m_shaderPrograms.resize((uint32_t)EBuiltInShaderProgramType::COUNT, nullptr);
+		for (auto& pShaderProgram : m_shaderPrograms)
+		{
+			pShaderProgram = nullptr;
+		}
+		m_shaderProgramsLoading.resize((uint32_t)EBuiltInShaderProgramType::COUNT, false);
 	}
 
 	void RenderingSystem::Initialize()
 	{
+		int64_t phaseStartTime = Timer::TimeSinceStartUp();
+
 		CreateDevice();
+		LOG_MESSAGE("Graphics device initialized in " + std::to_string((Timer::TimeSinceStartUp() - phaseStartTime) / 1000000) + " ms.");
 		
 		if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPrebuildShadersAndPipelines())
 		{
+			phaseStartTime = Timer::TimeSinceStartUp();
 			LoadAllShaders();
+			LOG_MESSAGE("Shader programs loaded in " + std::to_string((Timer::TimeSinceStartUp() - phaseStartTime) / 1000000) + " ms.");
 		}
 
 		RegisterRenderers();
+
+		phaseStartTime = Timer::TimeSinceStartUp();
 		InitializeActiveRenderer();
+		LOG_MESSAGE("Active renderer initialized in " + std::to_string((Timer::TimeSinceStartUp() - phaseStartTime) / 1000000) + " ms.");
+
+		auto pGraphicsConfig = gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics);
+		if (pGraphicsConfig->GetDynamicResolution())
+		{
+			CE_NEW(m_pDynamicResolutionController, DynamicResolutionController, pGraphicsConfig->GetTargetFrameTime(), pGraphicsConfig->GetMinDynamicResolutionScale());
+		}
 
 		m_renderThread = std::thread(&RenderingSystem::RenderThreadFunction, this);
 	}
@@ -48,6 +72,10 @@ namespace Engine
 	{
 		m_isRunning = false;
 		m_renderThread.join();
+
+		ImageTexture::WaitStreamingJobs();
+
+		CE_SAFE_DELETE(m_pDynamicResolutionController);
 	}
 
 	void RenderingSystem::FrameBegin()
@@ -106,13 +134,13 @@ namespace Engine
 	{
 		DEBUG_ASSERT_CE((uint32_t)type < m_shaderPrograms.size());
 
-		if (m_shaderPrograms[(uint32_t)type] == nullptr)
+		if (m_shaderPrograms[(uint32_t)type].load() == nullptr)
 		{
 			bool result = LoadShader(type);
 			DEBUG_ASSERT_CE(result);
 		}
 
-		return m_shaderPrograms[(uint32_t)type];
+		return m_shaderPrograms[(uint32_t)type].load();
 	}
 
 	void RenderingSystem::RemoveRenderer(ERendererType type)
@@ -180,27 +208,37 @@ namespace Engine
 
 	void RenderingSystem::LoadAllShaders()
 	{
-		LoadShader(EBuiltInShaderProgramType::Basic);
-		LoadShader(EBuiltInShaderProgramType::Basic_Transparent);
-		LoadShader(EBuiltInShaderProgramType::WaterBasic);
-		LoadShader(EBuiltInShaderProgramType::DepthBased_ColorBlend_2);
-		LoadShader(EBuiltInShaderProgramType::GBuffer);
-		LoadShader(EBuiltInShaderProgramType::AnimeStyle);
-		LoadShader(EBuiltInShaderProgramType::ShadowMap);
-		LoadShader(EBuiltInShaderProgramType::DOF);
-		LoadShader(EBuiltInShaderProgramType::DeferredLighting);
-		LoadShader(EBuiltInShaderProgramType::DeferredLighting_Directional);
+		// Each program reads, creates and reflects its own shader modules, so they can be loaded in parallel
+		JobCounter loadCounter;
+		for (uint32_t i = 0; i < (uint32_t)EBuiltInShaderProgramType::COUNT; ++i)
+		{
+			JobSystem::Schedule([this, i]()
+				{
+					LoadShader((EBuiltInShaderProgramType)i);
+				},
+				&loadCounter);
+		}
+		JobSystem::WaitForCounter(&loadCounter);
 	}
 
 	bool RenderingSystem::LoadShader(EBuiltInShaderProgramType type)
 	{
-		std::lock_guard<std::mutex> guard(m_shaderProgramsMutex);
-
-		if (m_shaderPrograms[(uint32_t)type] != nullptr)
 		{
-			return true;
+			std::unique_lock<std::mutex> lock(m_shaderProgramsMutex);
+
+			// Only the first requesting thread loads the program, others wait for it to be registered
+			m_shaderProgramsCv.wait(lock, [this, type]() { return !m_shaderProgramsLoading[(uint32_t)type]; });
+
+			if (m_shaderPrograms[(uint32_t)type].load() != nullptr)
+			{
+				return true;
+			}
+			m_shaderProgramsLoading[(uint32_t)type] = true;
 		}
 
+		// Loading is done outside of the lock, so that different programs do not block each other
+		ShaderProgram* pShaderProgram = nullptr;
+
 		switch (m_pDevice->GetGraphicsAPIType())
 		{
 		case EGraphicsAPIType::Vulkan:
@@ -208,43 +246,53 @@ namespace Engine
 			switch (type)
 			{
 			case EBuiltInShaderProgramType::Basic:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_BASIC_VK, BuiltInResourcesPath::SHADER_FRAGMENT_BASIC_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_BASIC_VK,
+					m_pDevice->IsBindlessTexturingEnabled() ? BuiltInResourcesPath::SHADER_FRAGMENT_BASIC_BINDLESS_VK : BuiltInResourcesPath::SHADER_FRAGMENT_BASIC_VK);
 				break;
 
 			case EBuiltInShaderProgramType::Basic_Transparent:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_BASIC_TRANSPARENT_VK, BuiltInResourcesPath::SHADER_FRAGMENT_BASIC_TRANSPARENT_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_BASIC_TRANSPARENT_VK, BuiltInResourcesPath::SHADER_FRAGMENT_BASIC_TRANSPARENT_VK);
 				break;
 
 			case EBuiltInShaderProgramType::WaterBasic:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_WATER_BASIC_VK, BuiltInResourcesPath::SHADER_FRAGMENT_WATER_BASIC_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_WATER_BASIC_VK, BuiltInResourcesPath::SHADER_FRAGMENT_WATER_BASIC_VK);
 				break;
 
 			case EBuiltInShaderProgramType::DepthBased_ColorBlend_2:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEPTH_COLORBLEND_2_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEPTH_COLORBLEND_2_VK);
 				break;
 
 			case EBuiltInShaderProgramType::GBuffer:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_GBUFFER_VK, BuiltInResourcesPath::SHADER_FRAGMENT_GBUFFER_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_GBUFFER_VK, BuiltInResourcesPath::SHADER_FRAGMENT_GBUFFER_VK);
 				break;
 
 			case EBuiltInShaderProgramType::AnimeStyle:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_ANIMESTYLE_VK, BuiltInResourcesPath::SHADER_FRAGMENT_ANIMESTYLE_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_ANIMESTYLE_VK,
+					m_pDevice->IsBindlessTexturingEnabled() ? BuiltInResourcesPath::SHADER_FRAGMENT_ANIMESTYLE_BINDLESS_VK : BuiltInResourcesPath::SHADER_FRAGMENT_ANIMESTYLE_VK);
 				break;
 
 			case EBuiltInShaderProgramType::ShadowMap:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_SHADOWMAP_VK, BuiltInResourcesPath::SHADER_FRAGMENT_SHADOWMAP_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_SHADOWMAP_VK, BuiltInResourcesPath::SHADER_FRAGMENT_SHADOWMAP_VK);
 				break;
 
 			case EBuiltInShaderProgramType::DOF:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEPTH_OF_FIELD_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEPTH_OF_FIELD_VK);
 				break;
 
 			case EBuiltInShaderProgramType::DeferredLighting:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_DEFERRED_LIGHTING_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEFERRED_LIGHTING_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_DEFERRED_LIGHTING_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEFERRED_LIGHTING_VK);
 				break;
 
 			case EBuiltInShaderProgramType::DeferredLighting_Directional:
-				m_shaderPrograms[(uint32_t)type] = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEFERRED_LIGHTING_DIR_VK);
+				pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_FULLSCREEN_QUAD_VK, BuiltInResourcesPath::SHADER_FRAGMENT_DEFERRED_LIGHTING_DIR_VK);
+				break;
+
+			case EBuiltInShaderProgramType::ShadowMap_PositionOnly:
+				// Only used by meshes that carry position stream
+				if (gpGlobal->GetConfiguration<GraphicsConfiguration>(EConfigurationType::Graphics)->GetPositionStream())
+				{
+					pShaderProgram = m_pDevice->CreateShaderProgramFromFile(BuiltInResourcesPath::SHADER_VERTEX_SHADOWMAP_POSITION_ONLY_VK, BuiltInResourcesPath::SHADER_FRAGMENT_SHADOWMAP_POSITION_ONLY_VK);
+				}
 				break;
 
 			default:
@@ -253,7 +301,7 @@ namespace Engine
 				return false;
 			}
 			}
-			return true;
+			break;
 		}
 		case EGraphicsAPIType::D3D12:
 		{
@@ -265,12 +313,21 @@ namespace Engine
 				return false;
 			}
 			}
-			return true;
+			break;
 		}
 		default:
 			throw std::runtime_error("Unhandled graphics device type.");
 			return false;
 		}
+
+		{
+			std::lock_guard<std::mutex> guard(m_shaderProgramsMutex);
+			m_shaderPrograms[(uint32_t)type].store(pShaderProgram);
+			m_shaderProgramsLoading[(uint32_t)type] = false;
+		}
+		m_shaderProgramsCv.notify_all();
+
+		return pShaderProgram != nullptr;
 	}
 
 	void RenderingSystem::RenderThreadFunction()
@@ -300,6 +357,15 @@ namespace Engine
 				m_transparentDrawList.clear();
 				m_lightDrawList.clear();
 
+				// Present reclaims transient descriptor pools of the next frame slot, so no render node job may still be recording
+				for (auto pRenderer : m_rendererTable)
+				{
+					if (pRenderer && pRenderer->GetRenderGraph())
+					{
+						pRenderer->GetRenderGraph()->WaitRenderPasses();
+					}
+				}
+
 				m_pDevice->Present(m_frameIndex);
 				m_frameIndex = (m_frameIndex + 1) % m_maxFramesInFlight;
 
@@ -320,6 +386,8 @@ namespace Engine
 
 	void RenderingSystem::BuildRenderTask()
 	{
+		bool useBindless = m_pDevice->IsBindlessTexturingEnabled();
+
 		auto pEntityList = m_pECSWorld->GetEntityList();
 		for (auto itr = pEntityList->begin(); itr != pEntityList->end(); ++itr)
 		{
@@ -329,6 +397,11 @@ namespace Engine
 
 			if (pMeshFilterComp && pMaterialComp)
 			{
+				if (useBindless)
+				{
+					UpdateBindlessMaterials(pMaterialComp);
+				}
+
 				if (pMaterialComp->HasTransparency())
 				{
 					m_transparentDrawList.emplace_back(itr->second);
@@ -344,6 +417,53 @@ namespace Engine
 		}
 	}
 
+	void RenderingSystem::UpdateBindlessMaterials(MaterialComponent* pMaterialComp)
+	{
+		for (auto& pMaterial : pMaterialComp->GetMaterialList())
+		{
+			if (!pMaterial || !pMaterial->IsBindlessRecordDirty())
+			{
+				continue;
+			}
+
+			BindlessMaterialRecord record{};
+			record.albedoColor = pMaterial->GetAlbedoColor();
+			record.anisotropy = pMaterial->GetAnisotropy();
+			record.roughness = pMaterial->GetRoughness();
+
+			// Placeholder is registered while textures are streaming in, the record is kept dirty so it gets updated once they are resident
+			bool texturesResident = true;
+			for (auto& texture : pMaterial->GetTextureList())
+			{
+				if (texture.second && texture.second->QuerySource() == ETexture2DSource::ImageTexture && !((ImageTexture*)texture.second)->IsResident())
+				{
+					texturesResident = false;
+				}
+			}
+
+			auto pAlbedoTexture = pMaterial->GetTexture(EMaterialTextureType::Albedo);
+			record.albedoTextureIndex = pAlbedoTexture ? m_pDevice->RegisterBindlessTexture(pAlbedoTexture) : BINDLESS_INVALID_INDEX;
+
+			// Tone texture is looked up with unfiltered sampler
+			auto pToneTexture = pMaterial->GetTexture(EMaterialTextureType::Tone);
+			record.toneTextureIndex = pToneTexture ? m_pDevice->RegisterBindlessTexture(pToneTexture, m_pDevice->GetTextureSampler(ESamplerAnisotropyLevel::None)) : BINDLESS_INVALID_INDEX;
+
+			if (pMaterial->GetBindlessIndex() == BINDLESS_INVALID_INDEX)
+			{
+				pMaterial->SetBindlessIndex(m_pDevice->RegisterBindlessMaterial(record));
+			}
+			else
+			{
+				m_pDevice->UpdateBindlessMaterial(pMaterial->GetBindlessIndex(), record);
+			}
+
+			if (texturesResident)
+			{
+				pMaterial->ClearBindlessRecordDirty();
+			}
+		}
+	}
+
 	void RenderingSystem::ExecuteRenderTask()
 	{
 		auto pCamera = m_pECSWorld->FindEntityWithTag(EEntityTag::MainCamera);
@@ -359,6 +479,14 @@ namespace Engine
 			context.pTransparentDrawList = &m_transparentDrawList;
 			context.pLightDrawList = &m_lightDrawList;
 			context.pCamera = pCamera;
+			context.dynamicResolutionScale = 1.0f;
+
+			if (m_pDynamicResolutionController)
+			{
+				// Alert: CPU frame time is used for now, it cannot tell whether GPU is the bottleneck and is capped by vsync
+				m_pDynamicResolutionController->AddFrameTime(Timer::GetFrameDeltaTime() * 1000.0f);
+				context.dynamicResolutionScale = m_pDynamicResolutionController->GetScale();
+			}
 
 			pRenderer->Draw(context, m_frameIndex);
 		}
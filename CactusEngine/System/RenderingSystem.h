@@ -8,6 +8,8 @@ namespace Engine
 {
 	class ShaderProgram;
 	class BaseWindow;
+	class MaterialComponent;
+	class DynamicResolutionController;
 
 	class RenderingSystem : public BaseSystem
 	{
@@ -52,6 +54,7 @@ namespace Engine
 
 		void RenderThreadFunction();
 		void BuildRenderTask();
+		void UpdateBindlessMaterials(MaterialComponent* pMaterialComp);
 		void ExecuteRenderTask();
 
 		void UpdateResolutionImpl();
@@ -61,8 +64,10 @@ namespace Engine
 		GraphicsDevice* m_pDevice;
 		bool m_isRunning;
 
-		std::vector<ShaderProgram*> m_shaderPrograms;
+		std::vector<std::atomic<ShaderProgram*>> m_shaderPrograms; // Read without lock once registered
+		std::vector<bool> m_shaderProgramsLoading;
 		std::mutex m_shaderProgramsMutex;
+		std::condition_variable m_shaderProgramsCv;
 
 		ERendererType m_activeRenderer;
 		BaseRenderer* m_rendererTable[(uint32_t)ERendererType::COUNT];
@@ -88,5 +93,7 @@ namespace Engine
 
 		bool m_pendingResolutionUpdate;
 		bool m_pauseRendering;
+
+		DynamicResolutionController* m_pDynamicResolutionController; // Null if dynamic resolution is disabled
 	};
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "FileUtility.h"
+#include "LogUtility.h"
+
+#include <fstream>
+#include <filesystem>
+
+namespace Engine
+{
+	bool FileUtility::WriteFileAtomic(const char* filePath, const std::function<void(std::ostream&)>& writeContent)
+	{
+		std::filesystem::path finalPath(filePath);
+		std::filesystem::path tempFilePath(finalPath);
+		tempFilePath += ".tmp";
+
+		std::error_code errorCode;
+		if (finalPath.has_parent_path())
+		{
+			std::filesystem::create_directories(finalPath.parent_path(), errorCode);
+		}
+
+		{
+			std::ofstream fileWriter(tempFilePath, std::ios::binary | std::ios::trunc);
+			if (fileWriter.fail())
+			{
+				LOG_WARNING("Cannot write file " + tempFilePath.string());
+				return false;
+			}
+
+			writeContent(fileWriter);
+			fileWriter.close();
+
+			if (fileWriter.fail())
+			{
+				LOG_WARNING("Cannot write file " + tempFilePath.string());
+				std::filesystem::remove(tempFilePath, errorCode);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempFilePath, finalPath, errorCode);
+		if (errorCode)
+		{
+			LOG_WARNING("Cannot replace file " + finalPath.string() + ": " + errorCode.message());
+			std::filesystem::remove(tempFilePath, errorCode);
+			return false;
+		}
+
+		return true;
+	}
+
+	uint64_t FileUtility::HashFNV1a64(const void* pData, size_t size, uint64_t hash)
+	{
+		const uint8_t* pBytes = (const uint8_t*)pData;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= (uint64_t)pBytes[i];
+			hash *= FNV1A64_PRIME;
+		}
+		return hash;
+	}
+}
\ No newline at end of file
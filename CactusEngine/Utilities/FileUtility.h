@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+
+namespace Engine
+{
+	// Helpers shared by on-disk caches and cooked asset files
+	class FileUtility
+	{
+	public:
+		// Content is written to a temporary file that then replaces filePath in one step, so a partially written file is never visible under the final name.
+		// Parent directories are created if needed, failures are logged as warnings
+		static bool WriteFileAtomic(const char* filePath, const std::function<void(std::ostream&)>& writeContent);
+
+		// 64-bit FNV-1a, pass a previous result as hash to continue hashing more data
+		static uint64_t HashFNV1a64(const void* pData, size_t size, uint64_t hash = FNV1A64_OFFSET_BASIS);
+
+	public:
+		static const uint64_t FNV1A64_OFFSET_BASIS = 14695981039346656037ull;
+		static const uint64_t FNV1A64_PRIME = 1099511628211ull;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "JobSystem.h"
+#include "LogUtility.h"
+#include "MemoryAllocator.h"
+
+#include <algorithm>
+
+namespace Engine
+{
+	bool JobSystem::m_sIsInitialized = false;
+	std::atomic<bool> JobSystem::m_sIsRunning(false);
+	uint32_t JobSystem::m_sWorkerCount = 0;
+	std::vector<std::thread> JobSystem::m_sWorkerThreads;
+	std::vector<JobSystem::ThreadSlot*> JobSystem::m_sThreadSlots;
+	std::atomic<uint32_t> JobSystem::m_sExternalThreadCount(0);
+	thread_local uint32_t JobSystem::m_sCurrentThreadSlot = JobSystem::UNASSIGNED_THREAD_SLOT;
+	std::atomic<uint64_t> JobSystem::m_sWorkEpoch(0);
+	std::atomic<uint32_t> JobSystem::m_sSleepingWorkerCount(0);
+	std::mutex JobSystem::m_sSleepMutex;
+	std::condition_variable JobSystem::m_sSleepCv;
+
+	void JobCounter::Increase(uint32_t count)
+	{
+		m_countImpl.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	void JobCounter::Decrease()
+	{
+		m_countImpl.fetch_sub(1, std::memory_order_release);
+	}
+
+	bool JobCounter::IsDone() const
+	{
+		return m_countImpl.load(std::memory_order_acquire) == 0;
+	}
+
+	JobSystem::ThreadSlot::ThreadSlot()
+		: jobQueue(JOB_QUEUE_CAPACITY),
+		jobPool(JOB_POOL_SIZE),
+		nextJobIndex(0)
+	{
+
+	}
+
+	void JobSystem::Initialize(uint32_t workerCount)
+	{
+		DEBUG_ASSERT_MESSAGE_CE(!m_sIsInitialized, "Job system is already initialized.");
+
+		if (workerCount == 0)
+		{
+			workerCount = std::thread::hardware_concurrency() > 2 ? std::thread::hardware_concurrency() - 2 : 1; // -2 for main thread and render thread
+		}
+		m_sWorkerCount = workerCount;
+#if defined(DEBUG_MODE_CE)
+		if (m_sWorkerCount == 1)
+		{
+			LOG_MESSAGE("Hardware concurrency is very low, job execution will be suboptimal.");
+		}
+#endif
+
+		m_sThreadSlots.resize(m_sWorkerCount + MAX_EXTERNAL_THREAD_COUNT);
+		for (auto& pSlot : m_sThreadSlots)
+		{
+			CE_NEW(pSlot, ThreadSlot);
+		}
+
+		m_sExternalThreadCount = 0;
+		m_sIsRunning = true;
+		m_sIsInitialized = true;
+
+		for (uint32_t i = 0; i < m_sWorkerCount; i++)
+		{
+			m_sWorkerThreads.emplace_back(&JobSystem::WorkerThreadFunction, i);
+		}
+	}
+
+	void JobSystem::ShutDown()
+	{
+		if (!m_sIsInitialized)
+		{
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(m_sSleepMutex);
+			m_sIsRunning = false;
+		}
+		m_sSleepCv.notify_all();
+
+		for (auto& thread : m_sWorkerThreads)
+		{
+			thread.join();
+		}
+		m_sWorkerThreads.clear();
+
+		for (auto& pSlot : m_sThreadSlots)
+		{
+			CE_DELETE(pSlot);
+		}
+		m_sThreadSlots.clear();
+
+		m_sIsInitialized = false;
+	}
+
+	void JobSystem::Schedule(const JobFunction& function, JobCounter* pCounter)
+	{
+		uint32_t slot = m_sIsInitialized ? GetCurrentThreadSlot() : INVALID_THREAD_SLOT;
+		Job* pJob = slot != INVALID_THREAD_SLOT ? AllocateJob(slot) : nullptr;
+		if (!pJob)
+		{
+			// No job storage available to this thread, execute immediately
+			function();
+			return;
+		}
+
+		if (pCounter)
+		{
+			pCounter->Increase();
+		}
+
+		pJob->function = function;
+		pJob->pCounter = pCounter;
+
+		if (!m_sThreadSlots[slot]->jobQueue.Push(pJob))
+		{
+			// Queue is full, execute immediately on current thread
+			ExecuteJob(pJob);
+			return;
+		}
+
+		WakeWorker();
+	}
+
+	void JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t)>& function)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+		batchSize = std::max<uint32_t>(batchSize, 1);
+
+		JobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += batchSize)
+		{
+			uint32_t end = std::min<uint32_t>(begin + batchSize, count);
+			Schedule([&function, begin, end]()
+				{
+					for (uint32_t i = begin; i < end; ++i)
+					{
+						function(i);
+					}
+				},
+				&counter);
+		}
+
+		WaitForCounter(&counter);
+	}
+
+	void JobSystem::WaitForCounter(const JobCounter* pCounter)
+	{
+		DEBUG_ASSERT_CE(pCounter != nullptr);
+
+		if (!m_sIsInitialized)
+		{
+			return;
+		}
+
+		uint32_t slot = GetCurrentThreadSlot();
+		while (!pCounter->IsDone())
+		{
+			if (slot == INVALID_THREAD_SLOT || !TryExecuteJob(slot))
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	uint32_t JobSystem::GetWorkerCount()
+	{
+		return m_sWorkerCount;
+	}
+
+	uint32_t JobSystem::GetThreadSlotCount()
+	{
+		return (uint32_t)m_sThreadSlots.size();
+	}
+
+	uint32_t JobSystem::GetCurrentThreadSlot()
+	{
+		if (m_sCurrentThreadSlot == UNASSIGNED_THREAD_SLOT)
+		{
+			// First time an external thread interacts with job system
+			uint32_t externalIndex = m_sExternalThreadCount.fetch_add(1);
+			if (externalIndex < MAX_EXTERNAL_THREAD_COUNT)
+			{
+				m_sCurrentThreadSlot = m_sWorkerCount + externalIndex;
+			}
+			else
+			{
+				LOG_WARNING("JobSystem: too many external threads are using job system, jobs scheduled from this thread are executed inline.");
+				m_sCurrentThreadSlot = INVALID_THREAD_SLOT;
+			}
+		}
+		return m_sCurrentThreadSlot;
+	}
+
+	void JobSystem::WorkerThreadFunction(uint32_t slot)
+	{
+		m_sCurrentThreadSlot = slot;
+
+		while (m_sIsRunning)
+		{
+			if (TryExecuteJob(slot))
+			{
+				continue;
+			}
+
+			// Spin for a while before going to sleep, as new jobs usually arrive in bursts
+			bool foundJob = false;
+			for (uint32_t i = 0; i < IDLE_SPIN_COUNT && !foundJob; i++)
+			{
+				std::this_thread::yield();
+				foundJob = TryExecuteJob(slot);
+			}
+			if (foundJob)
+			{
+				continue;
+			}
+
+			uint64_t epoch = m_sWorkEpoch.load();
+			if (TryExecuteJob(slot))
+			{
+				continue;
+			}
+
+			m_sSleepingWorkerCount++;
+			{
+				std::unique_lock<std::mutex> lock(m_sSleepMutex);
+				m_sSleepCv.wait(lock, [epoch]() { return m_sWorkEpoch.load() != epoch || !m_sIsRunning; });
+			}
+			m_sSleepingWorkerCount--;
+		}
+	}
+
+	bool JobSystem::TryExecuteJob(uint32_t slot)
+	{
+		Job* pJob = nullptr;
+
+		if (m_sThreadSlots[slot]->jobQueue.Pop(pJob))
+		{
+			ExecuteJob(pJob);
+			return true;
+		}
+
+		uint32_t slotCount = (uint32_t)m_sThreadSlots.size();
+		for (uint32_t i = 1; i < slotCount; i++)
+		{
+			if (m_sThreadSlots[(slot + i) % slotCount]->jobQueue.Steal(pJob))
+			{
+				ExecuteJob(pJob);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void JobSystem::ExecuteJob(Job* pJob)
+	{
+		JobCounter* pCounter = pJob->pCounter;
+		pJob->function();
+
+		// Release captured state before the owner thread can reuse this job
+		pJob->function = nullptr;
+		pJob->isFree.store(true, std::memory_order_release);
+
+		if (pCounter)
+		{
+			pCounter->Decrease();
+		}
+	}
+
+	JobSystem::Job* JobSystem::AllocateJob(uint32_t slot)
+	{
+		// Jobs usually finish in scheduling order, so the next job in ring order is almost always free
+		auto pSlot = m_sThreadSlots[slot];
+		for (uint32_t i = 0; i < JOB_POOL_SIZE; i++)
+		{
+			Job* pJob = &pSlot->jobPool[pSlot->nextJobIndex];
+			pSlot->nextJobIndex = (pSlot->nextJobIndex + 1) % JOB_POOL_SIZE;
+
+			if (pJob->isFree.load(std::memory_order_acquire))
+			{
+				pJob->isFree.store(false, std::memory_order_relaxed);
+				return pJob;
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::WakeWorker()
+	{
+		m_sWorkEpoch++;
+		if (m_sSleepingWorkerCount.load() > 0)
+		{
+			std::lock_guard<std::mutex> guard(m_sSleepMutex);
+			m_sSleepCv.notify_one();
+		}
+	}
+}
\ No newline at end of file
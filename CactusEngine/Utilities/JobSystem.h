@@ -0,0 +1,92 @@
+#pragma once
+#include "WorkStealingDeque.h"
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+namespace Engine
+{
+	typedef std::function<void()> JobFunction;
+
+	// Counts unfinished jobs scheduled against it
+	class JobCounter
+	{
+	public:
+		JobCounter() : m_countImpl(0) {};
+
+		void Increase(uint32_t count = 1);
+		void Decrease();
+		bool IsDone() const;
+
+	private:
+		std::atomic<uint32_t> m_countImpl;
+	};
+
+	// Engine-wide worker pool. Each thread owns a work stealing deque, idle threads steal from others
+	class JobSystem
+	{
+	public:
+		static void Initialize(uint32_t workerCount = 0); // 0 means deduce from hardware concurrency
+		static void ShutDown();
+
+		static void Schedule(const JobFunction& function, JobCounter* pCounter = nullptr);
+		static void ParallelFor(uint32_t count, uint32_t batchSize, const std::function<void(uint32_t)>& function); // Returns when all iterations are finished
+		static void WaitForCounter(const JobCounter* pCounter); // Executes pending jobs while waiting instead of blocking
+
+		static uint32_t GetWorkerCount();
+		static uint32_t GetThreadSlotCount(); // Worker threads plus external threads that schedule or wait on jobs
+		static uint32_t GetCurrentThreadSlot(); // Unique per thread, can be used to index per-thread resources. INVALID_THREAD_SLOT if all external slots are taken
+
+	private:
+		struct Job
+		{
+			Job() : pCounter(nullptr), isFree(true) {};
+
+			JobFunction function;
+			JobCounter* pCounter;
+			std::atomic<bool> isFree; // Set by executing thread once the job has finished
+		};
+
+		struct ThreadSlot
+		{
+			ThreadSlot();
+
+			WorkStealingDeque<Job*> jobQueue;
+			std::vector<Job> jobPool;
+			uint32_t nextJobIndex;
+		};
+
+		static void WorkerThreadFunction(uint32_t slot);
+		static bool TryExecuteJob(uint32_t slot);
+		static void ExecuteJob(Job* pJob);
+		static Job* AllocateJob(uint32_t slot); // Returns nullptr if every job of the slot is still pending or running
+		static void WakeWorker();
+
+	public:
+		static const uint32_t MAX_EXTERNAL_THREAD_COUNT = 4; // Further external threads execute their jobs inline
+		static const uint32_t JOB_QUEUE_CAPACITY = 4096;
+		static const uint32_t JOB_POOL_SIZE = 2 * JOB_QUEUE_CAPACITY;
+		static const uint32_t INVALID_THREAD_SLOT = UINT32_MAX - 1;
+
+	private:
+		static const uint32_t UNASSIGNED_THREAD_SLOT = UINT32_MAX;
+		static const uint32_t IDLE_SPIN_COUNT = 64;
+
+		static bool m_sIsInitialized;
+		static std::atomic<bool> m_sIsRunning;
+		static uint32_t m_sWorkerCount;
+		static std::vector<std::thread> m_sWorkerThreads;
+		static std::vector<ThreadSlot*> m_sThreadSlots;
+		static std::atomic<uint32_t> m_sExternalThreadCount;
+		static thread_local uint32_t m_sCurrentThreadSlot;
+
+		// For putting idle workers to sleep
+		static std::atomic<uint64_t> m_sWorkEpoch;
+		static std::atomic<uint32_t> m_sSleepingWorkerCount;
+		static std::mutex m_sSleepMutex;
+		static std::condition_variable m_sSleepCv;
+	};
+}
\ No newline at end of file
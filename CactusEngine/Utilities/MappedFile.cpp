@@ -0,0 +1,140 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	MappedFile::MappedFile()
+		: m_pData(nullptr),
+		m_size(0),
+#if defined(_WIN32)
+		m_fileHandle(INVALID_HANDLE_VALUE),
+		m_mappingHandle(nullptr)
+#else
+		m_fileDescriptor(-1)
+#endif
+	{
+
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const char* filePath)
+	{
+		Close();
+
+#if defined(_WIN32)
+		m_fileHandle = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (m_fileHandle == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			Close();
+			return false;
+		}
+		m_size = (size_t)fileSize.QuadPart;
+
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mappingHandle == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		m_pData = (const uint8_t*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (m_pData == nullptr)
+		{
+			Close();
+			return false;
+		}
+#else
+		m_fileDescriptor = open(filePath, O_RDONLY);
+		if (m_fileDescriptor < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat{};
+		if (fstat(m_fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			Close();
+			return false;
+		}
+		m_size = (size_t)fileStat.st_size;
+
+		void* pMapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+		if (pMapped == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+		m_pData = (const uint8_t*)pMapped;
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+#if defined(_WIN32)
+		if (m_pData != nullptr)
+		{
+			UnmapViewOfFile(m_pData);
+		}
+		if (m_mappingHandle != nullptr)
+		{
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = nullptr;
+		}
+		if (m_fileHandle != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (m_pData != nullptr)
+		{
+			munmap((void*)m_pData, m_size);
+		}
+		if (m_fileDescriptor >= 0)
+		{
+			close(m_fileDescriptor);
+			m_fileDescriptor = -1;
+		}
+#endif
+
+		m_pData = nullptr;
+		m_size = 0;
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return m_pData != nullptr;
+	}
+
+	const uint8_t* MappedFile::GetData() const
+	{
+		return m_pData;
+	}
+
+	size_t MappedFile::GetSize() const
+	{
+		return m_size;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+#include "NoCopy.h"
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Engine
+{
+	// Read-only memory mapping of a whole file, pages are loaded by OS on first access
+	class MappedFile : public NoCopy
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool Open(const char* filePath);
+		void Close();
+
+		bool IsOpen() const;
+		const uint8_t* GetData() const;
+		size_t GetSize() const;
+
+	private:
+		const uint8_t* m_pData;
+		size_t m_size;
+
+#if defined(_WIN32)
+		void* m_fileHandle;
+		void* m_mappingHandle;
+#else
+		int m_fileDescriptor;
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+namespace Engine
+{
+	// Bounded Chase-Lev deque. Only the owner thread can push and pop at the bottom, any thread can steal from the top
+	// T should be trivially copyable (e.g. a pointer)
+	template<typename T>
+	class WorkStealingDeque
+	{
+	public:
+		WorkStealingDeque(uint32_t capacity); // Capacity must be power of 2
+		~WorkStealingDeque() = default;
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		bool Push(T val); // Owner only, returns false if deque is full
+		bool Pop(T& val); // Owner only
+		bool Steal(T& val);
+
+		bool Empty() const;
+		uint32_t GetCapacity() const;
+
+	private:
+		std::atomic<int64_t> m_top;
+		std::atomic<int64_t> m_bottom;
+		std::unique_ptr<std::atomic<T>[]> m_buffer;
+		uint32_t m_capacity;
+		int64_t m_mask;
+	};
+
+
+	template<typename T>
+	WorkStealingDeque<T>::WorkStealingDeque(uint32_t capacity)
+		: m_top(0),
+		m_bottom(0),
+		m_buffer(new std::atomic<T>[capacity]),
+		m_capacity(capacity),
+		m_mask((int64_t)capacity - 1)
+	{
+
+	}
+
+	template<typename T>
+	bool WorkStealingDeque<T>::Push(T val)
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+		int64_t top = m_top.load(std::memory_order_acquire);
+
+		if (bottom - top >= (int64_t)m_capacity)
+		{
+			return false;
+		}
+
+		m_buffer[bottom & m_mask].store(val, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+
+		return true;
+	}
+
+	template<typename T>
+	bool WorkStealingDeque<T>::Pop(T& val)
+	{
+		int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_top.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			// Empty
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		val = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+
+		if (top == bottom)
+		{
+			// Last element, race against thieves
+			bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return won;
+		}
+
+		return true;
+	}
+
+	template<typename T>
+	bool WorkStealingDeque<T>::Steal(T& val)
+	{
+		int64_t top = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+		if (top >= bottom)
+		{
+			return false;
+		}
+
+		val = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+
+		return m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	bool WorkStealingDeque<T>::Empty() const
+	{
+		return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	uint32_t WorkStealingDeque<T>::GetCapacity() const
+	{
+		return m_capacity;
+	}
+}
\ No newline at end of file